@@ -0,0 +1,76 @@
+-- 新增 curve_blob 打包曲线表，并从 5 张逐点明细表回填
+-- 回填使用文本编码（encoding = 16，逗号分隔的十进制数），应用启动时在后台执行 SampleDAO::backfillCurveBlobs，升级为二进制 float64 + 压缩
+
+CREATE TABLE IF NOT EXISTS curve_blob (
+  sample_id INT NOT NULL COMMENT '样品ID',
+  data_type ENUM('big','small','small_raw','chrom','process_big') NOT NULL COMMENT '数据类型',
+  format_version SMALLINT NOT NULL DEFAULT 1 COMMENT '存储格式版本',
+  encoding TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '编码标志：1=XOR差分 2=zlib 16=文本(迁移回填)',
+  point_count INT NOT NULL COMMENT '点数',
+  x_data LONGBLOB NOT NULL COMMENT 'x 数组',
+  y_data LONGBLOB NOT NULL COMMENT 'y 数组',
+  checksum INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'CRC32(x_data || y_data)',
+  source_filename VARCHAR(255) COMMENT '原始文件名',
+  import_attributes JSON NULL COMMENT '导入属性',
+  updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+  PRIMARY KEY (sample_id, data_type),
+  FOREIGN KEY (sample_id) REFERENCES single_tobacco_sample(id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+-- 早期版本的逐行 AFTER DELETE 触发器已废弃（重导入时每行触发一次），改由明细 DAO 在删除时一并删除打包行
+DROP TRIGGER IF EXISTS trg_tg_big_data_ad;
+DROP TRIGGER IF EXISTS trg_tg_small_data_ad;
+DROP TRIGGER IF EXISTS trg_tg_small_raw_data_ad;
+DROP TRIGGER IF EXISTS trg_chromatography_data_ad;
+DROP TRIGGER IF EXISTS trg_process_tg_big_data_ad;
+
+-- 回填（GROUP_CONCAT 默认上限 1024 字节，需放大）
+-- 与应用读取明细一致：不过滤 NULL 行，NULL 按 0 计（QVariant 空值转 double 为 0），排序位置同 ORDER BY x
+SET SESSION group_concat_max_len = 1073741824;
+
+INSERT INTO curve_blob (sample_id, data_type, format_version, encoding, point_count, x_data, y_data, checksum, source_filename)
+SELECT sample_id, 'big', 1, 16, COUNT(*),
+       GROUP_CONCAT(IFNULL(serial_no, 0) ORDER BY serial_no, id SEPARATOR ','),
+       GROUP_CONCAT(IFNULL(weight, 0) ORDER BY serial_no, id SEPARATOR ','),
+       0, MAX(source_filename)
+FROM tg_big_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE sample_id = sample_id;
+
+INSERT INTO curve_blob (sample_id, data_type, format_version, encoding, point_count, x_data, y_data, checksum, source_filename)
+SELECT sample_id, 'small', 1, 16, COUNT(*),
+       GROUP_CONCAT(IFNULL(temperature, 0) ORDER BY temperature, id SEPARATOR ','),
+       GROUP_CONCAT(IFNULL(dtg_value, 0) ORDER BY temperature, id SEPARATOR ','),
+       0, MAX(source_filename)
+FROM tg_small_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE sample_id = sample_id;
+
+INSERT INTO curve_blob (sample_id, data_type, format_version, encoding, point_count, x_data, y_data, checksum, source_filename)
+SELECT sample_id, 'small_raw', 1, 16, COUNT(*),
+       GROUP_CONCAT(IFNULL(temperature, 0) ORDER BY temperature, id SEPARATOR ','),
+       GROUP_CONCAT(IFNULL(weight, 0) ORDER BY temperature, id SEPARATOR ','),
+       0, MAX(source_filename)
+FROM tg_small_raw_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE sample_id = sample_id;
+
+INSERT INTO curve_blob (sample_id, data_type, format_version, encoding, point_count, x_data, y_data, checksum, source_filename)
+SELECT sample_id, 'chrom', 1, 16, COUNT(*),
+       GROUP_CONCAT(IFNULL(retention_time, 0) ORDER BY retention_time, id SEPARATOR ','),
+       GROUP_CONCAT(IFNULL(response_value, 0) ORDER BY retention_time, id SEPARATOR ','),
+       0, MAX(source_filename)
+FROM chromatography_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE sample_id = sample_id;
+
+INSERT INTO curve_blob (sample_id, data_type, format_version, encoding, point_count, x_data, y_data, checksum, source_filename)
+SELECT sample_id, 'process_big', 1, 16, COUNT(*),
+       GROUP_CONCAT(IFNULL(serial_no, 0) ORDER BY serial_no, id SEPARATOR ','),
+       GROUP_CONCAT(IFNULL(weight, 0) ORDER BY serial_no, id SEPARATOR ','),
+       0, MAX(source_filename)
+FROM process_tg_big_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE sample_id = sample_id;
+
+UPDATE curve_blob SET checksum = CRC32(CONCAT(x_data, y_data)) WHERE encoding = 16;
@@ -0,0 +1,58 @@
+-- 新增 sample_data_summary 样本数据目录表，并从 5 张逐点明细表回填
+-- 依赖 add_import_attributes.sql（明细表的 import_attributes 列）
+-- checksum 与应用端 SampleDataSummaryDAO::refresh 使用同一表达式；import_attributes 取 MIN()（同一样本各行相同；ANY_VALUE() 需 MySQL 5.7+，MariaDB 不支持）
+
+CREATE TABLE IF NOT EXISTS sample_data_summary (
+  sample_id INT NOT NULL COMMENT '样品ID',
+  data_type ENUM('big','small','small_raw','chrom','process_big') NOT NULL COMMENT '数据类型',
+  point_count INT NOT NULL COMMENT '点数',
+  x_min DOUBLE NULL COMMENT 'x 最小值',
+  x_max DOUBLE NULL COMMENT 'x 最大值',
+  checksum INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'BIT_XOR(CRC32(x,y))',
+  import_attributes JSON NULL COMMENT '导入属性',
+  imported_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+  PRIMARY KEY (sample_id, data_type),
+  INDEX idx_summary_type (data_type, sample_id),
+  FOREIGN KEY (sample_id) REFERENCES single_tobacco_sample(id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+-- 回填
+INSERT INTO sample_data_summary (sample_id, data_type, point_count, x_min, x_max, checksum, import_attributes)
+SELECT sample_id, 'big', COUNT(*), MIN(serial_no), MAX(serial_no),
+       BIT_XOR(CRC32(CONCAT_WS(',', serial_no, weight))), MIN(import_attributes)
+FROM tg_big_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE point_count = VALUES(point_count), x_min = VALUES(x_min), x_max = VALUES(x_max),
+                        checksum = VALUES(checksum), import_attributes = VALUES(import_attributes);
+
+INSERT INTO sample_data_summary (sample_id, data_type, point_count, x_min, x_max, checksum, import_attributes)
+SELECT sample_id, 'small', COUNT(*), MIN(temperature), MAX(temperature),
+       BIT_XOR(CRC32(CONCAT_WS(',', temperature, dtg_value))), MIN(import_attributes)
+FROM tg_small_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE point_count = VALUES(point_count), x_min = VALUES(x_min), x_max = VALUES(x_max),
+                        checksum = VALUES(checksum), import_attributes = VALUES(import_attributes);
+
+INSERT INTO sample_data_summary (sample_id, data_type, point_count, x_min, x_max, checksum, import_attributes)
+SELECT sample_id, 'small_raw', COUNT(*), MIN(temperature), MAX(temperature),
+       BIT_XOR(CRC32(CONCAT_WS(',', temperature, weight))), MIN(import_attributes)
+FROM tg_small_raw_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE point_count = VALUES(point_count), x_min = VALUES(x_min), x_max = VALUES(x_max),
+                        checksum = VALUES(checksum), import_attributes = VALUES(import_attributes);
+
+INSERT INTO sample_data_summary (sample_id, data_type, point_count, x_min, x_max, checksum, import_attributes)
+SELECT sample_id, 'chrom', COUNT(*), MIN(retention_time), MAX(retention_time),
+       BIT_XOR(CRC32(CONCAT_WS(',', retention_time, response_value))), MIN(import_attributes)
+FROM chromatography_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE point_count = VALUES(point_count), x_min = VALUES(x_min), x_max = VALUES(x_max),
+                        checksum = VALUES(checksum), import_attributes = VALUES(import_attributes);
+
+INSERT INTO sample_data_summary (sample_id, data_type, point_count, x_min, x_max, checksum, import_attributes)
+SELECT sample_id, 'process_big', COUNT(*), MIN(serial_no), MAX(serial_no),
+       BIT_XOR(CRC32(CONCAT_WS(',', serial_no, weight))), MIN(import_attributes)
+FROM process_tg_big_data
+GROUP BY sample_id
+ON DUPLICATE KEY UPDATE point_count = VALUES(point_count), x_min = VALUES(x_min), x_max = VALUES(x_max),
+                        checksum = VALUES(checksum), import_attributes = VALUES(import_attributes);
@@ -0,0 +1,26 @@
+-- algo_results 改为按阶段打包存储的处理结果缓存：每个 (样品, 数据类型, 阶段, 参数哈希) 一行，
+-- x/y 编码与 curve_blob 相同。原逐点布局从未有代码写入，直接重建
+
+DROP TABLE IF EXISTS algo_results;
+
+CREATE TABLE IF NOT EXISTS algo_results (
+  sample_id INT NOT NULL COMMENT '样品ID',
+  data_type ENUM('big','small','small_raw','chrom','process_big') NOT NULL COMMENT '数据类型',
+  stage_key VARCHAR(64) NOT NULL COMMENT '阶段ID（如 baseline_correction / peak_alignment）',
+  param_hash BINARY(20) NOT NULL COMMENT '参数哈希 SHA-1（含前序阶段参数）',
+  algo_name VARCHAR(100) NOT NULL COMMENT '算法名称',
+  algo_version INT NOT NULL DEFAULT 1 COMMENT '算法实现版本，与程序内版本不一致时结果作废',
+  raw_version INT UNSIGNED NOT NULL COMMENT '原始数据版本：原始 x/y 列的 CRC32，原始数据变化时结果作废',
+  param_json JSON NULL COMMENT '算法运行参数（仅供查看）',
+  curve_name VARCHAR(255) NULL COMMENT '结果曲线名称',
+  format_version SMALLINT NOT NULL DEFAULT 1 COMMENT '存储格式版本（同 curve_blob）',
+  encoding TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '编码标志：1=XOR差分 2=zlib',
+  point_count INT NOT NULL COMMENT '点数',
+  x_data LONGBLOB NOT NULL COMMENT 'x 数组',
+  y_data LONGBLOB NOT NULL COMMENT 'y 数组',
+  metrics_data LONGBLOB NULL COMMENT '附加指标（QDataStream 序列化的 QVariantMap）',
+  checksum INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'CRC32(x_data || y_data)',
+  created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+  PRIMARY KEY (sample_id, data_type, stage_key, param_hash),
+  FOREIGN KEY (sample_id) REFERENCES single_tobacco_sample(id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
@@ -4,6 +4,7 @@
 #include "AppInitializer.h"
 #include "utils/ConfigLoader.h"
 #include "data_access/DatabaseConnector.h"
+#include "data_access/SampleDAO.h"
 
 // --- 引入所有需要完整定义的 Service/Factory/Algorithm ---
 #include "services/SingleTobaccoSampleService.h"
@@ -27,6 +28,7 @@
 #include <QDir>
 #include <QFile>
 #include <QTextStream>
+#include <QtConcurrent>
 
 
 
@@ -67,6 +69,7 @@ AppInitializer::AppInitializer(QObject *parent)
 
 AppInitializer::~AppInitializer()
 {
+    m_curveBlobBackfill.waitForFinished();
 
     delete m_singleTobaccoSampleDAO;
     delete m_tgBigDataDao;           // <-- 删除
@@ -280,9 +283,30 @@ bool AppInitializer::initializeDatabase()
         showCriticalError("数据库表初始化失败", "无法创建或检查数据库表结构。\n请检查SQL脚本文件内容及数据库用户权限。");
         return false;
     }
+    startCurveBlobBackfill();
     return true;
 }
 
+void AppInitializer::startCurveBlobBackfill()
+{
+    // 迁移只建表并以文本编码回填；此处补齐缺失的打包行并升级为二进制。
+    // 已是最新时每种类型只有一次目录比对查询；已有行不覆盖，可与导入并发
+    m_curveBlobBackfill = QtConcurrent::run([]() {
+        ScopedThreadConnection connection;
+        if (!connection.database().isOpen()) return;
+        SampleDAO dao(connection.database());
+        for (DataType dataType : {DataType::TG_BIG, DataType::TG_SMALL, DataType::TG_SMALL_RAW,
+                                  DataType::CHROMATOGRAM, DataType::PROCESS_TG_BIG}) {
+            QString error;
+            dao.backfillCurveBlobs(dataType, error);
+            if (!error.isEmpty()) {
+                DEBUG_LOG << "curve_blob 回填跳过:" << dataType << error;
+                return; // 表不存在时各类型结果相同
+            }
+        }
+    });
+}
+
 bool AppInitializer::initializeLogging()
 {
     QVariantMap loggingConfig = m_fullConfig.value("logging").toMap();
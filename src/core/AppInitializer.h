@@ -7,6 +7,7 @@
 
 #include <QObject>
 #include <QVariantMap>
+#include <QFuture>
 
 #include "services/DataProcessingService.h"
 #include "services/analysis/SampleComparisonService.h"
@@ -89,9 +90,12 @@ private:
 
     IAlgorithmService* m_algorithmService = nullptr;
     FileHandlerFactory* m_fileHandlerFactory = nullptr; // <-- 实例，存储工厂实例
+    QFuture<void> m_curveBlobBackfill; // 析构时等待其结束，避免退出时仍持有数据库连接
 
     bool loadConfiguration();
     bool initializeDatabase();
+    // 建表完成后在后台执行一次 curve_blob 回填与文本编码升级（见 SampleDAO::backfillCurveBlobs）
+    void startCurveBlobBackfill();
     bool initializeLogging();
     bool initializeServices(); // 负责创建并注入所有 Service, Factory
     bool initializeAlgorithmService(); // 这行，声明方法
@@ -1,6 +1,145 @@
 #include "CurveMathUtils.h"
 #include <algorithm>
 #include <cmath>
+#include <limits>
+#include <numeric>
+
+namespace {
+
+// 按 X 升序的源曲线（输入已有序时与其隐式共享，不复制）
+struct SortedSeries {
+    QVector<double> x;
+    QVector<double> y;
+};
+
+static SortedSeries sortedSeries(const QVector<double>& x, const QVector<double>& y)
+{
+    SortedSeries s;
+    const int n = qMin(x.size(), y.size());
+    if (x.size() == n && y.size() == n && std::is_sorted(x.constBegin(), x.constEnd())) {
+        s.x = x;
+        s.y = y;
+        return s;
+    }
+
+    QVector<int> order(n);
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [&x](int a, int b) { return x[a] < x[b]; });
+    s.x.resize(n);
+    s.y.resize(n);
+    for (int i = 0; i < n; ++i) {
+        s.x[i] = x[order[i]];
+        s.y[i] = y[order[i]];
+    }
+    return s;
+}
+
+// 过 (x0, y0)-(x1, y1) 的直线在 t 处的值；两点 X 重合时返回 degenerate（与 interpolateYAtX 相同的运算顺序）
+static inline double lineAt(double x0, double y0, double x1, double y1, double t, double degenerate)
+{
+    const double dx = x1 - x0;
+    if (std::abs(dx) < 1e-15)
+        return degenerate;
+    const double u = (t - x0) / dx;
+    return y0 + u * (y1 - y0);
+}
+
+static inline int signOf(double v)
+{
+    return (v > 0.0) - (v < 0.0);
+}
+
+// PCHIP 端点斜率（MATLAB pchip 的三点公式，并保证保形）
+static double pchipEndSlope(double h0, double h1, double del0, double del1)
+{
+    if (h0 + h1 <= 0.0)
+        return 0.0;
+    double d = ((2.0 * h0 + h1) * del0 - h0 * del1) / (h0 + h1);
+    if (signOf(d) != signOf(del0))
+        d = 0.0;
+    else if (signOf(del0) != signOf(del1) && std::abs(d) > std::abs(3.0 * del0))
+        d = 3.0 * del0;
+    return d;
+}
+
+// PCHIP 各节点导数（Fritsch-Carlson：相邻割线异号或为零取 0，否则取加权调和平均）
+static QVector<double> pchipSlopes(const double* x, const double* y, int n)
+{
+    QVector<double> h(n - 1), del(n - 1), d(n);
+    for (int k = 0; k < n - 1; ++k) {
+        h[k] = x[k + 1] - x[k];
+        del[k] = (h[k] > 1e-15) ? (y[k + 1] - y[k]) / h[k] : 0.0;
+    }
+    if (n == 2) {
+        d[0] = d[1] = del[0];
+        return d;
+    }
+    for (int k = 1; k < n - 1; ++k) {
+        if (del[k - 1] * del[k] <= 0.0) {
+            d[k] = 0.0;
+        } else {
+            const double w1 = 2.0 * h[k] + h[k - 1];
+            const double w2 = h[k] + 2.0 * h[k - 1];
+            d[k] = (w1 + w2) / (w1 / del[k - 1] + w2 / del[k]);
+        }
+    }
+    d[0] = pchipEndSlope(h[0], h[1], del[0], del[1]);
+    d[n - 1] = pchipEndSlope(h[n - 2], h[n - 3], del[n - 2], del[n - 3]);
+    return d;
+}
+
+// 区间定位：返回 lo ∈ [0, n-2]，满足 x[lo] <= t < x[lo+1]（调用方保证 x[0] < t < x[n-1]）
+// 等间距源按下标直接定位；否则从上次位置向前归并扫描，目标回退时在已扫过的部分二分
+class SegmentLocator
+{
+public:
+    explicit SegmentLocator(const QVector<double>& x)
+        : m_x(x.constData()), m_n(x.size())
+    {
+        UniformGrid grid;
+        m_uniform = CurveMathUtils::detectUniformGrid(x, &grid) && grid.dx > 0.0;
+        if (m_uniform) {
+            m_x0 = grid.x0;
+            m_invDx = 1.0 / grid.dx;
+        }
+    }
+
+    int find(double t)
+    {
+        int lo = m_hint;
+        if (m_uniform) {
+            lo = qBound(0, static_cast<int>((t - m_x0) * m_invDx), m_n - 2);
+            while (lo > 0 && m_x[lo] > t)
+                --lo;
+        } else if (m_x[lo] > t) {
+            lo = static_cast<int>(std::upper_bound(m_x, m_x + lo, t) - m_x) - 1;
+        }
+        while (lo < m_n - 2 && m_x[lo + 1] <= t)
+            ++lo;
+        m_hint = lo;
+        return lo;
+    }
+
+private:
+    const double* m_x;
+    int m_n;
+    bool m_uniform = false;
+    double m_x0 = 0.0;
+    double m_invDx = 0.0;
+    int m_hint = 0;
+};
+
+static void splitPoints(const QVector<QPointF>& points, QVector<double>& x, QVector<double>& y)
+{
+    x.resize(points.size());
+    y.resize(points.size());
+    for (int i = 0; i < points.size(); ++i) {
+        x[i] = points[i].x();
+        y[i] = points[i].y();
+    }
+}
+
+} // namespace
 
 namespace CurveMathUtils {
 
@@ -54,21 +193,157 @@ QVector<QPointF> sumCurvesYByUnionX(const QVector<QPointF>& curveA, const QVecto
     if (curveA.isEmpty() || curveB.isEmpty())
         return out;
 
-    QVector<double> xs;
-    xs.reserve(curveA.size() + curveB.size());
-    for (const QPointF& p : curveA)
-        xs.append(p.x());
-    for (const QPointF& p : curveB)
-        xs.append(p.x());
-    std::sort(xs.begin(), xs.end());
-    xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
-
-    out.reserve(xs.size());
-    for (double x : xs) {
-        const double y = interpolateYAtX(curveA, x) + interpolateYAtX(curveB, x);
-        out.append(QPointF(x, y));
+    // 并集网格上各曲线一次归并扫描（原实现对每个并集点做两次二分查找）
+    AlignOptions options;
+    options.grid = GridPolicy::Union;
+    const AlignedCurves aligned = alignToCommonGrid(QVector<QVector<QPointF>>{curveA, curveB}, options);
+
+    out.reserve(aligned.x.size());
+    for (int i = 0; i < aligned.x.size(); ++i)
+        out.append(QPointF(aligned.x[i], aligned.y[0][i] + aligned.y[1][i]));
+    return out;
+}
+
+bool detectUniformGrid(const QVector<double>& x, UniformGrid* grid, double relTol)
+{
+    return UniformGrid::detect(x, grid, relTol);
+}
+
+QVector<double> resample(const QVector<double>& x, const QVector<double>& y, const QVector<double>& targetX,
+                         Interpolation method, Extrapolation extrapolation)
+{
+    QVector<double> out(targetX.size(), 0.0);
+    const SortedSeries s = sortedSeries(x, y);
+    const int n = s.x.size();
+    if (n == 0 || targetX.isEmpty())
+        return out;
+    if (n == 1) {
+        out.fill(s.y[0]);
+        return out;
+    }
+
+    const double* sx = s.x.constData();
+    const double* sy = s.y.constData();
+    const QVector<double> slopes = (method == Interpolation::Pchip) ? pchipSlopes(sx, sy, n) : QVector<double>();
+    const bool clamp = (extrapolation == Extrapolation::Clamp);
+    SegmentLocator locator(s.x);
+
+    double* o = out.data();
+    for (int i = 0; i < targetX.size(); ++i) {
+        const double t = targetX[i];
+        if (std::isnan(t)) {
+            o[i] = t;
+            continue;
+        }
+        if (t <= sx[0]) {
+            o[i] = clamp ? sy[0] : lineAt(sx[0], sy[0], sx[1], sy[1], t, sy[0]);
+            continue;
+        }
+        if (t >= sx[n - 1]) {
+            o[i] = clamp ? sy[n - 1] : lineAt(sx[n - 2], sy[n - 2], sx[n - 1], sy[n - 1], t, sy[n - 1]);
+            continue;
+        }
+
+        const int k = locator.find(t);
+        const double x0 = sx[k], x1 = sx[k + 1];
+        const double y0 = sy[k], y1 = sy[k + 1];
+        if (method == Interpolation::Linear) {
+            o[i] = lineAt(x0, y0, x1, y1, t, 0.5 * (y0 + y1));
+            continue;
+        }
+
+        const double h = x1 - x0;
+        if (std::abs(h) < 1e-15) {
+            o[i] = 0.5 * (y0 + y1);
+            continue;
+        }
+        const double u = (t - x0) / h;
+        const double u2 = u * u, u3 = u2 * u;
+        const double h00 = 2 * u3 - 3 * u2 + 1;
+        const double h10 = u3 - 2 * u2 + u;
+        const double h01 = -2 * u3 + 3 * u2;
+        const double h11 = u3 - u2;
+        o[i] = h00 * y0 + h10 * (h * slopes[k]) + h01 * y1 + h11 * (h * slopes[k + 1]);
     }
     return out;
 }
 
+QVector<double> resample(const QVector<QPointF>& points, const QVector<double>& targetX,
+                         Interpolation method, Extrapolation extrapolation)
+{
+    QVector<double> x, y;
+    splitPoints(points, x, y);
+    return resample(x, y, targetX, method, extrapolation);
+}
+
+AlignedCurves alignToCommonGrid(const QVector<QVector<double>>& xs, const QVector<QVector<double>>& ys,
+                                const AlignOptions& options)
+{
+    AlignedCurves result;
+    const int count = xs.size();
+    if (count == 0 || ys.size() != count)
+        return result;
+
+    QVector<SortedSeries> series;
+    series.reserve(count);
+    for (int i = 0; i < count; ++i) {
+        series.append(sortedSeries(xs[i], ys[i]));
+        if (series.last().x.isEmpty())
+            return result;
+    }
+
+    QVector<double> grid;
+    if (options.grid == GridPolicy::Union) {
+        // 各曲线 X 已升序：逐条线性归并
+        grid = series[0].x;
+        QVector<double> merged;
+        for (int i = 1; i < count; ++i) {
+            const QVector<double>& other = series[i].x;
+            merged.resize(grid.size() + other.size());
+            const auto end = std::set_union(grid.constBegin(), grid.constEnd(),
+                                            other.constBegin(), other.constEnd(), merged.begin());
+            merged.resize(static_cast<int>(end - merged.begin()));
+            grid.swap(merged);
+        }
+        grid.erase(std::unique(grid.begin(), grid.end()), grid.end());
+    } else {
+        if (options.referenceIndex < 0 || options.referenceIndex >= count)
+            return result;
+        const QVector<double>& refX = series[options.referenceIndex].x;
+        if (options.grid == GridPolicy::Reference) {
+            grid = refX;
+        } else {
+            double lo = -std::numeric_limits<double>::infinity();
+            double hi = std::numeric_limits<double>::infinity();
+            for (const SortedSeries& s : series) {
+                lo = qMax(lo, s.x.first());
+                hi = qMin(hi, s.x.last());
+            }
+            const auto first = std::lower_bound(refX.constBegin(), refX.constEnd(), lo);
+            const auto last = std::upper_bound(refX.constBegin(), refX.constEnd(), hi);
+            if (first < last) {
+                grid.reserve(static_cast<int>(last - first));
+                for (auto it = first; it != last; ++it)
+                    grid.append(*it);
+            }
+        }
+    }
+    if (grid.isEmpty())
+        return result;
+
+    result.y.reserve(count);
+    for (const SortedSeries& s : series)
+        result.y.append(resample(s.x, s.y, grid, options.interpolation, options.extrapolation));
+    result.x = grid;
+    return result;
+}
+
+AlignedCurves alignToCommonGrid(const QVector<QVector<QPointF>>& curves, const AlignOptions& options)
+{
+    QVector<QVector<double>> xs(curves.size()), ys(curves.size());
+    for (int i = 0; i < curves.size(); ++i)
+        splitPoints(curves[i], xs[i], ys[i]);
+    return alignToCommonGrid(xs, ys, options);
+}
+
 } // namespace CurveMathUtils
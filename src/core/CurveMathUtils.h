@@ -4,6 +4,8 @@
 #include <QPointF>
 #include <QVector>
 
+#include "entities/UniformGrid.h"
+
 namespace CurveMathUtils {
 
 // 在按 X 升序排列的折线上对 x 做线性插值/外推（端点外推用首段/末段斜率）
@@ -12,6 +14,61 @@ double interpolateYAtX(const QVector<QPointF>& sortedByX, double x);
 // 将两条曲线在所有 X 并集上对齐，对 Y 相加（X 来自两条曲线全部采样点的并集，排序去重）
 QVector<QPointF> sumCurvesYByUnionX(const QVector<QPointF>& curveA, const QVector<QPointF>& curveB);
 
+// ==== 重采样引擎 ====
+// 源曲线按 X 升序后，目标网格单调时对每条曲线只做一次归并扫描（O(源点数 + 目标点数)）；
+// 源 X 为等间距时按下标直接定位区间（O(1)，目标网格无序也适用）。
+
+enum class Interpolation {
+    Linear, // 分段线性（与 interpolateYAtX 逐位一致）
+    Pchip   // 分段三次 Hermite 保形插值（Fritsch-Carlson 斜率，同 MATLAB pchip）
+};
+
+enum class Extrapolation {
+    EndSlope, // 按首段/末段直线外推（与 interpolateYAtX 一致）
+    Clamp     // 取端点值（绘图对齐用）
+};
+
+// 等间距网格 x[i] = x0 + i·dx（与曲线的等间距 X 描述为同一类型）
+using ::UniformGrid;
+
+// 判断 x 是否为严格递增的等间距网格，见 UniformGrid::detect()。grid 非空时写出描述
+bool detectUniformGrid(const QVector<double>& x, UniformGrid* grid = nullptr, double relTol = 1e-6);
+
+// 将 (x, y) 重采样到 targetX（x 无需有序，非升序时先排序；长度不一致按较短者）
+QVector<double> resample(const QVector<double>& x, const QVector<double>& y, const QVector<double>& targetX,
+                         Interpolation method = Interpolation::Linear,
+                         Extrapolation extrapolation = Extrapolation::EndSlope);
+QVector<double> resample(const QVector<QPointF>& points, const QVector<double>& targetX,
+                         Interpolation method = Interpolation::Linear,
+                         Extrapolation extrapolation = Extrapolation::EndSlope);
+
+// 公共网格的取法
+enum class GridPolicy {
+    Union,     // 全部曲线 X 的并集（排序去重）
+    Overlap,   // 参考曲线落在各曲线公共 X 区间内的采样点（不外推；X 相同的曲线等价于截断到最短长度）
+    Reference  // 参考曲线的全部采样点
+};
+
+struct AlignOptions {
+    GridPolicy grid = GridPolicy::Overlap;
+    int referenceIndex = 0; // Overlap / Reference 使用的参考曲线
+    Interpolation interpolation = Interpolation::Linear;
+    Extrapolation extrapolation = Extrapolation::EndSlope;
+};
+
+struct AlignedCurves {
+    QVector<double> x;          // 公共网格（升序）
+    QVector<QVector<double>> y; // y[i] 为第 i 条曲线在公共网格上的值
+
+    bool isEmpty() const { return x.isEmpty(); }
+};
+
+// 将 N 条曲线对齐到公共网格；任一曲线为空、参考下标越界或公共区间为空时返回空结果
+AlignedCurves alignToCommonGrid(const QVector<QVector<double>>& xs, const QVector<QVector<double>>& ys,
+                                const AlignOptions& options = AlignOptions());
+AlignedCurves alignToCommonGrid(const QVector<QVector<QPointF>>& curves,
+                                const AlignOptions& options = AlignOptions());
+
 } // namespace CurveMathUtils
 
 #endif
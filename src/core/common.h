@@ -454,7 +454,7 @@ struct StageData {
     StageName stageName;  // 阶段名称，例如 "平滑"
     AlgorithmType algorithm;  // 算法类型，例如 "Savitzky-Golay"
     // QString name;                        // 阶段名称，例如 "平滑"
-    QSharedPointer<Curve> curve;         // 整体曲线（未分段）
+    StageCurve curve;                    // 整体曲线（未分段）；流水线写入值类型，界面访问时才生成 Curve
     // QString algorithm;                    // 算法类型，例如 "Savitzky-Golay"
     QVariantMap parameters;               // 算法参数，例如 {"window":5, "order":3}
 
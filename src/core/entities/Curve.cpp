@@ -23,7 +23,22 @@ Curve::Curve(const QVector<double> &xData, const QVector<double> &yData, const Q
 }
 
 Curve::Curve(const QVector<QPointF> &data, const QString &name, QObject *parent)
-    : QObject(parent), m_data(data), m_name(name)
+    : QObject(parent), m_name(name)
+{
+    setData(data);
+    m_pen.setColor(Qt::blue);
+    m_pen.setWidth(1);
+    m_pen.setStyle(Qt::SolidLine);
+}
+
+Curve::Curve(const CurveValue &data, QObject *parent)
+    : QObject(parent),
+      m_x(data.xValues()),
+      m_y(data.yValues()),
+      m_sampleId(data.meta().sampleId),
+      m_dataType(data.meta().dataType),
+      m_sourceFileName(data.meta().sourceFileName),
+      m_name(data.meta().name)
 {
     m_pen.setColor(Qt::blue);
     m_pen.setWidth(1);
@@ -34,7 +49,8 @@ Curve::Curve(const QVector<QPointF> &data, const QString &name, QObject *parent)
 Curve::Curve(const Curve &other)
     : QObject(other.parent()) // 父对象通常不拷贝
 {
-    m_data = other.m_data;
+    m_x = other.m_x; // 隐式共享，不复制数据
+    m_y = other.m_y;
     m_sampleId = other.m_sampleId;
     m_dataType = other.m_dataType;
     m_sourceFileName = other.m_sourceFileName;
@@ -49,7 +65,9 @@ Curve& Curve::operator=(const Curve &other)
         return *this; // 处理自我赋值
     }
     // 父对象不赋值
-    m_data = other.m_data;
+    m_x = other.m_x;
+    m_y = other.m_y;
+    invalidateDerivedData();
     m_sampleId = other.m_sampleId;
     m_dataType = other.m_dataType;
     m_sourceFileName = other.m_sourceFileName;
@@ -71,15 +89,53 @@ Curve& Curve::operator=(const Curve &other)
 
 // --- 核心数据接口 ---
 
-// ！！！【新增】实现 getDataContainer
+const QVector<double>& Curve::xValues() const { return m_x; }
+const QVector<double>& Curve::yValues() const { return m_y; }
+const double* Curve::xData() const { return m_x.constData(); }
+const double* Curve::yData() const { return m_y.constData(); }
+double Curve::xAt(int i) const { return m_x.at(i); }
+double Curve::yAt(int i) const { return m_y.at(i); }
+bool Curve::isEmpty() const { return m_x.isEmpty(); }
+UniformGrid Curve::uniformX() const { return UniformGrid::fromX(m_x); }
+bool Curve::hasUniformX() const { return uniformX().isValid(); }
+
+void Curve::invalidateDerivedData()
+{
+    QMutexLocker locker(&m_derivedMutex);
+    m_points = QVector<QPointF>();
+    m_pointsValid = false;
+    m_dataContainer.reset(); // 已交给 QCPGraph 的旧容器由其继续持有
+}
+
 QSharedPointer<QCPGraphDataContainer> Curve::getDataContainer() const
 {
+    QMutexLocker locker(&m_derivedMutex);
+    if (m_dataContainer.isNull()) {
+        const int n = m_x.size();
+        QVector<QCPGraphData> points(n);
+        bool sorted = true;
+        for (int i = 0; i < n; ++i) {
+            points[i].key = m_x[i];
+            points[i].value = m_y[i];
+            if (i > 0 && m_x[i] < m_x[i - 1]) sorted = false;
+        }
+        auto container = QSharedPointer<QCPGraphDataContainer>::create();
+        container->set(points, sorted); // X 已升序时跳过排序
+        m_dataContainer = container;
+    }
     return m_dataContainer;
 }
 
 const QVector<QPointF>& Curve::data() const
 {
-    return m_data;
+    QMutexLocker locker(&m_derivedMutex);
+    if (!m_pointsValid) {
+        const int n = m_x.size();
+        m_points.resize(n);
+        for (int i = 0; i < n; ++i) m_points[i] = QPointF(m_x[i], m_y[i]);
+        m_pointsValid = true;
+    }
+    return m_points;
 }
 // // (可选) 如果你还想保留旧的 data() 方法
 // const QVector<QPointF>& Curve::data() const
@@ -97,10 +153,28 @@ const QVector<QPointF>& Curve::data() const
 
 void Curve::setData(const QVector<QPointF> &data)
 {
-    if (m_data != data) {
-        m_data = data;
-        emit dataChanged();
+    const int n = data.size();
+    if (n == m_x.size()) {
+        bool same = true;
+        for (int i = 0; i < n && same; ++i)
+            same = data[i].x() == m_x[i] && data[i].y() == m_y[i];
+        if (same) return;
+    }
+
+    QVector<double> x(n), y(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = data[i].x();
+        y[i] = data[i].y();
     }
+    m_x = x;
+    m_y = y;
+    invalidateDerivedData();
+    {
+        QMutexLocker locker(&m_derivedMutex);
+        m_points = data; // 调用方已持有点序列，直接共享作为兼容缓存
+        m_pointsValid = true;
+    }
+    emit dataChanged();
 }
 
 // // ！！！【修改】更新 setData 方法
@@ -121,13 +195,15 @@ void Curve::setData(const QVector<QPointF> &data)
 
 void Curve::setData(const QVector<double> &xData, const QVector<double> &yData)
 {
-    QVector<QPointF> newData;
-    int size = std::min(xData.size(), yData.size());
-    newData.reserve(size);
-    for (int i = 0; i < size; ++i) {
-        newData.append(QPointF(xData.at(i), yData.at(i)));
-    }
-    setData(newData); // 复用 setData(QVector<QPointF>)
+    const int size = std::min(xData.size(), yData.size());
+    const QVector<double> x = (xData.size() == size) ? xData : xData.mid(0, size);
+    const QVector<double> y = (yData.size() == size) ? yData : yData.mid(0, size);
+    if (x == m_x && y == m_y) return;
+
+    m_x = x;
+    m_y = y;
+    invalidateDerivedData();
+    emit dataChanged();
 }
 
 
@@ -148,7 +224,16 @@ void Curve::setData(const QVector<double> &xData, const QVector<double> &yData)
 
 int Curve::pointCount() const
 {
-    return m_data.size();
+    return m_x.size();
+}
+
+CurveValue Curve::toCurveValue() const
+{
+    CurveValue out(m_x, m_y, m_name);
+    out.meta().sampleId = m_sampleId;
+    out.meta().dataType = m_dataType;
+    out.meta().sourceFileName = m_sourceFileName;
+    return out;
 }
 
 // // ！！！【修改】更新 pointCount
@@ -235,21 +320,20 @@ QString Curve::printCurveData(int limit) const
     str += QString("SampleId: %1 | Type: %2 | Points: %3\n\n")
             .arg(m_sampleId)
             .arg(m_dataType)
-            .arg(m_data.size());
+            .arg(m_x.size());
 
-    int count = (limit < 0) ? m_data.size() : qMin(limit, m_data.size());
+    int count = (limit < 0) ? m_x.size() : qMin(limit, m_x.size());
 
     for (int i = 0; i < count; ++i) {
-        const auto& p = m_data[i];
         str += QString("[%1]  X=%2,  Y=%3\n")
                 .arg(i)
-                .arg(p.x())
-                .arg(p.y());
+                .arg(m_x[i])
+                .arg(m_y[i]);
     }
 
-    if (limit > 0 && m_data.size() > limit) {
+    if (limit > 0 && m_x.size() > limit) {
         str += QString("... (%1 more points omitted)\n")
-                .arg(m_data.size() - limit);
+                .arg(m_x.size() - limit);
     }
 
     return str;
@@ -7,8 +7,10 @@
 #include <QPointF>
 #include <QColor>
 #include <QPen>
+#include <QMutex>
 
 #include "qcustomplot.h" 
+#include "CurveValue.h"
 
 class Curve : public QObject
 {
@@ -38,18 +40,38 @@ public:
           const QString& name = "",
           QObject* parent = nullptr);
 
+    // 由流水线值类型生成界面曲线（共享 X/Y 列并带入元数据）
+    explicit Curve(const CurveValue& data, QObject* parent = nullptr);
+
     // 拷贝构造函数，用于安全复制
     Curve(const Curve& other);
     Curve& operator=(const Curve& other);
 
 
     // --- 核心数据接口 ---
+    // X/Y 按列连续存储（隐式共享），算法与绘图应优先使用列访问，避免逐点拆分拷贝
+    const QVector<double>& xValues() const;
+    const QVector<double>& yValues() const;
+    const double* xData() const;   // 连续 X 缓冲区，长度为 pointCount()
+    const double* yData() const;   // 连续 Y 缓冲区，长度为 pointCount()
+    double xAt(int i) const;
+    double yAt(int i) const;
+    bool isEmpty() const;
+    // 等间距 X 描述（每次调用时检测 X，不缓存；X 不等间距时无效），见 CurveValue::uniformX()
+    UniformGrid uniformX() const;
+    bool hasUniformX() const;
+
+    // 兼容旧接口：首次调用时由 X/Y 列组装并缓存，数据变化后失效；新代码请勿依赖
     const QVector<QPointF>& data() const;
     void setData(const QVector<QPointF>& data);
+    // 长度一致时直接共享传入的缓冲区（不复制）
     void setData(const QVector<double>& xData, const QVector<double>& yData);
     int pointCount() const;
+    // 转为值类型（共享 X/Y 列，不复制）
+    CurveValue toCurveValue() const;
 
 
+    // QCustomPlot 数据容器：首次调用时构建并缓存，可直接交给 QCPGraph::setData 共享（只读使用）
     QSharedPointer<QCPGraphDataContainer> getDataContainer() const;
 
 
@@ -90,8 +112,11 @@ signals:
     void dataChanged(); // 当数据点本身发生变化时
 
 private:
+    void invalidateDerivedData();
+
     // --- 核心数据 ---
-    QVector<QPointF> m_data;  // 存储曲线的 (X, Y) 数据点
+    QVector<double> m_x;      // X 列（与 m_y 等长）
+    QVector<double> m_y;      // Y 列
 
 
     int m_sampleId = -1;             // 关联的原始样本ID (single_tobacco_sample.id)
@@ -102,8 +127,11 @@ private:
     QString m_name;                  // 曲线名称 (用于图例)
     QPen m_pen;                      // 使用 QPen 统一管理颜色、线宽、线型
 
-    // 用 QCustomPlot 的数据容器替换 QVector<QPointF>
-    QSharedPointer<QCPGraphDataContainer> m_dataContainer;
+    // 由 X/Y 列派生的惰性缓存（const 访问时构建，受 m_derivedMutex 保护）
+    mutable QMutex m_derivedMutex;
+    mutable QVector<QPointF> m_points;
+    mutable bool m_pointsValid = false;
+    mutable QSharedPointer<QCPGraphDataContainer> m_dataContainer;
 };
 
 #endif // CURVE_H
\ No newline at end of file
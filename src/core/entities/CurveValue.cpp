@@ -0,0 +1,104 @@
+#include "CurveValue.h"
+#include "Curve.h"
+
+#include <QMutex>
+#include <QMutexLocker>
+#include <algorithm>
+
+// --- CurveValue ---
+
+CurveValue::CurveValue(const QVector<double>& xData, const QVector<double>& yData, const QString& name)
+{
+    setData(xData, yData);
+    m_meta.name = name;
+}
+
+CurveValue::CurveValue(const UniformGrid& grid, const QVector<double>& yData, const QString& name)
+{
+    UniformGrid g = grid;
+    g.n = std::min(grid.n, yData.size());
+    m_x = g.values();
+    m_y = (yData.size() == g.n) ? yData : yData.mid(0, g.n);
+    if (g.n > 0) m_grid = g;
+    m_meta.name = name;
+}
+
+CurveValue::CurveValue(const QVector<QPointF>& points, const QString& name)
+{
+    const int n = points.size();
+    m_x.resize(n);
+    m_y.resize(n);
+    for (int i = 0; i < n; ++i) {
+        m_x[i] = points[i].x();
+        m_y[i] = points[i].y();
+    }
+    m_meta.name = name;
+}
+
+void CurveValue::setData(const QVector<double>& xData, const QVector<double>& yData)
+{
+    const int size = std::min(xData.size(), yData.size());
+    m_x = (xData.size() == size) ? xData : xData.mid(0, size);
+    m_y = (yData.size() == size) ? yData : yData.mid(0, size);
+    m_grid = UniformGrid();
+}
+
+UniformGrid CurveValue::uniformX() const
+{
+    return m_grid.isValid() ? m_grid : UniformGrid::fromX(m_x);
+}
+
+QVector<QPointF> CurveValue::points() const
+{
+    const int n = m_x.size();
+    QVector<QPointF> pts(n);
+    for (int i = 0; i < n; ++i) pts[i] = QPointF(m_x[i], m_y[i]);
+    return pts;
+}
+
+// --- StageCurve ---
+
+struct StageCurve::State
+{
+    QMutex mutex;
+    CurveValue value;
+    QSharedPointer<Curve> curve; // 首次界面访问时生成
+};
+
+StageCurve::StageCurve(const CurveValue& data)
+    : d(QSharedPointer<State>::create())
+{
+    d->value = data;
+}
+
+StageCurve::StageCurve(const QSharedPointer<Curve>& curve)
+{
+    if (curve.isNull()) return;
+    d = QSharedPointer<State>::create();
+    d->curve = curve;
+}
+
+CurveValue StageCurve::value() const
+{
+    if (d.isNull()) return CurveValue();
+    QMutexLocker locker(&d->mutex);
+    return d->curve.isNull() ? d->value : d->curve->toCurveValue();
+}
+
+bool StageCurve::isMaterialized() const
+{
+    if (d.isNull()) return false;
+    QMutexLocker locker(&d->mutex);
+    return !d->curve.isNull();
+}
+
+QSharedPointer<Curve> StageCurve::toCurve() const
+{
+    if (d.isNull()) return QSharedPointer<Curve>();
+    QMutexLocker locker(&d->mutex);
+    if (d->curve.isNull()) {
+        d->curve = QSharedPointer<Curve>::create(d->value);
+        d->value = CurveValue(); // 之后以 Curve 为准
+    }
+    return d->curve;
+}
@@ -0,0 +1,111 @@
+#ifndef CURVEVALUE_H
+#define CURVEVALUE_H
+
+#include <QMetaType>
+#include <QPointF>
+#include <QSharedPointer>
+#include <QString>
+#include <QVector>
+
+#include "UniformGrid.h"
+
+class Curve;
+
+/**
+ * @brief 曲线元数据（名称、样本、数据类型、来源文件）
+ */
+struct CurveMeta
+{
+    QString name;                 // 曲线名称（用于图例）
+    int sampleId = -1;            // 关联的原始样本ID
+    QString dataType;             // 数据类型, e.g., "大热重", "色谱-平滑后"
+    QString sourceFileName;       // 原始文件名
+};
+
+/**
+ * @brief 处理流水线使用的轻量曲线值类型
+ *
+ * X/Y 按列存放于隐式共享的 QVector<double> 中，拷贝只增加引用计数；
+ * 不是 QObject，没有画笔与信号，可在工作线程中随意创建与传递。
+ * 等间距 X 的网格描述 uniformX() 按需检测（设置数据时不扫描 X，X 列保持原样）；
+ * 由网格构造时直接记下描述并随值拷贝。
+ * 界面层需要 Curve 时通过 Curve(const CurveValue&) 或 StageCurve 按需生成。
+ */
+class CurveValue
+{
+public:
+    CurveValue() = default;
+    CurveValue(const QVector<double>& xData, const QVector<double>& yData, const QString& name = QString());
+    CurveValue(const QVector<QPointF>& points, const QString& name = QString());
+    // 等间距 X：X 列按网格生成，长度按较短者
+    CurveValue(const UniformGrid& grid, const QVector<double>& yData, const QString& name = QString());
+
+    const QVector<double>& xValues() const { return m_x; }
+    const QVector<double>& yValues() const { return m_y; }
+    const double* xData() const { return m_x.constData(); }
+    const double* yData() const { return m_y.constData(); }
+    double xAt(int i) const { return m_x.at(i); }
+    double yAt(int i) const { return m_y.at(i); }
+    int pointCount() const { return m_x.size(); }
+    bool isEmpty() const { return m_x.isEmpty(); }
+
+    // 等间距 X 描述；无效（n = 0）表示显式 X。
+    // 由网格构造时直接返回，否则每次调用都会检测一遍 X（O(n)，不缓存），调用方应自行保存结果
+    UniformGrid uniformX() const;
+    bool hasUniformX() const { return uniformX().isValid(); }
+
+    // 长度一致时直接共享传入的缓冲区（不复制）
+    void setData(const QVector<double>& xData, const QVector<double>& yData);
+    // 组装 QPointF 序列（兼容仍按点处理的旧代码）
+    QVector<QPointF> points() const;
+
+    const CurveMeta& meta() const { return m_meta; }
+    CurveMeta& meta() { return m_meta; }
+    QString name() const { return m_meta.name; }
+    void setName(const QString& name) { m_meta.name = name; }
+    int sampleId() const { return m_meta.sampleId; }
+    void setSampleId(int id) { m_meta.sampleId = id; }
+
+private:
+    QVector<double> m_x;
+    QVector<double> m_y;
+    UniformGrid m_grid; // 仅由网格构造时有效，setData 后清除
+    CurveMeta m_meta;
+};
+Q_DECLARE_METATYPE(CurveValue)
+
+/**
+ * @brief 阶段曲线句柄：流水线写入 CurveValue，界面首次访问时才生成 Curve
+ *
+ * 接口与 QSharedPointer<Curve> 兼容（->、data()、isNull()、布尔判断、隐式转换），
+ * 拷贝共享同一状态，因此各副本得到的是同一个 Curve 对象。
+ * Curve 生成后以其当前数据为准（value() 从 Curve 读取，界面修改可见）。
+ */
+class StageCurve
+{
+public:
+    StageCurve() = default;
+    StageCurve(const CurveValue& data);
+    StageCurve(const QSharedPointer<Curve>& curve);
+
+    bool isNull() const { return d.isNull(); }
+    explicit operator bool() const { return !d.isNull(); }
+
+    // 取值类型数据（不会生成 Curve）
+    CurveValue value() const;
+    // 是否已生成界面用的 Curve
+    bool isMaterialized() const;
+
+    // 生成（或返回已生成的）Curve
+    QSharedPointer<Curve> toCurve() const;
+    operator QSharedPointer<Curve>() const { return toCurve(); }
+    Curve* data() const { return toCurve().data(); }
+    Curve* operator->() const { return data(); }
+    Curve& operator*() const { return *data(); }
+
+private:
+    struct State;
+    QSharedPointer<State> d;
+};
+
+#endif // CURVEVALUE_H
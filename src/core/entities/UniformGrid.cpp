@@ -0,0 +1,37 @@
+#include "UniformGrid.h"
+
+#include <cmath>
+
+bool UniformGrid::detect(const QVector<double>& x, UniformGrid* grid, double relTol)
+{
+    const int n = x.size();
+    if (n == 0) return false;
+
+    UniformGrid g;
+    g.x0 = x[0];
+    g.n = n;
+    if (n > 1) {
+        g.dx = (x[n - 1] - x[0]) / (n - 1);
+        if (!(g.dx > 0.0) || !std::isfinite(g.dx)) return false;
+        const double tol = relTol * g.dx;
+        for (int i = 1; i < n; ++i) {
+            if (!(std::abs(x[i] - g.at(i)) <= tol)) return false;
+        }
+    }
+    if (grid) *grid = g;
+    return true;
+}
+
+UniformGrid UniformGrid::fromX(const QVector<double>& x, double relTol)
+{
+    UniformGrid grid;
+    if (x.size() < 2 || !detect(x, &grid, relTol)) return UniformGrid();
+    return grid;
+}
+
+QVector<double> UniformGrid::values() const
+{
+    QVector<double> x(qMax(n, 0));
+    for (int i = 0; i < x.size(); ++i) x[i] = at(i);
+    return x;
+}
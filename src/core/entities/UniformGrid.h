@@ -0,0 +1,45 @@
+#ifndef UNIFORMGRID_H
+#define UNIFORMGRID_H
+
+#include <QVector>
+
+/**
+ * @brief 等间距 X 网格描述：x[i] ≈ x0 + i·dx（0 <= i < n）
+ *
+ * 大热重/工序大热重以 serial_no（0,1,2,…）为 X，色谱按固定保留时间步长采样。
+ * CurveValue/Curve 只在有消费者询问时（uniformX()）检测，设置数据不做 O(n) 扫描，X 列本身保持原样；
+ * 由网格构造的 CurveValue（如 curve_blob 解码）直接记下描述，无需再检测：
+ * - 存储：curve_blob / algo_results 在 X 逐位等于 x0 + i·dx 时只写 x0 与 dx（点数已单独成列）；
+ * - 算法：已知网格时跳过等间距检测，按下标直接定位（LOESS 等）。
+ * 小热重温度等非等间距数据没有网格描述，照常使用显式 X。
+ */
+struct UniformGrid
+{
+    // 判定等间距的默认容差（相对 dx）：远小于 DOUBLE 列的输入精度，按下标计算与按 X 计算的差异可以忽略
+    static constexpr double DefaultTolerance = 1e-9;
+
+    double x0 = 0.0;
+    double dx = 0.0;
+    int n = 0;
+
+    bool isValid() const { return n > 0; }
+    double at(int i) const { return x0 + i * dx; }
+    double last() const { return at(n - 1); }
+
+    bool operator==(const UniformGrid& other) const { return x0 == other.x0 && dx == other.dx && n == other.n; }
+    bool operator!=(const UniformGrid& other) const { return !(*this == other); }
+
+    /**
+     * @brief 判断 x 是否为严格递增的等间距序列：各点与 x0 + i·dx 的偏差不超过 relTol·dx
+     * dx 取 (x[n-1] - x[0]) / (n-1)；relTol = 0 表示逐位相等。单点视为等间距（dx = 0）。
+     */
+    static bool detect(const QVector<double>& x, UniformGrid* grid = nullptr, double relTol = DefaultTolerance);
+
+    // x 至少两点且等间距时返回其网格，否则返回无效网格（不修改 x）
+    static UniformGrid fromX(const QVector<double>& x, double relTol = DefaultTolerance);
+
+    // 按网格生成 X 列 x0 + i·dx
+    QVector<double> values() const;
+};
+
+#endif // UNIFORMGRID_H
@@ -20,34 +20,89 @@ void DifferenceResultModel::populate(const QList<DifferenceResultRow> &results)
     // 固定展示列顺序：欧氏距离、皮尔逊相关系数、NRMSE
     m_algorithmIds = QStringList() << "euclidean" << "pearson" << "nrmse";
 
-    // 默认按“排名规则”排序：
-    // 非参考样本优先（参考样本始终在最后，排名列显示“基准样本”）
-    // 其余样本按 NRMSE 升序、Pearson 降序、Euclidean 升序
+    // 默认按“排名规则”排序
     std::sort(m_results.begin(), m_results.end(), [this](const DifferenceResultRow& a, const DifferenceResultRow& b) {
-        const bool aIsRef = (a.sampleId == m_referenceSampleId);
-        const bool bIsRef = (b.sampleId == m_referenceSampleId);
-        if (aIsRef != bIsRef) {
-            return !aIsRef;
-        }
+        return rankLess(a, b);
+    });
 
-        const double aNrmse = a.scores.value("nrmse", 0.0);
-        const double bNrmse = b.scores.value("nrmse", 0.0);
-        if (!qFuzzyCompare(aNrmse + 1.0, bNrmse + 1.0)) {
-            return aNrmse < bNrmse;
-        }
+    endResetModel();
+}
 
-        const double aPearson = a.scores.value("pearson", 0.0);
-        const double bPearson = b.scores.value("pearson", 0.0);
-        if (!qFuzzyCompare(aPearson + 1.0, bPearson + 1.0)) {
-            return aPearson > bPearson;
+void DifferenceResultModel::clear()
+{
+    beginResetModel();
+    m_results.clear();
+    m_algorithmIds = QStringList() << "euclidean" << "pearson" << "nrmse";
+    endResetModel();
+}
+
+void DifferenceResultModel::appendRows(const QList<DifferenceResultRow>& rows)
+{
+    if (rows.isEmpty()) return;
+    if (m_algorithmIds.isEmpty()) {
+        clear();
+    }
+
+    // 逐行按排名规则二分插入，已显示的行保持相对顺序
+    for (const DifferenceResultRow& row : rows) {
+        auto pos = std::upper_bound(m_results.begin(), m_results.end(), row,
+                                    [this](const DifferenceResultRow& a, const DifferenceResultRow& b) {
+                                        return rankLess(a, b);
+                                    });
+        const int rowIndex = int(pos - m_results.begin());
+        beginInsertRows(QModelIndex(), rowIndex, rowIndex);
+        m_results.insert(rowIndex, row);
+        endInsertRows();
+
+        // 插入点之后各行的排名数字随之变化
+        if (rowIndex + 1 < m_results.count()) {
+            const int rankColumn = m_algorithmIds.count() + 1;
+            emit dataChanged(index(rowIndex + 1, rankColumn), index(m_results.count() - 1, rankColumn));
         }
+    }
+}
 
-        const double aEuclidean = a.scores.value("euclidean", 0.0);
-        const double bEuclidean = b.scores.value("euclidean", 0.0);
-        return aEuclidean < bEuclidean;
-    });
+void DifferenceResultModel::setSampleIdentifiers(const QHash<int, SampleIdentifier>& identifiers)
+{
+    m_identifiers = identifiers;
+    if (!m_results.isEmpty()) {
+        emit dataChanged(index(0, 0), index(m_results.count() - 1, 0));
+    }
+}
 
-    endResetModel();
+QString DifferenceResultModel::displayName(int sampleId) const
+{
+    auto it = m_identifiers.constFind(sampleId);
+    if (it != m_identifiers.constEnd()) {
+        return SingleTobaccoSampleService::buildSampleDisplayName(it.value());
+    }
+    return SingleTobaccoSampleService::buildSampleDisplayName(sampleId);
+}
+
+bool DifferenceResultModel::rankLess(const DifferenceResultRow& a, const DifferenceResultRow& b) const
+{
+    // 非参考样本优先（参考样本始终在最后，排名列显示“基准样本”）
+    const bool aIsRef = (a.sampleId == m_referenceSampleId);
+    const bool bIsRef = (b.sampleId == m_referenceSampleId);
+    if (aIsRef != bIsRef) {
+        return !aIsRef;
+    }
+
+    const double aNrmse = a.scores.value("nrmse", 0.0);
+    const double bNrmse = b.scores.value("nrmse", 0.0);
+    if (!qFuzzyCompare(aNrmse + 1.0, bNrmse + 1.0)) {
+        return aNrmse < bNrmse;
+    }
+
+    const double aPearson = a.scores.value("pearson", 0.0);
+    const double bPearson = b.scores.value("pearson", 0.0);
+    if (!qFuzzyCompare(aPearson + 1.0, bPearson + 1.0)) {
+        return aPearson > bPearson;
+    }
+
+    const double aEuclidean = a.scores.value("euclidean", 0.0);
+    const double bEuclidean = b.scores.value("euclidean", 0.0);
+    return aEuclidean < bEuclidean;
 }
 
 void DifferenceResultModel::setReferenceSampleId(int sampleId)
@@ -111,7 +166,7 @@ QVariant DifferenceResultModel::data(const QModelIndex &index, int role) const
         const DifferenceResultRow& rowData = m_results.at(index.row());
 
         if (index.column() == 0) {
-            return SingleTobaccoSampleService::buildSampleDisplayName(rowData.sampleId);
+            return displayName(rowData.sampleId);
         }
 
         if (index.column() - 1 < m_algorithmIds.count()) {
@@ -147,8 +202,8 @@ void DifferenceResultModel::sort(int column, Qt::SortOrder order)
     // 根据点击的列进行排序
     if (column == 0) { // 按样本名称排序
         std::sort(m_results.begin(), m_results.end(), [&](const auto& a, const auto& b){
-            const QString aName = SingleTobaccoSampleService::buildSampleDisplayName(a.sampleId);
-            const QString bName = SingleTobaccoSampleService::buildSampleDisplayName(b.sampleId);
+            const QString aName = displayName(a.sampleId);
+            const QString bName = displayName(b.sampleId);
             return order == Qt::AscendingOrder ? aName < bName : aName > bName;
         });
     } else if (column - 1 < m_algorithmIds.count()) { // 按某个指标排序
@@ -2,6 +2,7 @@
 #define DIFFERENCERESULTMODEL_H
 
 #include <QAbstractTableModel>
+#include <QHash>
 #include "core/common.h" // 确保 common.h 中包含了 DifferenceResultRow 的定义
 #include "core/AppInitializer.h"
 
@@ -58,6 +59,22 @@ public:
      */
     void populate(const QList<DifferenceResultRow>& results);
 
+    /**
+     * @brief 清空结果（保留列定义），用于后台计算开始前。
+     */
+    void clear();
+
+    /**
+     * @brief 追加一批结果（后台计算逐块到达时调用），按排名规则插入到对应位置。
+     * @param rows 新到达的结果行。
+     */
+    void appendRows(const QList<DifferenceResultRow>& rows);
+
+    /**
+     * @brief 设置批量查询得到的样本标识，样本名称列与按名称排序不再逐行查询数据库。
+     */
+    void setSampleIdentifiers(const QHash<int, SampleIdentifier>& identifiers);
+
     /**
      * @brief 设置参考样本ID（用于排名列显示“基准样本”）。
      */
@@ -71,11 +88,16 @@ public:
     int getSampleIdForRow(int row) const;
 
 private:
+    // 默认排名规则：参考样本最后，其余按 NRMSE 升序、Pearson 降序、Euclidean 升序
+    bool rankLess(const DifferenceResultRow& a, const DifferenceResultRow& b) const;
+    QString displayName(int sampleId) const;
+
     QList<DifferenceResultRow> m_results; // 存储原始的、未排序的数据
     // 用于按列索引算法ID，以保证列的顺序在刷新和排序时是稳定的
     QStringList m_algorithmIds; 
     AppInitializer* m_appInit;  // 保存指针
     int m_referenceSampleId = -1;
+    QHash<int, SampleIdentifier> m_identifiers; // 样本ID -> 标识（批量查询缓存）
 };
 
 #endif // DIFFERENCERESULTMODEL_H
\ No newline at end of file
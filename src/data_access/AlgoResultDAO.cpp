@@ -0,0 +1,217 @@
+#include "AlgoResultDAO.h"
+#include "AlgoResultRetention.h"
+#include "CurveBlobDAO.h"
+#include "DatabaseConnector.h"
+#include "Logger.h"
+#include <QDataStream>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QStringList>
+
+namespace {
+
+static QByteArray encodeMetrics(const QVariantMap& metrics)
+{
+    if (metrics.isEmpty()) return QByteArray();
+    QByteArray data;
+    QDataStream stream(&data, QIODevice::WriteOnly);
+    stream.setVersion(QDataStream::Qt_5_9);
+    stream << metrics;
+    return data;
+}
+
+static QVariantMap decodeMetrics(const QByteArray& data)
+{
+    QVariantMap metrics;
+    if (data.isEmpty()) return metrics;
+    QDataStream stream(data);
+    stream.setVersion(QDataStream::Qt_5_9);
+    stream >> metrics;
+    return metrics;
+}
+
+} // namespace
+
+quint32 AlgoResultDAO::rawVersion(const CurveValue& rawCurve)
+{
+    const QVector<double>& x = rawCurve.xValues();
+    const QVector<double>& y = rawCurve.yValues();
+    // 直接对列缓冲区求 CRC，不复制
+    const QByteArray xBytes = QByteArray::fromRawData(reinterpret_cast<const char*>(x.constData()), x.size() * int(sizeof(double)));
+    const QByteArray yBytes = QByteArray::fromRawData(reinterpret_cast<const char*>(y.constData()), y.size() * int(sizeof(double)));
+    return CurveBlobDAO::crc32(yBytes, CurveBlobDAO::crc32(xBytes));
+}
+
+QSqlDatabase AlgoResultDAO::database() const
+{
+    return m_db.isValid() ? m_db : DatabaseConnector::getInstance().getDatabase();
+}
+
+bool AlgoResultDAO::isAvailable()
+{
+    // 旧布局没有 param_hash 列：未执行 rebuild_algo_results.sql 迁移前不读写
+    return SchemaProbeCache::lookup(database(), QStringLiteral("algo_results.param_hash"), [](QSqlDatabase& db) {
+        QSqlQuery q(db);
+        bool found = false;
+        if (q.exec("SELECT 1 FROM information_schema.COLUMNS WHERE TABLE_SCHEMA = DATABASE() "
+                   "AND TABLE_NAME = 'algo_results' AND COLUMN_NAME = 'param_hash'"))
+            found = q.next();
+        DEBUG_LOG << "algo_results 表（打包布局）存在:" << found << db.connectionName();
+        return found;
+    });
+}
+
+bool AlgoResultDAO::load(const Key& key, CurveValue& curve, QVariantMap* metrics)
+{
+    if (!isAvailable()) return false;
+
+    QSqlQuery query(database());
+    query.prepare("SELECT algo_name, algo_version, raw_version, curve_name, format_version, encoding, "
+                  "point_count, x_data, y_data, metrics_data, checksum "
+                  "FROM algo_results WHERE sample_id = :sample_id AND data_type = :data_type "
+                  "AND stage_key = :stage_key AND param_hash = :param_hash");
+    query.bindValue(":sample_id", key.sampleId);
+    query.bindValue(":data_type", CurveBlobDAO::dataTypeKey(key.dataType));
+    query.bindValue(":stage_key", key.stageKey);
+    query.bindValue(":param_hash", key.paramHash);
+    if (!query.exec()) {
+        WARNING_LOG << "algo_results 查询失败, sample_id=" << key.sampleId << ":" << query.lastError().text();
+        return false;
+    }
+    if (!query.next()) return false;
+
+    // 算法实现或原始数据已变化：旧结果作废（由下次 save 清理）
+    if (query.value(0).toString() != key.algoName
+        || query.value(1).toInt() != key.algoVersion
+        || query.value(2).toUInt() != key.rawVersion) {
+        DEBUG_LOG << "algo_results 结果已过期, sample_id=" << key.sampleId << "stage=" << key.stageKey;
+        return false;
+    }
+
+    const int formatVersion = query.value(4).toInt();
+    const int encoding = query.value(5).toInt();
+    const int pointCount = query.value(6).toInt();
+    const QByteArray xData = query.value(7).toByteArray();
+    const QByteArray yData = query.value(8).toByteArray();
+    if (formatVersion > CurveBlobDAO::FormatVersion) {
+        WARNING_LOG << "algo_results 格式版本不支持:" << formatVersion << "sample_id=" << key.sampleId;
+        return false;
+    }
+    if (CurveBlobDAO::checksum(xData, yData) != query.value(10).toUInt()) {
+        WARNING_LOG << "algo_results 校验失败, sample_id=" << key.sampleId << "stage=" << key.stageKey;
+        return false;
+    }
+    QVector<double> x, y;
+    if (!CurveBlobDAO::decodeXColumn(xData, encoding, pointCount, x)
+        || !CurveBlobDAO::decodeColumn(yData, encoding, pointCount, y)) {
+        WARNING_LOG << "algo_results 解码失败, sample_id=" << key.sampleId << "encoding=" << encoding;
+        return false;
+    }
+
+    curve = CurveValue(x, y, query.value(3).toString());
+    curve.setSampleId(key.sampleId);
+    if (metrics) *metrics = decodeMetrics(query.value(9).toByteArray());
+    return true;
+}
+
+bool AlgoResultDAO::save(const Key& key, const CurveValue& curve,
+                         const QVariantMap& params, const QVariantMap& metrics)
+{
+    if (curve.isEmpty() || key.paramHash.isEmpty()) return false;
+    if (!isAvailable()) return false;
+
+    int encoding = CurveBlobDAO::EncodingXorDelta | CurveBlobDAO::EncodingZlib;
+    const QByteArray xData = CurveBlobDAO::encodeXColumn(curve.xValues(), encoding);
+    const QByteArray yData = CurveBlobDAO::encodeColumn(curve.yValues(), encoding);
+    const QString dataType = CurveBlobDAO::dataTypeKey(key.dataType);
+
+    // 同一阶段在旧原始数据/旧算法版本下的结果不会再命中，写入前清理
+    QSqlQuery purge(database());
+    purge.prepare("DELETE FROM algo_results WHERE sample_id = :sample_id AND data_type = :data_type "
+                  "AND stage_key = :stage_key AND (raw_version <> :raw_version OR algo_version <> :algo_version)");
+    purge.bindValue(":sample_id", key.sampleId);
+    purge.bindValue(":data_type", dataType);
+    purge.bindValue(":stage_key", key.stageKey);
+    purge.bindValue(":raw_version", key.rawVersion);
+    purge.bindValue(":algo_version", key.algoVersion);
+    if (!purge.exec()) {
+        WARNING_LOG << "algo_results 过期结果清理失败, sample_id=" << key.sampleId << ":" << purge.lastError().text();
+    }
+
+    QSqlQuery query(database());
+    query.prepare("INSERT INTO algo_results (sample_id, data_type, stage_key, param_hash, algo_name, algo_version, "
+                  "raw_version, param_json, curve_name, format_version, encoding, point_count, "
+                  "x_data, y_data, metrics_data, checksum) "
+                  "VALUES (:sample_id, :data_type, :stage_key, :param_hash, :algo_name, :algo_version, "
+                  ":raw_version, :param_json, :curve_name, :format_version, :encoding, :point_count, "
+                  ":x_data, :y_data, :metrics_data, :checksum) "
+                  "ON DUPLICATE KEY UPDATE algo_name = VALUES(algo_name), algo_version = VALUES(algo_version), "
+                  "raw_version = VALUES(raw_version), param_json = VALUES(param_json), curve_name = VALUES(curve_name), "
+                  "format_version = VALUES(format_version), encoding = VALUES(encoding), "
+                  "point_count = VALUES(point_count), x_data = VALUES(x_data), y_data = VALUES(y_data), "
+                  "metrics_data = VALUES(metrics_data), checksum = VALUES(checksum)");
+    query.bindValue(":sample_id", key.sampleId);
+    query.bindValue(":data_type", dataType);
+    query.bindValue(":stage_key", key.stageKey);
+    query.bindValue(":param_hash", key.paramHash);
+    query.bindValue(":algo_name", key.algoName);
+    query.bindValue(":algo_version", key.algoVersion);
+    query.bindValue(":raw_version", key.rawVersion);
+    query.bindValue(":param_json", params.isEmpty()
+                        ? QVariant(QVariant::String)
+                        : QVariant(QString::fromUtf8(QJsonDocument(QJsonObject::fromVariantMap(params)).toJson(QJsonDocument::Compact))));
+    query.bindValue(":curve_name", curve.name());
+    query.bindValue(":format_version", CurveBlobDAO::formatVersionFor(encoding));
+    query.bindValue(":encoding", encoding);
+    query.bindValue(":point_count", curve.pointCount());
+    query.bindValue(":x_data", xData);
+    query.bindValue(":y_data", yData);
+    const QByteArray metricsData = encodeMetrics(metrics);
+    query.bindValue(":metrics_data", metricsData.isEmpty() ? QVariant(QVariant::ByteArray) : QVariant(metricsData));
+    query.bindValue(":checksum", CurveBlobDAO::checksum(xData, yData));
+
+    if (!query.exec()) {
+        WARNING_LOG << "algo_results 写入失败, sample_id=" << key.sampleId << "stage=" << key.stageKey
+                    << ":" << query.lastError().text();
+        return false;
+    }
+    evictOldParamSets(key);
+    return true;
+}
+
+void AlgoResultDAO::evictOldParamSets(const Key& key)
+{
+    const QString dataType = CurveBlobDAO::dataTypeKey(key.dataType);
+
+    // 主键前缀查询，每个阶段至多 DefaultParamSetsPerStage + 1 行
+    QSqlQuery list(database());
+    list.prepare("SELECT param_hash, created_at FROM algo_results "
+                 "WHERE sample_id = :sample_id AND data_type = :data_type AND stage_key = :stage_key");
+    list.bindValue(":sample_id", key.sampleId);
+    list.bindValue(":data_type", dataType);
+    list.bindValue(":stage_key", key.stageKey);
+    if (!list.exec()) {
+        WARNING_LOG << "algo_results 保留策略查询失败, sample_id=" << key.sampleId << ":" << list.lastError().text();
+        return;
+    }
+    QVector<AlgoResultRetention::Entry> entries;
+    while (list.next()) entries.append({list.value(0).toByteArray(), list.value(1).toDateTime()});
+
+    const QList<QByteArray> evicted = AlgoResultRetention::hashesToEvict(entries, key.paramHash);
+    if (evicted.isEmpty()) return;
+
+    QStringList placeholders;
+    for (int i = 0; i < evicted.size(); ++i) placeholders << QStringLiteral("?");
+    QSqlQuery purge(database());
+    purge.prepare(QString("DELETE FROM algo_results WHERE sample_id = ? AND data_type = ? AND stage_key = ? "
+                          "AND param_hash IN (%1)").arg(placeholders.join(',')));
+    purge.addBindValue(key.sampleId);
+    purge.addBindValue(dataType);
+    purge.addBindValue(key.stageKey);
+    for (const QByteArray& hash : evicted) purge.addBindValue(hash);
+    if (!purge.exec()) {
+        WARNING_LOG << "algo_results 旧参数结果清理失败, sample_id=" << key.sampleId << ":" << purge.lastError().text();
+    }
+}
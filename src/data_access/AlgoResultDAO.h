@@ -0,0 +1,55 @@
+#ifndef ALGORESULTDAO_H
+#define ALGORESULTDAO_H
+
+#include <QByteArray>
+#include <QSqlDatabase>
+#include <QString>
+#include <QVariantMap>
+
+#include "common.h"
+
+/**
+ * @brief 持久化的阶段处理结果（algo_results 表）访问对象
+ *
+ * 每个 (样本, 数据类型, 阶段, 参数哈希) 一行，曲线 x/y 与 curve_blob 同格式打包存放。
+ * 行内记录算法版本与原始数据版本（原始 x/y 的 CRC32），读取时任一不符即视为未命中，
+ * 下次写入同一阶段时连同该阶段的过期行一并清理；每个阶段只保留最近写入的若干组参数（见 AlgoResultRetention）。
+ * 表不存在或仍是旧的逐点布局时 isAvailable() 返回 false，调用方照常计算即可。
+ */
+class AlgoResultDAO {
+public:
+    struct Key {
+        int sampleId = -1;
+        DataType dataType = DataType::CHROMATOGRAM;
+        QString stageKey;        // 阶段ID，如 "baseline_correction"
+        QByteArray paramHash;    // 20 字节 SHA-1：阶段参数及其全部前序阶段参数
+        QString algoName;        // IProcessingStep::stepName()
+        int algoVersion = 1;     // IProcessingStep::version()
+        quint32 rawVersion = 0;  // rawVersion(原始曲线)
+    };
+
+    AlgoResultDAO() = default;
+    explicit AlgoResultDAO(const QSqlDatabase& db) : m_db(db) {}
+
+    // 原始数据版本：x/y 列的 CRC32
+    static quint32 rawVersion(const CurveValue& rawCurve);
+
+    // algo_results 表（新布局）是否存在（按连接缓存检测结果，见 SchemaProbeCache）
+    bool isAvailable();
+
+    // 命中且版本、校验均一致时写入 curve（及 metrics）并返回 true
+    bool load(const Key& key, CurveValue& curve, QVariantMap* metrics = nullptr);
+
+    // 写入/覆盖一条结果；params 仅以 JSON 形式留档，不参与匹配
+    bool save(const Key& key, const CurveValue& curve,
+              const QVariantMap& params, const QVariantMap& metrics = QVariantMap());
+
+private:
+    QSqlDatabase database() const;
+    // 写入后按 AlgoResultRetention 淘汰同一阶段最久未写入的参数组
+    void evictOldParamSets(const Key& key);
+
+    QSqlDatabase m_db; // 数据库连接
+};
+
+#endif // ALGORESULTDAO_H
@@ -0,0 +1,25 @@
+#include "AlgoResultRetention.h"
+
+#include <algorithm>
+
+namespace AlgoResultRetention {
+
+QList<QByteArray> hashesToEvict(QVector<Entry> entries, const QByteArray& currentHash, int keepCount)
+{
+    keepCount = std::max(keepCount, 1);
+
+    // 刚写入的参数组排在最前，其余按写入时间从新到旧
+    std::sort(entries.begin(), entries.end(), [&currentHash](const Entry& a, const Entry& b) {
+        const bool aCurrent = a.paramHash == currentHash;
+        const bool bCurrent = b.paramHash == currentHash;
+        if (aCurrent != bCurrent) return aCurrent;
+        if (a.writtenAt != b.writtenAt) return a.writtenAt > b.writtenAt;
+        return a.paramHash < b.paramHash;
+    });
+
+    QList<QByteArray> evicted;
+    for (int i = keepCount; i < entries.size(); ++i) evicted.append(entries[i].paramHash);
+    return evicted;
+}
+
+} // namespace AlgoResultRetention
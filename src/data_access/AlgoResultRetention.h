@@ -0,0 +1,31 @@
+#ifndef ALGORESULTRETENTION_H
+#define ALGORESULTRETENTION_H
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief algo_results 的保留策略（不依赖数据库，便于单独测试）
+ *
+ * 每个 (样本, 数据类型, 阶段) 只保留最近写入的若干组参数结果：调参时每组参数都会写入一行，
+ * 不清理则表随调参次数无限增长。超出部分按写入时间从旧到新淘汰，刚写入的参数组始终保留。
+ */
+namespace AlgoResultRetention {
+
+// 每个阶段默认保留的参数组数
+constexpr int DefaultParamSetsPerStage = 8;
+
+struct Entry {
+    QByteArray paramHash;
+    QDateTime writtenAt;
+};
+
+// 返回需要删除的参数哈希；同一写入时间按哈希排序，结果与输入顺序无关。keepCount < 1 按 1 处理
+QList<QByteArray> hashesToEvict(QVector<Entry> entries, const QByteArray& currentHash,
+                                int keepCount = DefaultParamSetsPerStage);
+
+} // namespace AlgoResultRetention
+
+#endif // ALGORESULTRETENTION_H
@@ -1,5 +1,7 @@
 #include "ChromatographyDataDAO.h"
 #include "DatabaseConnector.h"
+#include "CurveBlobDAO.h"
+#include "SampleDataSummaryDAO.h"
 #include "core/sql/SqlConfigLoader.h"
 #include <QSqlError>
 #include <QDebug>
@@ -109,7 +111,8 @@ bool ChromatographyDataDAO::insertBatch(QList<ChromatographyData>& chromatograph
             }
         }
         DEBUG_LOG << "Batch insert ChromatographyData successful (sequential with import_attributes), rows:" << chromatographyDataList.size();
-        return true;
+        // 目录行维护失败时返回 false，由持有事务的调用方回滚
+        return SampleDataSummaryDAO(db).refreshRows(chromatographyDataList, DataType::CHROMATOGRAM);
     }
 
     QVariantList sampleIds, retentionTimes, responseValues, sourceNames;
@@ -127,12 +130,72 @@ bool ChromatographyDataDAO::insertBatch(QList<ChromatographyData>& chromatograph
 
     if (query.execBatch()) {
         DEBUG_LOG << "Batch insert ChromatographyData successful, inserted" << chromatographyDataList.size() << "rows.";
-        return true;
+        // 目录行维护失败时返回 false，由持有事务的调用方回滚
+        return SampleDataSummaryDAO(db).refreshRows(chromatographyDataList, DataType::CHROMATOGRAM);
     }
     WARNING_LOG << "Batch insert ChromatographyData failed:" << query.lastError().text();
     return false;
 }
 
+bool ChromatographyDataDAO::insertColumns(int sampleId,
+                                          const QVector<double>& retentionTimes,
+                                          const QVector<double>& responseValues,
+                                          const QString& sourceFilename,
+                                          const QJsonObject& importAttributes,
+                                          int rowsPerStatement) {
+    if (retentionTimes.size() != responseValues.size()) {
+        WARNING_LOG << "insertColumns: retention/response size mismatch" << retentionTimes.size() << responseValues.size();
+        return false;
+    }
+    if (retentionTimes.isEmpty()) return true;
+    QSqlDatabase db = m_db.isValid() ? m_db : DatabaseConnector::getInstance().getDatabase();
+    if (!db.isOpen()) { return false; }
+    if (rowsPerStatement <= 0) rowsPerStatement = 2000;
+
+    // 每文件常量：通过会话变量绑定一次，多行 VALUES 中只引用变量，避免逐行重复序列化 JSON
+    const bool withAttrs = hasImportAttrsColumn_chrom(db);
+    QSqlQuery setVars(db);
+    setVars.prepare("SET @chrom_src = ?, @chrom_attrs = ?");
+    setVars.addBindValue(sourceFilename);
+    setVars.addBindValue(withAttrs ? QVariant(QString::fromUtf8(QJsonDocument(importAttributes).toJson(QJsonDocument::Compact)))
+                                   : QVariant(QVariant::String));
+    if (!setVars.exec()) {
+        WARNING_LOG << "insertColumns: set session variables failed:" << setVars.lastError().text();
+        return false;
+    }
+
+    const QString head = withAttrs
+        ? QStringLiteral("INSERT INTO chromatography_data (sample_id, retention_time, response_value, source_filename, import_attributes) VALUES ")
+        : QStringLiteral("INSERT INTO chromatography_data (sample_id, retention_time, response_value, source_filename) VALUES ");
+    const QString rowPrefix = QStringLiteral("(") + QString::number(sampleId) + QLatin1Char(',');
+    const QString rowSuffix = withAttrs ? QStringLiteral(",@chrom_src,@chrom_attrs)") : QStringLiteral(",@chrom_src)");
+
+    QSqlQuery query(db);
+    QString sql;
+    const int total = retentionTimes.size();
+    for (int begin = 0; begin < total; begin += rowsPerStatement) {
+        const int end = qMin(begin + rowsPerStatement, total);
+        sql.clear();
+        sql.reserve(head.size() + (end - begin) * (rowPrefix.size() + rowSuffix.size() + 48));
+        sql += head;
+        for (int i = begin; i < end; ++i) {
+            if (i > begin) sql += QLatin1Char(',');
+            sql += rowPrefix;
+            // 'g' 17 位有效数字可无损往返 double
+            sql += QString::number(retentionTimes[i], 'g', 17);
+            sql += QLatin1Char(',');
+            sql += QString::number(responseValues[i], 'g', 17);
+            sql += rowSuffix;
+        }
+        if (!query.exec(sql)) {
+            WARNING_LOG << "Multi-row insert ChromatographyData failed at row" << begin << ":" << query.lastError().text();
+            return false;
+        }
+    }
+    DEBUG_LOG << "Multi-row insert ChromatographyData successful, sample_id" << sampleId << "rows:" << total;
+    return SampleDataSummaryDAO(db).refresh(sampleId, DataType::CHROMATOGRAM);
+}
+
 QList<ChromatographyData> ChromatographyDataDAO::getBySampleId(int sampleId) {
     QElapsedTimer timer;
     timer.restart();
@@ -168,6 +231,13 @@ bool ChromatographyDataDAO::removeBySampleId(int sampleId) {
     query.bindValue(":sample_id", sampleId);
 
     if (query.exec()) {
+        // 目录行与打包曲线随明细一并删除（导入时由 Worker 在同一事务内重写）；失败时返回 false，由调用方回滚
+        CurveBlobDAO blobDao(db);
+        if (!SampleDataSummaryDAO(db).remove(sampleId, DataType::CHROMATOGRAM)
+            || (blobDao.isAvailable() && !blobDao.remove(sampleId, DataType::CHROMATOGRAM))) {
+            WARNING_LOG << "Remove ChromatographyData summary/blob failed for sample_id" << sampleId;
+            return false;
+        }
         DEBUG_LOG << "Removed ChromatographyData for sample_id" << sampleId << ", affected" << query.numRowsAffected() << "rows.";
         return query.numRowsAffected() > 0;
     }
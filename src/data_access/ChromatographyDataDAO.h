@@ -2,8 +2,10 @@
 #define CHROMATOGRAPHYDATADAO_H
 
 #include "ChromatographyData.h" // 引入数据实体
+#include <QJsonObject>
 #include <QList>
 #include <QSqlQuery>
+#include <QVector>
 
 class ChromatographyDataDAO {
 public:
@@ -15,6 +17,18 @@ public:
     bool insert(ChromatographyData& chromatographyData);
     // 批量插入色谱记录
     bool insertBatch(QList<ChromatographyData>& chromatographyDataList);
+    /**
+     * @brief 按列批量插入单个样本的色谱点（导入路径）
+     * 以多行 INSERT ... VALUES (...),(...) 提交，每条语句 rowsPerStatement 行；
+     * source_filename / import_attributes 每次调用只序列化、绑定一次。
+     * 不开启事务，由调用方控制。
+     */
+    bool insertColumns(int sampleId,
+                       const QVector<double>& retentionTimes,
+                       const QVector<double>& responseValues,
+                       const QString& sourceFilename,
+                       const QJsonObject& importAttributes,
+                       int rowsPerStatement = 2000);
     // 根据 sampleId 查询所有色谱记录
     QList<ChromatographyData> getBySampleId(int sampleId);
     // 根据 sampleId 删除所有色谱记录
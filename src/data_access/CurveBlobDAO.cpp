@@ -0,0 +1,389 @@
+#include "CurveBlobDAO.h"
+#include "DatabaseConnector.h"
+#include "Logger.h"
+#include "core/entities/UniformGrid.h"
+#include <QSqlError>
+#include <QSqlQuery>
+#include <QJsonDocument>
+#include <QStringList>
+#include <QtEndian>
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <numeric>
+
+namespace {
+
+// 标准 CRC32（与 zlib / MySQL CRC32() 一致），迁移回填的校验值由 MySQL 计算，必须兼容
+static std::array<quint32, 256> makeCrc32Table()
+{
+    std::array<quint32, 256> table;
+    for (quint32 i = 0; i < 256; ++i) {
+        quint32 c = i;
+        for (int k = 0; k < 8; ++k) c = (c & 1u) ? (0xEDB88320u ^ (c >> 1)) : (c >> 1);
+        table[i] = c;
+    }
+    return table;
+}
+
+static quint32 crc32Update(quint32 crc, const QByteArray& data)
+{
+    static const std::array<quint32, 256> table = makeCrc32Table(); // 局部静态初始化线程安全
+    crc = ~crc;
+    const uchar* p = reinterpret_cast<const uchar*>(data.constData());
+    for (int i = 0; i < data.size(); ++i) crc = table[(crc ^ p[i]) & 0xFFu] ^ (crc >> 8);
+    return ~crc;
+}
+
+} // namespace
+
+QString CurveBlobDAO::dataTypeKey(DataType dataType)
+{
+    switch (dataType) {
+    case DataType::TG_BIG:         return QStringLiteral("big");
+    case DataType::TG_SMALL:       return QStringLiteral("small");
+    case DataType::TG_SMALL_RAW:   return QStringLiteral("small_raw");
+    case DataType::CHROMATOGRAM:   return QStringLiteral("chrom");
+    case DataType::PROCESS_TG_BIG: return QStringLiteral("process_big");
+    }
+    return QString();
+}
+
+quint32 CurveBlobDAO::crc32(const QByteArray& data, quint32 crc)
+{
+    return crc32Update(crc, data);
+}
+
+quint32 CurveBlobDAO::checksum(const QByteArray& xData, const QByteArray& yData)
+{
+    return crc32Update(crc32Update(0u, xData), yData);
+}
+
+QByteArray CurveBlobDAO::encodeColumn(const QVector<double>& values, int encoding)
+{
+    QByteArray raw(values.size() * 8, Qt::Uninitialized);
+    uchar* out = reinterpret_cast<uchar*>(raw.data());
+    quint64 prev = 0;
+    for (int i = 0; i < values.size(); ++i) {
+        quint64 bits;
+        std::memcpy(&bits, &values[i], sizeof(bits));
+        // XOR 差分：相邻点符号/指数/高位尾数相同，异或后高位为 0，便于 zlib 压缩且可无损还原
+        const quint64 word = (encoding & EncodingXorDelta) ? (bits ^ prev) : bits;
+        prev = bits;
+        qToLittleEndian<quint64>(word, out + 8 * i);
+    }
+    if (encoding & EncodingZlib) return qCompress(raw);
+    return raw;
+}
+
+bool CurveBlobDAO::decodeColumn(const QByteArray& stored, int encoding, int pointCount, QVector<double>& values)
+{
+    values.clear();
+    if (encoding & EncodingText) {
+        // 迁移回填：逗号分隔的十进制文本
+        const QList<QByteArray> parts = stored.split(',');
+        if (parts.size() != pointCount) return false;
+        values.reserve(pointCount);
+        for (const QByteArray& part : parts) {
+            bool ok = false;
+            values.append(part.toDouble(&ok));
+            if (!ok) return false;
+        }
+        return true;
+    }
+
+    const QByteArray raw = (encoding & EncodingZlib) ? qUncompress(stored) : stored;
+    if (raw.size() != pointCount * 8) return false;
+    values.resize(pointCount);
+    const uchar* in = reinterpret_cast<const uchar*>(raw.constData());
+    quint64 prev = 0;
+    for (int i = 0; i < pointCount; ++i) {
+        const quint64 word = qFromLittleEndian<quint64>(in + 8 * i);
+        const quint64 bits = (encoding & EncodingXorDelta) ? (word ^ prev) : word;
+        prev = bits;
+        std::memcpy(&values[i], &bits, sizeof(bits));
+    }
+    return true;
+}
+
+QByteArray CurveBlobDAO::encodeXColumn(const QVector<double>& x, int& encoding)
+{
+    encoding &= ~EncodingUniformX;
+    // 只接受逐位等于 x0 + i·dx 的列，保证读取还原后与写入前完全一致
+    const UniformGrid grid = UniformGrid::fromX(x, 0.0);
+    if (!grid.isValid())
+        return encodeColumn(x, encoding);
+
+    encoding |= EncodingUniformX;
+    QByteArray stored(16, Qt::Uninitialized);
+    uchar* out = reinterpret_cast<uchar*>(stored.data());
+    quint64 bits;
+    std::memcpy(&bits, &grid.x0, sizeof(bits));
+    qToLittleEndian<quint64>(bits, out);
+    std::memcpy(&bits, &grid.dx, sizeof(bits));
+    qToLittleEndian<quint64>(bits, out + 8);
+    return stored;
+}
+
+bool CurveBlobDAO::decodeXColumn(const QByteArray& stored, int encoding, int pointCount, QVector<double>& x)
+{
+    if (!(encoding & EncodingUniformX))
+        return decodeColumn(stored, encoding, pointCount, x);
+
+    x.clear();
+    if (stored.size() != 16 || pointCount <= 0) return false;
+    const uchar* in = reinterpret_cast<const uchar*>(stored.constData());
+    UniformGrid grid;
+    grid.n = pointCount;
+    const quint64 x0Bits = qFromLittleEndian<quint64>(in);
+    const quint64 dxBits = qFromLittleEndian<quint64>(in + 8);
+    std::memcpy(&grid.x0, &x0Bits, sizeof(x0Bits));
+    std::memcpy(&grid.dx, &dxBits, sizeof(dxBits));
+    x = grid.values();
+    return true;
+}
+
+int CurveBlobDAO::formatVersionFor(int encoding)
+{
+    return (encoding & EncodingUniformX) ? 2 : 1;
+}
+
+bool CurveBlobDAO::isAvailable()
+{
+    return SchemaProbeCache::lookup(m_db, QStringLiteral("curve_blob"), [](QSqlDatabase& db) {
+        QSqlQuery q(db);
+        bool found = false;
+        if (q.exec("SELECT 1 FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE() "
+                   "AND TABLE_NAME = 'curve_blob'"))
+            found = q.next();
+        if (!found && q.exec("SHOW TABLES LIKE 'curve_blob'"))
+            found = q.next();
+        DEBUG_LOG << "curve_blob 表存在:" << found << db.connectionName();
+        return found;
+    });
+}
+
+bool CurveBlobDAO::save(int sampleId, DataType dataType,
+                        const QVector<double>& x, const QVector<double>& y,
+                        const QString& sourceFilename,
+                        const QJsonObject& importAttributes,
+                        int encoding)
+{
+    return write(sampleId, dataType, x, y, sourceFilename, importAttributes, encoding, true);
+}
+
+bool CurveBlobDAO::saveIfMissing(int sampleId, DataType dataType, const QVector<double>& x, const QVector<double>& y)
+{
+    return write(sampleId, dataType, x, y, QString(), QJsonObject(), EncodingXorDelta | EncodingZlib, false);
+}
+
+bool CurveBlobDAO::write(int sampleId, DataType dataType,
+                         const QVector<double>& x, const QVector<double>& y,
+                         const QString& sourceFilename,
+                         const QJsonObject& importAttributes,
+                         int encoding, bool overwrite)
+{
+    if (x.size() != y.size() || x.isEmpty()) return false;
+    if (!isAvailable()) return false;
+    encoding &= (EncodingXorDelta | EncodingZlib); // 写入只允许二进制编码，EncodingUniformX 由 X 列自动决定
+
+    // 与明细表读取（ORDER BY x）保持一致：非递增时按 x 稳定排序
+    QVector<double> sortedX = x;
+    QVector<double> sortedY = y;
+    if (!std::is_sorted(x.constBegin(), x.constEnd())) {
+        QVector<int> order(x.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&x](int a, int b) { return x[a] < x[b]; });
+        for (int i = 0; i < order.size(); ++i) {
+            sortedX[i] = x[order[i]];
+            sortedY[i] = y[order[i]];
+        }
+    }
+
+    const QByteArray xData = encodeXColumn(sortedX, encoding);
+    const QByteArray yData = encodeColumn(sortedY, encoding);
+
+    QSqlQuery query(m_db);
+    query.prepare(QStringLiteral("INSERT INTO curve_blob (sample_id, data_type, format_version, encoding, point_count, "
+                                 "x_data, y_data, checksum, source_filename, import_attributes) "
+                                 "VALUES (:sample_id, :data_type, :format_version, :encoding, :point_count, "
+                                 ":x_data, :y_data, :checksum, :source_filename, :import_attributes) ")
+                  + (overwrite
+                     ? QStringLiteral("ON DUPLICATE KEY UPDATE format_version = VALUES(format_version), encoding = VALUES(encoding), "
+                                      "point_count = VALUES(point_count), x_data = VALUES(x_data), y_data = VALUES(y_data), "
+                                      "checksum = VALUES(checksum), source_filename = VALUES(source_filename), "
+                                      "import_attributes = VALUES(import_attributes)")
+                     // 已有行（并发导入刚写入的新曲线）保持不变
+                     : QStringLiteral("ON DUPLICATE KEY UPDATE sample_id = sample_id")));
+    query.bindValue(":sample_id", sampleId);
+    query.bindValue(":data_type", dataTypeKey(dataType));
+    query.bindValue(":format_version", formatVersionFor(encoding));
+    query.bindValue(":encoding", encoding);
+    query.bindValue(":point_count", sortedX.size());
+    query.bindValue(":x_data", xData);
+    query.bindValue(":y_data", yData);
+    query.bindValue(":checksum", checksum(xData, yData));
+    query.bindValue(":source_filename", sourceFilename.isEmpty() ? QVariant(QVariant::String) : QVariant(sourceFilename));
+    query.bindValue(":import_attributes", importAttributes.isEmpty()
+                        ? QVariant(QVariant::String)
+                        : QVariant(QString::fromUtf8(QJsonDocument(importAttributes).toJson(QJsonDocument::Compact))));
+
+    if (!query.exec()) {
+        WARNING_LOG << "curve_blob 写入失败, sample_id=" << sampleId << ":" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool CurveBlobDAO::decodeRow(const QSqlQuery& query, QVector<double>& x, QVector<double>& y)
+{
+    const int sampleId = query.value(0).toInt();
+    const int formatVersion = query.value(1).toInt();
+    const int encoding = query.value(2).toInt();
+    const int pointCount = query.value(3).toInt();
+    const QByteArray xData = query.value(4).toByteArray();
+    const QByteArray yData = query.value(5).toByteArray();
+    const quint32 storedChecksum = query.value(6).toUInt();
+
+    if (formatVersion > FormatVersion) {
+        WARNING_LOG << "curve_blob 格式版本不支持:" << formatVersion << "sample_id=" << sampleId;
+        return false;
+    }
+    if (checksum(xData, yData) != storedChecksum) {
+        WARNING_LOG << "curve_blob 校验失败, sample_id=" << sampleId;
+        return false;
+    }
+    if (!decodeXColumn(xData, encoding, pointCount, x) || !decodeColumn(yData, encoding, pointCount, y)) {
+        WARNING_LOG << "curve_blob 解码失败, sample_id=" << sampleId << "encoding=" << encoding;
+        return false;
+    }
+    return true;
+}
+
+bool CurveBlobDAO::upgradeTextEncoding(int sampleId, DataType dataType, const QVector<double>& x, const QVector<double>& y)
+{
+    int binaryEncoding = EncodingXorDelta | EncodingZlib;
+    const QByteArray newX = encodeXColumn(x, binaryEncoding);
+    const QByteArray newY = encodeColumn(y, binaryEncoding);
+    QSqlQuery upgrade(m_db);
+    upgrade.prepare("UPDATE curve_blob SET format_version = :format_version, encoding = :encoding, "
+                    "x_data = :x_data, y_data = :y_data, checksum = :checksum "
+                    // 仍为文本编码时才改写：读取后被重新导入覆盖的行保持新内容
+                    "WHERE sample_id = :sample_id AND data_type = :data_type AND (encoding & :text) <> 0");
+    upgrade.bindValue(":format_version", formatVersionFor(binaryEncoding));
+    upgrade.bindValue(":encoding", binaryEncoding);
+    upgrade.bindValue(":x_data", newX);
+    upgrade.bindValue(":y_data", newY);
+    upgrade.bindValue(":checksum", checksum(newX, newY));
+    upgrade.bindValue(":sample_id", sampleId);
+    upgrade.bindValue(":data_type", dataTypeKey(dataType));
+    upgrade.bindValue(":text", int(EncodingText));
+    if (!upgrade.exec()) {
+        WARNING_LOG << "curve_blob 编码升级失败, sample_id=" << sampleId << ":" << upgrade.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool CurveBlobDAO::load(int sampleId, DataType dataType, QVector<double>& x, QVector<double>& y)
+{
+    if (!isAvailable()) return false;
+
+    QSqlQuery query(m_db);
+    query.prepare("SELECT sample_id, format_version, encoding, point_count, x_data, y_data, checksum "
+                  "FROM curve_blob WHERE sample_id = :sample_id AND data_type = :data_type");
+    query.bindValue(":sample_id", sampleId);
+    query.bindValue(":data_type", dataTypeKey(dataType));
+    if (!query.exec()) {
+        WARNING_LOG << "curve_blob 查询失败, sample_id=" << sampleId << ":" << query.lastError().text();
+        return false;
+    }
+    if (!query.next()) return false;
+    return decodeRow(query, x, y);
+}
+
+QHash<int, SampleCurveColumns> CurveBlobDAO::loadMany(const QList<int>& sampleIds, DataType dataType)
+{
+    QHash<int, SampleCurveColumns> curves;
+    if (sampleIds.isEmpty() || !isAvailable()) return curves;
+
+    const int chunkSize = 500;
+    for (int begin = 0; begin < sampleIds.size(); begin += chunkSize) {
+        QStringList idList;
+        const int end = qMin(begin + chunkSize, sampleIds.size());
+        for (int i = begin; i < end; ++i) idList << QString::number(sampleIds.at(i));
+
+        QSqlQuery query(m_db);
+        query.setForwardOnly(true);
+        query.prepare(QString("SELECT sample_id, format_version, encoding, point_count, x_data, y_data, checksum "
+                              "FROM curve_blob WHERE data_type = :data_type AND sample_id IN (%1)")
+                          .arg(idList.join(',')));
+        query.bindValue(":data_type", dataTypeKey(dataType));
+        if (!query.exec()) {
+            WARNING_LOG << "curve_blob 批量查询失败:" << query.lastError().text();
+            return curves;
+        }
+        while (query.next()) {
+            SampleCurveColumns columns;
+            if (decodeRow(query, columns.x, columns.y)) curves.insert(query.value(0).toInt(), columns);
+        }
+    }
+    return curves;
+}
+
+bool CurveBlobDAO::remove(int sampleId, DataType dataType)
+{
+    if (!isAvailable()) return false;
+
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM curve_blob WHERE sample_id = :sample_id AND data_type = :data_type");
+    query.bindValue(":sample_id", sampleId);
+    query.bindValue(":data_type", dataTypeKey(dataType));
+    if (!query.exec()) {
+        WARNING_LOG << "curve_blob 删除失败, sample_id=" << sampleId << ":" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool CurveBlobDAO::removeAll(DataType dataType)
+{
+    if (!isAvailable()) return false;
+
+    QSqlQuery query(m_db);
+    query.prepare("DELETE FROM curve_blob WHERE data_type = :data_type");
+    query.bindValue(":data_type", dataTypeKey(dataType));
+    if (!query.exec()) {
+        WARNING_LOG << "curve_blob 清空失败:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+int CurveBlobDAO::upgradeTextRows(DataType dataType)
+{
+    if (!isAvailable()) return 0;
+
+    QSqlQuery query(m_db);
+    query.setForwardOnly(true);
+    query.prepare("SELECT sample_id, format_version, encoding, point_count, x_data, y_data, checksum "
+                  "FROM curve_blob WHERE data_type = :data_type AND (encoding & :text) <> 0");
+    query.bindValue(":data_type", dataTypeKey(dataType));
+    query.bindValue(":text", int(EncodingText));
+    if (!query.exec()) {
+        WARNING_LOG << "curve_blob 文本编码行查询失败:" << query.lastError().text();
+        return 0;
+    }
+    QHash<int, SampleCurveColumns> curves;
+    while (query.next()) {
+        SampleCurveColumns columns;
+        if (decodeRow(query, columns.x, columns.y)) curves.insert(query.value(0).toInt(), columns);
+    }
+
+    // 结果集读取完毕后再执行升级写入
+    int upgraded = 0;
+    for (auto it = curves.constBegin(); it != curves.constEnd(); ++it) {
+        if (upgradeTextEncoding(it.key(), dataType, it->x, it->y)) ++upgraded;
+    }
+    return upgraded;
+}
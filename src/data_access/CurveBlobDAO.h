@@ -0,0 +1,108 @@
+#ifndef CURVEBLOBDAO_H
+#define CURVEBLOBDAO_H
+
+#include <QHash>
+#include <QJsonObject>
+#include <QList>
+#include <QSqlDatabase>
+#include <QSqlQuery>
+#include <QString>
+#include <QVector>
+
+#include "common.h"
+#include "SampleDAO.h" // SampleCurveColumns
+
+/**
+ * @brief 曲线打包存储（curve_blob 表）访问对象
+ *
+ * 每个 (样本, 数据类型) 一行：x/y 以 little-endian float64 数组存放，
+ * 可选 XOR 差分 + zlib 压缩，附带格式版本与 CRC32 校验。
+ * 等间距 X（serial_no、固定步长保留时间）逐位等于 x0 + i·dx 时只存 x0 与 dx，读取时按网格还原（见 UniformGrid）。
+ * 表不存在（未执行迁移）时 isAvailable() 返回 false，调用方应回退到逐点明细表。
+ * 连接始终由调用方传入，与同一事务内的明细读写保持一致。
+ */
+class CurveBlobDAO {
+public:
+    // 支持的最高存储格式版本；不含 EncodingUniformX 的行仍按版本 1 写入，旧版本程序可继续读取
+    static const int FormatVersion = 2;
+
+    // 编码标志（可组合）；Text 仅由 SQL 迁移回填产生，由 upgradeTextRows() 升级为二进制
+    enum Encoding {
+        EncodingRaw      = 0x00,
+        EncodingXorDelta = 0x01,
+        EncodingZlib     = 0x02,
+        EncodingUniformX = 0x04, // x 列为 16 字节 (x0, dx)，点数取 point_count（格式版本 2）
+        EncodingText     = 0x10
+    };
+
+    explicit CurveBlobDAO(QSqlDatabase& db) : m_db(db) {}
+
+    // DataType -> curve_blob.data_type 枚举值（'big'/'small'/'small_raw'/'chrom'/'process_big'）
+    static QString dataTypeKey(DataType dataType);
+
+    // 列编码/解码与校验；algo_results 等同格式的打包表复用
+    static QByteArray encodeColumn(const QVector<double>& values, int encoding);
+    static bool decodeColumn(const QByteArray& stored, int encoding, int pointCount, QVector<double>& values);
+    // X 列：逐位等间距时写成 (x0, dx) 并在 encoding 中置 EncodingUniformX，否则同 encodeColumn
+    static QByteArray encodeXColumn(const QVector<double>& x, int& encoding);
+    static bool decodeXColumn(const QByteArray& stored, int encoding, int pointCount, QVector<double>& x);
+    // 按编码标志取写入的格式版本
+    static int formatVersionFor(int encoding);
+    static quint32 checksum(const QByteArray& xData, const QByteArray& yData);
+    // 标准 CRC32（与 MySQL CRC32() 一致），crc 为前一段数据的结果
+    static quint32 crc32(const QByteArray& data, quint32 crc = 0);
+
+    // curve_blob 表是否存在（按连接缓存检测结果，见 SchemaProbeCache）
+    bool isAvailable();
+
+    // 写入/覆盖一条曲线；x 非递增时按 x 稳定排序后存储，与明细表 ORDER BY x 的读取结果一致
+    bool save(int sampleId, DataType dataType,
+              const QVector<double>& x, const QVector<double>& y,
+              const QString& sourceFilename = QString(),
+              const QJsonObject& importAttributes = QJsonObject(),
+              int encoding = EncodingXorDelta | EncodingZlib);
+
+    // 仅在尚无该 (样本, 数据类型) 行时写入；回填使用，不覆盖并发导入写入的曲线
+    bool saveIfMissing(int sampleId, DataType dataType, const QVector<double>& x, const QVector<double>& y);
+
+    // 主键单行读取；未命中、校验失败或格式版本不识别时返回 false
+    bool load(int sampleId, DataType dataType, QVector<double>& x, QVector<double>& y);
+
+    // 批量读取，只包含命中的样本
+    QHash<int, SampleCurveColumns> loadMany(const QList<int>& sampleIds, DataType dataType);
+
+    bool remove(int sampleId, DataType dataType);
+    bool removeAll(DataType dataType);
+
+    // 维护操作：将迁移回填的文本编码行改写为二进制，返回升级行数（读取路径不做写入；由启动时的回填任务调用）
+    int upgradeTextRows(DataType dataType);
+
+    // 导入路径使用：从明细实体列表抽取 x/y 后写入（来源文件名与导入属性取首行）
+    template <typename Row, typename XOf, typename YOf>
+    bool saveRows(int sampleId, DataType dataType, const QList<Row>& rows, XOf xOf, YOf yOf)
+    {
+        if (rows.isEmpty()) return false;
+        QVector<double> x, y;
+        x.reserve(rows.size());
+        y.reserve(rows.size());
+        for (const Row& row : rows) {
+            x.append(xOf(row));
+            y.append(yOf(row));
+        }
+        return save(sampleId, dataType, x, y, rows.first().getSourceName(), rows.first().getImportAttributes());
+    }
+
+private:
+    // overwrite 为 false 时已有行保持不变
+    bool write(int sampleId, DataType dataType,
+               const QVector<double>& x, const QVector<double>& y,
+               const QString& sourceFilename, const QJsonObject& importAttributes,
+               int encoding, bool overwrite);
+    // 解码一行查询结果（列顺序：sample_id, format_version, encoding, point_count, x_data, y_data, checksum）
+    bool decodeRow(const QSqlQuery& query, QVector<double>& x, QVector<double>& y);
+    bool upgradeTextEncoding(int sampleId, DataType dataType, const QVector<double>& x, const QVector<double>& y);
+
+    QSqlDatabase m_db; // 数据库连接
+};
+
+#endif // CURVEBLOBDAO_H
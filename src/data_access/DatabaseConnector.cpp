@@ -39,7 +39,10 @@
 #include <QSqlError>
 #include <QDebug>
 #include <QThread> // 用于生成临时连接名
+#include <QAtomicInt>
 #include <QFile>
+#include <QHash>
+#include <QMutex>
 
 // 构造函数：初始化主数据库连接对象及其名称
 DatabaseConnector::DatabaseConnector()
@@ -78,6 +81,66 @@ QSqlDatabase& DatabaseConnector::getDatabase() {
     return m_db;
 }
 
+ScopedThreadConnection::ScopedThreadConnection()
+{
+    // 同一线程可能同时持有多个连接（批次预取与对齐阶段），名称附带序号保证唯一
+    static QAtomicInt serial(0);
+    m_connectionName = QString("ta_thread_conn_%1_%2")
+                           .arg(reinterpret_cast<quintptr>(QThread::currentThreadId()))
+                           .arg(serial.fetchAndAddOrdered(1));
+    // 按名称克隆：cloneDatabase(const QSqlDatabase&) 不能在主连接所属线程以外调用
+    m_db = QSqlDatabase::cloneDatabase(DatabaseConnector::getInstance().connectionName(), m_connectionName);
+    if (m_db.open()) {
+        // 与主连接一致使用 utf8mb4，避免中文项目名/批次号乱码
+        QSqlQuery q(m_db);
+        q.exec("SET NAMES utf8mb4");
+    } else {
+        WARNING_LOG << "Thread connection open failed:" << m_connectionName << m_db.lastError().text();
+    }
+}
+
+ScopedThreadConnection::~ScopedThreadConnection()
+{
+    if (m_db.isOpen()) {
+        m_db.close();
+    }
+    // 先释放持有的句柄，否则 removeDatabase 会报告连接仍在使用
+    m_db = QSqlDatabase();
+    QSqlDatabase::removeDatabase(m_connectionName);
+    SchemaProbeCache::forget(m_connectionName);
+}
+
+// 连接名 -> (探测键 -> 结果)
+static QMutex s_schemaProbeMutex;
+static QHash<QString, QHash<QString, bool>> s_schemaProbeResults;
+
+bool SchemaProbeCache::lookup(const QSqlDatabase& db, const QString& probeKey,
+                              const std::function<bool(QSqlDatabase&)>& probe)
+{
+    if (!db.isOpen()) return false; // 连接未就绪时不缓存结果
+
+    const QString connectionName = db.connectionName();
+    {
+        QMutexLocker locker(&s_schemaProbeMutex);
+        const auto it = s_schemaProbeResults.constFind(connectionName);
+        if (it != s_schemaProbeResults.constEnd() && it->contains(probeKey)) return it->value(probeKey);
+    }
+
+    // 探测在锁外执行：并发首次探测至多重复一次查询，结果相同
+    QSqlDatabase probeDb = db;
+    const bool found = probe(probeDb);
+    QMutexLocker locker(&s_schemaProbeMutex);
+    s_schemaProbeResults[connectionName].insert(probeKey, found);
+    return found;
+}
+
+void SchemaProbeCache::forget(const QString& connectionName)
+{
+    QMutexLocker locker(&s_schemaProbeMutex);
+    if (connectionName.isEmpty()) s_schemaProbeResults.clear();
+    else s_schemaProbeResults.remove(connectionName);
+}
+
 bool DatabaseConnector::connectOrCreateDatabase(const QVariantMap& config)
 {
     // 从传入的配置中提取数据库连接参数
@@ -141,6 +204,8 @@ bool DatabaseConnector::connectOrCreateDatabase(const QVariantMap& config)
     m_db.setPassword(password);
     m_db.setPort(port);
 
+    // 重新打开（可能已切换到另一个库）后重新探测表结构
+    SchemaProbeCache::forget(m_connectionName);
     if (!m_db.open()) {
         WARNING_LOG << "连接到指定数据库失败:" << m_db.lastError().text();
         return false;
@@ -206,6 +271,7 @@ bool DatabaseConnector::ensureTablesExist(const QString &filePath) {
             if (!statement.isEmpty()) {
                 if (!query.exec(statement)) {
                     WARNING_LOG << "执行SQL语句失败:" << query.lastError().text() << "SQL:" << statement;
+                    SchemaProbeCache::forget();
                     return false;
                 }
             }
@@ -220,9 +286,12 @@ bool DatabaseConnector::ensureTablesExist(const QString &filePath) {
     if (!statement.isEmpty()) {
         if (!query.exec(statement)) {
             WARNING_LOG << "执行SQL语句失败:" << query.lastError().text() << "SQL:" << statement;
+            SchemaProbeCache::forget();
             return false;
         }
     }
 
+    // 建表脚本可能新建了迁移表，所有连接重新探测
+    SchemaProbeCache::forget();
     return true;
 }
@@ -30,6 +30,7 @@
 #include <QSqlDatabase>
 #include <QString>
 #include <QVariantMap> // 用于接收配置参数
+#include <functional>
 
 class DatabaseConnector {
 public:
@@ -39,6 +40,9 @@ public:
     // 获取数据库连接对象
     QSqlDatabase& getDatabase();
 
+    // 主连接名称（供其他线程按名称克隆连接）
+    QString connectionName() const { return m_connectionName; }
+
     // 连接或创建数据库。参数从外部配置文件读取，通过 QVariantMap 传入
     bool connectOrCreateDatabase(const QVariantMap& config);
 
@@ -59,4 +63,37 @@ private:
     bool m_utf8Set = false;      // 是否已执行 SET NAMES utf8mb4
 };
 
+/**
+ * @brief 当前线程专用的数据库连接（RAII）
+ * 构造时按连接名克隆主连接（可在任意线程调用）并打开，析构时关闭并移除该连接。
+ * 使用该连接的 DAO 须先于本对象析构。
+ */
+class ScopedThreadConnection {
+public:
+    ScopedThreadConnection();
+    ~ScopedThreadConnection();
+
+    QSqlDatabase& database() { return m_db; }
+
+private:
+    ScopedThreadConnection(const ScopedThreadConnection&) = delete;
+    ScopedThreadConnection& operator=(const ScopedThreadConnection&) = delete;
+
+    QString m_connectionName;
+    QSqlDatabase m_db;
+};
+
+/**
+ * @brief 按连接名缓存的表结构探测结果（如某张迁移表是否存在）
+ * 同一连接只探测一次；连接重新打开、被移除或执行建表脚本后清除缓存，下次使用时重新探测，
+ * 因此运行期间执行迁移或切换数据库后不会沿用旧结论。连接未打开时不探测也不缓存。
+ */
+class SchemaProbeCache {
+public:
+    static bool lookup(const QSqlDatabase& db, const QString& probeKey,
+                       const std::function<bool(QSqlDatabase&)>& probe);
+    // connectionName 为空时清除全部连接的缓存
+    static void forget(const QString& connectionName = QString());
+};
+
 #endif // DATABASECONNECTOR_H
\ No newline at end of file
@@ -5,6 +5,8 @@
 #include "NavigatorDAO.h"
 #include "DatabaseManager.h"
 #include "core/sql/SqlConfigLoader.h"
+#include "CurveBlobDAO.h"
+#include "SampleDataSummaryDAO.h"
 #include <QJsonObject>
 #include <QStringList>
 #include <QSqlQuery>
@@ -107,6 +109,35 @@ QPair<QString, QMap<QString, QVariant>> makeAttributeFilterSql(const QJsonObject
     return {extra, binds};
 }
 
+bool summaryAvailable()
+{
+    QSqlDatabase db = DatabaseManager::instance().database();
+    return SampleDataSummaryDAO(db).isAvailable();
+}
+
+/// 样本与某类数据的关联子句（别名 d）：有 sample_data_summary 目录时按 (sample_id, data_type) 主键一行关联，
+/// 否则回退到逐点明细表。两者都有 import_attributes 列，属性筛选不受影响
+QString dataJoinClause(const QString& tableName)
+{
+    for (DataType type : {DataType::TG_BIG, DataType::TG_SMALL, DataType::TG_SMALL_RAW,
+                          DataType::CHROMATOGRAM, DataType::PROCESS_TG_BIG}) {
+        if (SampleDataSummaryDAO::pointTable(type) != tableName) continue;
+        if (summaryAvailable()) {
+            return QStringLiteral("JOIN sample_data_summary d ON d.sample_id = s.id AND d.data_type = '%1'")
+                .arg(CurveBlobDAO::dataTypeKey(type));
+        }
+        break;
+    }
+    return QStringLiteral("JOIN %1 d ON s.id = d.sample_id").arg(tableName);
+}
+
+/// 读取 SQL 配置：目录表可用时取 "<op>_summary" 版本，避免配置中的旧明细表 SQL 绕过目录
+QString navigatorSql(const QString& opName)
+{
+    const QString name = summaryAvailable() ? opName + QStringLiteral("_summary") : opName;
+    return SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", name).sql;
+}
+
 } // namespace
 
 bool NavigatorDAO::attributeFilterHasCriteria(const QJsonObject& o)
@@ -183,15 +214,15 @@ QList<QString> NavigatorDAO::fetchBatchCodesForProject(const QString& projectNam
     QSqlQuery query(DatabaseManager::instance().database());
     
     // 使用SqlConfigLoader获取SQL语句，如果配置中不存在则使用默认SQL
-    QString sql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "select_batch_codes_by_project").sql;
+    QString sql = navigatorSql("select_batch_codes_by_project");
     if (sql.isEmpty()) {
-        sql = R"(
+        sql = QString(R"(
         SELECT DISTINCT s.batch_code 
-        FROM tg_big_data d
-        JOIN single_tobacco_sample s ON d.sample_id = s.id
+        FROM single_tobacco_sample s
+        %1
         WHERE s.project_name = :project_name 
         ORDER BY s.batch_code
-        )";
+        )").arg(dataJoinClause("tg_big_data"));
     }
     query.prepare(sql);
     query.bindValue(":project_name", projectName);
@@ -215,9 +246,9 @@ QList<QVariantMap> NavigatorDAO::fetchSamplesForProjectAndBatch(const QString& p
     QSqlQuery query(DatabaseManager::instance().database());
     
     // 使用SqlConfigLoader获取SQL语句，如果配置中不存在则使用默认SQL
-    QString sql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "select_samples_by_project_and_batch").sql;
+    QString sql = navigatorSql("select_samples_by_project_and_batch");
     if (sql.isEmpty()) {
-        sql = R"(
+        sql = QString(R"(
         SELECT DISTINCT
                s.id as sample_id,
                s.project_name,
@@ -227,12 +258,12 @@ QList<QVariantMap> NavigatorDAO::fetchSamplesForProjectAndBatch(const QString& p
                s.sample_name,
                s.origin,
                s.grade
-        FROM tg_big_data d
-        JOIN single_tobacco_sample s ON d.sample_id = s.id
+        FROM single_tobacco_sample s
+        %1
         LEFT JOIN tobacco_batch b ON s.batch_id = b.id
         WHERE s.project_name = :project_name AND b.batch_code = :batch_code
         ORDER BY s.short_code, s.parallel_no
-        )";
+        )").arg(dataJoinClause("tg_big_data"));
     }
     query.prepare(sql);
     query.bindValue(":project_name", projectName);
@@ -432,6 +463,35 @@ QStringList NavigatorDAO::getAvailableDataTypesForShortCode(int batchId, const Q
 {
     QStringList dataTypes;
     QSqlQuery query(DatabaseManager::instance().database());
+
+    // 有目录表时一次查询得到全部数据类型
+    if (summaryAvailable()) {
+        QString sql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "select_data_types_by_batch_and_short_code").sql;
+        if (sql.isEmpty()) {
+            sql = R"(
+                SELECT DISTINCT d.data_type
+                FROM single_tobacco_sample s
+                JOIN sample_data_summary d ON d.sample_id = s.id
+                WHERE s.batch_id = :batch_id AND s.short_code = :short_code
+            )";
+        }
+        query.prepare(sql);
+        query.bindValue(":batch_id", batchId);
+        query.bindValue(":short_code", shortCode);
+        if (!query.exec()) {
+            error = query.lastError().text();
+            DEBUG_LOG << "NavigatorDAO::getAvailableDataTypesForShortCode - SQL Error:" << error;
+            return dataTypes;
+        }
+        QSet<QString> keys;
+        while (query.next()) keys.insert(query.value(0).toString());
+        // 与逐表检查的顺序一致
+        if (keys.contains(CurveBlobDAO::dataTypeKey(DataType::TG_BIG))) dataTypes.append("大热重");
+        if (keys.contains(CurveBlobDAO::dataTypeKey(DataType::TG_SMALL))) dataTypes.append("小热重");
+        if (keys.contains(CurveBlobDAO::dataTypeKey(DataType::TG_SMALL_RAW))) dataTypes.append("小热重（原始数据）");
+        if (keys.contains(CurveBlobDAO::dataTypeKey(DataType::CHROMATOGRAM))) dataTypes.append("色谱");
+        return dataTypes;
+    }
     
     // 检查大热重数据
     QString sql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "exists_tg_big_by_batch_and_short_code").sql;
@@ -695,9 +755,9 @@ QList<QString> NavigatorDAO::fetchShortCodesForDataType(const QString& dataType,
             SELECT DISTINCT s.short_code
             FROM single_tobacco_sample s
             JOIN tobacco_batch b ON s.batch_id = b.id
-            JOIN %1 d ON s.id = d.sample_id
+            %1
             WHERE 1=1
-        )").arg(tableName);
+        )").arg(dataJoinClause(tableName));
         sql += clause.first;
         sql += QStringLiteral(" ORDER BY s.short_code");
 
@@ -707,15 +767,15 @@ QList<QString> NavigatorDAO::fetchShortCodesForDataType(const QString& dataType,
         }
     } else {
         QString opName = QString("select_short_codes_for_%1").arg(tableName);
-        sql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", opName).sql;
+        sql = navigatorSql(opName);
 
         if (sql.isEmpty()) {
             sql = QString(R"(
             SELECT DISTINCT s.short_code 
             FROM single_tobacco_sample s
-            JOIN %1 d ON s.id = d.sample_id
+            %1
             ORDER BY s.short_code
-        )").arg(tableName);
+        )").arg(dataJoinClause(tableName));
         }
 
         query.prepare(sql);
@@ -758,9 +818,9 @@ QList<NavigatorDAO::SampleLeafInfo> NavigatorDAO::fetchParallelSamplesForShortCo
                COALESCE(s.sample_name, '') AS sample_name
         FROM single_tobacco_sample s
         JOIN tobacco_batch b ON s.batch_id = b.id
-        JOIN %1 d ON s.id = d.sample_id
+        %1
         WHERE s.short_code = :short_code
-    )").arg(tableName);
+    )").arg(dataJoinClause(tableName));
 
     QMap<QString, QVariant> attrBinds;
     if (attributeFilterHasCriteria(attributeFilter)) {
@@ -846,10 +906,10 @@ bool NavigatorDAO::renameShortCodeForDataType(const QString& oldShortCode, const
     QSqlQuery query(db);
     const QString sql = QStringLiteral(
         "UPDATE single_tobacco_sample s "
-        "JOIN %1 d ON s.id = d.sample_id "
+        "%1 "
         "SET s.short_code = :new_sc "
         "WHERE s.short_code = :old_sc"
-    ).arg(tableName);
+    ).arg(dataJoinClause(tableName));
 
     query.prepare(sql);
     query.bindValue(QStringLiteral(":new_sc"), trimmedNew);
@@ -877,8 +937,8 @@ QList<QString> NavigatorDAO::fetchProjectsForProcessData(QString& error, const Q
             "SELECT DISTINCT s.project_name "
             "FROM single_tobacco_sample s "
             "JOIN tobacco_batch b ON s.batch_id = b.id "
-            "JOIN process_tg_big_data d ON s.id = d.sample_id "
-            "WHERE 1=1");
+            "%1 "
+            "WHERE 1=1").arg(dataJoinClause(QStringLiteral("process_tg_big_data")));
         sql += clause.first;
         sql += QStringLiteral(" ORDER BY s.project_name");
         query.prepare(sql);
@@ -889,8 +949,8 @@ QList<QString> NavigatorDAO::fetchProjectsForProcessData(QString& error, const Q
         sql = QStringLiteral(
             "SELECT DISTINCT s.project_name "
             "FROM single_tobacco_sample s "
-            "JOIN process_tg_big_data d ON s.id = d.sample_id "
-            "ORDER BY s.project_name");
+            "%1 "
+            "ORDER BY s.project_name").arg(dataJoinClause(QStringLiteral("process_tg_big_data")));
         query.prepare(sql);
     }
 
@@ -916,8 +976,8 @@ QList<QPair<QString, int>> NavigatorDAO::fetchBatchesForProcessProject(const QSt
         "SELECT DISTINCT b.batch_code, b.id "
         "FROM tobacco_batch b "
         "JOIN single_tobacco_sample s ON s.batch_id = b.id "
-        "JOIN process_tg_big_data d ON s.id = d.sample_id "
-        "WHERE s.project_name = :project_name");
+        "%1 "
+        "WHERE s.project_name = :project_name").arg(dataJoinClause(QStringLiteral("process_tg_big_data")));
 
     QMap<QString, QVariant> attrBinds;
     if (attributeFilterHasCriteria(attributeFilter)) {
@@ -958,8 +1018,8 @@ QList<NavigatorDAO::SampleLeafInfo> NavigatorDAO::fetchSamplesForProcessBatch(co
         "COALESCE(s.sample_name, '') AS sample_name "
         "FROM single_tobacco_sample s "
         "JOIN tobacco_batch b ON s.batch_id = b.id "
-        "JOIN process_tg_big_data d ON s.id = d.sample_id "
-        "WHERE b.batch_code = :batch_code");
+        "%1 "
+        "WHERE b.batch_code = :batch_code").arg(dataJoinClause(QStringLiteral("process_tg_big_data")));
 
     QMap<QString, QVariant> attrBinds;
     if (attributeFilterHasCriteria(attributeFilter)) {
@@ -1442,6 +1502,7 @@ bool NavigatorDAO::deleteSampleDataByType(int sampleId, const QString& dataType,
 
     QSqlQuery query(db);
     QString delSql;
+    DataType type = DataType::TG_BIG;
 
     if (dataType == "大热重") {
         delSql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "delete_tg_big_by_sample_id").sql;
@@ -1449,21 +1510,25 @@ bool NavigatorDAO::deleteSampleDataByType(int sampleId, const QString& dataType,
             delSql = "DELETE FROM tg_big_data WHERE sample_id = :sid";
         }
     } else if (dataType == "小热重") {
+        type = DataType::TG_SMALL;
         delSql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "delete_tg_small_by_sample_id").sql;
         if (delSql.isEmpty()) {
             delSql = "DELETE FROM tg_small_data WHERE sample_id = :sid";
         }
     } else if (dataType == "小热重（原始数据）") {
+        type = DataType::TG_SMALL_RAW;
         delSql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "delete_tg_small_raw_by_sample_id").sql;
         if (delSql.isEmpty()) {
             delSql = "DELETE FROM tg_small_raw_data WHERE sample_id = :sid";
         }
     } else if (dataType == "色谱") {
+        type = DataType::CHROMATOGRAM;
         delSql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "delete_chrom_by_sample_id").sql;
         if (delSql.isEmpty()) {
             delSql = "DELETE FROM chromatography_data WHERE sample_id = :sid";
         }
     } else if (dataType == "工序大热重") {
+        type = DataType::PROCESS_TG_BIG;
         delSql = SqlConfigLoader::getInstance().getSqlOperation("NavigatorDAO", "delete_process_tg_big_by_sample_id").sql;
         if (delSql.isEmpty()) {
             delSql = "DELETE FROM process_tg_big_data WHERE sample_id = :sid";
@@ -1482,6 +1547,20 @@ bool NavigatorDAO::deleteSampleDataByType(int sampleId, const QString& dataType,
         return false;
     }
 
+    // 同一事务内删除目录行与打包曲线
+    SampleDataSummaryDAO summaryDao(db);
+    if (summaryDao.isAvailable() && !summaryDao.remove(sampleId, type)) {
+        db.rollback();
+        error = "删除样本数据目录失败";
+        return false;
+    }
+    CurveBlobDAO blobDao(db);
+    if (blobDao.isAvailable() && !blobDao.remove(sampleId, type)) {
+        db.rollback();
+        error = "删除打包曲线失败";
+        return false;
+    }
+
     if (!db.commit()) { db.rollback(); error = db.lastError().text(); return false; }
     return true;
 }
@@ -1494,16 +1573,21 @@ bool NavigatorDAO::deleteAllDataByType(const QString& dataType, QString& error)
 
     QSqlQuery query(db);
     QString delSql;
+    DataType type = DataType::TG_BIG;
 
     if (dataType == "大热重") {
         delSql = "DELETE FROM tg_big_data";
     } else if (dataType == "小热重") {
+        type = DataType::TG_SMALL;
         delSql = "DELETE FROM tg_small_data";
     } else if (dataType == "小热重（原始数据）") {
+        type = DataType::TG_SMALL_RAW;
         delSql = "DELETE FROM tg_small_raw_data";
     } else if (dataType == "色谱") {
+        type = DataType::CHROMATOGRAM;
         delSql = "DELETE FROM chromatography_data";
     } else if (dataType == "工序大热重") {
+        type = DataType::PROCESS_TG_BIG;
         delSql = "DELETE FROM process_tg_big_data";
     } else {
         db.rollback();
@@ -1517,6 +1601,19 @@ bool NavigatorDAO::deleteAllDataByType(const QString& dataType, QString& error)
         return false;
     }
 
+    SampleDataSummaryDAO summaryDao(db);
+    if (summaryDao.isAvailable() && !summaryDao.removeAll(type)) {
+        db.rollback();
+        error = "清空样本数据目录失败";
+        return false;
+    }
+    CurveBlobDAO blobDao(db);
+    if (blobDao.isAvailable() && !blobDao.removeAll(type)) {
+        db.rollback();
+        error = "清空打包曲线失败";
+        return false;
+    }
+
     if (!db.commit()) { db.rollback(); error = db.lastError().text(); return false; }
     return true;
 }
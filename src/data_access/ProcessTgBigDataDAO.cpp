@@ -1,5 +1,7 @@
 #include "ProcessTgBigDataDAO.h"
 #include "DatabaseConnector.h"
+#include "CurveBlobDAO.h"
+#include "SampleDataSummaryDAO.h"
 #include "core/sql/SqlConfigLoader.h"
 #include <QSqlError>
 #include <QDebug>
@@ -118,7 +120,8 @@ bool ProcessTgBigDataDAO::insertBatch(QList<ProcessTgBigData>& processTgBigDataL
                 return false;
             }
         }
-        return true;
+        // 目录行维护失败时返回 false，由持有事务的调用方回滚
+        return SampleDataSummaryDAO(db).refreshRows(processTgBigDataList, DataType::PROCESS_TG_BIG);
     }
 
     QVariantList sampleIds, serialNos, temperatures, weights, tgValues, dtgValues, sourceNames;
@@ -142,7 +145,8 @@ bool ProcessTgBigDataDAO::insertBatch(QList<ProcessTgBigData>& processTgBigDataL
         WARNING_LOG << "Batch insert ProcessTgBigData failed:" << query.lastError().text();
         return false;
     }
-    return true;
+    // 目录行维护失败时返回 false，由持有事务的调用方回滚
+    return SampleDataSummaryDAO(db).refreshRows(processTgBigDataList, DataType::PROCESS_TG_BIG);
 }
 
 QList<ProcessTgBigData> ProcessTgBigDataDAO::getBySampleId(int sampleId) {
@@ -176,7 +180,16 @@ bool ProcessTgBigDataDAO::removeBySampleId(int sampleId) {
     query.prepare(sql);
     query.bindValue(":sample_id", sampleId);
 
-    if (query.exec()) return true;
+    if (query.exec()) {
+        // 目录行与打包曲线随明细一并删除（导入时由 Worker 在同一事务内重写）；失败时返回 false，由调用方回滚
+        CurveBlobDAO blobDao(db);
+        if (!SampleDataSummaryDAO(db).remove(sampleId, DataType::PROCESS_TG_BIG)
+            || (blobDao.isAvailable() && !blobDao.remove(sampleId, DataType::PROCESS_TG_BIG))) {
+            WARNING_LOG << "Remove ProcessTgBigData summary/blob failed for sample_id" << sampleId;
+            return false;
+        }
+        return true;
+    }
     WARNING_LOG << "Remove ProcessTgBigData by sample_id failed:" << query.lastError().text();
     return false;
 }
@@ -8,11 +8,18 @@
 #include "Logger.h" 
 #include "core/entities/SingleTobaccoSample.h"
 #include "data_access/DatabaseManager.h"
+#include "data_access/CurveBlobDAO.h"
+#include "data_access/SampleDataSummaryDAO.h"
 #include "core/sql/SqlConfigLoader.h"
 #include "common.h"
 
 SampleDAO::SampleDAO() {}
 
+QSqlDatabase SampleDAO::database() const
+{
+    return m_db.isValid() ? m_db : DatabaseManager::instance().database();
+}
+
 QList<SingleTobaccoSample*> SampleDAO::fetchParallelSamplesInfo(const QString &projectName, const QString &batchCode, 
      const QString &shortCode,
      const int &parallelNo, 
@@ -20,7 +27,7 @@ QList<SingleTobaccoSample*> SampleDAO::fetchParallelSamplesInfo(const QString &p
 {
     DEBUG_LOG << "projectName: " << projectName << "batchCode: " << batchCode << "shortCode: " << shortCode;
     QList<SingleTobaccoSample*> samples;
-    QSqlQuery query(DatabaseManager::instance().database());
+    QSqlQuery query(database());
 
 
     // 使用SqlConfigLoader获取SQL语句，如果配置中不存在则使用默认SQL
@@ -71,58 +78,88 @@ QList<SingleTobaccoSample*> SampleDAO::fetchParallelSamplesInfo(const QString &p
 }
 
 
-QVector<QPointF> SampleDAO::fetchChartDataForSample(int sampleId, const DataType dataType, QString &error)
+namespace {
+
+// 明细查询：sql_config.json 中的配置键与内置默认 SQL
+struct PointQuery
 {
-    QVector<QPointF> data;
-    QSqlQuery query(DatabaseManager::instance().database());
-    QString queryString;
-    QString xColumn, yColumn;
+    QString configuredSql;
+    QString defaultSql;
+
+    QString sql() const { return configuredSql.isEmpty() ? defaultSql : configuredSql; }
+    // curve_blob 按内置查询的结果打包；站点改写了查询时只能读明细表，否则读到的数据与配置不一致
+    bool isDefault() const { return configuredSql.isEmpty() || configuredSql.simplified() == defaultSql.simplified(); }
+};
 
-    // 根据数据类型，选择要查询的表和列
+bool pointColumns(DataType dataType, QString& tableName, QString& xColumn, QString& yColumn, QString& keySuffix)
+{
     if (dataType == DataType::TG_BIG) {
-        queryString = SqlConfigLoader::getInstance().getSqlOperation("SampleDAO", "select_data_by_sample_id_big").sql;
-        if (queryString.isEmpty()) {
-            queryString = "SELECT serial_no, weight FROM tg_big_data WHERE sample_id = :sample_id ORDER BY serial_no";
-        }
-        xColumn = "serial_no";
-        yColumn = "weight";
+        tableName = "tg_big_data"; xColumn = "serial_no"; yColumn = "weight"; keySuffix = "big";
     } else if (dataType == DataType::TG_SMALL) {
-        queryString = SqlConfigLoader::getInstance().getSqlOperation("SampleDAO", "select_data_by_sample_id_small").sql;
-        if (queryString.isEmpty()) {
-            queryString = "SELECT temperature, dtg_value FROM tg_small_data WHERE sample_id = :sample_id ORDER BY temperature";
-        }
-        xColumn = "temperature";
-        yColumn = "dtg_value";
+        tableName = "tg_small_data"; xColumn = "temperature"; yColumn = "dtg_value"; keySuffix = "small";
     } else if (dataType == DataType::TG_SMALL_RAW) {
-        queryString = SqlConfigLoader::getInstance().getSqlOperation("SampleDAO", "select_data_by_sample_id_small_raw").sql;
-        if (queryString.isEmpty()) {
-            // 原始小热重：以温度-重量为基础（后续裁剪/归一化/平滑/微分都基于此原始曲线）
-            queryString = "SELECT temperature, weight FROM tg_small_raw_data WHERE sample_id = :sample_id ORDER BY temperature";
-        }
-        xColumn = "temperature";
-        yColumn = "weight";
-    // } else if (dataType == DataType::CHROMATOGRAPHY || dataType == DataType::GC) {
-       } else if (dataType == DataType::CHROMATOGRAM) {
-        queryString = SqlConfigLoader::getInstance().getSqlOperation("SampleDAO", "select_data_by_sample_id_chrom").sql;
-        if (queryString.isEmpty()) {
-            queryString = "SELECT retention_time, response_value FROM chromatography_data WHERE sample_id = :sample_id ORDER BY retention_time";
-        }
-        xColumn = "retention_time";
-        yColumn = "response_value";
+        // 原始小热重：以温度-重量为基础（后续裁剪/归一化/平滑/微分都基于此原始曲线）
+        tableName = "tg_small_raw_data"; xColumn = "temperature"; yColumn = "weight"; keySuffix = "small_raw";
+    } else if (dataType == DataType::CHROMATOGRAM) {
+        tableName = "chromatography_data"; xColumn = "retention_time"; yColumn = "response_value"; keySuffix = "chrom";
     } else if (dataType == DataType::PROCESS_TG_BIG) {
-        queryString = SqlConfigLoader::getInstance().getSqlOperation("SampleDAO", "select_data_by_sample_id_process_big").sql;
-        if (queryString.isEmpty()) {
-            queryString = "SELECT serial_no, weight FROM process_tg_big_data WHERE sample_id = :sample_id ORDER BY serial_no";
-        }
-        xColumn = "serial_no";
-        yColumn = "weight";
+        tableName = "process_tg_big_data"; xColumn = "serial_no"; yColumn = "weight"; keySuffix = "process_big";
     } else {
+        return false;
+    }
+    return true;
+}
+
+// 单样本查询（select_data_by_sample_id_*）：列顺序 x, y
+bool singlePointQuery(DataType dataType, PointQuery& query)
+{
+    QString tableName, xColumn, yColumn, keySuffix;
+    if (!pointColumns(dataType, tableName, xColumn, yColumn, keySuffix)) return false;
+    query.configuredSql = SqlConfigLoader::getInstance()
+                              .getSqlOperation("SampleDAO", "select_data_by_sample_id_" + keySuffix).sql;
+    query.defaultSql = QString("SELECT %2, %3 FROM %1 WHERE sample_id = :sample_id ORDER BY %2")
+                           .arg(tableName, xColumn, yColumn);
+    return true;
+}
+
+// 批量查询（select_data_by_sample_ids_*）：以 {sample_ids} 作为 ID 列表占位符，列顺序 sample_id, x, y 且按 sample_id 分组有序
+bool bulkPointQuery(DataType dataType, PointQuery& query)
+{
+    QString tableName, xColumn, yColumn, keySuffix;
+    if (!pointColumns(dataType, tableName, xColumn, yColumn, keySuffix)) return false;
+    query.configuredSql = SqlConfigLoader::getInstance()
+                              .getSqlOperation("SampleDAO", "select_data_by_sample_ids_" + keySuffix).sql;
+    query.defaultSql = QString("SELECT sample_id, %2, %3 FROM %1 WHERE sample_id IN ({sample_ids}) ORDER BY sample_id, %2")
+                           .arg(tableName, xColumn, yColumn);
+    return true;
+}
+
+} // namespace
+
+QVector<QPointF> SampleDAO::fetchChartDataForSample(int sampleId, const DataType dataType, QString &error)
+{
+    QVector<QPointF> data;
+
+    PointQuery pointQuery;
+    if (!singlePointQuery(dataType, pointQuery)) {
         error = QString("未知的数据类型: %1").arg(dataType);
         DEBUG_LOG << "Unknown data type:" << dataType;
         return data;
     }
 
-    query.prepare(queryString);
+    // 优先读取打包存储：单行主键查询（只读，未命中时不回填，见 backfillCurveBlobs）
+    QSqlDatabase db = database();
+    if (pointQuery.isDefault()) {
+        QVector<double> blobX, blobY;
+        if (CurveBlobDAO(db).load(sampleId, dataType, blobX, blobY)) {
+            data.reserve(blobX.size());
+            for (int i = 0; i < blobX.size(); ++i) data.append(QPointF(blobX[i], blobY[i]));
+            return data;
+        }
+    }
+
+    QSqlQuery query(db);
+    query.prepare(pointQuery.sql());
     query.bindValue(":sample_id", sampleId);
 
     if (!query.exec()) {
@@ -149,6 +186,135 @@ QVector<QPointF> SampleDAO::fetchChartDataForSample(int sampleId, const DataType
 
 
 
+QHash<int, SampleCurveColumns> SampleDAO::fetchChartDataForSamples(const QList<int> &sampleIds, const DataType dataType, QString &error)
+{
+    if (sampleIds.isEmpty()) return QHash<int, SampleCurveColumns>();
+
+    PointQuery pointQuery;
+    if (!bulkPointQuery(dataType, pointQuery)) {
+        error = QString("未知的数据类型: %1").arg(dataType);
+        DEBUG_LOG << "Unknown data type:" << dataType;
+        return QHash<int, SampleCurveColumns>();
+    }
+    if (!pointQuery.isDefault()) return fetchPointRowsForSamples(sampleIds, pointQuery.sql(), error);
+
+    // 优先读取打包存储，未命中的样本再走明细表（只读，未命中时不回填）
+    QSqlDatabase db = database();
+    QHash<int, SampleCurveColumns> curves = CurveBlobDAO(db).loadMany(sampleIds, dataType);
+    QList<int> missingIds;
+    for (int sampleId : sampleIds) {
+        if (!curves.contains(sampleId)) missingIds.append(sampleId);
+    }
+    if (missingIds.isEmpty()) return curves;
+
+    const QHash<int, SampleCurveColumns> pointCurves = fetchPointRowsForSamples(missingIds, pointQuery.sql(), error);
+    if (pointCurves.isEmpty()) return QHash<int, SampleCurveColumns>(); // 明细查询失败
+
+    for (auto it = pointCurves.constBegin(); it != pointCurves.constEnd(); ++it) curves.insert(it.key(), it.value());
+    return curves;
+}
+
+int SampleDAO::backfillCurveBlobs(const DataType dataType, QString &error)
+{
+    QSqlDatabase db = database();
+    CurveBlobDAO blobDao(db);
+    if (!blobDao.isAvailable()) {
+        error = QStringLiteral("curve_blob 表不存在，请先执行 sql/migrations/add_curve_blob.sql");
+        return 0;
+    }
+
+    QString tableName, xColumn, yColumn, keySuffix;
+    PointQuery pointQuery;
+    if (!pointColumns(dataType, tableName, xColumn, yColumn, keySuffix) || !bulkPointQuery(dataType, pointQuery)) {
+        error = QString("未知的数据类型: %1").arg(dataType);
+        return 0;
+    }
+
+    // 迁移回填的文本编码行先升级为二进制
+    blobDao.upgradeTextRows(dataType);
+
+    // 有目录表时按目录行比对（每样本一行），否则扫描明细表的样本列
+    QSqlQuery query(db);
+    if (SampleDataSummaryDAO(db).isAvailable()) {
+        query.prepare("SELECT d.sample_id FROM sample_data_summary d "
+                      "LEFT JOIN curve_blob c ON c.sample_id = d.sample_id AND c.data_type = :data_type "
+                      "WHERE d.data_type = :data_type AND c.sample_id IS NULL");
+    } else {
+        query.prepare(QString("SELECT DISTINCT d.sample_id FROM %1 d "
+                              "LEFT JOIN curve_blob c ON c.sample_id = d.sample_id AND c.data_type = :data_type "
+                              "WHERE c.sample_id IS NULL").arg(tableName));
+    }
+    query.bindValue(":data_type", CurveBlobDAO::dataTypeKey(dataType));
+    if (!query.exec()) {
+        error = query.lastError().text();
+        return 0;
+    }
+    QList<int> missingIds;
+    while (query.next()) missingIds.append(query.value(0).toInt());
+
+    // 分块读取明细（始终用内置查询：打包存储只在内置查询生效时被读取）并逐样本写入
+    int filled = 0;
+    const int chunkSize = 100;
+    for (int begin = 0; begin < missingIds.size(); begin += chunkSize) {
+        const QHash<int, SampleCurveColumns> curves =
+            fetchPointRowsForSamples(missingIds.mid(begin, chunkSize), pointQuery.defaultSql, error);
+        for (auto it = curves.constBegin(); it != curves.constEnd(); ++it) {
+            if (!it->x.isEmpty() && blobDao.saveIfMissing(it.key(), dataType, it->x, it->y)) ++filled;
+        }
+    }
+    INFO_LOG << "curve_blob 回填完成:" << tableName << filled << "/" << missingIds.size();
+    return filled;
+}
+
+QHash<int, SampleCurveColumns> SampleDAO::fetchPointRowsForSamples(const QList<int> &sampleIds, const QString &sqlTemplate, QString &error)
+{
+    QHash<int, SampleCurveColumns> curves;
+    if (sampleIds.isEmpty()) return curves;
+
+    // 先为每个请求的样本占位，保证调用方可区分“无数据”与“未请求”
+    for (int sampleId : sampleIds) curves.insert(sampleId, SampleCurveColumns());
+
+    // ID 列表分块，避免单条 SQL 过长
+    const int chunkSize = 500;
+    for (int begin = 0; begin < sampleIds.size(); begin += chunkSize) {
+        QStringList idList;
+        const int end = qMin(begin + chunkSize, sampleIds.size());
+        for (int i = begin; i < end; ++i) idList << QString::number(sampleIds.at(i));
+
+        QSqlQuery query(database());
+        query.setForwardOnly(true); // 流式读取，不在客户端缓存可回滚结果集
+        if (!query.exec(QString(sqlTemplate).replace("{sample_ids}", idList.join(',')))) {
+            error = query.lastError().text();
+            WARNING_LOG << "Failed to bulk fetch chart data:" << error;
+            return QHash<int, SampleCurveColumns>();
+        }
+
+        int currentId = -1;
+        SampleCurveColumns* current = nullptr;
+        while (query.next()) {
+            const int sampleId = query.value(0).toInt();
+            if (sampleId != currentId || !current) {
+                currentId = sampleId;
+                auto it = curves.find(sampleId);
+                current = (it != curves.end()) ? &it.value() : nullptr;
+                if (!current) continue;
+            }
+            bool okX, okY;
+            const double x = query.value(1).toDouble(&okX);
+            const double y = query.value(2).toDouble(&okY);
+            if (okX && okY) {
+                current->x.append(x);
+                current->y.append(y);
+            } else {
+                WARNING_LOG << "Data conversion error for sample ID" << sampleId << "at row" << query.at();
+            }
+        }
+    }
+
+    return curves;
+}
+
+
 QList<QVariantMap> SampleDAO::getSamplesByDataType(const QString &dataType)
 {
     QString tableName;
@@ -164,7 +330,7 @@ QList<QVariantMap> SampleDAO::getSamplesByDataType(const QString &dataType)
         return {}; // 未知数据类型
     }
 
-    QSqlQuery query(DatabaseManager::instance().database());
+    QSqlQuery query(database());
     
     // 使用SqlConfigLoader获取SQL语句，如果配置中不存在则使用默认SQL
     QString sqlKey;
@@ -217,7 +383,7 @@ QList<QVariantMap> SampleDAO::getSamplesByDataType(const QString &dataType)
 QVariantMap SampleDAO::getSampleById(int sampleId)
 {
     QVariantMap result;
-    QSqlQuery query(DatabaseManager::instance().database());
+    QSqlQuery query(database());
     
     // 使用SqlConfigLoader获取SQL语句，如果配置中不存在则使用默认SQL
     QString sql = SqlConfigLoader::getInstance().getSqlOperation("SampleDAO", "select_sample_by_id").sql;
@@ -260,7 +426,7 @@ QVariantMap SampleDAO::getSampleById(int sampleId)
         }
 
         if (needFetchTime) {
-            QSqlQuery timeQuery(DatabaseManager::instance().database());
+            QSqlQuery timeQuery(database());
             QString timeSql = QStringLiteral(
                 "SELECT detect_date, created_at "
                 "FROM single_tobacco_sample WHERE id = :sample_id");
@@ -7,14 +7,25 @@
 #include <QVector>
 #include <QPointF>
 #include <QVariantMap>
+#include <QHash>
+#include <QSqlDatabase>
 #include "common.h"
 
 class SingleTobaccoSample;
 
+// 单个样本的列式原始曲线（x/y 分列存放，可直接用于构造 Curve）
+struct SampleCurveColumns
+{
+    QVector<double> x;
+    QVector<double> y;
+};
+
 class SampleDAO
 {
 public:
     SampleDAO();
+    // 使用指定连接（如并行批处理中的线程专用连接）
+    explicit SampleDAO(const QSqlDatabase& db) : m_db(db) {}
 
     // 根据批次ID, short_code, 获取所有平行样的样本信息
     QList<SingleTobaccoSample*> fetchParallelSamplesInfo(const QString &projectName, const QString &batchCode, 
@@ -23,10 +34,33 @@ public:
     // 根据样本ID(sample_id)和数据类型，获取图表数据
     QVector<QPointF> fetchChartDataForSample(int sampleId, const DataType dataType, QString& error);
 
+    /**
+     * @brief 批量获取多个样本的图表数据
+     * 以 sample_id IN (...) 单条查询流式读取，按 sample_id 拆分为列数组；
+     * 每个请求的样本都会出现在结果中（无数据时为空列）。查询失败时返回空表并设置 error。
+     */
+    QHash<int, SampleCurveColumns> fetchChartDataForSamples(const QList<int>& sampleIds, const DataType dataType, QString& error);
+
+    /**
+     * @brief 将明细表中尚无打包存储的样本回填到 curve_blob，并把迁移产生的文本编码行升级为二进制
+     * 读取路径不写库，回填只在此维护操作中进行（启动时由 AppInitializer 在后台执行一次）；
+     * 已有打包行不覆盖，可与导入并发。
+     * @return 成功回填的样本数；curve_blob 表不存在时返回 0 并设置 error
+     */
+    int backfillCurveBlobs(const DataType dataType, QString& error);
+
     QList<QVariantMap> getSamplesByDataType(const QString &dataType);
     
     // 根据样本ID获取样本信息
     QVariantMap getSampleById(int sampleId);
+
+private:
+    // 未指定连接时回退到 DatabaseManager 的主连接
+    QSqlDatabase database() const;
+    // 按给定 SQL 模板从逐点明细表批量读取（不经过 curve_blob）
+    QHash<int, SampleCurveColumns> fetchPointRowsForSamples(const QList<int>& sampleIds, const QString& sqlTemplate, QString& error);
+
+    QSqlDatabase m_db; // 数据库连接
 };
 
 #endif // SAMPLEDATAACCESS_H
@@ -0,0 +1,131 @@
+#include "SampleDataSummaryDAO.h"
+#include "CurveBlobDAO.h"
+#include "DatabaseConnector.h"
+#include "Logger.h"
+#include <QSqlError>
+#include <QSqlQuery>
+
+namespace {
+
+// 各明细表的 x / y 列（与 curve_blob 回填及读取查询一致）
+static QPair<QString, QString> pointColumns(DataType dataType)
+{
+    switch (dataType) {
+    case DataType::TG_BIG:         return {QStringLiteral("serial_no"), QStringLiteral("weight")};
+    case DataType::TG_SMALL:       return {QStringLiteral("temperature"), QStringLiteral("dtg_value")};
+    case DataType::TG_SMALL_RAW:   return {QStringLiteral("temperature"), QStringLiteral("weight")};
+    case DataType::CHROMATOGRAM:   return {QStringLiteral("retention_time"), QStringLiteral("response_value")};
+    case DataType::PROCESS_TG_BIG: return {QStringLiteral("serial_no"), QStringLiteral("weight")};
+    }
+    return {};
+}
+
+} // namespace
+
+QString SampleDataSummaryDAO::pointTable(DataType dataType)
+{
+    switch (dataType) {
+    case DataType::TG_BIG:         return QStringLiteral("tg_big_data");
+    case DataType::TG_SMALL:       return QStringLiteral("tg_small_data");
+    case DataType::TG_SMALL_RAW:   return QStringLiteral("tg_small_raw_data");
+    case DataType::CHROMATOGRAM:   return QStringLiteral("chromatography_data");
+    case DataType::PROCESS_TG_BIG: return QStringLiteral("process_tg_big_data");
+    }
+    return QString();
+}
+
+QSqlDatabase SampleDataSummaryDAO::database() const
+{
+    return m_db.isValid() ? m_db : DatabaseConnector::getInstance().getDatabase();
+}
+
+bool SampleDataSummaryDAO::isAvailable()
+{
+    return SchemaProbeCache::lookup(database(), QStringLiteral("sample_data_summary"), [](QSqlDatabase& db) {
+        QSqlQuery q(db);
+        bool found = false;
+        if (q.exec("SELECT 1 FROM information_schema.TABLES WHERE TABLE_SCHEMA = DATABASE() "
+                   "AND TABLE_NAME = 'sample_data_summary'"))
+            found = q.next();
+        if (!found && q.exec("SHOW TABLES LIKE 'sample_data_summary'"))
+            found = q.next();
+        DEBUG_LOG << "sample_data_summary 表存在:" << found << db.connectionName();
+        return found;
+    });
+}
+
+bool SampleDataSummaryDAO::refresh(int sampleId, DataType dataType)
+{
+    if (!isAvailable()) return true; // 未执行迁移：无目录需维护
+
+    // 单条 upsert 覆盖目录行，不经过“先删后插”的中间状态；只扫描该样本的明细行（sample_id 索引），
+    // 指纹与迁移回填使用同一表达式。MIN(import_attributes)：同一样本各行导入属性相同；ANY_VALUE() 需 MySQL 5.7+，MariaDB 不支持
+    const QString table = pointTable(dataType);
+    const QPair<QString, QString> xy = pointColumns(dataType);
+    QSqlQuery query(database());
+    query.prepare(QStringLiteral(
+        "INSERT INTO sample_data_summary (sample_id, data_type, point_count, x_min, x_max, checksum, import_attributes) "
+        "SELECT :sample_id, :data_type, COUNT(*), MIN(%2), MAX(%2), BIT_XOR(CRC32(CONCAT_WS(',', %2, %3))), "
+        "MIN(import_attributes) "
+        "FROM %1 WHERE sample_id = :point_sample_id HAVING COUNT(*) > 0 "
+        "ON DUPLICATE KEY UPDATE point_count = VALUES(point_count), x_min = VALUES(x_min), x_max = VALUES(x_max), "
+        "checksum = VALUES(checksum), import_attributes = VALUES(import_attributes)")
+                      .arg(table, xy.first, xy.second));
+    query.bindValue(":sample_id", sampleId);
+    query.bindValue(":data_type", CurveBlobDAO::dataTypeKey(dataType));
+    query.bindValue(":point_sample_id", sampleId);
+    if (!query.exec()) {
+        WARNING_LOG << "sample_data_summary 汇总失败, sample_id=" << sampleId << ":" << query.lastError().text();
+        return false;
+    }
+
+    // 明细为空时删除目录行
+    QSqlQuery cleanup(database());
+    cleanup.prepare(QStringLiteral(
+        "DELETE FROM sample_data_summary WHERE sample_id = :sample_id AND data_type = :data_type "
+        "AND NOT EXISTS (SELECT 1 FROM %1 WHERE sample_id = :point_sample_id)").arg(table));
+    cleanup.bindValue(":sample_id", sampleId);
+    cleanup.bindValue(":data_type", CurveBlobDAO::dataTypeKey(dataType));
+    cleanup.bindValue(":point_sample_id", sampleId);
+    if (!cleanup.exec()) {
+        WARNING_LOG << "sample_data_summary 清理失败, sample_id=" << sampleId << ":" << cleanup.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool SampleDataSummaryDAO::refresh(const QSet<int>& sampleIds, DataType dataType)
+{
+    bool ok = true;
+    for (int sampleId : sampleIds) ok = refresh(sampleId, dataType) && ok;
+    return ok;
+}
+
+bool SampleDataSummaryDAO::remove(int sampleId, DataType dataType)
+{
+    if (!isAvailable()) return true;
+
+    QSqlQuery query(database());
+    query.prepare("DELETE FROM sample_data_summary WHERE sample_id = :sample_id AND data_type = :data_type");
+    query.bindValue(":sample_id", sampleId);
+    query.bindValue(":data_type", CurveBlobDAO::dataTypeKey(dataType));
+    if (!query.exec()) {
+        WARNING_LOG << "sample_data_summary 删除失败, sample_id=" << sampleId << ":" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+bool SampleDataSummaryDAO::removeAll(DataType dataType)
+{
+    if (!isAvailable()) return true;
+
+    QSqlQuery query(database());
+    query.prepare("DELETE FROM sample_data_summary WHERE data_type = :data_type");
+    query.bindValue(":data_type", CurveBlobDAO::dataTypeKey(dataType));
+    if (!query.exec()) {
+        WARNING_LOG << "sample_data_summary 清空失败:" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
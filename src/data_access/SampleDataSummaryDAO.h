@@ -0,0 +1,54 @@
+#ifndef SAMPLEDATASUMMARYDAO_H
+#define SAMPLEDATASUMMARYDAO_H
+
+#include <QList>
+#include <QSet>
+#include <QSqlDatabase>
+#include <QString>
+
+#include "common.h"
+
+/**
+ * @brief 样本数据目录（sample_data_summary 表）访问对象
+ *
+ * 每个 (样本, 数据类型) 一行：点数、x 范围、明细内容指纹、导入属性与导入时间。
+ * 导航树只需知道"哪些样本有哪类数据"，查询目录表即可，不必对逐点明细表做 DISTINCT 关联。
+ * 目录行由明细 DAO 在写入/删除明细后、在同一连接上同步维护；明细 DAO 不自行开启事务（导入 Worker 已在该连接上开启），
+ * 维护失败时明细 DAO 返回 false，由持有事务的调用方回滚，明细与目录一同生效或一同撤销；
+ * 删除样本时由外键级联删除。表不存在（未执行迁移）时 isAvailable() 返回 false，调用方回退到明细表。
+ */
+class SampleDataSummaryDAO {
+public:
+    SampleDataSummaryDAO() = default;
+    explicit SampleDataSummaryDAO(QSqlDatabase& db) : m_db(db) {}
+
+    // sample_data_summary 表是否存在（按连接缓存检测结果，见 SchemaProbeCache）
+    bool isAvailable();
+
+    // 按明细表重新汇总一个样本的一类数据（单条 upsert）；明细为空时删除目录行。
+    // 以下维护操作在表不存在时视为无需维护并返回 true
+    bool refresh(int sampleId, DataType dataType);
+    bool refresh(const QSet<int>& sampleIds, DataType dataType);
+
+    // 明细 DAO 批量写入后使用：汇总列表中出现的所有样本
+    template <typename Row>
+    bool refreshRows(const QList<Row>& rows, DataType dataType)
+    {
+        QSet<int> sampleIds;
+        for (const Row& row : rows) sampleIds.insert(row.getSampleId());
+        return refresh(sampleIds, dataType);
+    }
+
+    bool remove(int sampleId, DataType dataType);
+    bool removeAll(DataType dataType);
+
+    // 数据类型对应的明细表名（x/y 列与 curve_blob 一致）
+    static QString pointTable(DataType dataType);
+
+private:
+    QSqlDatabase database() const;
+
+    QSqlDatabase m_db; // 数据库连接
+};
+
+#endif // SAMPLEDATASUMMARYDAO_H
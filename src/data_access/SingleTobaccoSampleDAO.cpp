@@ -566,6 +566,58 @@ SampleIdentifier SingleTobaccoSampleDAO::getSampleIdentifierById(int sampleId)
 
 
 
+QHash<int, SampleIdentifier> SingleTobaccoSampleDAO::getSampleIdentifiersByIds(const QList<int>& sampleIds)
+{
+    QHash<int, SampleIdentifier> result;
+    if (sampleIds.isEmpty()) return result;
+
+    QSqlDatabase db = m_db.isValid() ? m_db : DatabaseConnector::getInstance().getDatabase();
+    if (!db.isOpen()) {
+        qWarning() << "Database not open for getSampleIdentifiersByIds operation.";
+        return result;
+    }
+
+    // 配置中的 SQL 以 {sample_ids} 作为 ID 列表占位符
+    QString sql = SqlConfigLoader::getInstance()
+                      .getSqlOperation("SingleTobaccoSampleDAO", "getSampleIdentifiersByIds")
+                      .sql;
+    if (sql.isEmpty()) {
+        sql = R"(
+            SELECT s.id, s.project_name, b.batch_code, s.short_code, s.parallel_no
+            FROM single_tobacco_sample AS s
+            LEFT JOIN tobacco_batch AS b ON s.batch_id = b.id
+            WHERE s.id IN ({sample_ids})
+        )";
+    }
+
+    // ID 列表分块，避免单条 SQL 过长（与 SampleDAO::fetchChartDataForSamples 一致）
+    const int chunkSize = 500;
+    for (int begin = 0; begin < sampleIds.size(); begin += chunkSize) {
+        QStringList idList;
+        const int end = qMin(begin + chunkSize, sampleIds.size());
+        for (int i = begin; i < end; ++i) idList << QString::number(sampleIds.at(i));
+
+        QSqlQuery query(db);
+        query.setForwardOnly(true);
+        if (!query.exec(QString(sql).replace("{sample_ids}", idList.join(',')))) {
+            qWarning() << "Query failed:" << query.lastError().text();
+            return QHash<int, SampleIdentifier>();
+        }
+
+        while (query.next()) {
+            SampleIdentifier identifier;
+            identifier.sampleId    = query.value("id").toInt();
+            identifier.projectName = query.value("project_name").toString();
+            identifier.batchCode   = query.value("batch_code").toString();
+            identifier.shortCode   = query.value("short_code").toString();
+            identifier.parallelNo  = query.value("parallel_no").toInt();
+            result.insert(identifier.sampleId, identifier);
+        }
+    }
+
+    return result;
+}
+
 QList<SampleIdentifier> SingleTobaccoSampleDAO::getSampleIdentifiersByProjectAndBatch(
     const QString& projectName,
     const QString& batchCode, 
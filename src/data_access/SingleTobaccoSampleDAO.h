@@ -6,6 +6,7 @@
 #include "SingleTobaccoSampleData.h"
 #include <QList>
 #include <QMap>
+#include <QHash>
 #include <QVariant>
 #include <QSqlQuery>
 
@@ -79,6 +80,8 @@ public:
     QList<SingleTobaccoSampleData> queryByProjectNameAndBatchCodeAndShortCodeAndParallelNo(
     const QString& projectName, const QString& batchCode, const QString& shortCode, int parallelNo);
     SampleIdentifier getSampleIdentifierById(int sampleId);
+    // 批量获取样本标识符（单条 IN 查询），键为样本ID；不存在的ID不出现在结果中
+    QHash<int, SampleIdentifier> getSampleIdentifiersByIds(const QList<int>& sampleIds);
 
     
     QList<SampleIdentifier> getSampleIdentifiersByProjectAndBatch(const QString& projectName, const QString& batchCode, const BatchType batchType);
@@ -1,5 +1,7 @@
 #include "TgBigDataDAO.h"
 #include "DatabaseConnector.h" // 引入 DatabaseConnector 获取数据库连接
+#include "CurveBlobDAO.h"
+#include "SampleDataSummaryDAO.h"
 #include "core/sql/SqlConfigLoader.h"
 #include <QSqlError>
 #include <QDebug>
@@ -145,7 +147,8 @@ bool TgBigDataDAO::insertBatch(QList<TgBigData>& tgBigDataList) {
             }
         }
         DEBUG_LOG << "Batch insert TgBigData successful (sequential with import_attributes), rows:" << tgBigDataList.size();
-        return true;
+        // 目录行维护失败时返回 false，由持有事务的调用方回滚
+        return SampleDataSummaryDAO(db).refreshRows(tgBigDataList, DataType::TG_BIG);
     }
 
     QVariantList sampleIds, serialNos, temperatures, weights, tgValues, dtgValues, sourceNames;
@@ -169,7 +172,8 @@ bool TgBigDataDAO::insertBatch(QList<TgBigData>& tgBigDataList) {
 
     if (query.execBatch()) {
         DEBUG_LOG << "Batch insert TgBigData successful, inserted" << tgBigDataList.size() << "rows.";
-        return true;
+        // 目录行维护失败时返回 false，由持有事务的调用方回滚
+        return SampleDataSummaryDAO(db).refreshRows(tgBigDataList, DataType::TG_BIG);
     }
     WARNING_LOG << "Batch insert TgBigData failed:" << query.lastError().text();
     return false;
@@ -231,6 +235,13 @@ bool TgBigDataDAO::removeBySampleId(int sampleId) {
     query.bindValue(":sample_id", sampleId);
 
     if (query.exec()) {
+        // 目录行与打包曲线随明细一并删除（导入时由 Worker 在同一事务内重写）；失败时返回 false，由调用方回滚
+        CurveBlobDAO blobDao(db);
+        if (!SampleDataSummaryDAO(db).remove(sampleId, DataType::TG_BIG)
+            || (blobDao.isAvailable() && !blobDao.remove(sampleId, DataType::TG_BIG))) {
+            WARNING_LOG << "Remove TgBigData summary/blob failed for sample_id" << sampleId;
+            return false;
+        }
         DEBUG_LOG << "Removed TgBigData for sample_id" << sampleId << ", affected" << query.numRowsAffected() << "rows.";
         return query.numRowsAffected() > 0;
     } else {
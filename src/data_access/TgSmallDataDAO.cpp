@@ -1,5 +1,7 @@
 #include "TgSmallDataDAO.h"
 #include "DatabaseConnector.h"
+#include "CurveBlobDAO.h"
+#include "SampleDataSummaryDAO.h"
 #include "core/sql/SqlConfigLoader.h"
 #include "Logger.h"
 #include <QSqlError>
@@ -117,7 +119,8 @@ bool TgSmallDataDAO::insertBatch(QList<TgSmallData>& tgSmallDataList) {
             }
         }
         DEBUG_LOG << "Batch insert TgSmallData successful (sequential with import_attributes), rows:" << tgSmallDataList.size();
-        return true;
+        // 目录行维护失败时返回 false，由持有事务的调用方回滚
+        return SampleDataSummaryDAO(db).refreshRows(tgSmallDataList, DataType::TG_SMALL);
     }
 
     QVariantList sampleIds, serialNos, temperatures, weight, tgValues, dtgValues, sourceNames;
@@ -141,7 +144,8 @@ bool TgSmallDataDAO::insertBatch(QList<TgSmallData>& tgSmallDataList) {
 
     if (query.execBatch()) {
         DEBUG_LOG << "Batch insert TgSmallData successful, inserted" << tgSmallDataList.size() << "rows.";
-        return true;
+        // 目录行维护失败时返回 false，由持有事务的调用方回滚
+        return SampleDataSummaryDAO(db).refreshRows(tgSmallDataList, DataType::TG_SMALL);
     }
     WARNING_LOG << "Batch insert TgSmallData failed:" << query.lastError().text();
     return false;
@@ -179,6 +183,13 @@ bool TgSmallDataDAO::removeBySampleId(int sampleId) {
     query.bindValue(":sample_id", sampleId);
 
     if (query.exec()) {
+        // 目录行与打包曲线随明细一并删除（导入时由 Worker 在同一事务内重写）；失败时返回 false，由调用方回滚
+        CurveBlobDAO blobDao(db);
+        if (!SampleDataSummaryDAO(db).remove(sampleId, DataType::TG_SMALL)
+            || (blobDao.isAvailable() && !blobDao.remove(sampleId, DataType::TG_SMALL))) {
+            WARNING_LOG << "Remove TgSmallData summary/blob failed for sample_id" << sampleId;
+            return false;
+        }
         DEBUG_LOG << "Removed TgSmallData for sample_id" << sampleId << ", affected" << query.numRowsAffected() << "rows.";
         return query.numRowsAffected() > 0;
     }
@@ -1,4 +1,5 @@
 #include "DatabaseManager.h"
+#include "DatabaseConnector.h" // SchemaProbeCache
 #include "Logger.h"
 
 DatabaseManager& DatabaseManager::instance()
@@ -41,6 +42,7 @@ bool DatabaseManager::connectToDb(const QString& dbName, const QString& user, co
     }
 
     // 数据库连接成功
+    SchemaProbeCache::forget(m_db.connectionName());
     INFO_LOG << "Database connection successful!";
     return true;
 }
@@ -48,6 +50,7 @@ bool DatabaseManager::connectToDb(const QString& dbName, const QString& user, co
 void DatabaseManager::disconnectFromDb()
 {
     m_db.close();
+    SchemaProbeCache::forget(m_db.connectionName());
     INFO_LOG << "Database connection closed.";
 }
 
@@ -127,6 +127,7 @@ void BatchListDialog::on_deleteButton_clicked()
         QMessageBox::critical(this, "删除失败", "数据库错误：" + error);
         return;
     }
+    emit sampleDataDeleted(-1);
 
     // 删除成功后刷新列表
     int currentModelIndex = ui->modelComboBox->currentIndex();
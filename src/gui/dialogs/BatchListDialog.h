@@ -16,6 +16,10 @@ public:
     explicit BatchListDialog(QWidget* parent = nullptr);
     ~BatchListDialog();
 
+signals:
+    // 删除成功后发出，sampleId < 0 表示影响多个样本，用于清理阶段缓存
+    void sampleDataDeleted(int sampleId);
+
 private slots:
     void onModelChanged(int index);
     // 批次类型切换时，按当前选择刷新批次列表
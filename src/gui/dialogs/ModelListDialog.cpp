@@ -98,6 +98,7 @@ void ModelListDialog::on_deleteButton_clicked()
         QMessageBox::critical(this, "删除失败", "数据库错误或未找到匹配数据：" + error);
         return;
     }
+    emit sampleDataDeleted(-1);
 
     // 删除成功后刷新列表
     loadModels();
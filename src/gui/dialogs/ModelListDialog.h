@@ -12,6 +12,10 @@ public:
     explicit ModelListDialog(QWidget* parent = nullptr);
     ~ModelListDialog();
 
+signals:
+    // 删除成功后发出，sampleId < 0 表示影响多个样本，用于清理阶段缓存
+    void sampleDataDeleted(int sampleId);
+
 private slots:
     // 新增按钮点击，预留后续实现
     void on_addButton_clicked();
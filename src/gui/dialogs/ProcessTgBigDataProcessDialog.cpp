@@ -18,6 +18,7 @@
 #include "xlsxdocument.h"
 #include "gui/views/ChartView.h"
 #include "core/entities/Curve.h"
+#include "core/CurveMathUtils.h"
 #include "SingleTobaccoSampleDAO.h" // 修改: 包含对应的头文件
 #include "ColorUtils.h"
 #include "core/singletons/SampleSelectionManager.h"
@@ -1240,9 +1241,9 @@ QSharedPointer<Curve> ProcessTgBigDataProcessDialog::processCurveForBestSelectio
         clipParams["min_x"] = params.clipMinX_ProcessTgBig;
         clipParams["max_x"] = params.clipMaxX_ProcessTgBig;
         QString error;
-        ProcessingResult res = clippingStep.process({currentCurve.data()}, clipParams, error);
+        ProcessingResult res = clippingStep.process({currentCurve->toCurveValue()}, clipParams, error);
         if (!res.namedCurves.isEmpty() && res.namedCurves.contains("clipped")) {
-            currentCurve = QSharedPointer<Curve>(res.namedCurves.value("clipped").first());
+            currentCurve = QSharedPointer<Curve>::create(res.namedCurves.value("clipped").first());
             currentCurve->setSampleId(sampleId);
         }
     }
@@ -1256,9 +1257,9 @@ QSharedPointer<Curve> ProcessTgBigDataProcessDialog::processCurveForBestSelectio
             normParams["rangeMax"] = 100.0;
         }
         QString error;
-        ProcessingResult res = normalizationStep.process({currentCurve.data()}, normParams, error);
+        ProcessingResult res = normalizationStep.process({currentCurve->toCurveValue()}, normParams, error);
         if (!res.namedCurves.isEmpty() && res.namedCurves.contains("normalized")) {
-            currentCurve = QSharedPointer<Curve>(res.namedCurves.value("normalized").first());
+            currentCurve = QSharedPointer<Curve>::create(res.namedCurves.value("normalized").first());
             currentCurve->setSampleId(sampleId);
         }
     }
@@ -1277,14 +1278,15 @@ QSharedPointer<Curve> ProcessTgBigDataProcessDialog::processCurveForBestSelectio
             smoothParams["window_size"] = sgWin;
             smoothParams["poly_order"] = params.sgPolyOrder;
             smoothParams["derivative_order"] = 0;
+            smoothParams["outputs"] = "smoothed"; // 只计算平滑
             
             if (currentCurve && currentCurve->pointCount() > 0 && 
                 smoothParams["window_size"].toInt() > 2 && 
                 smoothParams["window_size"].toInt() <= currentCurve->pointCount()) {
                 QString error;
-                ProcessingResult res = sgStep.process({currentCurve.data()}, smoothParams, error);
+                ProcessingResult res = sgStep.process({currentCurve->toCurveValue()}, smoothParams, error);
                 if (!res.namedCurves.isEmpty() && res.namedCurves.contains("smoothed")) {
-                    currentCurve = QSharedPointer<Curve>(res.namedCurves.value("smoothed").first());
+                    currentCurve = QSharedPointer<Curve>::create(res.namedCurves.value("smoothed").first());
                     currentCurve->setSampleId(sampleId);
                 }
             }
@@ -1293,9 +1295,9 @@ QSharedPointer<Curve> ProcessTgBigDataProcessDialog::processCurveForBestSelectio
             smoothParams["fraction"] = params.loessSpan;
             if (currentCurve && currentCurve->pointCount() > 2) {
                 QString error;
-                ProcessingResult res = loessStep.process({currentCurve.data()}, smoothParams, error);
+                ProcessingResult res = loessStep.process({currentCurve->toCurveValue()}, smoothParams, error);
                 if (!res.namedCurves.isEmpty() && res.namedCurves.contains("smoothed")) {
-                    currentCurve = QSharedPointer<Curve>(res.namedCurves.value("smoothed").first());
+                    currentCurve = QSharedPointer<Curve>::create(res.namedCurves.value("smoothed").first());
                     currentCurve->setSampleId(sampleId);
                 }
             }
@@ -1316,14 +1318,15 @@ QSharedPointer<Curve> ProcessTgBigDataProcessDialog::processCurveForBestSelectio
             derivParams["window_size"] = dWin;
             derivParams["poly_order"] = params.derivSgPolyOrder;
             derivParams["derivative_order"] = 1;
+            derivParams["outputs"] = "derivative"; // 只计算导数
             
             if (currentCurve && currentCurve->pointCount() > 1 && 
                 derivParams["window_size"].toInt() > 2 && 
                 derivParams["window_size"].toInt() <= currentCurve->pointCount()) {
                 QString error;
-                ProcessingResult res = sgStep.process({currentCurve.data()}, derivParams, error);
+                ProcessingResult res = sgStep.process({currentCurve->toCurveValue()}, derivParams, error);
                 if (res.namedCurves.contains("derivative1")) {
-                    currentCurve = QSharedPointer<Curve>(res.namedCurves.value("derivative1").first());
+                    currentCurve = QSharedPointer<Curve>::create(res.namedCurves.value("derivative1").first());
                     currentCurve->setSampleId(sampleId);
                 }
             }
@@ -2479,24 +2482,12 @@ void ProcessTgBigDataProcessDialog::updatePlotQZH()
                 if (!c.isNull()) { extractX(c); break; }
             }
         }
-        // 线性插值到统一X
+        // 线性插值到统一X（端点外取端点值）；共用 CurveMathUtils 重采样引擎，每条曲线一次归并扫描
         auto interpToCommon = [&](const QVector<QPointF>& srcPts){
-            QVector<double> yOut;
-            if (srcPts.isEmpty() || !xCommonReady) return yOut;
-            yOut.reserve(xCommon.size());
-            QVector<double> sx, sy; sx.reserve(srcPts.size()); sy.reserve(srcPts.size());
-            for (const auto& p : srcPts) { sx.append(p.x()); sy.append(p.y()); }
-            int j = 0;
-            for (double xr : xCommon) {
-                while (j + 1 < sx.size() && sx[j + 1] < xr) j++;
-                if (j >= sx.size() - 1) { yOut.append(sy.last()); continue; }
-                double x1 = sx[j], y1 = sy[j];
-                double x2 = sx[j + 1], y2 = sy[j + 1];
-                double t = (qFuzzyCompare(x1, x2) ? 0.0 : (xr - x1) / (x2 - x1));
-                if (t < 0.0) t = 0.0; if (t > 1.0) t = 1.0;
-                yOut.append(y1 * (1 - t) + y2 * t);
-            }
-            return yOut;
+            if (srcPts.isEmpty() || !xCommonReady) return QVector<double>();
+            return CurveMathUtils::resample(srcPts, xCommon,
+                                            CurveMathUtils::Interpolation::Linear,
+                                            CurveMathUtils::Extrapolation::Clamp);
         };
         // 均值累加器（总是基于统一X进行累加，确保均值意义稳定）
         QVector<double> meanAcc;
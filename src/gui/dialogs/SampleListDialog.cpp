@@ -346,6 +346,7 @@ void SampleListDialog::on_deleteButton_clicked()
         QMessageBox::warning(this, tr("删除失败"), tr("删除样本失败：%1").arg(error));
         return;
     }
+    emit sampleDataDeleted(sampleId);
 
     // 删除成功后刷新当前页签数据
     if (ui->tabWidget->currentIndex() == 0) {
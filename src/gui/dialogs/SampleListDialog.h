@@ -19,6 +19,10 @@ public:
     explicit SampleListDialog(QWidget* parent = nullptr, AppInitializer* appInitializer = nullptr);
     ~SampleListDialog();
 
+signals:
+    // 删除成功后发出，sampleId < 0 表示影响多个样本，用于清理阶段缓存
+    void sampleDataDeleted(int sampleId);
+
 private:
     void setupModels();
     void loadBigSamples();
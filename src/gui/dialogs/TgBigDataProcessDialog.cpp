@@ -1189,29 +1189,17 @@ void TgBigDataProcessDialog::plotWeightedCurvesAndSum(const QList<int>& sampleId
     normW.reserve(weights.size());
     for (double w : weights) normW.push_back(qBound(0.0, w, 1.0) / wSum);
 
-    int commonLen = curves[0].size();
-    for (int i = 1; i < curves.size(); ++i) {
-        commonLen = qMin(commonLen, curves[i].size());
-    }
-    if (commonLen <= 0) {
-        QMessageBox::warning(this, tr("提示"), tr("无可计算交集区间。"));
-        return;
-    }
+    // 以第一条曲线为参考、在各曲线公共 X 区间内对齐（X 不一致的曲线线性插值到参考采样点）
+    const CurveMathUtils::AlignedCurves aligned = CurveMathUtils::alignToCommonGrid(curves);
 
     QVector<QPointF> sumPts;
-    sumPts.reserve(commonLen);
-    for (int idx = 0; idx < commonLen; ++idx) {
-        const double x0 = curves[0][idx].x();
-        bool allSameX = true;
+    sumPts.reserve(aligned.x.size());
+    for (int idx = 0; idx < aligned.x.size(); ++idx) {
         double y = 0.0;
-        for (int c = 0; c < curves.size(); ++c) {
-            if (qAbs(curves[c][idx].x() - x0) > 1e-9) {
-                allSameX = false;
-                break;
-            }
-            y += normW[c] * curves[c][idx].y();
+        for (int c = 0; c < aligned.y.size(); ++c) {
+            y += normW[c] * aligned.y[c][idx];
         }
-        if (allSameX) sumPts.push_back(QPointF(x0, y));
+        sumPts.push_back(QPointF(aligned.x[idx], y));
     }
 
     if (sumPts.isEmpty()) {
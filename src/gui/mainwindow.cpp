@@ -237,6 +237,13 @@ DEBUG_LOG << "m_navigator" << m_navigator;
     connect(m_navigator, &DataNavigator::requestSelectAllSamplesInBatch,
             this, &MainWindow::onSelectAllSamplesInBatch);
 
+    // 导航树删除数据后清理阶段缓存，避免同 ID 样本重新导入时复用旧的处理结果
+    connect(m_navigator, &DataNavigator::sampleDataDeleted,
+            this, [this](int sampleId) {
+                if (m_appInitializer && m_appInitializer->getDataProcessingService())
+                    m_appInitializer->getDataProcessingService()->invalidateStageCache(sampleId);
+            });
+
     connect(m_mdiArea, &QMdiArea::subWindowActivated,
         this, &MainWindow::onSubWindowActivated);
 
@@ -2039,6 +2046,9 @@ void MainWindow::on_actionOpenSingleMaterialData_triggered()
     // TG/小热重/色谱数据归入数据源刷新；工序大热重归入工序数据刷新
     connect(widget, &SingleMaterialDataWidget::dataImportFinished,
             this, [this](const QString& category) {
+                // 导入可能覆盖已有样本的数据：清空阶段缓存，避免复用旧的处理结果
+                if (m_appInitializer && m_appInitializer->getDataProcessingService())
+                    m_appInitializer->getDataProcessingService()->invalidateStageCache();
                 // 根据导入类别刷新导航树，并写入操作日志
                 if (!m_navigator) return; // 防御性检查
                 QString typeName;
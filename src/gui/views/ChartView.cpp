@@ -1,11 +1,16 @@
 #include "ChartView.h"
 #include "Logger.h"
 #include "ColorUtils.h"
+#include "core/CurveMathUtils.h"
 #include "gui/dialogs/WeightedCurveSumDialog.h"
 #include <QMessageBox>
 #include <QMenu>
 #include <QSet>
+#include <QTimer>
+#include <QtConcurrent>
+#include <QFutureWatcher>
 #include <algorithm>
+#include <limits>
     #include <QElapsedTimer>
 // ：图标着色与自定义光标需要的绘图类
 #include <QPainter>
@@ -288,6 +293,9 @@ m_toolBar->hide();
     m_plot->setMouseTracking(true);
     connect(m_plot, &QCustomPlot::mouseMove, this, &ChartView::onPlotMouseMove);
 
+    // 每次重绘前按当前 X 范围为大曲线选择 LOD 级别（缩放/平移/改变窗口大小都会触发重绘）
+    connect(m_plot, &QCustomPlot::beforeReplot, this, &ChartView::updateLodLevels);
+
     DEBUG_LOG;
     // 初始化成员变量
     m_currentToolMode = ChartView::Select;
@@ -313,7 +321,7 @@ m_toolBar->hide();
         if (!m_markOn) return;
         const bool append = (event && (event->modifiers() & Qt::ControlModifier));
         // 更新点击标记与坐标显示；按下 Ctrl 时追加多个点，否则只保留一个点
-        updateClickMarker(graph, dataIndex, append);
+        updateClickMarker(graph, dataIndex, append, event ? event->pos() : QPoint(-1, -1));
         // 避免点击后曲线进入选中态导致颜色变化，立即清除选中状态
         if (m_plot) {
             m_plot->deselectAll();
@@ -358,26 +366,13 @@ void ChartView::addCurve(QSharedPointer<Curve> curve)
     QElapsedTimer timer;  //  先声明
     timer.restart();
 
-    // 1. 从 Curve 对象中提取数据
-    const QVector<QPointF>& dataPoints = curve->data();
-    if (dataPoints.isEmpty()) {
+    if (curve->isEmpty()) {
         qWarning() << "ChartView::addCurve: Curve" << curve->name() << "has no data points.";
         return; // 不绘制空曲线
     }
 
-    
-    
-    QVector<double> xData, yData;
-    xData.reserve(dataPoints.size());
-    yData.reserve(dataPoints.size());
-    for (const auto& point : dataPoints) {
-        xData.append(point.x());
-        yData.append(point.y());
-    }
-
-    // 2. 复用已有的 addGraph 方法进行底层绘图
-    //    addGraph 负责处理所有与 QCustomPlot 相关的细节
-    this->addGraph(xData, yData, curve->name(), curve->color(), curve->sampleId());
+    // 直接共享 Curve 缓存的 QCP 数据容器（零拷贝），不再逐点拆分 X/Y
+    this->addGraphContainer(curve->getDataContainer(), curve->name(), curve->color(), curve->sampleId());
 
     // DEBUG_LOG << "data points. Preparation took" << timer.elapsed() << "ms.";
     // 应用曲线线型（例如虚线），避免覆盖“基线”原点样式
@@ -391,6 +386,33 @@ void ChartView::addCurve(QSharedPointer<Curve> curve)
     }
 }
 
+void ChartView::addCurvesInBatches(const QList<QSharedPointer<Curve>>& curves, int batchSize)
+{
+    m_pendingCurves.append(curves);
+    m_curveBatchSize = qMax(1, batchSize);
+    if (!m_curveBatchScheduled && !m_pendingCurves.isEmpty()) {
+        m_curveBatchScheduled = true;
+        QTimer::singleShot(0, this, &ChartView::addPendingCurveBatch);
+    }
+}
+
+void ChartView::addPendingCurveBatch()
+{
+    m_curveBatchScheduled = false;
+    if (m_pendingCurves.isEmpty()) return; // 期间已 clearGraphs
+
+    const int count = qMin(m_curveBatchSize, m_pendingCurves.size());
+    for (int i = 0; i < count; ++i) {
+        addCurve(m_pendingCurves.takeFirst());
+    }
+    replot();
+
+    if (!m_pendingCurves.isEmpty()) {
+        m_curveBatchScheduled = true;
+        QTimer::singleShot(0, this, &ChartView::addPendingCurveBatch);
+    }
+}
+
 
 // // 提供一个新的、更高效的 addCurve 版本
 // void ChartView::addCurve(QSharedPointer<Curve> curve)
@@ -443,26 +465,50 @@ void ChartView::addGraph(const QVector<double>& x, const QVector<double>& y,
         DEBUG_LOG << "ChartView::addGraph - ERROR: Empty data vectors!";
         return;
     }
-    
-    // 计算数据范围
-    double xMin = *std::min_element(x.begin(), x.end());
-    double xMax = *std::max_element(x.begin(), x.end());
-    double yMin = *std::min_element(y.begin(), y.end());
-    double yMax = *std::max_element(y.begin(), y.end());
-    
-    // DEBUG_LOG << "ChartView::addGraph - X range:" << xMin << "to" << xMax;
-    // DEBUG_LOG << "ChartView::addGraph - Y range:" << yMin << "to" << yMax;
-    
+
+    const int n = qMin(x.size(), y.size());
+    QVector<QCPGraphData> points(n);
+    for (int i = 0; i < n; ++i) {
+        points[i].key = x[i];
+        points[i].value = y[i];
+    }
+    auto container = QSharedPointer<QCPGraphDataContainer>::create();
+    container->set(points); // 未排序时由容器排序，与 QCPGraph::setData(x, y) 相同
+    addGraphContainer(container, name, color, sampleId);
+}
+
+void ChartView::addGraphContainer(const QSharedPointer<QCPGraphDataContainer>& data,
+                                  const QString& name, const QColor& color, int sampleId)
+{
+    if (!m_plot || data.isNull() || data->isEmpty()) {
+        DEBUG_LOG << "ChartView::addGraphContainer - ERROR: null plot or empty data!";
+        return;
+    }
+
+    // 计算数据范围（跳过 NaN）
+    bool foundKey = false, foundValue = false;
+    const QCPRange keyRange = data->keyRange(foundKey);
+    const QCPRange valueRange = data->valueRange(foundValue);
+    if (!foundKey || !foundValue) {
+        DEBUG_LOG << "ChartView::addGraphContainer - ERROR: no finite data points!";
+        return;
+    }
+    const double xMin = keyRange.lower;
+    const double xMax = keyRange.upper;
+    const double yMin = valueRange.lower;
+    const double yMax = valueRange.upper;
+
     // 创建新图表
     QCPGraph* graph = m_plot->addGraph();
     if (!graph) {
         DEBUG_LOG << "ChartView::addGraph - ERROR: Failed to create graph!";
         return;
     }
-    
-    // 设置数据
-    graph->setData(x, y);
-    
+
+    // 设置数据：共享容器，不复制
+    graph->setData(data);
+    m_lodGraphs.remove(graph); // 新曲线可能复用已删除曲线的地址
+
     // 确保坐标轴范围包含所有数据点
     if (m_plot->graphCount() == 1) {
         // 第一条曲线，直接设置范围
@@ -490,6 +536,12 @@ void ChartView::addGraph(const QVector<double>& x, const QVector<double>& y,
         graph->setLineStyle(QCPGraph::lsNone);
         QCPScatterStyle scatter(QCPScatterStyle::ssCircle, QPen(color), QBrush(color), 3);
         graph->setScatterStyle(scatter);
+    } else if (data->size() >= CurveLodPyramid::MinPointsForLod) {
+        // 大曲线：后台构建 min/max 金字塔，完成前先绘制原始数据
+        LodState state;
+        state.full = data;
+        m_lodGraphs.insert(graph, state);
+        buildLodAsync(graph, data);
     }
     
     // 确保曲线可见
@@ -628,6 +680,9 @@ void ChartView::clearGraphs()
     m_plot->clearGraphs();
     m_sampleGraphs.clear();
     m_sampleNames.clear();
+    m_pendingCurves.clear();
+    m_lodGraphs.clear();
+    m_hitIndex.clear();
     clearClickMarker();
 
     // 清空曲线时重置手动X范围锁，避免影响后续非裁剪场景
@@ -640,9 +695,89 @@ void ChartView::clearGraphs()
     DEBUG_LOG << "ChartView::clearGraphs - All graphs cleared";
 }
 
+void ChartView::buildLodAsync(QCPGraph* graph, const QSharedPointer<QCPGraphDataContainer>& data)
+{
+    // 构建期间只读 data；完成时若曲线已删除或数据已替换则丢弃结果
+    QPointer<QCPGraph> graphGuard(graph);
+    auto* watcher = new QFutureWatcher<QSharedPointer<CurveLodPyramid>>(this);
+    connect(watcher, &QFutureWatcher<QSharedPointer<CurveLodPyramid>>::finished, this, [this, watcher, graphGuard, data]() {
+        const QSharedPointer<CurveLodPyramid> pyramid = watcher->result();
+        watcher->deleteLater();
+        if (!m_plot || graphGuard.isNull()) return;
+        auto it = m_lodGraphs.find(graphGuard.data());
+        if (it == m_lodGraphs.end() || it->full != data) return;
+        it->pyramid = pyramid;
+        m_plot->replot(QCustomPlot::rpQueuedReplot);
+    });
+    watcher->setFuture(QtConcurrent::run([data]() {
+        return QSharedPointer<CurveLodPyramid>::create(data);
+    }));
+}
+
+void ChartView::updateLodLevels()
+{
+    if (!m_plot || m_lodGraphs.isEmpty()) return;
+
+    const double pixelWidth = m_plot->axisRect() ? m_plot->axisRect()->width() : 0;
+    for (auto it = m_lodGraphs.begin(); it != m_lodGraphs.end();) {
+        QCPGraph* graph = it.key();
+        LodState& state = it.value();
+        // 曲线已删除，或外部通过 setData 替换了数据：不再管理
+        const QSharedPointer<QCPGraphDataContainer> shown = m_plot->hasPlottable(graph) ? graph->data() : QSharedPointer<QCPGraphDataContainer>();
+        const QSharedPointer<QCPGraphDataContainer> expected = state.pyramid ? state.pyramid->level(state.level) : state.full;
+        if (shown.isNull() || shown != expected) {
+            it = m_lodGraphs.erase(it);
+            continue;
+        }
+
+        int level = 0;
+        if (!m_lodSuspended && state.pyramid && graph->keyAxis())
+            level = state.pyramid->levelFor(graph->keyAxis()->range(), pixelWidth);
+        if (state.pyramid && level != state.level) {
+            graph->setData(state.pyramid->level(level));
+            state.level = level;
+        }
+        ++it;
+    }
+}
+
+void ChartView::setLodSuspended(bool suspended)
+{
+    m_lodSuspended = suspended;
+    updateLodLevels();
+}
+
+const CurveHitIndex& ChartView::hitIndexFor(QCPGraph* graph)
+{
+    // 删除的曲线不会通知 ChartView：索引数多于曲线数时清理一次
+    if (m_hitIndex.size() > m_plot->graphCount()) {
+        for (auto it = m_hitIndex.begin(); it != m_hitIndex.end();) {
+            if (m_plot->hasPlottable(it.key())) ++it;
+            else it = m_hitIndex.erase(it);
+        }
+    }
+
+    const QSharedPointer<QCPGraphDataContainer> data = fullResolutionData(graph);
+    const bool connected = graph->lineStyle() != QCPGraph::lsNone;
+    auto it = m_hitIndex.find(graph);
+    if (it == m_hitIndex.end() || it->isStale(data, connected))
+        it = m_hitIndex.insert(graph, CurveHitIndex(data, connected));
+    return it.value();
+}
+
+QSharedPointer<QCPGraphDataContainer> ChartView::fullResolutionData(QCPGraph* graph) const
+{
+    if (!graph) return QSharedPointer<QCPGraphDataContainer>();
+    auto it = m_lodGraphs.constFind(graph);
+    if (it == m_lodGraphs.constEnd()) return graph->data();
+    // 记录可能已过期（曲线删除后地址被新曲线复用），以当前显示数据核对
+    const QSharedPointer<QCPGraphDataContainer> expected = it->pyramid ? it->pyramid->level(it->level) : it->full;
+    return graph->data() == expected ? it->full : graph->data();
+}
+
 // --- ：更新点击点标记与坐标文本 ---
 // 根据被点击的图形与数据索引，在曲线上标记一个点并显示其坐标
-void ChartView::updateClickMarker(QCPGraph* graph, int dataIndex, bool append)
+void ChartView::updateClickMarker(QCPGraph* graph, int dataIndex, bool append, const QPoint& mousePos)
 {
     if (!m_plot || !graph) return;
 
@@ -654,8 +789,31 @@ void ChartView::updateClickMarker(QCPGraph* graph, int dataIndex, bool append)
     // QCPDataContainer::at 返回的是 const_iterator（指向数据的指针），需解引用
     auto it = dataContainer->at(dataIndex);
     if (it == dataContainer->constEnd()) return; // 越界保护
-    const double x = it->key;
-    const double y = it->value;
+    double x = it->key;
+    double y = it->value;
+
+    // 降采样显示的曲线：在原始数据中取鼠标 ±3 像素内最近的点，标记坐标与原始数据一致
+    const bool lodManaged = m_lodGraphs.contains(graph);
+    CurveHitIndex::Mapping mapping;
+    if (lodManaged && mousePos.x() >= 0 && CurveHitIndex::mappingFor(graph->keyAxis(), graph->valueAxis(), &mapping)) {
+        const CurveHitIndex& index = hitIndexFor(graph);
+        const CurveHitIndex::Hit hit = index.nearest(mousePos, 3.0, mapping);
+        if (hit.index >= 0) {
+            x = index.data()->at(hit.index)->key;
+            y = index.data()->at(hit.index)->value;
+        }
+    }
+    // 降采样曲线按坐标放置标记（显示级别切换后 setGraphKey 的插值会偏离原始点）
+    auto placeTracer = [&](QCPItemTracer* tracer) {
+        if (lodManaged) {
+            tracer->setGraph(nullptr);
+            tracer->position->setAxes(graph->keyAxis(), graph->valueAxis());
+            tracer->position->setCoords(x, y);
+        } else {
+            tracer->setGraph(graph);
+            tracer->setGraphKey(x);
+        }
+    };
 
     if (!append) {
         // 非 Ctrl 模式：只保留一个点，先清除所有已有标记
@@ -670,8 +828,7 @@ void ChartView::updateClickMarker(QCPGraph* graph, int dataIndex, bool append)
             m_clickTracer->setBrush(QBrush(QColor(255, 0, 0, 60))); // 半透明填充
             m_clickTracer->setInterpolating(true);
         }
-        m_clickTracer->setGraph(graph);
-        m_clickTracer->setGraphKey(x);
+        placeTracer(m_clickTracer);
 
         // 初始化或更新单一坐标文本
         if (!m_coordText) {
@@ -697,8 +854,7 @@ void ChartView::updateClickMarker(QCPGraph* graph, int dataIndex, bool append)
         tracer->setPen(QPen(Qt::red, 2));
         tracer->setBrush(QBrush(QColor(255, 0, 0, 60)));
         tracer->setInterpolating(true);
-        tracer->setGraph(graph);
-        tracer->setGraphKey(x);
+        placeTracer(tracer);
         m_extraTracers.push_back(tracer);
 
         QCPItemText* text = new QCPItemText(m_plot);
@@ -756,18 +912,29 @@ void ChartView::onPlotMouseMove(QMouseEvent* event)
         return;
     }
 
-    // 遍历所有曲线，使用 selectTest 评估距离，找到最近曲线
+    // 遍历所有曲线，用命中索引评估距离（每条曲线二分定位 + 分块剔除），找到最近曲线；
+    // 对数坐标轴等非线性映射退回 selectTest
     QCPGraph* nearestGraph = nullptr;
+    CurveHitIndex::Hit nearestHit;
     double bestDist = std::numeric_limits<double>::max();
     const double threshold = 12.0; // 像素距离阈值
 
     for (int i = 0; i < m_plot->graphCount(); ++i) {
         QCPGraph* g = m_plot->graph(i);
         if (!g || !g->visible()) continue;
-        double d = g->selectTest(event->pos(), false, nullptr);
+        CurveHitIndex::Mapping mapping;
+        CurveHitIndex::Hit hit;
+        double d = -1.0;
+        if (CurveHitIndex::mappingFor(g->keyAxis(), g->valueAxis(), &mapping)) {
+            hit = hitIndexFor(g).nearest(event->pos(), threshold, mapping);
+            d = hit.distance;
+        } else {
+            d = g->selectTest(event->pos(), false, nullptr);
+        }
         if (d >= 0 && d < bestDist) {
             bestDist = d;
             nearestGraph = g;
+            nearestHit = hit;
         }
     }
 
@@ -785,8 +952,16 @@ void ChartView::onPlotMouseMove(QMouseEvent* event)
             m_hoverTracer->setBrush(QBrush(QColor(180, 180, 180, 40))); // 更淡的半透明
             m_hoverTracer->setInterpolating(true);
         }
-        m_hoverTracer->setGraph(nearestGraph);
-        m_hoverTracer->setGraphKey(xCoord);
+        if (m_lodGraphs.contains(nearestGraph) && nearestHit.index >= 0) {
+            // 降采样显示的曲线：标记放在原始数据中最近的点上，而非显示级别上插值
+            const QCPGraphData* point = fullResolutionData(nearestGraph)->at(nearestHit.index);
+            m_hoverTracer->setGraph(nullptr);
+            m_hoverTracer->position->setAxes(nearestGraph->keyAxis(), nearestGraph->valueAxis());
+            m_hoverTracer->position->setCoords(point->key, point->value);
+        } else {
+            m_hoverTracer->setGraph(nearestGraph);
+            m_hoverTracer->setGraphKey(xCoord);
+        }
 
         if (!m_hoverLegendText) {
             m_hoverLegendText = new QCPItemText(m_plot);
@@ -1562,9 +1737,10 @@ QVector<QPair<QVector<double>, QVector<double>>> ChartView::getCurvesData() cons
         QVector<double> xData, yData;
         
         // 获取图形的数据点
-        for (int j = 0; j < graph->data()->size(); ++j) {
-            xData.append(graph->data()->at(j)->key);
-            yData.append(graph->data()->at(j)->value);
+        const QSharedPointer<QCPGraphDataContainer> data = fullResolutionData(graph); // 降采样显示时仍返回原始数据
+        for (int j = 0; j < data->size(); ++j) {
+            xData.append(data->at(j)->key);
+            yData.append(data->at(j)->value);
         }
         
         allData.append(qMakePair(xData, yData));
@@ -1589,9 +1765,10 @@ QVector<QPair<QVector<double>, QVector<double>>> ChartView::getSelectedCurvesDat
             QVector<double> xData, yData;
             
             // 获取图形的数据点
-            for (int j = 0; j < graph->data()->size(); ++j) {
-                xData.append(graph->data()->at(j)->key);
-                yData.append(graph->data()->at(j)->value);
+            const QSharedPointer<QCPGraphDataContainer> data = fullResolutionData(graph);
+            for (int j = 0; j < data->size(); ++j) {
+                xData.append(data->at(j)->key);
+                yData.append(data->at(j)->value);
             }
             
             selectedData.append(qMakePair(xData, yData));
@@ -1617,9 +1794,10 @@ QList<QPair<int, QPair<QVector<double>, QVector<double>>>> ChartView::getSelecte
             QVector<double> xData, yData;
             
             // 获取图形的数据点
-            for (int j = 0; j < graph->data()->size(); ++j) {
-                xData.append(graph->data()->at(j)->key);
-                yData.append(graph->data()->at(j)->value);
+            const QSharedPointer<QCPGraphDataContainer> data = fullResolutionData(graph);
+            for (int j = 0; j < data->size(); ++j) {
+                xData.append(data->at(j)->key);
+                yData.append(data->at(j)->value);
             }
             
             // 查找对应的样本ID
@@ -1654,9 +1832,10 @@ QList<QPair<int, QPair<QVector<double>, QVector<double>>>> ChartView::getAllCurv
             QVector<double> xData, yData;
             
             // 获取图形的数据点
-            for (int j = 0; j < graph->data()->size(); ++j) {
-                xData.append(graph->data()->at(j)->key);
-                yData.append(graph->data()->at(j)->value);
+            const QSharedPointer<QCPGraphDataContainer> data = fullResolutionData(graph);
+            for (int j = 0; j < data->size(); ++j) {
+                xData.append(data->at(j)->key);
+                yData.append(data->at(j)->value);
             }
             
             // 查找对应的样本ID
@@ -2035,7 +2214,10 @@ void ChartView::exportImage()
 void ChartView::exportData()
 {
     if (m_plot && m_plotExporter) {
+        // PlotExporter 直接读取 graph->data()，导出期间切回原始数据
+        setLodSuspended(true);
         m_plotExporter->exportData(m_plot);
+        setLodSuspended(false);
     }
 }
 
@@ -2053,14 +2235,15 @@ void ChartView::clonePlotTo(ChartView* target) const
 
     for (int i = 0; i < m_plot->graphCount(); ++i) {
         QCPGraph* srcGraph = m_plot->graph(i);
-        if (!srcGraph || !srcGraph->data()) continue;
+        const QSharedPointer<QCPGraphDataContainer> srcData = fullResolutionData(srcGraph);
+        if (!srcGraph || !srcData) continue;
 
         QVector<double> x;
         QVector<double> y;
-        x.reserve(srcGraph->data()->size());
-        y.reserve(srcGraph->data()->size());
+        x.reserve(srcData->size());
+        y.reserve(srcData->size());
 
-        for (auto it = srcGraph->data()->constBegin(); it != srcGraph->data()->constEnd(); ++it) {
+        for (auto it = srcData->constBegin(); it != srcData->constEnd(); ++it) {
             x.append(it->key);
             y.append(it->value);
         }
@@ -2157,52 +2340,26 @@ bool ChartView::addWeightedSumCurveFromSelected(const QMap<int, double>& inputWe
         w /= wSum;
     }
 
-    // 严格交集：使用第一条曲线的x为基准，其余曲线必须在同索引具有相同x
-    const QVector<double>& baseX = selected[0].second.first;
-    if (baseX.isEmpty()) {
-        setErr(tr("选中曲线数据为空。"));
-        return false;
-    }
-
-    int commonLen = baseX.size();
-    for (int i = 1; i < selected.size(); ++i) {
-        commonLen = qMin(commonLen, selected[i].second.first.size());
-        commonLen = qMin(commonLen, selected[i].second.second.size());
-    }
-    commonLen = qMin(commonLen, selected[0].second.second.size());
-
-    if (commonLen <= 0) {
-        setErr(tr("选中曲线无可计算交集区间。"));
-        return false;
-    }
-
-    QVector<double> outX;
-    QVector<double> outY;
-    outX.reserve(commonLen);
-    outY.reserve(commonLen);
-
-    for (int idx = 0; idx < commonLen; ++idx) {
-        const double x0 = selected[0].second.first[idx];
-        bool allSameX = true;
-        double ySum = 0.0;
-
-        for (int c = 0; c < selected.size(); ++c) {
-            const QVector<double>& cx = selected[c].second.first;
-            const QVector<double>& cy = selected[c].second.second;
-            if (idx >= cx.size() || idx >= cy.size()) {
-                allSameX = false;
-                break;
-            }
-            if (qAbs(cx[idx] - x0) > 1e-9) {
-                allSameX = false;
-                break;
-            }
-            ySum += weights[c] * cy[idx];
+    // 以第一条曲线为参考、在各曲线公共 X 区间内对齐（X 不一致的曲线线性插值到参考采样点）
+    QVector<QVector<double>> xs, ys;
+    xs.reserve(selected.size());
+    ys.reserve(selected.size());
+    for (const auto& one : selected) {
+        if (one.second.first.isEmpty() || one.second.second.isEmpty()) {
+            setErr(tr("选中曲线数据为空。"));
+            return false;
         }
+        xs.append(one.second.first);
+        ys.append(one.second.second);
+    }
+    const CurveMathUtils::AlignedCurves aligned = CurveMathUtils::alignToCommonGrid(xs, ys);
 
-        if (allSameX) {
-            outX.push_back(x0);
-            outY.push_back(ySum);
+    QVector<double> outX = aligned.x;
+    QVector<double> outY(outX.size(), 0.0);
+    for (int c = 0; c < aligned.y.size(); ++c) {
+        const QVector<double>& cy = aligned.y[c];
+        for (int idx = 0; idx < outY.size(); ++idx) {
+            outY[idx] += weights[c] * cy[idx];
         }
     }
 
@@ -13,10 +13,13 @@
 #include <QMouseEvent>
 #include <QShowEvent>
 #include <QMap>
+#include <QHash>
 #include <QPointer>
 
 #include "core/entities/Curve.h"
 #include "PlotExporter.h"
+#include "CurveLodPyramid.h"
+#include "CurveHitIndex.h"
 #include "third_party/QXlsx/header/xlsxdocument.h"
 
 class ChartView : public QWidget
@@ -33,12 +36,17 @@ public:
 
     // --- 【关键】添加新的公共接口 ---
     void addCurve(QSharedPointer<Curve> curve);
+    /** 分批添加曲线：每轮事件循环添加 batchSize 条并重绘，大量曲线时界面保持响应；clearGraphs 时丢弃未添加的部分 */
+    void addCurvesInBatches(const QList<QSharedPointer<Curve>>& curves, int batchSize = 20);
 
     /** 在当前坐标轴范围内绘制竖线（用于分段边界）；clearGraphs 时一并清除 */
     void addVerticalLines(const QVector<double>& xWorld, const QColor& color = QColor(80, 80, 80, 160));
 
     // void addGraph(const QVector<double>& x, const QVector<double>& y, const QString& name, const QColor& color = Qt::blue, int sampleId);
     void addGraph(const QVector<double>& x, const QVector<double>& y, const QString& name, const QColor& color = Qt::blue, int sampleId =-1);
+    // 以现成的 QCP 数据容器添加曲线（共享容器，不复制数据）
+    void addGraphContainer(const QSharedPointer<QCPGraphDataContainer>& data, const QString& name,
+                           const QColor& color = Qt::blue, int sampleId = -1);
 
     /** 添加柱状图（用于分段面积等可视化）*/
     void addBars(const QVector<double>& x, const QVector<double>& y,
@@ -197,7 +205,8 @@ private:
 
     // --- 新增：辅助方法 ---
     // 根据被点击的图形与数据索引，更新标记位置与坐标文本
-    void updateClickMarker(QCPGraph* graph, int dataIndex, bool append);
+    // mousePos 有效且曲线处于降采样显示时，改取原始数据中距鼠标最近的点
+    void updateClickMarker(QCPGraph* graph, int dataIndex, bool append, const QPoint& mousePos = QPoint(-1, -1));
     // 清理现有标记与文本（包含所有附加标记）
     void clearClickMarker();
     // 删除距离鼠标位置最近的标记点（含主标记与附加标记）
@@ -239,6 +248,30 @@ private:
 
     QCPBarsGroup* m_barsGroup = nullptr;
     QVector<QCPBars*> m_barsList;
+
+    // --- 多分辨率绘制（LOD）：大曲线按当前 X 范围与像素宽度切换 min/max 金字塔级别 ---
+    // 原始数据始终保存在 LodState::full，导出与点击标记使用原始数据
+    struct LodState {
+        QSharedPointer<QCPGraphDataContainer> full;      // 原始数据
+        QSharedPointer<CurveLodPyramid> pyramid;         // 后台构建完成前为空（绘制原始数据）
+        int level = 0;                                   // 当前绘制的级别
+    };
+    QHash<QCPGraph*, LodState> m_lodGraphs;
+    bool m_lodSuspended = false;                         // 导出期间强制绘制原始数据
+    void buildLodAsync(QCPGraph* graph, const QSharedPointer<QCPGraphDataContainer>& data);
+    void updateLodLevels();                              // 连接 beforeReplot：每次重绘前选择级别
+    void setLodSuspended(bool suspended);
+    QSharedPointer<QCPGraphDataContainer> fullResolutionData(QCPGraph* graph) const;
+
+    // 悬停/点击命中索引（按原始数据建立，数据变化时惰性重建）
+    QHash<QCPGraph*, CurveHitIndex> m_hitIndex;
+    const CurveHitIndex& hitIndexFor(QCPGraph* graph);
+
+    // addCurvesInBatches 的待添加队列
+    void addPendingCurveBatch();
+    QList<QSharedPointer<Curve>> m_pendingCurves;
+    int m_curveBatchSize = 20;
+    bool m_curveBatchScheduled = false;
 };
 
 #endif // CHARTVIEW_H
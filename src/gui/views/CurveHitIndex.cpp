@@ -0,0 +1,124 @@
+#include "CurveHitIndex.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 点到线段的像素距离平方
+static double segmentDistanceSquared(double px, double py, double x1, double y1, double x2, double y2)
+{
+    const double dx = x2 - x1;
+    const double dy = y2 - y1;
+    const double len2 = dx * dx + dy * dy;
+    double t = 0.0;
+    if (len2 > 0.0) t = qBound(0.0, ((px - x1) * dx + (py - y1) * dy) / len2, 1.0);
+    const double ex = x1 + t * dx - px;
+    const double ey = y1 + t * dy - py;
+    return ex * ex + ey * ey;
+}
+
+static bool linearMapping(const QCPAxis* axis, double* scale, double* offset)
+{
+    if (!axis || axis->scaleType() != QCPAxis::stLinear) return false;
+    const QCPRange range = axis->range();
+    if (!(range.size() > 0.0)) return false;
+    const double p0 = axis->coordToPixel(range.lower);
+    const double p1 = axis->coordToPixel(range.upper);
+    *scale = (p1 - p0) / range.size();
+    *offset = p0 - *scale * range.lower;
+    return *scale != 0.0;
+}
+
+} // namespace
+
+CurveHitIndex::CurveHitIndex(const QSharedPointer<QCPGraphDataContainer>& data, bool connected)
+    : m_data(data), m_connected(connected)
+{
+    if (m_data.isNull() || m_data->isEmpty()) return;
+
+    const QCPGraphData* points = m_data->constBegin();
+    m_size = m_data->size();
+    m_firstKey = points[0].key;
+    m_lastKey = points[m_size - 1].key;
+
+    // 每块包含下一块的首点，使跨块的线段也落在本块的 value 范围内
+    const int blocks = (m_size + BlockSize - 1) / BlockSize;
+    m_blockMin.fill(std::numeric_limits<double>::infinity(), blocks);
+    m_blockMax.fill(-std::numeric_limits<double>::infinity(), blocks);
+    for (int b = 0; b < blocks; ++b) {
+        const int end = qMin(m_size - 1, (b + 1) * BlockSize);
+        for (int i = b * BlockSize; i <= end; ++i) {
+            const double v = points[i].value;
+            if (std::isnan(v)) continue;
+            if (v < m_blockMin[b]) m_blockMin[b] = v;
+            if (v > m_blockMax[b]) m_blockMax[b] = v;
+        }
+    }
+}
+
+bool CurveHitIndex::isStale(const QSharedPointer<QCPGraphDataContainer>& data, bool connected) const
+{
+    if (data != m_data || connected != m_connected) return true;
+    if (data.isNull()) return false;
+    if (data->size() != m_size) return true;
+    return m_size > 0 && (data->constBegin()->key != m_firstKey || (data->constEnd() - 1)->key != m_lastKey);
+}
+
+CurveHitIndex::Hit CurveHitIndex::nearest(const QPointF& pixel, double tolerance, const Mapping& mapping) const
+{
+    Hit hit;
+    if (m_size == 0 || mapping.keyScale == 0.0 || mapping.valueScale == 0.0) return hit;
+
+    const double px = pixel.x();
+    const double py = pixel.y();
+    const double k1 = (px - tolerance - mapping.keyOffset) / mapping.keyScale;
+    const double k2 = (px + tolerance - mapping.keyOffset) / mapping.keyScale;
+    const double v1 = (py - tolerance - mapping.valueOffset) / mapping.valueScale;
+    const double v2 = (py + tolerance - mapping.valueOffset) / mapping.valueScale;
+    const double keyLo = qMin(k1, k2), keyHi = qMax(k1, k2);
+    const double valueLo = qMin(v1, v2), valueHi = qMax(v1, v2);
+
+    // 含窗口两侧各一个点，穿过窗口的线段也参与计算
+    const QCPGraphData* points = m_data->constBegin();
+    const int first = int(m_data->findBegin(keyLo, true) - m_data->constBegin());
+    const int last = int(m_data->findEnd(keyHi, true) - m_data->constBegin()); // 不含
+    if (first >= last) return hit;
+
+    double bestPoint = std::numeric_limits<double>::max();
+    double bestLine = std::numeric_limits<double>::max();
+    for (int b = first / BlockSize; b <= (last - 1) / BlockSize; ++b) {
+        if (m_blockMin[b] > valueHi || m_blockMax[b] < valueLo) continue; // 整块在容差带之外
+        const int from = qMax(first, b * BlockSize);
+        const int to = qMin(last, (b + 1) * BlockSize);
+        for (int i = from; i < to; ++i) {
+            if (std::isnan(points[i].value)) continue;
+            const double x = mapping.keyScale * points[i].key + mapping.keyOffset;
+            const double y = mapping.valueScale * points[i].value + mapping.valueOffset;
+            const double d2 = (x - px) * (x - px) + (y - py) * (y - py);
+            if (d2 < bestPoint) {
+                bestPoint = d2;
+                hit.index = i;
+            }
+            if (m_connected && i + 1 < last && !std::isnan(points[i + 1].value)) {
+                const double x2 = mapping.keyScale * points[i + 1].key + mapping.keyOffset;
+                const double y2 = mapping.valueScale * points[i + 1].value + mapping.valueOffset;
+                bestLine = qMin(bestLine, segmentDistanceSquared(px, py, x, y, x2, y2));
+            }
+        }
+    }
+    if (hit.index < 0) return hit;
+
+    hit.pointDistance = std::sqrt(bestPoint);
+    const double distance = std::sqrt(qMin(bestPoint, bestLine));
+    hit.distance = (distance <= tolerance) ? distance : -1.0;
+    return hit;
+}
+
+bool CurveHitIndex::mappingFor(const QCPAxis* keyAxis, const QCPAxis* valueAxis, Mapping* mapping)
+{
+    if (!mapping || !keyAxis || !valueAxis) return false;
+    if (keyAxis->orientation() != Qt::Horizontal || valueAxis->orientation() != Qt::Vertical) return false;
+    return linearMapping(keyAxis, &mapping->keyScale, &mapping->keyOffset)
+           && linearMapping(valueAxis, &mapping->valueScale, &mapping->valueOffset);
+}
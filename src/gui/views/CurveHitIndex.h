@@ -0,0 +1,68 @@
+#ifndef CURVEHITINDEX_H
+#define CURVEHITINDEX_H
+
+#include <QPointF>
+#include <QSharedPointer>
+#include <QVector>
+
+#include "third_party/qcustomplot/qcustomplot.h"
+
+/**
+ * @brief 单条曲线的悬停/点击命中索引（替代逐点扫描的 QCPGraph::selectTest）
+ *
+ * 数据容器本身按 key 有序，二分查找即可定位鼠标附近的 key 窗口；
+ * 另按 BlockSize 个点分块记录 value 的最小/最大值（含到下一块首点的线段），
+ * 查询时整块落在鼠标上下容差带之外即跳过，只对剩余块计算像素距离。
+ * 索引建立在数据坐标上，坐标轴缩放/平移只改变查询时的线性映射，无需重建。
+ */
+class CurveHitIndex
+{
+public:
+    static constexpr int BlockSize = 32;
+
+    // 线性坐标轴下数据坐标到像素坐标的映射：px = keyScale·key + keyOffset，py = valueScale·value + valueOffset
+    struct Mapping {
+        double keyScale = 1.0;
+        double keyOffset = 0.0;
+        double valueScale = 1.0;
+        double valueOffset = 0.0;
+    };
+
+    struct Hit {
+        int index = -1;                 // 窗口内距鼠标最近的数据点下标（-1 表示窗口内无有效点）
+        double distance = -1.0;         // 到曲线（连线或散点）的像素距离
+        double pointDistance = -1.0;    // 到 index 点的像素距离
+    };
+
+    CurveHitIndex() = default;
+    // connected：曲线是否按折线绘制（lsNone 的散点曲线只按点计算距离）
+    CurveHitIndex(const QSharedPointer<QCPGraphDataContainer>& data, bool connected);
+
+    QSharedPointer<QCPGraphDataContainer> data() const { return m_data; }
+    bool connected() const { return m_connected; }
+
+    // 数据是否已被原地修改（点数或首尾 key 变化）
+    bool isStale(const QSharedPointer<QCPGraphDataContainer>& data, bool connected) const;
+
+    /**
+     * @brief 查询鼠标 pixel 附近 tolerance 像素内的曲线距离与最近点
+     * 超出容差时返回的 distance 为 -1
+     */
+    Hit nearest(const QPointF& pixel, double tolerance, const Mapping& mapping) const;
+
+    /**
+     * @brief 由曲线的坐标轴得到映射；非线性（对数）或 key 轴非水平时返回 false
+     */
+    static bool mappingFor(const QCPAxis* keyAxis, const QCPAxis* valueAxis, Mapping* mapping);
+
+private:
+    QSharedPointer<QCPGraphDataContainer> m_data;
+    bool m_connected = true;
+    int m_size = 0;
+    double m_firstKey = 0.0;
+    double m_lastKey = 0.0;
+    QVector<double> m_blockMin;   // 每块 value 最小值（跳过 NaN；全 NaN 为 +inf）
+    QVector<double> m_blockMax;
+};
+
+#endif // CURVEHITINDEX_H
@@ -0,0 +1,105 @@
+#include "CurveLodPyramid.h"
+
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 一个桶内最小/最大值点在原始数据中的下标；全为 NaN 时为 -1
+struct Bucket {
+    int minIndex = -1;
+    int maxIndex = -1;
+};
+
+static Bucket mergeBuckets(const QCPGraphData* data, const Bucket& a, const Bucket& b)
+{
+    if (a.minIndex < 0) return b;
+    if (b.minIndex < 0) return a;
+    Bucket m;
+    m.minIndex = (data[b.minIndex].value < data[a.minIndex].value) ? b.minIndex : a.minIndex;
+    m.maxIndex = (data[b.maxIndex].value > data[a.maxIndex].value) ? b.maxIndex : a.maxIndex;
+    return m;
+}
+
+static QSharedPointer<QCPGraphDataContainer> materialize(const QCPGraphData* data, int count,
+                                                         const QVector<Bucket>& buckets, int bucketSize)
+{
+    QVector<QCPGraphData> points;
+    points.reserve(buckets.size() * 2);
+    for (int b = 0; b < buckets.size(); ++b) {
+        const Bucket& bucket = buckets[b];
+        if (bucket.minIndex < 0) {
+            // 整桶为 NaN：保留一个 NaN 点，使曲线在此处保持断开
+            const int start = qMin(b * bucketSize, count - 1);
+            points.append(QCPGraphData(data[start].key, std::numeric_limits<double>::quiet_NaN()));
+            continue;
+        }
+        const int first = qMin(bucket.minIndex, bucket.maxIndex);
+        const int second = qMax(bucket.minIndex, bucket.maxIndex);
+        points.append(data[first]);
+        if (second != first) points.append(data[second]);
+    }
+    auto container = QSharedPointer<QCPGraphDataContainer>::create();
+    container->set(points, true); // 各桶按 key 顺序输出，已排序
+    return container;
+}
+
+} // namespace
+
+CurveLodPyramid::CurveLodPyramid(const QSharedPointer<QCPGraphDataContainer>& full)
+{
+    m_levels.append(full);
+    if (full.isNull()) return;
+
+    const int count = full->size();
+    if (count < MinPointsForLod) return;
+    const QCPGraphData* data = full->constBegin();
+
+    // 第 1 级直接扫描原始点
+    QVector<Bucket> buckets((count + BaseBucket - 1) / BaseBucket);
+    for (int b = 0; b < buckets.size(); ++b) {
+        const int end = qMin(count, (b + 1) * BaseBucket);
+        Bucket bucket;
+        for (int i = b * BaseBucket; i < end; ++i) {
+            const double v = data[i].value;
+            if (std::isnan(v)) continue;
+            if (bucket.minIndex < 0) {
+                bucket.minIndex = bucket.maxIndex = i;
+                continue;
+            }
+            if (v < data[bucket.minIndex].value) bucket.minIndex = i;
+            if (v > data[bucket.maxIndex].value) bucket.maxIndex = i;
+        }
+        buckets[b] = bucket;
+    }
+
+    // 逐级两两合并，直到桶数过少
+    while (buckets.size() >= MinBucketsPerLevel) {
+        m_levels.append(materialize(data, count, buckets, bucketSize(m_levels.size())));
+
+        QVector<Bucket> coarser((buckets.size() + 1) / 2);
+        for (int b = 0; b < coarser.size(); ++b) {
+            const int left = 2 * b;
+            coarser[b] = (left + 1 < buckets.size()) ? mergeBuckets(data, buckets[left], buckets[left + 1])
+                                                     : buckets[left];
+        }
+        buckets.swap(coarser);
+    }
+}
+
+int CurveLodPyramid::levelFor(const QCPRange& keyRange, double pixelWidth) const
+{
+    const QSharedPointer<QCPGraphDataContainer> full = fullData();
+    if (m_levels.size() <= 1 || full.isNull() || pixelWidth <= 0) return 0;
+
+    // 视野内的原始点数（二分查找）
+    const int visible = int(full->findEnd(keyRange.upper, false) - full->findBegin(keyRange.lower, false));
+    const double pointsPerPixel = visible / pixelWidth;
+
+    int best = 0;
+    for (int index = 1; index < m_levels.size(); ++index) {
+        if (bucketSize(index) > pointsPerPixel) break;
+        best = index;
+    }
+    return best;
+}
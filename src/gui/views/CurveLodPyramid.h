@@ -0,0 +1,44 @@
+#ifndef CURVELODPYRAMID_H
+#define CURVELODPYRAMID_H
+
+#include <QSharedPointer>
+#include <QVector>
+
+#include "third_party/qcustomplot/qcustomplot.h"
+
+/**
+ * @brief 单条曲线的多分辨率 min/max 金字塔（用于 ChartView 按视野切换绘制数据）
+ *
+ * 第 0 级为原始数据；第 L 级（L >= 1）把原始点按 BaseBucket·2^(L-1) 个一组分桶，
+ * 每桶只保留最小值点与最大值点（原始的 key/value，按 key 顺序），
+ * 所以只要每个像素列至少覆盖一个桶，画出的包络与峰值与原始数据一致。
+ * 高一级的桶由低一级相邻两桶合并得到，构建总耗时 O(N)，可在后台线程完成。
+ */
+class CurveLodPyramid
+{
+public:
+    static constexpr int BaseBucket = 4;             // 第 1 级每桶原始点数
+    static constexpr int MinPointsForLod = 4096;     // 点数少于此值的曲线不建金字塔
+    static constexpr int MinBucketsPerLevel = 256;   // 最粗一级至少保留的桶数
+
+    // full 须按 key 升序（QCPGraphDataContainer 的默认状态）；构建期间只读
+    explicit CurveLodPyramid(const QSharedPointer<QCPGraphDataContainer>& full);
+
+    int levelCount() const { return m_levels.size(); }  // 含第 0 级
+    QSharedPointer<QCPGraphDataContainer> level(int index) const { return m_levels.value(index); }
+    QSharedPointer<QCPGraphDataContainer> fullData() const { return m_levels.value(0); }
+
+    // 第 index 级每桶包含的原始点数（第 0 级为 1）
+    static int bucketSize(int index) { return index <= 0 ? 1 : BaseBucket << (index - 1); }
+
+    /**
+     * @brief 选择绘制 keyRange 所用的级别：每像素至少覆盖一个桶的最粗一级
+     * @param pixelWidth 坐标轴矩形的像素宽度
+     */
+    int levelFor(const QCPRange& keyRange, double pixelWidth) const;
+
+private:
+    QVector<QSharedPointer<QCPGraphDataContainer>> m_levels;
+};
+
+#endif // CURVELODPYRAMID_H
@@ -1125,6 +1125,7 @@ void DataNavigator::contextMenuEvent(QContextMenuEvent *event)
                     if (QMessageBox::question(this, tr("确认删除"), tip + tr("此操作不可撤销，是否继续？")) == QMessageBox::Yes) {
                         QString err;
                         if (m_dao.deleteProjectCascade(info.projectName, processBranch, err)) {
+                            emit sampleDataDeleted(-1);
                             if (processBranch) refreshProcessData(); else refreshDataSource();
                         } else {
                             QMessageBox::warning(this, tr("删除失败"), err);
@@ -1150,6 +1151,7 @@ void DataNavigator::contextMenuEvent(QContextMenuEvent *event)
                     if (QMessageBox::question(this, tr("确认删除"), tip + tr("此操作不可撤销，是否继续？")) == QMessageBox::Yes) {
                         QString err;
                         if (m_dao.deleteBatchCascade(info.projectName, info.batchCode, processBranch, err)) {
+                            emit sampleDataDeleted(-1);
                             // 刷新父型号节点或分支
                             QTreeWidgetItem* parent = item->parent();
                             if (parent) refreshNode(parent); else { if (processBranch) refreshProcessData(); else refreshDataSource(); }
@@ -1210,6 +1212,7 @@ void DataNavigator::contextMenuEvent(QContextMenuEvent *event)
                             QMessageBox::warning(this, tr("删除失败"), err);
                             return;
                         }
+                        emit sampleDataDeleted(sample.id);
                     }
 
                     QTreeWidgetItem* parent = item->parent();
@@ -1267,6 +1270,7 @@ void DataNavigator::contextMenuEvent(QContextMenuEvent *event)
                     if (QMessageBox::question(this, tr("确认删除"), tip + tr("此操作不可撤销，是否继续？")) == QMessageBox::Yes) {
                         QString err;
                         if (m_dao.deleteSampleDataByType(info.id, info.dataType, err)) {
+                            emit sampleDataDeleted(info.id);
                             // 刷新数据类型节点
                             QTreeWidgetItem* parent = item->parent();
                             if (parent) refreshNode(parent); else { if (processBranch) refreshProcessData(); else refreshDataSource(); }
@@ -49,6 +49,9 @@ signals:
     // 请求选择批次中的所有样本
     void requestSelectAllSamplesInBatch(const NavigatorNodeInfo& batchInfo);
 
+    // 删除操作成功后发出，sampleId < 0 表示影响多个样本（项目/批次级删除），用于清理阶段缓存
+    void sampleDataDeleted(int sampleId);
+
 public:
 
     void addOpenView(QMdiSubWindow* window);
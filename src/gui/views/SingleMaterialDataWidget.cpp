@@ -439,12 +439,14 @@ void SingleMaterialDataWidget::on_viewDetailsButton_clicked()
 void SingleMaterialDataWidget::on_openModelListButton_clicked()
 {
     ModelListDialog dlg(this);
+    connect(&dlg, &ModelListDialog::sampleDataDeleted, this, &SingleMaterialDataWidget::onSampleDataDeleted);
     dlg.exec();
 }
 
 void SingleMaterialDataWidget::on_openBatchListButton_clicked()
 {
     BatchListDialog dlg(this);
+    connect(&dlg, &BatchListDialog::sampleDataDeleted, this, &SingleMaterialDataWidget::onSampleDataDeleted);
     dlg.exec();
 }
 
@@ -467,9 +469,16 @@ void SingleMaterialDataWidget::on_openSampleListButton_clicked()
 {
     // 打开样本列表对话框，按四类数据分别显示并统计数据点数
     SampleListDialog dlg(this, m_appInitializer);
+    connect(&dlg, &SampleListDialog::sampleDataDeleted, this, &SingleMaterialDataWidget::onSampleDataDeleted);
     dlg.exec();
 }
 
+void SingleMaterialDataWidget::onSampleDataDeleted(int sampleId)
+{
+    if (m_appInitializer && m_appInitializer->getDataProcessingService())
+        m_appInitializer->getDataProcessingService()->invalidateStageCache(sampleId);
+}
+
 void SingleMaterialDataWidget::on_exportButton_clicked()
 {
     QString filter = "Excel Files (*.xlsx);;CSV Files (*.csv);;All Files (*.*)";
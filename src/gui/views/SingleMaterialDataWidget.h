@@ -96,6 +96,8 @@ private slots:
     void on_importProcessTgBigDataButton_clicked();
     void on_editImportAttributesButton_clicked();
     void onTableViewContextMenu(const QPoint& pos);
+    // 列表对话框删除数据后清理阶段缓存（sampleId < 0 时整体清空）
+    void onSampleDataDeleted(int sampleId);
 
 private:
     Ui::SingleMaterialDataWidget *ui; // UI 界面对象
@@ -16,6 +16,7 @@ class ChartView;
 class QTableView;
 class QPushButton;
 class DifferenceResultModel;
+class WorkbenchComputationService;
 class Curve;
 struct DifferenceResultRow;   //  添加这个或引入对应头文件
 
@@ -43,6 +44,9 @@ private slots:
     void onResultTableRowClicked(const QModelIndex& index);
     // 显示最佳样品差异排序表
     void onShowBestSampleRankingTable();
+    // 后台差异度计算：结果分块到达、结束后按差异度排序（进度与取消见 WorkbenchComputationService::bindProgress）
+    void onRankingRowsReady(const QList<DifferenceResultRow>& rows);
+    void onRankingFinished(bool cancelled);
     // 任意选择两条曲线并计算差异度
     void onCompareAnyTwoCurves();
 
@@ -68,6 +72,7 @@ private:
     QSharedPointer<Curve> m_referenceCurve;
     QList<QSharedPointer<Curve>> m_allCurves;
     QList<DifferenceResultRow> m_resultCache;
+    WorkbenchComputationService* m_computation = nullptr;
 
     int m_referenceSampleId;
     BatchGroupData m_processedData;
@@ -77,6 +82,7 @@ private:
     QTableView* m_tableView = nullptr;
     DifferenceResultModel* m_model = nullptr;
     QPushButton* m_bestSampleRankingButton = nullptr;
+    QPushButton* m_cancelComputationButton = nullptr;
     QPushButton* m_compareAnyTwoCurvesButton = nullptr;
 
     AppInitializer* m_appInitializer = nullptr;
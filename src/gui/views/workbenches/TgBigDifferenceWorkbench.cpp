@@ -2,6 +2,7 @@
 #include "gui/views/ChartView.h"
 #include "core/models/DifferenceResultModel.h"
 #include "services/analysis/SampleComparisonService.h"
+#include "services/analysis/WorkbenchComputationService.h"
 #include "services/analysis/ParallelSampleAnalysisService.h"
 #include "core/AppInitializer.h"
 // #include "gui/mainwindow.h"  // 根据你项目的实际路径
@@ -49,6 +50,8 @@ TgBigDifferenceWorkbench::TgBigDifferenceWorkbench(int referenceSampleId,
 
 void TgBigDifferenceWorkbench::setupUi()
 {
+    setWindowTitle(tr("大热重差异度分析 - 参考样本ID: %1").arg(m_referenceSampleId)); // 基础标题只确定一次，计算进度作为后缀追加
+
     // --- 创建主布局 ---
     QWidget* container = new QWidget;
     QVBoxLayout* mainLayout = new QVBoxLayout(container);
@@ -59,6 +62,8 @@ void TgBigDifferenceWorkbench::setupUi()
     m_chartView = new ChartView;
     m_tableView = new QTableView;
     m_model = new DifferenceResultModel(m_appInitializer, this);
+    m_computation = new WorkbenchComputationService(
+        m_appInitializer ? m_appInitializer->getSampleComparisonService() : nullptr, this);
     m_model->setReferenceSampleId(m_referenceSampleId);
 
     m_tableView->setModel(m_model);
@@ -110,9 +115,17 @@ void TgBigDifferenceWorkbench::setupUi()
         "}"
     );
     
+    m_cancelComputationButton = new QPushButton("取消计算");
+    m_cancelComputationButton->setMinimumHeight(30);
+    m_cancelComputationButton->setEnabled(false); // 仅在后台计算期间可用
+
+    QHBoxLayout* buttonLayout = new QHBoxLayout;
+    buttonLayout->addWidget(m_bestSampleRankingButton);
+    buttonLayout->addWidget(m_cancelComputationButton);
+
     // 添加组件到主布局
     mainLayout->addWidget(splitter);
-    mainLayout->addWidget(m_bestSampleRankingButton);
+    mainLayout->addLayout(buttonLayout);
     
     setWidget(container); // QMdiSubWindow 设置子窗口内容
 
@@ -121,6 +134,9 @@ void TgBigDifferenceWorkbench::setupUi()
             this, &TgBigDifferenceWorkbench::onResultTableRowClicked);
     connect(m_bestSampleRankingButton, &QPushButton::clicked,
             this, &TgBigDifferenceWorkbench::onShowBestSampleRankingTable);
+    connect(m_computation, &WorkbenchComputationService::rowsReady,
+            this, &TgBigDifferenceWorkbench::onRankingRowsReady);
+    m_computation->bindProgress(this, windowTitle(), m_cancelComputationButton);
 }
 
 
@@ -200,26 +216,30 @@ void TgBigDifferenceWorkbench::calculateAndDisplay()
         QMessageBox::critical(this, tr("错误"), tr("未能找到参考样本的有效微分数据。"));
         return;
     }
-    
-    setWindowTitle(tr("大热重差异度分析 - 参考样本ID: %1").arg(m_referenceSampleId));
 
     // --- 2. 调用 Service 进行差异度计算 ---
     if (!m_appInitializer || !m_appInitializer->getSampleComparisonService()) {
         QMessageBox::critical(this, tr("严重错误"), tr("差异度对比服务不可用。"));
         return;
     }
-    SampleComparisonService* comparer = m_appInitializer->getSampleComparisonService();
-    
-    // 这个调用是同步的，因为所有数据都已在内存中
-    m_resultCache = comparer->calculateRankingFromCurves(referenceCurve, allDerivativeCurves);
+    // --- 3. 一次批量查询全部样本标识（图例与表格共用，不再逐曲线查询） ---
+    QList<int> sampleIds;
+    for (auto it = m_processedData.constBegin(); it != m_processedData.constEnd(); ++it) {
+        for (const SampleDataFlexible& sample : it.value().sampleDatas) {
+            sampleIds.append(sample.sampleId);
+        }
+    }
+    const QHash<int, SampleIdentifier> identifiers = WorkbenchComputationService::resolveIdentifiers(sampleIds);
+    m_model->setSampleIdentifiers(identifiers);
 
-    // --- 3. 填充结果表格 ---
-    // 模型内部已按排名规则排序（优先级高在前），这里不再额外按列重排
-    m_model->populate(m_resultCache);
+    // --- 4. 后台分块计算差异度，结果逐块流入表格（见 onRankingRowsReady） ---
+    m_resultCache.clear();
+    m_model->clear();
+    m_computation->startRanking(referenceCurve, allDerivativeCurves);
 
-    // --- 4. 绘制所有微分曲线到图表，并设置详细的图例名称 ---
+    // --- 5. 绘制所有微分曲线到图表，并设置详细的图例名称 ---
     m_chartView->clearGraphs();
-    SingleTobaccoSampleDAO sampleDao; // 创建 DAO 用于查询样本详情
+    QList<QSharedPointer<Curve>> plotCurves; // 分批加入图表，绘制大量曲线时界面保持响应
 
     int colorIndex = 0;
     // for (QSharedPointer<Curve> curve : allDerivativeCurves) {
@@ -233,8 +253,9 @@ void TgBigDifferenceWorkbench::calculateAndDisplay()
         // 仅绘制代表样或参考样本
         if (!sample.bestInGroup && sample.sampleId != m_referenceSampleId) continue;
         QSharedPointer<Curve> curve = getCurveFromStage(sample, StageName::Derivative);
+        if (curve.isNull()) continue;
         // 使用 DAO 获取详细的样本标识符
-        SampleIdentifier sid = sampleDao.getSampleIdentifierById(sample.sampleId);
+        const SampleIdentifier sid = identifiers.value(sample.sampleId);
         // DEBUG_LOG << " curve->sampleId():"<< it.key().toInt();
         QString legendName = QString("%1-%2-%3-%4")
                                 .arg(sid.projectName)
@@ -260,10 +281,16 @@ void TgBigDifferenceWorkbench::calculateAndDisplay()
             curve->setColor(curveColor);
         }
         
-        m_chartView->addCurve(curve);
+        plotCurves.append(curve);
     }
     }
-    m_chartView->replot();
+    m_chartView->addCurvesInBatches(plotCurves);
+}
+
+void TgBigDifferenceWorkbench::onRankingRowsReady(const QList<DifferenceResultRow>& rows)
+{
+    m_resultCache.append(rows);
+    m_model->appendRows(rows);
 }
 
 
@@ -301,6 +328,7 @@ void TgBigDifferenceWorkbench::onResultTableRowClicked(const QModelIndex &index)
 // TgBigDifferenceWorkbench.cpp
 void TgBigDifferenceWorkbench::closeEvent(QCloseEvent* event)
 {
+    if (m_computation) m_computation->cancel(); // 关闭窗口时放弃未完成的分块
     QMdiSubWindow::closeEvent(event);
     DEBUG_LOG << "TgBigDifferenceWorkbench::closeEvent() emitted";
     emit closed(this);  // 通知外部
@@ -513,6 +541,8 @@ void TgBigDifferenceWorkbench::onShowBestSampleRankingTable()
     double pearsonMin = 999.0, pearsonMax = -999.0;
 
     SampleComparisonService* comparer = m_appInitializer->getSampleComparisonService();
+    // 参考 × 全部曲线一次融合计算四项指标
+    const QVector<CurveMetricsKernel::PairMetrics> pairMetrics = comparer->compareToReference(referenceCurve, allCurves);
 
     for (int i = 0; i < allCurves.size(); ++i) {
         QSharedPointer<Curve> curve = allCurves[i];
@@ -521,10 +551,10 @@ void TgBigDifferenceWorkbench::onShowBestSampleRankingTable()
         int sampleId = curve->sampleId();
         QString samplePrefix = curve->name();
 
-        double rmsePlain = comparer->calculatePlainRMSE(referenceCurve, curve);
-        double rmseRaw = comparer->calculateNRMSE(referenceCurve, curve);
-        double pearsonRaw = comparer->calculatePearsonCorrelation(referenceCurve, curve);
-        double euclideanRaw = comparer->calculateEuclideanDistance(referenceCurve, curve);
+        double rmsePlain = pairMetrics[i].rmse;
+        double rmseRaw = pairMetrics[i].nrmse;
+        double pearsonRaw = pairMetrics[i].pearson;
+        double euclideanRaw = pairMetrics[i].euclidean;
 
         // 归一化区间仅基于“非基准样本”统计
         if (sampleId != m_referenceSampleId) {
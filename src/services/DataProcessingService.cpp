@@ -3,6 +3,7 @@
 #include "core/AppInitializer.h"  // 引入 AppInitializer 以便获取代表样选择服务
 #include "services/analysis/ParallelSampleAnalysisService.h" // 修复：需要完整类型以调用其成员方法
 #include "data_access/SampleDAO.h" // 假设有这个DAO
+#include "data_access/AlgoResultDAO.h" // 持久化阶段结果（algo_results）
 #include "services/algorithm/processing/IProcessingStep.h" // 包含接口
 #include "Logger.h"
 // 包含所有具体的算法策略...
@@ -23,7 +24,7 @@
 
 
 #include "data_access/SingleTobaccoSampleDAO.h"
-#include "data_access/DatabaseConnector.h" // 获取主数据库连接以克隆线程专用连接
+#include "data_access/DatabaseConnector.h" // 批量工作任务的线程专用连接（ScopedThreadConnection）
 #include <QSqlDatabase> // 线程内数据库连接
 // #include "core/common.h"
 
@@ -31,6 +32,10 @@
 #include <QDebug>
 #include <QString>
 #include <QElapsedTimer>
+#include <QAtomicInt>
+#include <QFuture>
+#include <QtConcurrent>
+#include <functional>
 
 namespace {
 
@@ -53,22 +58,100 @@ static QVariantMap peakSegMatlabSepuAlignBatchParams()
     return extra;
 }
 
-static QSharedPointer<Curve> chromPreferredCurveForAlignment(const SampleDataFlexible& sample,
-                                                            const ProcessingParameters& params)
+/** 流水线阶段结果：值类型曲线并写入样本ID（不创建 Curve 对象） */
+static CurveValue withSampleId(CurveValue curve, int sampleId)
+{
+    curve.setSampleId(sampleId);
+    return curve;
+}
+
+static CurveValue chromPreferredCurveForAlignment(const SampleDataFlexible& sample,
+                                                  const ProcessingParameters& params)
 {
     // 对齐严格对齐 MATLAB 流程：使用“基线校正后再裁剪”的曲线（Clip 阶段）
     for (const StageData& st : sample.stages) {
-        if (st.stageName == StageName::Clip && st.curve) return st.curve;
+        if (st.stageName == StageName::Clip && st.curve) return st.curve.value();
     }
 
     // 若未开启裁剪，退化到基线校正（兼容旧参数）
     if (!params.chromClipEnabled) {
         for (const StageData& st : sample.stages) {
-            if (st.stageName == StageName::BaselineCorrection && st.curve) return st.curve;
+            if (st.stageName == StageName::BaselineCorrection && st.curve) return st.curve.value();
         }
     }
 
-    return nullptr;
+    return CurveValue();
+}
+
+/** 色谱基线校正参数（单样本流水线与持久化结果键共用） */
+static QVariantMap chromBaselineParams(const ProcessingParameters& params)
+{
+    QVariantMap baselineParams;
+    baselineParams["lambda"] = params.lambda;
+    baselineParams["p"] = params.p;
+    baselineParams["order"] = params.order;
+    baselineParams["itermax"] = params.itermax;
+    baselineParams["wep"] = params.wep;
+    return baselineParams;
+}
+
+/** 色谱裁剪参数（单样本流水线与持久化结果键共用） */
+static QVariantMap chromClipParams(const ProcessingParameters& params)
+{
+    QVariantMap clipParams;
+    clipParams["by_index"] = params.chromClipByIndex;
+    clipParams["start_index1"] = params.chromClipStartIndex1;
+    clipParams["end_index1"] = params.chromClipEndIndex1;
+    clipParams["min_x"] = params.chromClipMinX;
+    clipParams["max_x"] = params.chromClipMaxX;
+    return clipParams;
+}
+
+/**
+ * 持久化结果（algo_results）的参数哈希：与 StageCache 相同的逐级串接，
+ * 但不含样本ID与会话内数据版本——这两者由表的行键与 raw_version 承担，重启后仍可命中。
+ */
+static QByteArray chromBaselinePersistKey(const ProcessingParameters& params)
+{
+    return StageCache::chainKey(QByteArrayLiteral("chrom"), QStringLiteral("baseline_correction"), chromBaselineParams(params));
+}
+
+/** 对齐输入（chromPreferredCurveForAlignment 所取曲线）的上游参数哈希 */
+static QByteArray chromAlignmentInputPersistKey(const ProcessingParameters& params)
+{
+    QByteArray key = params.baselineEnabled ? chromBaselinePersistKey(params) : QByteArrayLiteral("chrom");
+    if (params.chromClipEnabled)
+        key = StageCache::chainKey(key, QStringLiteral("chrom_clip"), chromClipParams(params));
+    return key;
+}
+
+/** 样本原始数据版本（原始阶段曲线的 CRC32）；无原始阶段时为 0 */
+static quint32 rawVersionOf(const SampleDataFlexible& sample)
+{
+    for (const StageData& st : sample.stages) {
+        if (st.stageName == StageName::RawData && st.curve) return AlgoResultDAO::rawVersion(st.curve.value());
+    }
+    return 0;
+}
+
+/** 将单样本结果按 "项目-批次-短码" 归入批量分组；markFirstAsBest 为 true 时组内首个样本标记为最优 */
+static void appendToBatchGroup(BatchGroupData& batchResults,
+                               const SampleIdentifier& identifier,
+                               const SampleDataFlexible& singleSample,
+                               bool markFirstAsBest)
+{
+    const QString groupKey = QString("%1-%2-%3").arg(identifier.projectName).arg(identifier.batchCode).arg(identifier.shortCode);
+
+    // 构造或获取已有的 SampleGroup
+    SampleGroup &group = batchResults[groupKey];
+    group.projectName = identifier.projectName;
+    group.batchCode   = identifier.batchCode;
+    group.shortCode   = identifier.shortCode;
+
+    group.sampleDatas.append(singleSample);
+    if (markFirstAsBest && group.sampleDatas.size() == 1) {
+        group.sampleDatas[0].bestInGroup = true;
+    }
 }
 
 } // namespace
@@ -77,6 +160,7 @@ static QSharedPointer<Curve> chromPreferredCurveForAlignment(const SampleDataFle
 DataProcessingService::DataProcessingService(QObject *parent) : QObject(parent) {
     // 记录并保存 AppInitializer 指针（父对象即为 AppInitializer）
     m_appInitializer = qobject_cast<AppInitializer*>(parent);
+    m_batchPool.setMaxThreadCount(QThread::idealThreadCount());
     registerSteps();
 }
 DataProcessingService::~DataProcessingService() {
@@ -112,27 +196,148 @@ void DataProcessingService::registerSteps() {
     m_registeredSteps["peakseg_cow_alignment"] = new PeakSegCOWAlignment();
 }
 
-// 为当前线程确保一个独立的数据库连接，避免跨线程使用同一连接导致崩溃
-static QSqlDatabase ensureThreadLocalDatabase()
+static SampleDAO pipelineSampleDAO(const SamplePipelineContext& context)
+{
+    if (context.db.isValid()) return SampleDAO(context.db);
+    return SampleDAO();
+}
+
+static AlgoResultDAO pipelineAlgoResultDAO(const SamplePipelineContext& context)
+{
+    if (context.db.isValid()) return AlgoResultDAO(context.db);
+    return AlgoResultDAO();
+}
+
+// 读取单样本原始曲线：命中批量预取结果时直接取列数组（隐式共享，无拷贝），否则逐样本查询
+static bool loadRawColumns(const SamplePipelineContext& context, SampleDAO& dao, int sampleId, DataType dataType,
+                           QVector<double>& x, QVector<double>& y, QString& error)
+{
+    if (context.prefetchedCurves) {
+        auto it = context.prefetchedCurves->constFind(sampleId);
+        if (it != context.prefetchedCurves->constEnd()) {
+            x = it->x;
+            y = it->y;
+            return !x.isEmpty();
+        }
+    }
+
+    const QVector<QPointF> rawPoints = dao.fetchChartDataForSample(sampleId, dataType, error);
+    x.clear();
+    y.clear();
+    x.reserve(rawPoints.size());
+    y.reserve(rawPoints.size());
+    for (const auto& p : rawPoints) { x.append(p.x()); y.append(p.y()); }
+    return !x.isEmpty();
+}
+
+void DataProcessingService::setBatchThreadCount(int threadCount)
+{
+    m_batchPool.setMaxThreadCount(threadCount > 0 ? threadCount : QThread::idealThreadCount());
+}
+
+int DataProcessingService::batchThreadCount() const
+{
+    return m_batchPool.maxThreadCount();
+}
+
+QVector<SampleDataFlexible> DataProcessingService::runSamplesInParallel(
+    const QList<int> &sampleIds,
+    const ProcessingParameters &params,
+    DataType dataType,
+    SamplePipelineFn pipeline,
+    QVector<SampleIdentifier> &identifiers)
 {
-    QString connName = QStringLiteral("ta_thread_conn_%1").arg(reinterpret_cast<quintptr>(QThread::currentThreadId()));
-    if (QSqlDatabase::contains(connName)) {
-        QSqlDatabase db = QSqlDatabase::database(connName);
-        if (!db.isOpen()) db.open();
-        return db;
+    const int total = sampleIds.size();
+    QVector<SampleDataFlexible> samples(total);
+    identifiers = QVector<SampleIdentifier>(total);
+    if (total == 0) return samples;
+
+    const StageCache::Stats statsBefore = m_stageCache.stats();
+
+    // 批量预取：全部原始曲线与样本标识符各一条查询，替代逐样本往返；原始阶段已缓存的样本不再读取曲线
+    QList<int> rawFetchIds;
+    for (int sampleId : sampleIds) {
+        if (!StageCache::Chain(&m_stageCache, dataType, sampleId).contains(QStringLiteral("raw")))
+            rawFetchIds.append(sampleId);
+    }
+    QHash<int, SampleCurveColumns> prefetchedCurves;
+    QHash<int, SampleIdentifier> prefetchedIdentifiers;
+    {
+        ScopedThreadConnection prefetchConnection;
+        QString prefetchError;
+        if (!rawFetchIds.isEmpty())
+            prefetchedCurves = SampleDAO(prefetchConnection.database()).fetchChartDataForSamples(rawFetchIds, dataType, prefetchError);
+        if (!prefetchError.isEmpty()) {
+            WARNING_LOG << "Bulk raw data fetch failed, falling back to per-sample queries:" << prefetchError;
+        }
+        prefetchedIdentifiers = SingleTobaccoSampleDAO(prefetchConnection.database()).getSampleIdentifiersByIds(sampleIds);
     }
-    QSqlDatabase base = DatabaseConnector::getInstance().getDatabase();
-    QSqlDatabase db = QSqlDatabase::cloneDatabase(base, connName);
-    db.open();
-    return db;
+
+    // 每个工作任务从共享游标领取下一个样本（负载均衡），结果写入各自下标，互不重叠
+    SampleDataFlexible* sampleOut = samples.data();
+    SampleIdentifier* identifierOut = identifiers.data();
+    QAtomicInt nextIndex(0);
+    QAtomicInt finishedCount(0);
+
+    const int workerCount = qMin(total, qMax(1, m_batchPool.maxThreadCount()));
+    QList<QFuture<void>> futures;
+    for (int w = 0; w < workerCount; ++w) {
+        futures.append(QtConcurrent::run(&m_batchPool, [&]() {
+            // 本任务专用连接：任务结束时随 connection 析构关闭并移除（context/dao 先析构）
+            ScopedThreadConnection connection;
+            SamplePipelineContext context;
+            context.db = connection.database();
+            context.prefetchedCurves = prefetchedCurves.isEmpty() ? nullptr : &prefetchedCurves;
+            SingleTobaccoSampleDAO dao(connection.database());
+            for (int i = nextIndex.fetchAndAddOrdered(1); i < total; i = nextIndex.fetchAndAddOrdered(1)) {
+                const int sampleId = sampleIds.at(i);
+                sampleOut[i] = (this->*pipeline)(context, sampleId, params);
+                auto idIt = prefetchedIdentifiers.constFind(sampleId);
+                identifierOut[i] = (idIt != prefetchedIdentifiers.constEnd())
+                                       ? idIt.value() : dao.getSampleIdentifierById(sampleId);
+                emit batchSampleProgress(finishedCount.fetchAndAddOrdered(1) + 1, total, sampleId);
+            }
+        }));
+    }
+    for (QFuture<void>& f : futures) f.waitForFinished();
+
+    const StageCache::Stats statsAfter = m_stageCache.stats();
+    INFO_LOG << "Stage cache:" << total << "sample(s)," << (statsAfter.hits - statsBefore.hits) << "hit(s),"
+             << (statsAfter.misses - statsBefore.misses) << "miss(es)," << (statsAfter.evictions - statsBefore.evictions)
+             << "eviction(s); raw fetched for" << rawFetchIds.size() << "sample(s);" << statsAfter.entries << "entries,"
+             << (statsAfter.usedBytes / 1024) << "/" << (statsAfter.budgetBytes / 1024) << "KB";
+
+    return samples;
+}
+
+void DataProcessingService::setStageCacheBudget(qint64 budgetBytes)
+{
+    m_stageCache.setBudget(budgetBytes);
+}
+
+void DataProcessingService::invalidateStageCache(int sampleId)
+{
+    if (sampleId < 0) m_stageCache.invalidateAll();
+    else m_stageCache.invalidateSample(sampleId);
+}
+
+StageCache::Stats DataProcessingService::stageCacheStats() const
+{
+    return m_stageCache.stats();
 }
 
 SampleDataFlexible DataProcessingService::runTgBigPipeline(int sampleId, const ProcessingParameters &params)
 {
-    return runTgBigLikePipeline(DataType::TG_BIG, sampleId, params);
+    return runTgBigPipeline(SamplePipelineContext(), sampleId, params);
+}
+
+SampleDataFlexible DataProcessingService::runTgBigPipeline(const SamplePipelineContext &context, int sampleId, const ProcessingParameters &params)
+{
+    return runTgBigLikePipeline(context, DataType::TG_BIG, sampleId, params);
 }
 
-SampleDataFlexible DataProcessingService::runTgBigLikePipeline(DataType dataType, int sampleId, const ProcessingParameters &params)
+SampleDataFlexible DataProcessingService::runTgBigLikePipeline(const SamplePipelineContext &context, DataType dataType, int sampleId,
+                                                               const ProcessingParameters &params)
 {
     DEBUG_LOG << "Pipeline running in thread:" << QThread::currentThread();
     // DEBUG_LOG << "Processing parameters:" << params << "sampleId" << sampleId;
@@ -141,7 +346,7 @@ SampleDataFlexible DataProcessingService::runTgBigLikePipeline(DataType dataType
     sampleData.sampleId = sampleId;
     sampleData.dataType = dataType;
     QString error;
-    SampleDAO dao;
+    SampleDAO dao = pipelineSampleDAO(context);
 
     
     // 构造阶段数据
@@ -157,52 +362,46 @@ SampleDataFlexible DataProcessingService::runTgBigLikePipeline(DataType dataType
     QElapsedTimer timer;  //  先声明
     timer.restart();
 
-    // --- 1. 获取原始数据 ---
-    QVector<QPointF> rawPoints = dao.fetchChartDataForSample(sampleId, dataType, error);
-    if (rawPoints.isEmpty()) {
-        WARNING_LOG << "Pipeline failed: No raw data for sample" << sampleId;
-        return sampleData;
-    }
+    // 阶段缓存键链：参数未变的前序阶段（含原始数据读取）直接复用缓存结果
+    StageCache::Chain cacheChain(&m_stageCache, dataType, sampleId);
+    // 接力棒：后续阶段的输入
+    CurveValue currentCurve;
 
-    QVector<QPointF> workingPoints = rawPoints;
-    if (dataType == DataType::TG_BIG) {
-        // 对齐 V2.2.1_origin 的固定裁剪策略（索引起点=60，最大长度=341）
-        int fixedStartIndex = 60;            // MATLAB: fixedStartPoint=60
-        int fixedMaxLength  = 341;           // MATLAB: MaxLength=341
-        int n = rawPoints.size();
-        int startIdx = qMin(qMax(0, fixedStartIndex), n);
-        int maxLen   = qMin(fixedMaxLength, n - startIdx);
-        if (maxLen < 0) maxLen = 0;
-        QVector<QPointF> fixedSegment;
-        fixedSegment.reserve(maxLen);
-        for (int i = 0; i < maxLen; ++i) {
-            fixedSegment.append(rawPoints[startIdx + i]);
+    // --- 1. 获取原始数据 ---
+    if (!cacheChain.restore(QStringLiteral("raw"), QVariantMap(), stage, sampleData, currentCurve)) {
+        QVector<double> x, y;
+        if (!loadRawColumns(context, dao, sampleId, dataType, x, y, error)) {
+            WARNING_LOG << "Pipeline failed: No raw data for sample" << sampleId;
+            return sampleData;
         }
-        workingPoints = fixedSegment;
-    }
-
-    QVector<double> x, y;
-    for (const auto& p : workingPoints) { x.append(p.x()); y.append(p.y()); }
-    stage.stageName = StageName::RawData;
 
-    DEBUG_LOG << "CURVE前：" ;
-    stage.curve = QSharedPointer<Curve>::create(x, y, "原始数据");
-    stage.curve->setSampleId(sampleId);
-
-    DEBUG_LOG << "CURVE后:";
+        if (dataType == DataType::TG_BIG) {
+            // 对齐 V2.2.1_origin 的固定裁剪策略（索引起点=60，最大长度=341）
+            int fixedStartIndex = 60;            // MATLAB: fixedStartPoint=60
+            int fixedMaxLength  = 341;           // MATLAB: MaxLength=341
+            int n = x.size();
+            int startIdx = qMin(qMax(0, fixedStartIndex), n);
+            int maxLen   = qMin(fixedMaxLength, n - startIdx);
+            if (maxLen < 0) maxLen = 0;
+            x = x.mid(startIdx, maxLen);
+            y = y.mid(startIdx, maxLen);
+        }
 
-    stage.algorithm = AlgorithmType::None;
-    stage.isSegmented = false;
-    stage.numSegments = 1;
+        stage.stageName = StageName::RawData;
+        stage.curve = withSampleId(CurveValue(x, y, "原始数据"), sampleId);
+        stage.algorithm = AlgorithmType::None;
+        stage.isSegmented = false;
+        stage.numSegments = 1;
 
-    sampleData.stages.append(stage);
+        sampleData.stages.append(stage);
+        cacheChain.store(stage);
+        currentCurve = stage.curve.value();
+    }
 
     // DEBUG_LOG << "大热重单样本原始数据用时：" << timer.elapsed() << "ms";
     timer.restart();
 
     // --- 2. 流水线处理 ---
-    // 【修正】接力棒现在是智能指针，保证所有权清晰
-    QSharedPointer<Curve> currentCurve = stage.curve;
 
     // --- 阶段1.5: 坏点修复 (对齐 Copy_of_V2.2) ---
     // 在裁剪和归一化之前进行坏点修复，以避免异常值影响后续处理
@@ -225,28 +424,30 @@ SampleDataFlexible DataProcessingService::runTgBigLikePipeline(DataType dataType
         repairParams["eps_scale"]      = params.epsScale;            // 平台严格递减斜率尺度
         repairParams["interp_method"]  = params.interpMethod;        // 插值方法：pchip/linear
         
-        ProcessingResult res = step->process({currentCurve.data()}, repairParams, error);
+        if (!cacheChain.restore(QStringLiteral("bad_point_repair"), repairParams, stage, sampleData, currentCurve)) {
+            ProcessingResult res = step->process({currentCurve}, repairParams, error);
         
-        if (!res.namedCurves.isEmpty() && res.namedCurves.contains("repaired")) {
-            // DEBUG_LOG << "BadPointRepair succeeded";
+            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("repaired")) {
+                // DEBUG_LOG << "BadPointRepair succeeded";
             
-            stage.stageName = StageName::BadPointRepair;
-            stage.curve = QSharedPointer<Curve>(res.namedCurves.value("repaired").first());
-            stage.curve->setSampleId(sampleId);
-            stage.algorithm = AlgorithmType::BadPointRepair;
-            stage.isSegmented = false;
-            stage.numSegments = 1;
+                stage.stageName = StageName::BadPointRepair;
+                stage.curve = withSampleId(res.namedCurves.value("repaired").first(), sampleId);
+                stage.algorithm = AlgorithmType::BadPointRepair;
+                stage.isSegmented = false;
+                stage.numSegments = 1;
             
-            // 记录该阶段，但不一定需要在 UI 上单独展示，除非用户想看
-            sampleData.stages.append(stage);
+                // 记录该阶段，但不一定需要在 UI 上单独展示，除非用户想看
+                sampleData.stages.append(stage);
+                cacheChain.store(stage);
             
-            // 【关键】更新接力棒
-            currentCurve = stage.curve;
-        } else {
-            // 即使没有坏点被修复，通常也会返回一条曲线（可能与输入相同），
-            // 如果返回为空则说明出错或无坏点（视实现而定）。
-            // 若实现是“无坏点则不返回 repaired”，则保持 currentCurve 不变。
-            // 假设 BadPointRepair 总是返回 repaired
+                // 【关键】更新接力棒
+                currentCurve = stage.curve.value();
+            } else {
+                // 即使没有坏点被修复，通常也会返回一条曲线（可能与输入相同），
+                // 如果返回为空则说明出错或无坏点（视实现而定）。
+                // 若实现是“无坏点则不返回 repaired”，则保持 currentCurve 不变。
+                // 假设 BadPointRepair 总是返回 repaired
+            }
         }
     }
 
@@ -282,29 +483,31 @@ SampleDataFlexible DataProcessingService::runTgBigLikePipeline(DataType dataType
             // DEBUG_LOG << "Clipping parameters:" << clipParams;
 
             // 【修正】使用 -> 操作符，并通过 .data() 获取裸指针传递
-            ProcessingResult res = step->process({currentCurve.data()}, clipParams, error);
+            if (!cacheChain.restore(QStringLiteral("clipping"), clipParams, stage, sampleData, currentCurve)) {
+                ProcessingResult res = step->process({currentCurve}, clipParams, error);
 
-            // DEBUG_LOG << "Clipping result:" ;
+                // DEBUG_LOG << "Clipping result:" ;
 
-            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("clipped")) {
-                // DEBUG_LOG << "Clipping succeeded";
-                // 接管返回的裸指针，并更新接力棒
-                // results.cleaned = QSharedPointer<Curve>(res.namedCurves.value("clipped").first());
-                // results.cleaned->setSampleId(sampleId);
+                if (!res.namedCurves.isEmpty() && res.namedCurves.contains("clipped")) {
+                    // DEBUG_LOG << "Clipping succeeded";
+                    // 接管返回的裸指针，并更新接力棒
+                    // results.cleaned = QSharedPointer<Curve>(res.namedCurves.value("clipped").first());
+                    // results.cleaned->setSampleId(sampleId);
 
-                stage.stageName = StageName::Clip;
-                stage.curve = QSharedPointer<Curve>(res.namedCurves.value("clipped").first());
-                stage.curve->setSampleId(sampleId);
-                stage.algorithm = AlgorithmType::Clip;
-                stage.isSegmented = false;
-                stage.numSegments = 1;
+                    stage.stageName = StageName::Clip;
+                    stage.curve = withSampleId(res.namedCurves.value("clipped").first(), sampleId);
+                    stage.algorithm = AlgorithmType::Clip;
+                    stage.isSegmented = false;
+                    stage.numSegments = 1;
 
-                // currentCurve = results.cleaned;
-                sampleData.stages.append(stage);
+                    // currentCurve = results.cleaned;
+                    sampleData.stages.append(stage);
+                    cacheChain.store(stage);
 
-                // 【关键】更新接力棒：后续归一化/平滑/微分均应基于裁剪后的曲线
-                // 中文说明：如果不在此更新，后续阶段会继续沿用原始曲线，导致 X 轴范围回退到原始数据范围。
-                currentCurve = stage.curve;
+                    // 【关键】更新接力棒：后续归一化/平滑/微分均应基于裁剪后的曲线
+                    // 中文说明：如果不在此更新，后续阶段会继续沿用原始曲线，导致 X 轴范围回退到原始数据范围。
+                    currentCurve = stage.curve.value();
+                }
             }
         }
     }
@@ -334,23 +537,25 @@ SampleDataFlexible DataProcessingService::runTgBigLikePipeline(DataType dataType
             // normParams["rangeMax"] = params.normalizationRangeMax;
 
             // 【修正】使用 -> 操作符，并通过 .data() 获取裸指针传递
-            ProcessingResult res = step->process({currentCurve.data()}, normParams, error);
-
-            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("normalized")) {
-                // 接管返回的裸指针，并更新接力棒
-                // 归一化阶段完成后，将接力棒 currentCurve 更新为归一化结果，
-                // 以确保后续平滑、微分等阶段基于 [0,1] 范围的数据处理。
-                stage.stageName = StageName::Normalize;
-                stage.curve = QSharedPointer<Curve>(res.namedCurves.value("normalized").first());
-                stage.curve->setSampleId(sampleId);
-                stage.algorithm = AlgorithmType::Normalize;
-                stage.isSegmented = false;
-                stage.numSegments = 1;
+            if (!cacheChain.restore(QStringLiteral("normalization"), normParams, stage, sampleData, currentCurve)) {
+                ProcessingResult res = step->process({currentCurve}, normParams, error);
+
+                if (!res.namedCurves.isEmpty() && res.namedCurves.contains("normalized")) {
+                    // 接管返回的裸指针，并更新接力棒
+                    // 归一化阶段完成后，将接力棒 currentCurve 更新为归一化结果，
+                    // 以确保后续平滑、微分等阶段基于 [0,1] 范围的数据处理。
+                    stage.stageName = StageName::Normalize;
+                    stage.curve = withSampleId(res.namedCurves.value("normalized").first(), sampleId);
+                    stage.algorithm = AlgorithmType::Normalize;
+                    stage.isSegmented = false;
+                    stage.numSegments = 1;
 
-                sampleData.stages.append(stage);
+                    sampleData.stages.append(stage);
+                    cacheChain.store(stage);
 
-                // 【关键】更新接力棒用于后续阶段
-                currentCurve = stage.curve;
+                    // 【关键】更新接力棒用于后续阶段
+                    currentCurve = stage.curve.value();
+                }
             }
         }
     }
@@ -368,18 +573,20 @@ SampleDataFlexible DataProcessingService::runTgBigLikePipeline(DataType dataType
             QVariantMap smoothParams;
             // Loess 平滑使用参数 fraction（窗口比例），若未配置则使用算法默认参数
             smoothParams["fraction"] = params.loessSpan;
-            ProcessingResult res = step->process({currentCurve.data()}, smoothParams, error);
-            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("smoothed")) {
-                stage.stageName = StageName::Smooth;
-                stage.curve = QSharedPointer<Curve>(res.namedCurves.value("smoothed").first());
-                stage.curve->setSampleId(sampleId);
-                stage.algorithm = (sm == "loess") ? AlgorithmType::Smooth_Loess : AlgorithmType::Smooth_SG;
-                stage.isSegmented = false;
-                stage.numSegments = 1;
-                sampleData.stages.append(stage);
-                currentCurve = stage.curve;
-            } else {
-                WARNING_LOG << "平滑阶段无结果：未返回 smoothed 曲线";
+            if (!cacheChain.restore(methodId, smoothParams, stage, sampleData, currentCurve)) {
+                ProcessingResult res = step->process({currentCurve}, smoothParams, error);
+                if (!res.namedCurves.isEmpty() && res.namedCurves.contains("smoothed")) {
+                    stage.stageName = StageName::Smooth;
+                    stage.curve = withSampleId(res.namedCurves.value("smoothed").first(), sampleId);
+                    stage.algorithm = (sm == "loess") ? AlgorithmType::Smooth_Loess : AlgorithmType::Smooth_SG;
+                    stage.isSegmented = false;
+                    stage.numSegments = 1;
+                    sampleData.stages.append(stage);
+                    cacheChain.store(stage);
+                    currentCurve = stage.curve.value();
+                } else {
+                    WARNING_LOG << "平滑阶段无结果：未返回 smoothed 曲线";
+                }
             }
         } else {
             WARNING_LOG << "未注册的平滑算法:" << methodId;
@@ -402,23 +609,26 @@ SampleDataFlexible DataProcessingService::runTgBigLikePipeline(DataType dataType
                 derivParams["poly_order"] = params.derivSgPolyOrder;
                 // 【关键】明确告诉 SG 算法，这次是做一阶求导
                 derivParams["derivative_order"] = 1; 
+                derivParams["outputs"] = "derivative"; // 只计算导数
             }
             
             // 注意：微分的输入，通常是平滑后的数据 (currentCurve)
-            ProcessingResult res = step->process({currentCurve.data()}, derivParams, error);
-
-            if (res.namedCurves.contains("derivative1")) {
-                //  results.derivative = QSharedPointer<Curve>(res.namedCurves.value("derivative1").first());
-                //  results.derivative->setSampleId(sampleId);
-                stage.stageName = StageName::Derivative;
-                stage.curve = QSharedPointer<Curve>(res.namedCurves.value("derivative1").first());
-                stage.curve->setSampleId(sampleId);
-                stage.algorithm = AlgorithmType::Derivative_SG;
-                stage.isSegmented = false;
-                stage.numSegments = 1;
+            if (!cacheChain.restore(derivativeMethodId, derivParams, stage, sampleData, currentCurve)) {
+                ProcessingResult res = step->process({currentCurve}, derivParams, error);
 
-                sampleData.stages.append(stage);
+                if (res.namedCurves.contains("derivative1")) {
+                    //  results.derivative = QSharedPointer<Curve>(res.namedCurves.value("derivative1").first());
+                    //  results.derivative->setSampleId(sampleId);
+                    stage.stageName = StageName::Derivative;
+                    stage.curve = withSampleId(res.namedCurves.value("derivative1").first(), sampleId);
+                    stage.algorithm = AlgorithmType::Derivative_SG;
+                    stage.isSegmented = false;
+                    stage.numSegments = 1;
 
+                    sampleData.stages.append(stage);
+                    cacheChain.store(stage);
+
+                }
             }
         }
     }
@@ -454,44 +664,19 @@ BatchGroupData DataProcessingService::runTgBigPipelineForMultiple(
     const ProcessingParameters &params)
 {
     BatchGroupData batchResults;
-    SingleTobaccoSampleDAO dao;
 
     DEBUG_LOG << "Processing small TG samples:" << sampleIds;
 
     QElapsedTimer timer;  //先声明
     timer.restart();
 
-
-    for (int sampleId : sampleIds) {
-        // 单样本处理
-        SampleDataFlexible singleSample = runTgBigPipeline(sampleId, params);
-        SampleIdentifier identifier = dao.getSampleIdentifierById(sampleId);
-        QString projectName = identifier.projectName;
-        QString batchCode = identifier.batchCode;
-        QString shortCode = identifier.shortCode;
-        QString groupKey  = QString("%1-%2-%3").arg(projectName).arg(batchCode).arg(shortCode);
-
-        // // 插入批量结果
-        // batchResults.insert(name, singleSample);
-
-        // 构造或获取已有的 SampleGroup
-        SampleGroup &group = batchResults[groupKey];
-        group.projectName = projectName;
-        group.batchCode   = batchCode;
-        group.shortCode   = shortCode;
-
-        
-        // // 添加单样本到平行样本列表
-        // group.parallelSamples.append(singleSample);
-
-        // // 用 SampleDataFlexible 构造 ParallelSampleData
-        // ParallelSampleData parallelSample;
-        // parallelSample.sampleData = singleSample;
-        // parallelSample.parallelNo = identifier.parallelNo;  // 直接使用 identifier 中的 parallel_no
-
+    // 单样本流水线并行执行，结果按 sampleIds 顺序合并
+    QVector<SampleIdentifier> identifiers;
+    const QVector<SampleDataFlexible> samples = runSamplesInParallel(
+        sampleIds, params, DataType::TG_BIG, &DataProcessingService::runTgBigPipeline, identifiers);
+    for (int i = 0; i < samples.size(); ++i) {
         // 添加到组内样本列表（不在此处打 bestInGroup 标记，由代表样选择服务统一处理）
-        group.sampleDatas.append(singleSample);
-
+        appendToBatchGroup(batchResults, identifiers[i], samples[i], false);
     }
 
     DEBUG_LOG << "大热重批量样本处理用时：" << timer.elapsed() << "ms";
@@ -528,6 +713,11 @@ BatchGroupData DataProcessingService::runTgBigPipelineForMultiple(
 
 // ---------------- 单样本流水线 ----------------
 SampleDataFlexible DataProcessingService::runTgSmallPipeline(int sampleId, const ProcessingParameters &params)
+{
+    return runTgSmallPipeline(SamplePipelineContext(), sampleId, params);
+}
+
+SampleDataFlexible DataProcessingService::runTgSmallPipeline(const SamplePipelineContext &context, int sampleId, const ProcessingParameters &params)
 {
     DEBUG_LOG << "Small pipeline running in thread:" << QThread::currentThread();
 
@@ -535,32 +725,32 @@ SampleDataFlexible DataProcessingService::runTgSmallPipeline(int sampleId, const
     sampleData.sampleId = sampleId;
     sampleData.dataType = DataType::TG_SMALL;
     QString error;
-    SampleDAO dao;
-
-    // --- 获取原始数据（微分数据） ---
-    QVector<QPointF> rawPoints = dao.fetchChartDataForSample(sampleId, DataType::TG_SMALL, error);
-    if (rawPoints.isEmpty()) {
-        WARNING_LOG << "Pipeline failed: No raw data for sample" << sampleId;
-        return sampleData;
-    }
+    SampleDAO dao = pipelineSampleDAO(context);
 
-    QVector<double> x, y;
-    for (const auto &p : rawPoints) {
-        x.append(p.x());
-        y.append(p.y());
-    }
+    StageCache::Chain cacheChain(&m_stageCache, DataType::TG_SMALL, sampleId);
+    CurveValue rawCurve;
 
-    // RawData 阶段
+    // --- 获取原始数据（微分数据） ---
     StageData rawStage;
-    rawStage.stageName = StageName::RawData;
-    rawStage.curve = QSharedPointer<Curve>::create(x, y, "原始微分数据0");
-    rawStage.curve->setSampleId(sampleId);
-    rawStage.algorithm = AlgorithmType::None;
-    rawStage.isSegmented = false;
-    rawStage.numSegments = 1;
-    sampleData.stages.append(rawStage);
+    if (!cacheChain.restore(QStringLiteral("raw"), QVariantMap(), rawStage, sampleData, rawCurve)) {
+        QVector<double> x, y;
+        if (!loadRawColumns(context, dao, sampleId, DataType::TG_SMALL, x, y, error)) {
+            WARNING_LOG << "Pipeline failed: No raw data for sample" << sampleId;
+            return sampleData;
+        }
 
-    DEBUG_LOG << "Sample" << sampleId << "original points:" << x.size();
+        // RawData 阶段
+        rawStage.stageName = StageName::RawData;
+        rawStage.curve = withSampleId(CurveValue(x, y, "原始微分数据0"), sampleId);
+        rawStage.algorithm = AlgorithmType::None;
+        rawStage.isSegmented = false;
+        rawStage.numSegments = 1;
+        sampleData.stages.append(rawStage);
+        cacheChain.store(rawStage);
+        rawCurve = rawStage.curve.value();
+
+        DEBUG_LOG << "Sample" << sampleId << "original points:" << x.size();
+    }
 
     // 小热重（非原始数据）同样支持裁剪参数：clippingEnabled / clipMinX / clipMaxX
     if (params.clippingEnabled && m_registeredSteps.contains("clipping")) {
@@ -569,28 +759,30 @@ SampleDataFlexible DataProcessingService::runTgSmallPipeline(int sampleId, const
         clipParams["min_x"] = params.clipMinX;
         clipParams["max_x"] = params.clipMaxX;
 
-        ProcessingResult res = clipStep->process({rawStage.curve.data()}, clipParams, error);
-        if (!res.namedCurves.isEmpty() && res.namedCurves.contains("clipped") && !res.namedCurves.value("clipped").isEmpty()) {
-            StageData clipStage;
-            clipStage.stageName = StageName::Clip;
-            clipStage.curve = QSharedPointer<Curve>(res.namedCurves.value("clipped").first());
-            if (!clipStage.curve.isNull()) {
-                clipStage.curve->setSampleId(sampleId);
-            }
-
-            // 裁剪结果必须有有效点位才纳入阶段数据，避免前端拿到“空曲线对象”导致不显示。
-            if (!clipStage.curve.isNull() && clipStage.curve->pointCount() > 0) {
-                clipStage.algorithm = AlgorithmType::Clip;
-                clipStage.isSegmented = false;
-                clipStage.numSegments = 1;
-                sampleData.stages.append(clipStage);
+        StageData clipStage;
+        CurveValue clippedCurve;
+        if (!cacheChain.restore(QStringLiteral("clipping"), clipParams, clipStage, sampleData, clippedCurve)) {
+            ProcessingResult res = clipStep->process({rawCurve}, clipParams, error);
+            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("clipped") && !res.namedCurves.value("clipped").isEmpty()) {
+                clipStage.stageName = StageName::Clip;
+                const CurveValue clipped = withSampleId(res.namedCurves.value("clipped").first(), sampleId);
+                clipStage.curve = clipped;
+
+                // 裁剪结果必须有有效点位才纳入阶段数据，避免前端拿到“空曲线对象”导致不显示。
+                if (clipped.pointCount() > 0) {
+                    clipStage.algorithm = AlgorithmType::Clip;
+                    clipStage.isSegmented = false;
+                    clipStage.numSegments = 1;
+                    sampleData.stages.append(clipStage);
+                    cacheChain.store(clipStage);
+                } else {
+                    WARNING_LOG << "TG_SMALL clipping produced empty curve points, sampleId=" << sampleId
+                                << ", min_x=" << params.clipMinX << ", max_x=" << params.clipMaxX;
+                }
             } else {
-                WARNING_LOG << "TG_SMALL clipping produced empty curve points, sampleId=" << sampleId
+                WARNING_LOG << "TG_SMALL clipping produced empty result, sampleId=" << sampleId
                             << ", min_x=" << params.clipMinX << ", max_x=" << params.clipMaxX;
             }
-        } else {
-            WARNING_LOG << "TG_SMALL clipping produced empty result, sampleId=" << sampleId
-                        << ", min_x=" << params.clipMinX << ", max_x=" << params.clipMaxX;
         }
     }
 
@@ -599,7 +791,12 @@ SampleDataFlexible DataProcessingService::runTgSmallPipeline(int sampleId, const
 
 SampleDataFlexible DataProcessingService::runTgSmallRawPipeline(int sampleId, const ProcessingParameters &params)
 {
-    return runTgBigLikePipeline(DataType::TG_SMALL_RAW, sampleId, params);
+    return runTgSmallRawPipeline(SamplePipelineContext(), sampleId, params);
+}
+
+SampleDataFlexible DataProcessingService::runTgSmallRawPipeline(const SamplePipelineContext &context, int sampleId, const ProcessingParameters &params)
+{
+    return runTgBigLikePipeline(context, DataType::TG_SMALL_RAW, sampleId, params);
 }
 
 // ---------------- 批量样本流水线 ----------------
@@ -608,44 +805,15 @@ BatchGroupData DataProcessingService::runTgSmallPipelineForMultiple(
     const ProcessingParameters &params)
 {
     BatchGroupData batchResults;
-    SingleTobaccoSampleDAO dao;
 
     DEBUG_LOG << "Processing small TG samples:" << sampleIds;
 
-    for (int sampleId : sampleIds) {
-        // 单样本处理
-        SampleDataFlexible singleSample = runTgSmallPipeline(sampleId, params);
-        SampleIdentifier identifier = dao.getSampleIdentifierById(sampleId);
-        QString projectName = identifier.projectName;
-        QString batchCode = identifier.batchCode;
-        QString shortCode = identifier.shortCode;
-        QString groupKey  = QString("%1-%2-%3").arg(projectName).arg(batchCode).arg(shortCode);
-
-        // // 插入批量结果
-        // batchResults.insert(name, singleSample);
-
-        // 构造或获取已有的 SampleGroup
-        SampleGroup &group = batchResults[groupKey];
-        group.projectName = projectName;
-        group.batchCode   = batchCode;
-        group.shortCode   = shortCode;
-
-        
-        // // 添加单样本到平行样本列表
-        // group.parallelSamples.append(singleSample);
-
-        // // 用 SampleDataFlexible 构造 ParallelSampleData
-        // ParallelSampleData parallelSample;
-        // parallelSample.sampleData = singleSample;
-        // parallelSample.parallelNo = identifier.parallelNo;  // 直接使用 identifier 中的 parallel_no
-
-        // 添加到平行样本列表
-        group.sampleDatas.append(singleSample);
-        // 如果这是组内第一个样本，就标记为最优
-        if (group.sampleDatas.size() == 1) {
-            group.sampleDatas[0].bestInGroup = true;
-        }
-
+    QVector<SampleIdentifier> identifiers;
+    const QVector<SampleDataFlexible> samples = runSamplesInParallel(
+        sampleIds, params, DataType::TG_SMALL, &DataProcessingService::runTgSmallPipeline, identifiers);
+    for (int i = 0; i < samples.size(); ++i) {
+        // 按输入顺序合并：组内第一个样本标记为最优
+        appendToBatchGroup(batchResults, identifiers[i], samples[i], true);
     }
 
     // // 调试输出每个样本的数据点数
@@ -670,27 +838,14 @@ BatchGroupData DataProcessingService::runTgSmallRawPipelineForMultiple(
     const ProcessingParameters &params)
 {
     BatchGroupData batchResults;
-    SingleTobaccoSampleDAO dao;
 
     DEBUG_LOG << "Processing small raw TG samples:" << sampleIds;
 
-    for (int sampleId : sampleIds) {
-        SampleDataFlexible singleSample = runTgSmallRawPipeline(sampleId, params);
-        SampleIdentifier identifier = dao.getSampleIdentifierById(sampleId);
-        QString projectName = identifier.projectName;
-        QString batchCode = identifier.batchCode;
-        QString shortCode = identifier.shortCode;
-        QString groupKey  = QString("%1-%2-%3").arg(projectName).arg(batchCode).arg(shortCode);
-
-        SampleGroup &group = batchResults[groupKey];
-        group.projectName = projectName;
-        group.batchCode   = batchCode;
-        group.shortCode   = shortCode;
-
-        group.sampleDatas.append(singleSample);
-        if (group.sampleDatas.size() == 1) {
-            group.sampleDatas[0].bestInGroup = true;
-        }
+    QVector<SampleIdentifier> identifiers;
+    const QVector<SampleDataFlexible> samples = runSamplesInParallel(
+        sampleIds, params, DataType::TG_SMALL_RAW, &DataProcessingService::runTgSmallRawPipeline, identifiers);
+    for (int i = 0; i < samples.size(); ++i) {
+        appendToBatchGroup(batchResults, identifiers[i], samples[i], true);
     }
 
     return batchResults;
@@ -698,13 +853,18 @@ BatchGroupData DataProcessingService::runTgSmallRawPipelineForMultiple(
 
 
 SampleDataFlexible DataProcessingService::runChromatographPipeline(int sampleId, const ProcessingParameters& params)
+{
+    return runChromatographPipeline(SamplePipelineContext(), sampleId, params);
+}
+
+SampleDataFlexible DataProcessingService::runChromatographPipeline(const SamplePipelineContext& context, int sampleId, const ProcessingParameters& params)
 {
     DEBUG_LOG << "Chromatograph pipeline running in thread:" << QThread::currentThread();
     SampleDataFlexible sampleData;
     sampleData.sampleId = sampleId;
     sampleData.dataType = DataType::CHROMATOGRAM;
     QString error;
-    SampleDAO dao;
+    SampleDAO dao = pipelineSampleDAO(context);
 
     
     // 构造阶段数据
@@ -719,30 +879,33 @@ SampleDataFlexible DataProcessingService::runChromatographPipeline(int sampleId,
     QElapsedTimer timer;  //  先声明
     timer.restart();
 
+    // 阶段缓存键链：参数未变的前序阶段（含原始数据读取）直接复用缓存结果
+    StageCache::Chain cacheChain(&m_stageCache, DataType::CHROMATOGRAM, sampleId);
+    // 接力棒：后续阶段的输入
+    CurveValue currentCurve;
+
     // --- 1. 获取原始数据 ---
-    QVector<QPointF> rawPoints = dao.fetchChartDataForSample(sampleId, DataType::CHROMATOGRAM, error);
-    if (rawPoints.isEmpty()) {
-        WARNING_LOG << "Pipeline failed: No raw data for sample" << sampleId;
-        return sampleData;
+    if (!cacheChain.restore(QStringLiteral("raw"), QVariantMap(), stage, sampleData, currentCurve)) {
+        QVector<double> x, y;
+        if (!loadRawColumns(context, dao, sampleId, DataType::CHROMATOGRAM, x, y, error)) {
+            WARNING_LOG << "Pipeline failed: No raw data for sample" << sampleId;
+            return sampleData;
+        }
+        stage.stageName = StageName::RawData;
+        stage.curve = withSampleId(CurveValue(x, y, "原始数据"), sampleId);
+        stage.algorithm = AlgorithmType::None;
+        stage.isSegmented = false;
+        stage.numSegments = 1;
+
+        sampleData.stages.append(stage);
+        cacheChain.store(stage);
+        currentCurve = stage.curve.value();
     }
 
-    QVector<double> x, y;
-    for(const auto& p : rawPoints) { x.append(p.x()); y.append(p.y()); }
-    stage.stageName = StageName::RawData;
-    stage.curve = QSharedPointer<Curve>::create(x, y, "原始数据");
-    stage.curve->setSampleId(sampleId);
-    stage.algorithm = AlgorithmType::None;
-    stage.isSegmented = false;
-    stage.numSegments = 1;
-
-    sampleData.stages.append(stage);
-
     // DEBUG_LOG << "大热重单样本原始数据用时：" << timer.elapsed() << "ms";
     timer.restart();
 
     // --- 2. 流水线处理 ---
-    // 【修正】接力棒现在是智能指针，保证所有权清晰
-    QSharedPointer<Curve> currentCurve = stage.curve;
 
     
 
@@ -753,58 +916,80 @@ SampleDataFlexible DataProcessingService::runChromatographPipeline(int sampleId,
             IProcessingStep* step = m_registeredSteps.value("baseline_correction");
 
             // === 构造基线校正参数 ===
-            QVariantMap baselineParams;
-            baselineParams["lambda"] = params.lambda;
-            baselineParams["p"] = params.p;
-            baselineParams["order"] = params.order;
-            baselineParams["itermax"] = params.itermax;
-            baselineParams["wep"] = params.wep;
+            const QVariantMap baselineParams = chromBaselineParams(params);
 
             // === 调用算法 ===
-            ProcessingResult res = step->process({currentCurve.data()}, baselineParams, error);
-
-            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("baseline_corrected")) {
-                // 取出算法返回的基线校正结果
-                stage.stageName = StageName::BaselineCorrection;
-                stage.curve = QSharedPointer<Curve>(res.namedCurves.value("baseline_corrected").first());
-                stage.curve->setSampleId(sampleId);
-                stage.algorithm = AlgorithmType::BaselineCorrection;
-                stage.isSegmented = false;
-                stage.numSegments = 1;
+            if (!cacheChain.restore(QStringLiteral("baseline_correction"), baselineParams, stage, sampleData, currentCurve)) {
+                // 持久化结果：原始数据、算法版本与参数都未变化时直接读取上次的基线校正结果
+                AlgoResultDAO algoDao = pipelineAlgoResultDAO(context);
+                AlgoResultDAO::Key persistKey;
+                persistKey.sampleId = sampleId;
+                persistKey.dataType = DataType::CHROMATOGRAM;
+                persistKey.stageKey = QStringLiteral("baseline_correction");
+                persistKey.paramHash = chromBaselinePersistKey(params);
+                persistKey.algoName = step->stepName();
+                persistKey.algoVersion = step->version();
+                persistKey.rawVersion = AlgoResultDAO::rawVersion(currentCurve); // 基线校正的输入即原始曲线
+
+                CurveValue corrected;
+                if (!algoDao.load(persistKey, corrected)) {
+                    ProcessingResult res = step->process({currentCurve}, baselineParams, error);
+                    if (!res.namedCurves.value("baseline_corrected").isEmpty()) {
+                        // 取出算法返回的基线校正结果
+                        corrected = res.namedCurves.value("baseline_corrected").first();
+                        algoDao.save(persistKey, corrected, baselineParams);
+                    }
+                }
 
-                // 加入阶段结果
-                sampleData.stages.append(stage);
-                // 更新接力棒为基线校正后的曲线，便于后续峰检测等阶段
-                currentCurve = stage.curve;
+                if (!corrected.isEmpty()) {
+                    stage.stageName = StageName::BaselineCorrection;
+                    stage.curve = withSampleId(corrected, sampleId);
+                    stage.algorithm = AlgorithmType::BaselineCorrection;
+                    stage.isSegmented = false;
+                    stage.numSegments = 1;
+
+                    // 加入阶段结果
+                    sampleData.stages.append(stage);
+                    cacheChain.store(stage);
+                    // 更新接力棒为基线校正后的曲线，便于后续峰检测等阶段
+                    currentCurve = stage.curve.value();
+                }
             }
         }
     }
 
     // --- 色谱裁剪（BaseCorrect_data_cut：对基线校正后曲线按索引或 X 范围截取） ---
     if (params.chromClipEnabled) {
-        const QVector<QPointF> pts = currentCurve->data();
-        QVector<QPointF> out;
-        if (params.chromClipByIndex) {
-            const int i0 = qMax(0, params.chromClipStartIndex1 - 1);
-            const int i1 = qMin(pts.size() - 1, params.chromClipEndIndex1 - 1);
-            if (i0 <= i1) {
-                for (int i = i0; i <= i1; ++i) out.append(pts[i]);
+        if (!cacheChain.restore(QStringLiteral("chrom_clip"), chromClipParams(params), stage, sampleData, currentCurve)) {
+            const QVector<double>& cx = currentCurve.xValues();
+            const QVector<double>& cy = currentCurve.yValues();
+            QVector<double> outX, outY;
+            if (params.chromClipByIndex) {
+                const int i0 = qMax(0, params.chromClipStartIndex1 - 1);
+                const int i1 = qMin(cx.size() - 1, params.chromClipEndIndex1 - 1);
+                if (i0 <= i1) {
+                    outX = cx.mid(i0, i1 - i0 + 1);
+                    outY = cy.mid(i0, i1 - i0 + 1);
+                }
+            } else if (params.chromClipMaxX > params.chromClipMinX) {
+                for (int i = 0; i < cx.size(); ++i) {
+                    if (cx[i] >= params.chromClipMinX && cx[i] <= params.chromClipMaxX) {
+                        outX.append(cx[i]);
+                        outY.append(cy[i]);
+                    }
+                }
             }
-        } else if (params.chromClipMaxX > params.chromClipMinX) {
-            for (const QPointF& p : pts) {
-                if (p.x() >= params.chromClipMinX && p.x() <= params.chromClipMaxX) out.append(p);
+            if (!outX.isEmpty()) {
+                stage.stageName = StageName::Clip;
+                stage.curve = withSampleId(CurveValue(outX, outY, QStringLiteral("裁剪后")), sampleId);
+                stage.algorithm = AlgorithmType::Clip;
+                stage.isSegmented = false;
+                stage.numSegments = 1;
+                sampleData.stages.append(stage);
+                cacheChain.store(stage);
+                currentCurve = stage.curve.value();
             }
         }
-        if (!out.isEmpty()) {
-            stage.stageName = StageName::Clip;
-            stage.curve = QSharedPointer<Curve>::create(out, QStringLiteral("裁剪后"));
-            stage.curve->setSampleId(sampleId);
-            stage.algorithm = AlgorithmType::Clip;
-            stage.isSegmented = false;
-            stage.numSegments = 1;
-            sampleData.stages.append(stage);
-            currentCurve = stage.curve;
-        }
     }
 
     // DEBUG_LOG << "大热重单样本裁剪数据用时：" << timer.elapsed() << "ms";
@@ -821,15 +1006,17 @@ SampleDataFlexible DataProcessingService::runChromatographPipeline(int sampleId,
         peakParams["snr_threshold"] = params.peakSnrThreshold;
         peakParams["window"] = 20; // 默认窗口，用于局部显著性与噪声估计
 
-        ProcessingResult res = step->process({currentCurve.data()}, peakParams, error);
-        if (res.namedCurves.contains("peaks") && !res.namedCurves["peaks"].isEmpty()) {
-            stage.stageName = StageName::PeakDetection;
-            stage.curve = QSharedPointer<Curve>(res.namedCurves.value("peaks").first());
-            stage.curve->setSampleId(sampleId);
-            stage.algorithm = AlgorithmType::PeakDetection;
-            stage.isSegmented = false;
-            stage.numSegments = 1;
-            sampleData.stages.append(stage);
+        if (!cacheChain.restore(QStringLiteral("peak_detection"), peakParams, stage, sampleData, currentCurve)) {
+            ProcessingResult res = step->process({currentCurve}, peakParams, error);
+            if (res.namedCurves.contains("peaks") && !res.namedCurves["peaks"].isEmpty()) {
+                stage.stageName = StageName::PeakDetection;
+                stage.curve = withSampleId(res.namedCurves.value("peaks").first(), sampleId);
+                stage.algorithm = AlgorithmType::PeakDetection;
+                stage.isSegmented = false;
+                stage.numSegments = 1;
+                sampleData.stages.append(stage);
+                cacheChain.store(stage);
+            }
         }
     }
 
@@ -858,48 +1045,23 @@ BatchGroupData DataProcessingService::runChromatographPipelineForMultiple(
     batchTotalTimer.start();
 
     BatchGroupData batchResults;
-    SingleTobaccoSampleDAO dao;
 
     DEBUG_LOG << "Processing chromatograph samples:" << sampleIds;
 
-    qint64 perSamplePipelineMs = 0;
     QElapsedTimer perSampleTimer;
-    for (int sampleId : sampleIds) {
-        perSampleTimer.restart();
-        // 单样本处理
-        SampleDataFlexible singleSample = runChromatographPipeline(sampleId, params);
-        perSamplePipelineMs += perSampleTimer.elapsed();
-        SampleIdentifier identifier = dao.getSampleIdentifierById(sampleId);
-        QString projectName = identifier.projectName;
-        QString batchCode = identifier.batchCode;
-        QString shortCode = identifier.shortCode;
-        QString groupKey  = QString("%1-%2-%3").arg(projectName).arg(batchCode).arg(shortCode);
-
-        // // 插入批量结果
-        // batchResults.insert(name, singleSample);
-
-        // 构造或获取已有的 SampleGroup
-        SampleGroup &group = batchResults[groupKey];
-        group.projectName = projectName;
-        group.batchCode   = batchCode;
-        group.shortCode   = shortCode;
-
-        
-        // // 添加单样本到平行样本列表
-        // group.parallelSamples.append(singleSample);
-
-        // // 用 SampleDataFlexible 构造 ParallelSampleData
-        // ParallelSampleData parallelSample;
-        // parallelSample.sampleData = singleSample;
-        // parallelSample.parallelNo = identifier.parallelNo;  // 直接使用 identifier 中的 parallel_no
-
+    perSampleTimer.start();
+    QVector<SampleIdentifier> identifiers;
+    const QVector<SampleDataFlexible> samples = runSamplesInParallel(
+        sampleIds, params, DataType::CHROMATOGRAM, &DataProcessingService::runChromatographPipeline, identifiers);
+    const qint64 perSamplePipelineMs = perSampleTimer.elapsed();
+    for (int i = 0; i < samples.size(); ++i) {
         // 添加到组内样本列表（不在此处打 bestInGroup 标记，由代表样选择服务统一处理）
-        group.sampleDatas.append(singleSample);
-
+        appendToBatchGroup(batchResults, identifiers[i], samples[i], false);
     }
 
     DEBUG_LOG << "Chromatograph batch timing: per-sample pipeline"
-              << perSamplePipelineMs << "ms for" << sampleIds.size() << "sample(s)";
+              << perSamplePipelineMs << "ms for" << sampleIds.size() << "sample(s),"
+              << batchThreadCount() << "thread(s)";
 
     // 若启用峰对齐，且指定了参考样本ID，则对组内样本执行对齐（可选 COW / PeakSeg-COW）
     const QString alignStepKey = (params.peakSegCowEnabled ? QStringLiteral("peakseg_cow_alignment")
@@ -908,21 +1070,24 @@ BatchGroupData DataProcessingService::runChromatographPipelineForMultiple(
         QElapsedTimer alignPhaseTimer;
         alignPhaseTimer.start();
         IProcessingStep* alignStep = m_registeredSteps.value(alignStepKey);
+        const bool usePeakSeg = (alignStepKey == QStringLiteral("peakseg_cow_alignment"));
         QString error;
-        QSharedPointer<Curve> refCurve;
+        CurveValue refCurve;
+        quint32 refRawVersion = 0;
         for (auto it = batchResults.begin(); it != batchResults.end(); ++it) {
             SampleGroup& group = it.value();
             for (const SampleDataFlexible& sample : group.sampleDatas) {
                 if (sample.sampleId == params.referenceSampleId) {
                     refCurve = chromPreferredCurveForAlignment(sample, params);
+                    refRawVersion = rawVersionOf(sample);
                     break;
                 }
             }
-            if (!refCurve.isNull()) break;
+            if (!refCurve.isEmpty()) break;
         }
 
         // 对齐阶段必须以“裁剪后曲线”为输入。若缺失则跳过对齐，避免错误回退到原始曲线导致慢且结果偏差。
-        if (refCurve.isNull()) {
+        if (refCurve.isEmpty()) {
             WARNING_LOG << "Chromatogram alignment skipped: reference clip curve not found. referenceSampleId="
                         << params.referenceSampleId;
             DEBUG_LOG << "Chromatograph batch timing: total" << batchTotalTimer.elapsed()
@@ -930,55 +1095,141 @@ BatchGroupData DataProcessingService::runChromatographPipelineForMultiple(
             return batchResults;
         }
 
-        QVariantMap peakSegAlignParams;
-        if (!refCurve.isNull() && alignStepKey == QStringLiteral("peakseg_cow_alignment")) {
-            peakSegAlignParams.insert(QStringLiteral("min_prominence"), params.peakMinProminence);
-            peakSegAlignParams.insert(QStringLiteral("t"), params.cowMaxWarp);
-            peakSegAlignParams.insert(QStringLiteral("smooth_span"), 5);
-            peakSegAlignParams.insert(QStringLiteral("max_cluster_gap"), 5);
+        QVariantMap alignParams;
+        if (usePeakSeg) {
+            alignParams.insert(QStringLiteral("min_prominence"), params.peakMinProminence);
+            alignParams.insert(QStringLiteral("t"), params.cowMaxWarp);
+            alignParams.insert(QStringLiteral("smooth_span"), 5);
+            alignParams.insert(QStringLiteral("max_cluster_gap"), 5);
             if (params.peakSegUseMatlabDefaultRanges) {
                 const QVariantMap matlabExtra = peakSegMatlabSepuAlignBatchParams();
                 for (auto mit = matlabExtra.constBegin(); mit != matlabExtra.constEnd(); ++mit)
-                    peakSegAlignParams.insert(mit.key(), mit.value());
+                    alignParams.insert(mit.key(), mit.value());
             } else {
                 const int cappedRangeCount = qMax(1, qMin(params.cowSegmentCount, 10));
-                peakSegAlignParams.insert(QStringLiteral("range_count"), cappedRangeCount);
+                alignParams.insert(QStringLiteral("range_count"), cappedRangeCount);
             }
+        } else {
+            alignParams.insert(QStringLiteral("window_size"), params.cowWindowSize);
+            alignParams.insert(QStringLiteral("max_warp"), params.cowMaxWarp);
+            alignParams.insert(QStringLiteral("segment_count"), params.cowSegmentCount);
+            alignParams.insert(QStringLiteral("resample_step"), params.cowResampleStep);
         }
 
-        if (!refCurve.isNull()) {
-            for (auto it = batchResults.begin(); it != batchResults.end(); ++it) {
-                SampleGroup& group = it.value();
-                for (SampleDataFlexible& sample : group.sampleDatas) {
-                    if (sample.sampleId == params.referenceSampleId) continue;
-
-                    const QSharedPointer<Curve> tgtCurve = chromPreferredCurveForAlignment(sample, params);
-                    if (tgtCurve.isNull()) continue;
+        // 收集待对齐目标（批内顺序）
+        struct AlignTarget {
+            SampleDataFlexible* sample;
+            CurveValue curve;
+        };
+        QVector<AlignTarget> targets;
+        for (auto it = batchResults.begin(); it != batchResults.end(); ++it) {
+            SampleGroup& group = it.value();
+            for (SampleDataFlexible& sample : group.sampleDatas) {
+                if (sample.sampleId == params.referenceSampleId) continue;
+                const CurveValue tgtCurve = chromPreferredCurveForAlignment(sample, params);
+                if (tgtCurve.isEmpty()) continue;
+                targets.append(AlignTarget{&sample, tgtCurve});
+            }
+        }
 
-                    QVariantMap alignParams;
-                    if (alignStepKey == QStringLiteral("peakseg_cow_alignment")) {
-                        alignParams = peakSegAlignParams;
-                    } else {
-                        alignParams.insert(QStringLiteral("window_size"), params.cowWindowSize);
-                        alignParams.insert(QStringLiteral("max_warp"), params.cowMaxWarp);
-                        alignParams.insert(QStringLiteral("segment_count"), params.cowSegmentCount);
-                        alignParams.insert(QStringLiteral("resample_step"), params.cowResampleStep);
+        // 持久化结果：参考样本及其原始数据、目标原始数据、上游阶段参数与对齐参数均未变化的目标直接读取，
+        // 其余目标进入 pending 计算
+        QVector<ProcessingResult> alignResults(targets.size());
+        ScopedThreadConnection alignConnection;
+        AlgoResultDAO algoDao(alignConnection.database());
+        QVariantMap referenceParams;
+        referenceParams.insert(QStringLiteral("sample_id"), params.referenceSampleId);
+        referenceParams.insert(QStringLiteral("raw_version"), refRawVersion);
+        const QByteArray alignParamHash = StageCache::chainKey(
+            StageCache::chainKey(chromAlignmentInputPersistKey(params), QStringLiteral("reference"), referenceParams),
+            alignStepKey, alignParams);
+        QVector<AlgoResultDAO::Key> persistKeys(targets.size());
+        QVector<int> pending;
+        for (int i = 0; i < targets.size(); ++i) {
+            AlgoResultDAO::Key& key = persistKeys[i];
+            key.sampleId = targets[i].sample->sampleId;
+            key.dataType = DataType::CHROMATOGRAM;
+            key.stageKey = QStringLiteral("peak_alignment");
+            key.paramHash = alignParamHash;
+            key.algoName = alignStep->stepName();
+            key.algoVersion = alignStep->version();
+            key.rawVersion = rawVersionOf(*targets[i].sample);
+            CurveValue aligned;
+            if (algoDao.load(key, aligned, &alignResults[i].metadata))
+                alignResults[i].namedCurves[QStringLiteral("aligned")].append(aligned);
+            else
+                pending.append(i);
+        }
+        DEBUG_LOG << "Chromatograph alignment: persisted results reused for"
+                  << (targets.size() - pending.size()) << "of" << targets.size() << "target(s)";
+
+        // 参考侧整批只准备一次（PeakSeg：平滑、峰检测、分段、参考段统计；COW：参考频谱），
+        // 各目标的对齐在批处理线程池中并行
+        std::function<ProcessingResult(const CurveValue&, QString&)> alignOne;
+        if (pending.isEmpty()) {
+            // 全部命中持久化结果，无需准备参考
+        } else if (usePeakSeg) {
+            const QSharedPointer<const PeakSegCOWAlignment::PreparedReference> prepared =
+                PeakSegCOWAlignment::prepareReference(refCurve, alignParams, error);
+            if (prepared.isNull()) {
+                WARNING_LOG << "PeakSeg-COW reference preparation failed:" << error;
+                pending.clear();
+            } else {
+                alignOne = [prepared](const CurveValue& tgt, QString& alignError) {
+                    return PeakSegCOWAlignment::alignToReference(*prepared, tgt, alignError);
+                };
+            }
+        } else {
+            const QSharedPointer<const COWAlignment::PreparedReference> prepared =
+                COWAlignment::prepareReference(refCurve, alignParams, error);
+            if (prepared.isNull()) {
+                WARNING_LOG << "COW reference preparation failed:" << error;
+                pending.clear();
+            } else {
+                alignOne = [prepared](const CurveValue& tgt, QString& alignError) {
+                    return COWAlignment::alignToReference(*prepared, tgt, alignError);
+                };
+            }
+        }
+        if (!pending.isEmpty()) {
+            ProcessingResult* resultOut = alignResults.data();
+            QAtomicInt nextIndex(0);
+            const int total = pending.size();
+            const int workerCount = qMin(total, qMax(1, m_batchPool.maxThreadCount()));
+            QList<QFuture<void>> futures;
+            for (int w = 0; w < workerCount; ++w) {
+                futures.append(QtConcurrent::run(&m_batchPool, [&]() {
+                    for (int k = nextIndex.fetchAndAddOrdered(1); k < total; k = nextIndex.fetchAndAddOrdered(1)) {
+                        const int i = pending[k];
+                        QString alignError;
+                        resultOut[i] = alignOne(targets[i].curve, alignError);
+                        if (!alignError.isEmpty())
+                            WARNING_LOG << alignStep->stepName() << "failed for sample" << targets[i].sample->sampleId << ":" << alignError;
                     }
+                }));
+            }
+            for (QFuture<void>& f : futures) f.waitForFinished();
+        }
 
-                    ProcessingResult ar = alignStep->process({refCurve.data(), tgtCurve.data()}, alignParams, error);
-                    if (ar.namedCurves.contains(QStringLiteral("aligned")) && !ar.namedCurves[QStringLiteral("aligned")].isEmpty()) {
-                        StageData stg;
-                        stg.stageName = StageName::PeakAlignment;
-                        stg.curve = QSharedPointer<Curve>(ar.namedCurves[QStringLiteral("aligned")].first());
-                        stg.curve->setSampleId(sample.sampleId);
-                        stg.algorithm = AlgorithmType::PeakAlignment;
-                        stg.isSegmented = false;
-                        stg.numSegments = 1;
-                        for (auto mit = ar.metadata.constBegin(); mit != ar.metadata.constEnd(); ++mit)
-                            stg.metrics.insert(mit.key(), mit.value());
-                        sample.stages.append(stg);
-                    }
-                }
+        for (int i : pending) {
+            const QList<CurveValue> aligned = alignResults[i].namedCurves.value(QStringLiteral("aligned"));
+            if (!aligned.isEmpty())
+                algoDao.save(persistKeys[i], aligned.first(), alignParams, alignResults[i].metadata);
+        }
+
+        for (int i = 0; i < targets.size(); ++i) {
+            SampleDataFlexible& sample = *targets[i].sample;
+            const ProcessingResult& ar = alignResults[i];
+            if (ar.namedCurves.contains(QStringLiteral("aligned")) && !ar.namedCurves[QStringLiteral("aligned")].isEmpty()) {
+                StageData stg;
+                stg.stageName = StageName::PeakAlignment;
+                stg.curve = withSampleId(ar.namedCurves[QStringLiteral("aligned")].first(), sample.sampleId);
+                stg.algorithm = AlgorithmType::PeakAlignment;
+                stg.isSegmented = false;
+                stg.numSegments = 1;
+                for (auto mit = ar.metadata.constBegin(); mit != ar.metadata.constEnd(); ++mit)
+                    stg.metrics.insert(mit.key(), mit.value());
+                sample.stages.append(stg);
             }
         }
         DEBUG_LOG << "Chromatograph batch timing: alignment phase" << alignPhaseTimer.elapsed() << "ms";
@@ -992,48 +1243,54 @@ BatchGroupData DataProcessingService::runChromatographPipelineForMultiple(
 
 
 SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId, const ProcessingParameters& params)
+{
+    return runProcessTgBigPipeline(SamplePipelineContext(), sampleId, params);
+}
+
+SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(const SamplePipelineContext& context, int sampleId, const ProcessingParameters& params)
 {
     DEBUG_LOG << "ProcessTgBig pipeline running in thread:" << QThread::currentThread();
     SampleDataFlexible sampleData;
     sampleData.sampleId = sampleId;
     sampleData.dataType = DataType::PROCESS_TG_BIG; // 数据类型设置为工序大热重
     QString error;
-    SampleDAO dao;
+    SampleDAO dao = pipelineSampleDAO(context);
     // 工序数据无需 SampleDAO 曲线查询，转用 ProcessTgBigDataDAO
 
     // DEBUG_LOG << "Starting pipeline for sampleId:" << sampleId;
     
     // 构造阶段数据
     StageData stage;
+    // 阶段缓存键链：参数未变的前序阶段（含原始数据读取）直接复用缓存结果
+    StageCache::Chain cacheChain(&m_stageCache, sampleData.dataType, sampleId);
+    // 接力棒——后续阶段的输入
+    CurveValue currentCurve;
 
-    QVector<QPointF> rawPoints = dao.fetchChartDataForSample(sampleId, sampleData.dataType, error);
-        if (rawPoints.isEmpty()) {
+    if (!cacheChain.restore(QStringLiteral("raw"), QVariantMap(), stage, sampleData, currentCurve)) {
+        QVector<double> x, y;
+        if (!loadRawColumns(context, dao, sampleId, sampleData.dataType, x, y, error)) {
             WARNING_LOG << "Pipeline failed: No raw data for sample" << sampleId;
             return sampleData;
         }
 
-        // DEBUG_LOG << "Sample" << sampleId << "original points:" << rawPoints.size();
-
-    QVector<double> x, y;
-    for(const auto& p : rawPoints) { x.append(p.x()); y.append(p.y()); }
-    stage.stageName = StageName::RawData;
+        // DEBUG_LOG << "Sample" << sampleId << "original points:" << x.size();
+        stage.stageName = StageName::RawData;
 
-    stage.curve = QSharedPointer<Curve>::create(x, y, "原始数据");
-    stage.curve->setSampleId(sampleId);
-    stage.algorithm = AlgorithmType::None;
-    stage.isSegmented = false;
-    stage.numSegments = 1;
-    // 为“原始数据”阶段开启绘图显示（与界面阶段选择保持一致）
-    // 之前未设置 useForPlot 导致在选择“原始数据”阶段时不绘制，造成视图清空
-    stage.useForPlot = true;
+        stage.curve = withSampleId(CurveValue(x, y, "原始数据"), sampleId);
+        stage.algorithm = AlgorithmType::None;
+        stage.isSegmented = false;
+        stage.numSegments = 1;
+        // 为“原始数据”阶段开启绘图显示（与界面阶段选择保持一致）
+        // 之前未设置 useForPlot 导致在选择“原始数据”阶段时不绘制，造成视图清空
+        stage.useForPlot = true;
 
-    sampleData.stages.append(stage);
+        sampleData.stages.append(stage);
+        cacheChain.store(stage);
+        currentCurve = stage.curve.value();
+    }
 
     // DEBUG_LOG << "Starting pipeline for sampleId:" << sampleId;
 
-    // 接力棒——后续阶段的输入
-    QSharedPointer<Curve> currentCurve = stage.curve;
-
     // 阶段2 坏点修复（替换原“拟合数据”阶段）
     if (m_registeredSteps.contains("bad_point_repair")) {
 
@@ -1058,31 +1315,28 @@ SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId,
         // DEBUG_LOG << "工序大热重单样本坏点修复";
         
         QString error;
-        ProcessingResult res = step->process({currentCurve.data()}, bpParams, error);
+        if (!cacheChain.restore(QStringLiteral("bad_point_repair"), bpParams, stage, sampleData, currentCurve)) {
+            ProcessingResult res = step->process({currentCurve}, bpParams, error);
 
-        // DEBUG_LOG << "工序大热重单样本坏点修复";
+            // DEBUG_LOG << "工序大热重单样本坏点修复";
 
-        if (!res.namedCurves.isEmpty() && res.namedCurves.contains("repaired")) {
-            stage.stageName = StageName::BadPointRepair; // 坏点修复阶段
-            stage.curve = QSharedPointer<Curve>(res.namedCurves.value("repaired").first());
-            stage.curve->setSampleId(sampleId);
-            stage.algorithm = AlgorithmType::BadPointRepair;
-            stage.isSegmented = false;
-            stage.numSegments = 1;
-            stage.useForPlot = true; // 允许在绘图区域显示该阶段
-            // 将坏点坐标写入 metrics 供前端绘制
-            if (res.namedCurves.contains("bad_points") && !res.namedCurves["bad_points"].isEmpty()) {
-                Curve* badCurve = res.namedCurves["bad_points"].first();
-                QVector<QPointF> pts = badCurve->data();
-                QVector<double> bx, by;
-                bx.reserve(pts.size());
-                by.reserve(pts.size());
-                for (const auto& p : pts) { bx.append(p.x()); by.append(p.y()); }
-                stage.metrics.insert("bad_points_x", QVariant::fromValue(bx));
-                stage.metrics.insert("bad_points_y", QVariant::fromValue(by));
+            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("repaired")) {
+                stage.stageName = StageName::BadPointRepair; // 坏点修复阶段
+                stage.curve = withSampleId(res.namedCurves.value("repaired").first(), sampleId);
+                stage.algorithm = AlgorithmType::BadPointRepair;
+                stage.isSegmented = false;
+                stage.numSegments = 1;
+                stage.useForPlot = true; // 允许在绘图区域显示该阶段
+                // 将坏点坐标写入 metrics 供前端绘制
+                if (res.namedCurves.contains("bad_points") && !res.namedCurves["bad_points"].isEmpty()) {
+                    const CurveValue badCurve = res.namedCurves["bad_points"].first();
+                    stage.metrics.insert("bad_points_x", QVariant::fromValue(badCurve.xValues()));
+                    stage.metrics.insert("bad_points_y", QVariant::fromValue(badCurve.yValues()));
+                }
+                sampleData.stages.append(stage);
+                cacheChain.store(stage);
+                currentCurve = stage.curve.value(); // 更新接力棒，后续裁剪/归一化/平滑/微分基于修复后数据
             }
-            sampleData.stages.append(stage);
-            currentCurve = stage.curve; // 更新接力棒，后续裁剪/归一化/平滑/微分基于修复后数据
         }
     }
 
@@ -1094,17 +1348,19 @@ SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId,
         IProcessingStep* step = m_registeredSteps.value("clipping");
         QVariantMap clipParams; clipParams["min_x"] = params.clipMinX_ProcessTgBig; clipParams["max_x"] = params.clipMaxX_ProcessTgBig;
         QString error;
-        ProcessingResult res = step->process({currentCurve.data()}, clipParams, error);
-        if (!res.namedCurves.isEmpty() && res.namedCurves.contains("clipped")) {
-            stage.stageName = StageName::Clip;
-            stage.curve = QSharedPointer<Curve>(res.namedCurves.value("clipped").first());
-            stage.curve->setSampleId(sampleId);
-            stage.algorithm = AlgorithmType::Clip;
-            stage.isSegmented = false;
-            stage.numSegments = 1;
-            stage.useForPlot = true; // 允许在绘图区域显示该阶段
-            sampleData.stages.append(stage);
-            currentCurve = stage.curve;
+        if (!cacheChain.restore(QStringLiteral("clipping"), clipParams, stage, sampleData, currentCurve)) {
+            ProcessingResult res = step->process({currentCurve}, clipParams, error);
+            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("clipped")) {
+                stage.stageName = StageName::Clip;
+                stage.curve = withSampleId(res.namedCurves.value("clipped").first(), sampleId);
+                stage.algorithm = AlgorithmType::Clip;
+                stage.isSegmented = false;
+                stage.numSegments = 1;
+                stage.useForPlot = true; // 允许在绘图区域显示该阶段
+                sampleData.stages.append(stage);
+                cacheChain.store(stage);
+                currentCurve = stage.curve.value();
+            }
         }
     }
 
@@ -1120,17 +1376,19 @@ SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId,
             normParams["rangeMax"] = 100.0;
         }
         QString error;
-        ProcessingResult res = step->process({currentCurve.data()}, normParams, error);
-        if (!res.namedCurves.isEmpty() && res.namedCurves.contains("normalized")) {
-            stage.stageName = StageName::Normalize;
-            stage.curve = QSharedPointer<Curve>(res.namedCurves.value("normalized").first());
-            stage.curve->setSampleId(sampleId);
-            stage.algorithm = AlgorithmType::Normalize;
-            stage.isSegmented = false;
-            stage.numSegments = 1;
-            stage.useForPlot = true; // 允许在绘图区域显示该阶段
-            sampleData.stages.append(stage);
-            currentCurve = stage.curve;
+        if (!cacheChain.restore(QStringLiteral("normalization"), normParams, stage, sampleData, currentCurve)) {
+            ProcessingResult res = step->process({currentCurve}, normParams, error);
+            if (!res.namedCurves.isEmpty() && res.namedCurves.contains("normalized")) {
+                stage.stageName = StageName::Normalize;
+                stage.curve = withSampleId(res.namedCurves.value("normalized").first(), sampleId);
+                stage.algorithm = AlgorithmType::Normalize;
+                stage.isSegmented = false;
+                stage.numSegments = 1;
+                stage.useForPlot = true; // 允许在绘图区域显示该阶段
+                sampleData.stages.append(stage);
+                cacheChain.store(stage);
+                currentCurve = stage.curve.value();
+            }
         }
     }
 
@@ -1143,34 +1401,37 @@ SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId,
             int sgWin = params.sgWindowSize;
             // 强制窗口为奇数，且不超过点数范围（至少为3）
             if (sgWin % 2 == 0) sgWin += 1;
-            if (currentCurve && sgWin >= currentCurve->pointCount()) {
-                sgWin = qMax(3, currentCurve->pointCount() - 1);
+            if (!currentCurve.isEmpty() && sgWin >= currentCurve.pointCount()) {
+                sgWin = qMax(3, currentCurve.pointCount() - 1);
                 if (sgWin % 2 == 0) sgWin -= 1;
             }
             smoothParams["window_size"] = sgWin;
             smoothParams["poly_order"] = params.sgPolyOrder;
             smoothParams["derivative_order"] = 0;
+            smoothParams["outputs"] = "smoothed"; // 只计算平滑
         // 防御性检查，避免窗口大小超过点数导致算法越界崩溃
-            if (!currentCurve || currentCurve->pointCount() <= 0) {
+            if (currentCurve.isEmpty() || currentCurve.pointCount() <= 0) {
             WARNING_LOG << "平滑阶段跳过：当前曲线为空或点数为0";
-            } else if (smoothParams["window_size"].toInt() <= 2 || smoothParams["window_size"].toInt() > currentCurve->pointCount()) {
+            } else if (smoothParams["window_size"].toInt() <= 2 || smoothParams["window_size"].toInt() > currentCurve.pointCount()) {
             WARNING_LOG << "平滑阶段跳过：window_size 无效或超过点数";
             } else {
             QString error;
             try {
-                ProcessingResult res = step->process({currentCurve.data()}, smoothParams, error);
-                if (!res.namedCurves.isEmpty() && res.namedCurves.contains("smoothed")) {
-                    stage.stageName = StageName::Smooth;
-                    stage.curve = QSharedPointer<Curve>(res.namedCurves.value("smoothed").first());
-                    stage.curve->setSampleId(sampleId);
-                    stage.algorithm = AlgorithmType::Smooth_SG;
-                    stage.isSegmented = false;
-                    stage.numSegments = 1;
-                    stage.useForPlot = true; // 允许在绘图区域显示该阶段
-                    sampleData.stages.append(stage);
-                    currentCurve = stage.curve;
-                } else {
-                    WARNING_LOG << "平滑阶段无结果：未返回 smoothed 曲线";
+                if (!cacheChain.restore(QStringLiteral("smoothing_sg"), smoothParams, stage, sampleData, currentCurve)) {
+                    ProcessingResult res = step->process({currentCurve}, smoothParams, error);
+                    if (!res.namedCurves.isEmpty() && res.namedCurves.contains("smoothed")) {
+                        stage.stageName = StageName::Smooth;
+                        stage.curve = withSampleId(res.namedCurves.value("smoothed").first(), sampleId);
+                        stage.algorithm = AlgorithmType::Smooth_SG;
+                        stage.isSegmented = false;
+                        stage.numSegments = 1;
+                        stage.useForPlot = true; // 允许在绘图区域显示该阶段
+                        sampleData.stages.append(stage);
+                        cacheChain.store(stage);
+                        currentCurve = stage.curve.value();
+                    } else {
+                        WARNING_LOG << "平滑阶段无结果：未返回 smoothed 曲线";
+                    }
                 }
             } catch (const std::exception& e) {
                 ERROR_LOG << QString("平滑阶段异常：%1").arg(e.what());
@@ -1181,24 +1442,26 @@ SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId,
         } else if (smMethod == "loess" && m_registeredSteps.contains("smoothing_loess")) {
             IProcessingStep* step = m_registeredSteps.value("smoothing_loess");
             QVariantMap smoothParams; smoothParams["fraction"] = params.loessSpan;
-            if (!currentCurve || currentCurve->pointCount() <= 2) {
+            if (currentCurve.isEmpty() || currentCurve.pointCount() <= 2) {
                 WARNING_LOG << "平滑阶段跳过：当前曲线为空或点数不足";
             } else {
                 QString error;
                 try {
-                    ProcessingResult res = step->process({currentCurve.data()}, smoothParams, error);
-                    if (!res.namedCurves.isEmpty() && res.namedCurves.contains("smoothed")) {
-                        stage.stageName = StageName::Smooth;
-                        stage.curve = QSharedPointer<Curve>(res.namedCurves.value("smoothed").first());
-                        stage.curve->setSampleId(sampleId);
-                        stage.algorithm = AlgorithmType::Smooth_Loess; // Loess 平滑标记
-                        stage.isSegmented = false;
-                        stage.numSegments = 1;
-                        stage.useForPlot = true;
-                        sampleData.stages.append(stage);
-                        currentCurve = stage.curve;
-                    } else {
-                        WARNING_LOG << "Loess 平滑阶段无结果：未返回 smoothed 曲线";
+                    if (!cacheChain.restore(QStringLiteral("smoothing_loess"), smoothParams, stage, sampleData, currentCurve)) {
+                        ProcessingResult res = step->process({currentCurve}, smoothParams, error);
+                        if (!res.namedCurves.isEmpty() && res.namedCurves.contains("smoothed")) {
+                            stage.stageName = StageName::Smooth;
+                            stage.curve = withSampleId(res.namedCurves.value("smoothed").first(), sampleId);
+                            stage.algorithm = AlgorithmType::Smooth_Loess; // Loess 平滑标记
+                            stage.isSegmented = false;
+                            stage.numSegments = 1;
+                            stage.useForPlot = true;
+                            sampleData.stages.append(stage);
+                            cacheChain.store(stage);
+                            currentCurve = stage.curve.value();
+                        } else {
+                            WARNING_LOG << "Loess 平滑阶段无结果：未返回 smoothed 曲线";
+                        }
                     }
                 } catch (const std::exception& e) {
                     ERROR_LOG << QString("Loess 平滑阶段异常：%1").arg(e.what());
@@ -1218,35 +1481,38 @@ SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId,
         int dWin = params.derivSgWindowSize;
         // 强制窗口为奇数，且不超过点数范围（至少为3）
         if (dWin % 2 == 0) dWin += 1;
-        if (currentCurve && dWin >= currentCurve->pointCount()) {
-            dWin = qMax(3, currentCurve->pointCount() - 1);
+        if (!currentCurve.isEmpty() && dWin >= currentCurve.pointCount()) {
+            dWin = qMax(3, currentCurve.pointCount() - 1);
             if (dWin % 2 == 0) dWin -= 1;
         }
         derivParams["window_size"] = dWin;
         derivParams["poly_order"] = params.derivSgPolyOrder;
         derivParams["derivative_order"] = 1;
+        derivParams["outputs"] = "derivative"; // 只计算导数
         // 防御性检查，避免窗口大小超过点数导致算法越界崩溃
-        if (!currentCurve || currentCurve->pointCount() <= 1) {
+        if (currentCurve.isEmpty() || currentCurve.pointCount() <= 1) {
             WARNING_LOG << "DTG阶段跳过：当前曲线为空或点数不足";
-        } else if (derivParams["window_size"].toInt() <= 2 || derivParams["window_size"].toInt() > currentCurve->pointCount()) {
+        } else if (derivParams["window_size"].toInt() <= 2 || derivParams["window_size"].toInt() > currentCurve.pointCount()) {
             WARNING_LOG << "DTG阶段跳过：window_size 无效或超过点数";
         } else {
             QString error;
             try {
-                ProcessingResult res = step->process({currentCurve.data()}, derivParams, error);
-                if (res.namedCurves.contains("derivative1")) {
-                    stage.stageName = StageName::Derivative;
-                    stage.curve = QSharedPointer<Curve>(res.namedCurves.value("derivative1").first());
-                    stage.curve->setSampleId(sampleId);
-                    stage.algorithm = AlgorithmType::Derivative_SG;
-                    stage.isSegmented = false;
-                    stage.numSegments = 1;
-                    stage.useForPlot = true; // 允许在绘图区域显示该阶段
-                    sampleData.stages.append(stage);
-                    // 更新接力棒为DTG曲线，供下一阶段再次做一阶导数
-                    currentCurve = stage.curve;
-                } else {
-                    WARNING_LOG << "DTG阶段无结果：未返回 derivative1 曲线";
+                if (!cacheChain.restore(QStringLiteral("derivative_sg"), derivParams, stage, sampleData, currentCurve)) {
+                    ProcessingResult res = step->process({currentCurve}, derivParams, error);
+                    if (res.namedCurves.contains("derivative1")) {
+                        stage.stageName = StageName::Derivative;
+                        stage.curve = withSampleId(res.namedCurves.value("derivative1").first(), sampleId);
+                        stage.algorithm = AlgorithmType::Derivative_SG;
+                        stage.isSegmented = false;
+                        stage.numSegments = 1;
+                        stage.useForPlot = true; // 允许在绘图区域显示该阶段
+                        sampleData.stages.append(stage);
+                        cacheChain.store(stage);
+                        // 更新接力棒为DTG曲线，供下一阶段再次做一阶导数
+                        currentCurve = stage.curve.value();
+                    } else {
+                        WARNING_LOG << "DTG阶段无结果：未返回 derivative1 曲线";
+                    }
                 }
             } catch (const std::exception& e) {
                 ERROR_LOG << QString("DTG阶段异常：%1").arg(e.what());
@@ -1255,29 +1521,28 @@ SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId,
             }
         }
         } else if (dMethod == "first_diff") {
-            if (!currentCurve || currentCurve->pointCount() <= 1) {
+            if (currentCurve.isEmpty() || currentCurve.pointCount() <= 1) {
                 WARNING_LOG << "DTG阶段跳过：当前曲线为空或点数不足";
             } else {
-                // 简易一阶差分实现（基于x间隔的前向差分）
-                QVector<QPointF> src = currentCurve->data();
-                QVector<QPointF> diff;
-                diff.reserve(src.size());
-                for (int i = 0; i < src.size(); ++i) {
-                    if (i == 0) { diff.append(QPointF(src[i].x(), 0.0)); continue; }
-                    double dx = src[i].x() - src[i-1].x(); if (qAbs(dx) < 1e-12) dx = 1.0;
-                    double dy = src[i].y() - src[i-1].y();
-                    diff.append(QPointF(src[i].x(), dy / dx));
+                if (!cacheChain.restore(QStringLiteral("derivative_first_diff"), QVariantMap(), stage, sampleData, currentCurve)) {
+                    // 简易一阶差分实现（基于x间隔的前向差分）
+                    const QVector<double>& sx = currentCurve.xValues();
+                    const QVector<double>& sy = currentCurve.yValues();
+                    QVector<double> diff(sx.size(), 0.0);
+                    for (int i = 1; i < sx.size(); ++i) {
+                        double dx = sx[i] - sx[i-1]; if (qAbs(dx) < 1e-12) dx = 1.0;
+                        diff[i] = (sy[i] - sy[i-1]) / dx;
+                    }
+                    stage.stageName = StageName::Derivative;
+                    stage.curve = withSampleId(CurveValue(sx, diff, currentCurve.name() + QObject::tr(" (一阶差分)")), sampleId);
+                    stage.algorithm = AlgorithmType::Derivative_SG; // 占位
+                    stage.isSegmented = false;
+                    stage.numSegments = 1;
+                    stage.useForPlot = true;
+                    sampleData.stages.append(stage);
+                    cacheChain.store(stage);
+                    currentCurve = stage.curve.value();
                 }
-                Curve* dcurve = new Curve(diff, currentCurve->name() + QObject::tr(" (一阶差分)"));
-                stage.stageName = StageName::Derivative;
-                stage.curve = QSharedPointer<Curve>(dcurve);
-                stage.curve->setSampleId(sampleId);
-                stage.algorithm = AlgorithmType::Derivative_SG; // 占位
-                stage.isSegmented = false;
-                stage.numSegments = 1;
-                stage.useForPlot = true;
-                sampleData.stages.append(stage);
-                currentCurve = stage.curve;
             }
         }
     }
@@ -1291,62 +1556,64 @@ SampleDataFlexible DataProcessingService::runProcessTgBigPipeline(int sampleId,
             int d2Win = params.deriv2SgWindowSize;
             // 强制窗口为奇数，且不超过点数范围（至少为3）
             if (d2Win % 2 == 0) d2Win += 1;
-            if (currentCurve && d2Win >= currentCurve->pointCount()) {
-                d2Win = qMax(3, currentCurve->pointCount() - 1);
+            if (!currentCurve.isEmpty() && d2Win >= currentCurve.pointCount()) {
+                d2Win = qMax(3, currentCurve.pointCount() - 1);
                 if (d2Win % 2 == 0) d2Win -= 1;
             }
             derivParams["window_size"] = d2Win;
             derivParams["poly_order"] = params.deriv2SgPolyOrder;
             derivParams["derivative_order"] = 1;
-        // 防御性检查
-            if (!currentCurve || currentCurve->pointCount() <= 1) {
-            WARNING_LOG << "一阶导阶段跳过：当前曲线为空或点数不足";
-            } else if (derivParams["window_size"].toInt() <= 2 || derivParams["window_size"].toInt() > currentCurve->pointCount()) {
-            WARNING_LOG << "一阶导阶段跳过：window_size 无效或超过点数";
+            derivParams["outputs"] = "derivative"; // 只计算导数
+            // 防御性检查
+            if (currentCurve.isEmpty() || currentCurve.pointCount() <= 1) {
+                WARNING_LOG << "一阶导阶段跳过：当前曲线为空或点数不足";
+            } else if (derivParams["window_size"].toInt() <= 2 || derivParams["window_size"].toInt() > currentCurve.pointCount()) {
+                WARNING_LOG << "一阶导阶段跳过：window_size 无效或超过点数";
             } else {
-            QString error;
-            try {
-                ProcessingResult res = step->process({currentCurve.data()}, derivParams, error);
-                if (res.namedCurves.contains("derivative1")) {
-                    stage.stageName = StageName::Derivative;
-                    stage.curve = QSharedPointer<Curve>(res.namedCurves.value("derivative1").first());
-                    stage.curve->setSampleId(sampleId);
-                    stage.algorithm = AlgorithmType::Derivative_SG;
-                    stage.isSegmented = false;
-                    stage.numSegments = 1;
-                    stage.useForPlot = true; // 允许在绘图区域显示该阶段
-                    sampleData.stages.append(stage);
-                } else {
-                    WARNING_LOG << "一阶导阶段无结果：未返回 derivative1 曲线";
+                QString error;
+                try {
+                    if (!cacheChain.restore(QStringLiteral("derivative2_sg"), derivParams, stage, sampleData, currentCurve)) {
+                        ProcessingResult res = step->process({currentCurve}, derivParams, error);
+                        if (res.namedCurves.contains("derivative1")) {
+                            stage.stageName = StageName::Derivative;
+                            stage.curve = withSampleId(res.namedCurves.value("derivative1").first(), sampleId);
+                            stage.algorithm = AlgorithmType::Derivative_SG;
+                            stage.isSegmented = false;
+                            stage.numSegments = 1;
+                            stage.useForPlot = true; // 允许在绘图区域显示该阶段
+                            sampleData.stages.append(stage);
+                            cacheChain.store(stage);
+                        } else {
+                            WARNING_LOG << "一阶导阶段无结果：未返回 derivative1 曲线";
+                        }
+                    }
+                } catch (const std::exception& e) {
+                    ERROR_LOG << QString("一阶导阶段异常：%1").arg(e.what());
+                } catch (...) {
+                    ERROR_LOG << "一阶导阶段未知异常";
                 }
-            } catch (const std::exception& e) {
-                ERROR_LOG << QString("一阶导阶段异常：%1").arg(e.what());
-            } catch (...) {
-                ERROR_LOG << "一阶导阶段未知异常";
-            }
             }
         } else if (dMethod2 == "first_diff") {
-            if (!currentCurve || currentCurve->pointCount() <= 1) {
+            if (currentCurve.isEmpty() || currentCurve.pointCount() <= 1) {
                 WARNING_LOG << "一阶导阶段跳过：当前曲线为空或点数不足";
             } else {
-                QVector<QPointF> src = currentCurve->data();
-                QVector<QPointF> diff;
-                diff.reserve(src.size());
-                for (int i = 0; i < src.size(); ++i) {
-                    if (i == 0) { diff.append(QPointF(src[i].x(), 0.0)); continue; }
-                    double dx = src[i].x() - src[i-1].x(); if (qAbs(dx) < 1e-12) dx = 1.0;
-                    double dy = src[i].y() - src[i-1].y();
-                    diff.append(QPointF(src[i].x(), dy / dx));
+                if (!cacheChain.restore(QStringLiteral("derivative2_first_diff"), QVariantMap(), stage, sampleData, currentCurve)) {
+                    const QVector<double>& sx = currentCurve.xValues();
+                    const QVector<double>& sy = currentCurve.yValues();
+                    QVector<double> diff(sx.size(), 0.0);
+                    for (int i = 1; i < sx.size(); ++i) {
+                        double dx = sx[i] - sx[i-1]; if (qAbs(dx) < 1e-12) dx = 1.0;
+                        diff[i] = (sy[i] - sy[i-1]) / dx;
+                    }
+                    stage.stageName = StageName::Derivative;
+                    stage.curve = withSampleId(CurveValue(sx, diff, currentCurve.name() + QObject::tr(" (一阶差分)")), sampleId);
+                    stage.algorithm = AlgorithmType::Derivative_SG; // 占位
+                    stage.isSegmented = false;
+                    stage.numSegments = 1;
+                    stage.useForPlot = true;
+                    sampleData.stages.append(stage);
+                    cacheChain.store(stage);
                 }
-                Curve* dcurve = new Curve(diff, currentCurve->name() + QObject::tr(" (一阶差分)"));
-                stage.stageName = StageName::Derivative;
-                stage.curve = QSharedPointer<Curve>(dcurve);
-                stage.curve->setSampleId(sampleId);
-                stage.algorithm = AlgorithmType::Derivative_SG; // 占位
-                stage.isSegmented = false;
-                stage.numSegments = 1;
-                stage.useForPlot = true;
-                sampleData.stages.append(stage);
             }
         }
     }
@@ -1363,42 +1630,16 @@ BatchGroupData DataProcessingService::runProcessTgBigPipelineForMultiple(
     const ProcessingParameters &params)
 {
     BatchGroupData batchResults;
-    // QSqlDatabase threadDb = ensureThreadLocalDatabase(); // 批量处理也使用线程专用连接
-    // SingleTobaccoSampleDAO dao(threadDb);
-    SingleTobaccoSampleDAO dao;
 
     DEBUG_LOG << "Processing ProcessTgBig samples:" << sampleIds;
 
-    for (int sampleId : sampleIds) {
-        // 单样本处理
-        SampleDataFlexible singleSample = runProcessTgBigPipeline(sampleId, params);
-        SampleIdentifier identifier = dao.getSampleIdentifierById(sampleId);
-        QString projectName = identifier.projectName;
-        QString batchCode = identifier.batchCode;
-        QString shortCode = identifier.shortCode;
-        QString groupKey  = QString("%1-%2-%3").arg(projectName).arg(batchCode).arg(shortCode);
-
-        // // 插入批量结果
-        // batchResults.insert(name, singleSample);
-
-        // 构造或获取已有的 SampleGroup
-        SampleGroup &group = batchResults[groupKey];
-        group.projectName = projectName;
-        group.batchCode   = batchCode;
-        group.shortCode   = shortCode;
-
-        
-        // // 添加单样本到平行样本列表
-        // group.parallelSamples.append(singleSample);
-
-        // // 用 SampleDataFlexible 构造 ParallelSampleData
-        // ParallelSampleData parallelSample;
-        // parallelSample.sampleData = singleSample;
-        // parallelSample.parallelNo = identifier.parallelNo;  // 直接使用 identifier 中的 parallel_no
-
+    // 批量处理在线程池中执行，每个工作线程使用线程专用连接
+    QVector<SampleIdentifier> identifiers;
+    const QVector<SampleDataFlexible> samples = runSamplesInParallel(
+        sampleIds, params, DataType::PROCESS_TG_BIG, &DataProcessingService::runProcessTgBigPipeline, identifiers);
+    for (int i = 0; i < samples.size(); ++i) {
         // 添加到组内样本列表（不在此处打 bestInGroup 标记，由代表样选择服务统一处理）
-        group.sampleDatas.append(singleSample);
-
+        appendToBatchGroup(batchResults, identifiers[i], samples[i], false);
     }
 
     // 【关键】在完成批量组构建后，调用代表样选择服务，按 RawData 阶段进行组内最优选择
@@ -2,13 +2,27 @@
 #define DATAPROCESSINGSERVICE_H
 
 #include <QObject>
+#include <QThreadPool>
+#include <QVector>
+#include <QHash>
+#include <QSqlDatabase>
 #include "core/common.h"
+#include "services/StageCache.h"
 #include "gui/dialogs/TgBigParameterSettingsDialog.h" // 包含 ProcessingParameters
 
 // 前置声明
 class IProcessingStep;
 class Curve;
 class AppInitializer; // 前置声明 AppInitializer，便于在服务层使用其 Getter
+struct SampleCurveColumns;
+
+// 单样本流水线的批次上下文：批量工作线程传入本线程专用连接与本批次预取的原始曲线；
+// 默认值（无连接、无预取）即单独调用时的行为
+struct SamplePipelineContext
+{
+    QSqlDatabase db;
+    const QHash<int, SampleCurveColumns>* prefetchedCurves = nullptr;
+};
 
 
 // Q_DECLARE_METATYPE(BatchMultiStageData)
@@ -35,11 +49,45 @@ public slots:
     SampleDataFlexible runChromatographPipeline(int sampleId, const ProcessingParameters& params);
     SampleDataFlexible runProcessTgBigPipeline(int sampleId, const ProcessingParameters& params);
 
+public:
+    // 批量流水线的并行线程数（<=0 表示使用 QThread::idealThreadCount()）
+    void setBatchThreadCount(int threadCount);
+    int batchThreadCount() const;
+
+    /**
+     * @brief 阶段缓存（见 StageCache）：参数修改后只重算首个变化阶段及其后续阶段
+     * invalidateStageCache：样本数据变化（导入/修改/删除）后调用，sampleId < 0 时清空全部。
+     */
+    void setStageCacheBudget(qint64 budgetBytes);
+    void invalidateStageCache(int sampleId = -1);
+    StageCache::Stats stageCacheStats() const;
+
+signals:
+    // 批量流水线逐样本进度（在工作线程中发出，接收方应使用队列连接）
+    void batchSampleProgress(int finishedCount, int totalCount, int sampleId);
+
 private:
+    typedef SampleDataFlexible (DataProcessingService::*SamplePipelineFn)(const SamplePipelineContext&, int, const ProcessingParameters&);
+
     void registerSteps();
-    SampleDataFlexible runTgBigLikePipeline(DataType dataType, int sampleId, const ProcessingParameters& params);
+    // 单样本流水线的实际实现，公有槽函数以默认上下文转调
+    SampleDataFlexible runTgBigPipeline(const SamplePipelineContext& context, int sampleId, const ProcessingParameters& params);
+    SampleDataFlexible runTgSmallPipeline(const SamplePipelineContext& context, int sampleId, const ProcessingParameters& params);
+    SampleDataFlexible runTgSmallRawPipeline(const SamplePipelineContext& context, int sampleId, const ProcessingParameters& params);
+    SampleDataFlexible runChromatographPipeline(const SamplePipelineContext& context, int sampleId, const ProcessingParameters& params);
+    SampleDataFlexible runProcessTgBigPipeline(const SamplePipelineContext& context, int sampleId, const ProcessingParameters& params);
+    SampleDataFlexible runTgBigLikePipeline(const SamplePipelineContext& context, DataType dataType, int sampleId,
+                                            const ProcessingParameters& params);
+    // 将样本分发到有界线程池并行执行单样本流水线；结果按 sampleIds 顺序返回，保证合并结果确定
+    QVector<SampleDataFlexible> runSamplesInParallel(const QList<int>& sampleIds,
+                                                     const ProcessingParameters& params,
+                                                     DataType dataType,
+                                                     SamplePipelineFn pipeline,
+                                                     QVector<SampleIdentifier>& identifiers);
     QMap<QString, IProcessingStep*> m_registeredSteps;
     AppInitializer* m_appInitializer = nullptr; // 
+    QThreadPool m_batchPool; // 批量流水线专用线程池（每个工作任务持有一条连接，任务结束即释放）
+    StageCache m_stageCache; // 单样本流水线阶段结果缓存（线程安全，受内存预算约束）
 };
 
 #endif // DATAPROCESSINGSERVICE_H
@@ -4,6 +4,7 @@
 #include <QJsonObject>
 #include "utils/file_handler/XlsxParser.h"
 #include "utils/file_handler/FileHandlerFactory.h"
+#include "data_access/DatabaseConnector.h"
 #include "data_access/ProcessTgBigDataDAO.h"
 #include "core/entities/ProcessTgBigData.h"
 #include "Logger.h"
@@ -91,12 +92,18 @@ bool SingleTobaccoSampleService::importProcessTgBigDataForSample(int sampleId, c
     // 为每条记录注入导入属性
     for (ProcessTgBigData& d : processTgBigDataList) { d.setImportAttributes(importAttributes); }
 
+    // 删除旧数据与写入新数据（含目录行）在同一事务内，失败时整体回滚
+    QSqlDatabase db = DatabaseConnector::getInstance().getDatabase();
+    if (!db.isOpen()) { errorMessage = "数据库未连接，无法导入数据。"; return false; }
+    db.transaction();
+
     // 先删除该样本的现有数据
     m_processTgBigDataDao->removeBySampleId(sampleId);
 
     // 批量插入新数据
     bool insertSuccess = m_processTgBigDataDao->insertBatch(processTgBigDataList);
-    if (!insertSuccess) {
+    if (!insertSuccess || !db.commit()) {
+        db.rollback();
         errorMessage = "保存处理后大热重数据到数据库失败";
         return false;
     }
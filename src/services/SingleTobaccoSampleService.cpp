@@ -713,10 +713,13 @@ bool SingleTobaccoSampleService::exportDataToFile(const QString& filePath,
 
 QString SingleTobaccoSampleService::buildSampleDisplayName(int sampleId) {
         SingleTobaccoSampleDAO dao;
-        SampleIdentifier sid = dao.getSampleIdentifierById(sampleId);
+        return buildSampleDisplayName(dao.getSampleIdentifierById(sampleId));
+            }
+
+QString SingleTobaccoSampleService::buildSampleDisplayName(const SampleIdentifier& sid) {
         return QString("%1-%2-%3-%4")
                 .arg(sid.projectName)
                 .arg(sid.batchCode)
                 .arg(sid.shortCode)
                 .arg(sid.parallelNo);
-            }
+}
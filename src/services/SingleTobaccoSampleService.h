@@ -30,6 +30,7 @@ class AbstractFileParser;
 class AbstractFileWriter;
 // --- 结束前向声明 ---
 class DictionaryOptionService; // <-- 新增前向声明
+struct SampleIdentifier;
 
 // --- 修改：SingleReplicateColumnMapping 结构体，添加更多通用列 ---
 // 列索引都是 1-based (用户输入)，在代码中访问 QVariantList 时会转换为 0-based
@@ -169,6 +170,8 @@ public:
                           QString& errorMessage);
 
     static QString buildSampleDisplayName(int sampleId);
+    // 已取得标识时直接拼接（批量场景先用 getSampleIdentifiersByIds 一次查询）
+    static QString buildSampleDisplayName(const SampleIdentifier& sid);
 
 private:
     // ... (成员变量不变) ...
@@ -0,0 +1,172 @@
+#include "StageCache.h"
+
+#include <QCryptographicHash>
+#include <QDataStream>
+#include <QMutexLocker>
+#include <limits>
+
+namespace {
+
+// 条目费用（KB）：曲线 X/Y 列与 metrics 中的数组按 8 字节/点估算
+static int entryCostKb(const StageData& stage)
+{
+    const CurveValue value = stage.curve.value();
+    qint64 bytes = 256 + qint64(value.xValues().size() + value.yValues().size()) * qint64(sizeof(double));
+    for (auto it = stage.metrics.constBegin(); it != stage.metrics.constEnd(); ++it) {
+        if (it.value().userType() == qMetaTypeId<QVector<double>>())
+            bytes += qint64(it.value().value<QVector<double>>().size()) * qint64(sizeof(double));
+    }
+    return int(qMax<qint64>(1, (bytes + 1023) / 1024));
+}
+
+// 缓存内外各持一份独立的 StageCurve：界面生成/修改 Curve 不会影响缓存中的数据
+static StageData detachedStage(const StageData& stage)
+{
+    StageData copy = stage;
+    copy.curve = stage.curve.isNull() ? StageCurve() : StageCurve(stage.curve.value());
+    return copy;
+}
+
+} // namespace
+
+// --- StageCache::Chain ---
+
+StageCache::Chain::Chain(StageCache* cache, DataType dataType, int sampleId)
+    : m_cache(cache), m_sampleId(sampleId)
+{
+    if (m_cache) m_key = m_cache->rootKey(dataType, sampleId);
+}
+
+bool StageCache::Chain::restore(const QString& stageId, const QVariantMap& params,
+                                StageData& stage, SampleDataFlexible& sampleData, CurveValue& currentCurve)
+{
+    if (!m_cache) return false;
+    m_key = StageCache::chainKey(m_key, stageId, params);
+    if (!m_cache->lookup(m_key, stage)) return false;
+    sampleData.stages.append(stage);
+    currentCurve = stage.curve.value();
+    return true;
+}
+
+void StageCache::Chain::store(const StageData& stage)
+{
+    if (m_cache) m_cache->insert(m_key, m_sampleId, stage);
+}
+
+bool StageCache::Chain::contains(const QString& stageId, const QVariantMap& params) const
+{
+    return m_cache && m_cache->contains(StageCache::chainKey(m_key, stageId, params));
+}
+
+// --- StageCache ---
+
+StageCache::Entry::~Entry()
+{
+    if (!index) return;
+    auto it = index->find(sampleId);
+    if (it == index->end()) return;
+    it->remove(key);
+    if (it->isEmpty()) index->erase(it);
+}
+
+StageCache::StageCache(qint64 budgetBytes)
+{
+    setBudget(budgetBytes);
+}
+
+void StageCache::setBudget(qint64 budgetBytes)
+{
+    QMutexLocker locker(&m_mutex);
+    const int before = m_cache.size();
+    m_cache.setMaxCost(int(qBound<qint64>(1, budgetBytes / 1024, std::numeric_limits<int>::max())));
+    m_evictions += before - m_cache.size();
+}
+
+qint64 StageCache::budget() const
+{
+    QMutexLocker locker(&m_mutex);
+    return qint64(m_cache.maxCost()) * 1024;
+}
+
+void StageCache::invalidateSample(int sampleId)
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_sampleVersions[sampleId];
+    // 按索引逐键移除：QCache::object() 会把条目移到最近使用端，不能用来遍历查找
+    const QSet<QByteArray> keys = m_sampleKeys.value(sampleId);
+    for (const QByteArray& key : keys) m_cache.remove(key);
+}
+
+void StageCache::invalidateAll()
+{
+    QMutexLocker locker(&m_mutex);
+    ++m_epoch;
+    m_sampleVersions.clear();
+    m_cache.clear();
+}
+
+StageCache::Stats StageCache::stats() const
+{
+    QMutexLocker locker(&m_mutex);
+    Stats s;
+    s.hits = m_hits;
+    s.misses = m_misses;
+    s.evictions = m_evictions;
+    s.entries = m_cache.size();
+    s.usedBytes = qint64(m_cache.totalCost()) * 1024;
+    s.budgetBytes = qint64(m_cache.maxCost()) * 1024;
+    return s;
+}
+
+QByteArray StageCache::chainKey(const QByteArray& parentKey, const QString& stageId, const QVariantMap& params)
+{
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << parentKey << stageId << params; // QVariantMap 按键有序，序列化结果确定
+    return QCryptographicHash::hash(payload, QCryptographicHash::Sha1);
+}
+
+QByteArray StageCache::rootKey(DataType dataType, int sampleId) const
+{
+    QMutexLocker locker(&m_mutex);
+    QByteArray payload;
+    QDataStream stream(&payload, QIODevice::WriteOnly);
+    stream << qint32(dataType) << qint32(sampleId) << m_epoch << m_sampleVersions.value(sampleId, 0);
+    return QCryptographicHash::hash(payload, QCryptographicHash::Sha1);
+}
+
+bool StageCache::lookup(const QByteArray& key, StageData& stage)
+{
+    QMutexLocker locker(&m_mutex);
+    const Entry* entry = m_cache.object(key);
+    if (!entry) {
+        ++m_misses;
+        return false;
+    }
+    ++m_hits;
+    stage = detachedStage(entry->stage);
+    return true;
+}
+
+void StageCache::insert(const QByteArray& key, int sampleId, const StageData& stage)
+{
+    Entry* entry = new Entry;
+    entry->sampleId = sampleId;
+    entry->key = key;
+    entry->index = &m_sampleKeys;
+    entry->stage = detachedStage(stage);
+    const int cost = entryCostKb(entry->stage);
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.remove(key); // 旧条目先析构并退出索引，再登记新条目
+    m_sampleKeys[sampleId].insert(key);
+    const int expected = m_cache.size() + 1;
+    m_cache.insert(key, entry, cost); // 超出预算时 QCache 自动淘汰最久未用的条目（单条超预算则直接丢弃）
+    m_evictions += expected - m_cache.size();
+}
+
+bool StageCache::contains(const QByteArray& key) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.contains(key);
+}
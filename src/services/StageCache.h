@@ -0,0 +1,102 @@
+#ifndef STAGECACHE_H
+#define STAGECACHE_H
+
+#include <QByteArray>
+#include <QCache>
+#include <QHash>
+#include <QMutex>
+#include <QSet>
+#include <QString>
+#include <QVariantMap>
+
+#include "core/common.h"
+
+/**
+ * @brief 单样本流水线的阶段结果缓存
+ *
+ * 每个阶段的键由 (数据类型, 样本ID, 数据版本) 出发，按阶段顺序逐级串接
+ * “阶段ID + 该阶段参数”求哈希得到，因此某个参数改变时只有该阶段及其后续阶段的键会变化，
+ * 前面的阶段（包括原始数据读取）直接命中缓存。
+ *
+ * 按曲线数据量计费并受内存预算约束，超出预算时按最近最少使用淘汰。线程安全。
+ */
+class StageCache
+{
+public:
+    struct Stats {
+        qint64 hits = 0;         // 命中次数
+        qint64 misses = 0;       // 未命中次数
+        qint64 evictions = 0;    // 因预算淘汰的条目数
+        int entries = 0;         // 当前条目数
+        qint64 usedBytes = 0;    // 当前占用（估算）
+        qint64 budgetBytes = 0;  // 内存预算
+    };
+
+    /**
+     * @brief 一次单样本流水线的阶段键链
+     *
+     * 用法：每个启用的阶段先 restore()，未命中时照常计算，成功后 store()。
+     * restore() 无论是否命中都会把键推进到该阶段，后续阶段据此串接。
+     */
+    class Chain
+    {
+    public:
+        Chain(StageCache* cache, DataType dataType, int sampleId);
+
+        // 命中时写入 stage、追加到 sampleData.stages 并更新接力棒 currentCurve
+        bool restore(const QString& stageId, const QVariantMap& params,
+                     StageData& stage, SampleDataFlexible& sampleData, CurveValue& currentCurve);
+        // 记录当前阶段（最近一次 restore 的键）的计算结果
+        void store(const StageData& stage);
+        // 仅查询某阶段是否已缓存（不推进键链）
+        bool contains(const QString& stageId, const QVariantMap& params = QVariantMap()) const;
+
+    private:
+        StageCache* m_cache = nullptr;
+        int m_sampleId = -1;
+        QByteArray m_key;
+    };
+
+    explicit StageCache(qint64 budgetBytes = 256 * 1024 * 1024);
+
+    void setBudget(qint64 budgetBytes);
+    qint64 budget() const;
+
+    // 样本数据发生变化（重新导入/修改）时调用：提升该样本的数据版本并移除其全部阶段
+    void invalidateSample(int sampleId);
+    // 清空全部缓存（同时提升全局版本，进行中的流水线写入的旧结果不会再被命中）
+    void invalidateAll();
+
+    Stats stats() const;
+
+    // 阶段键：parentKey 与阶段ID、参数共同求哈希
+    static QByteArray chainKey(const QByteArray& parentKey, const QString& stageId, const QVariantMap& params);
+
+private:
+    // 样本 -> 其在缓存中的阶段键；条目被淘汰/移除时由析构函数同步删除
+    typedef QHash<int, QSet<QByteArray>> SampleKeyIndex;
+
+    struct Entry {
+        ~Entry();
+        int sampleId = -1;
+        QByteArray key;
+        SampleKeyIndex* index = nullptr;
+        StageData stage;
+    };
+
+    QByteArray rootKey(DataType dataType, int sampleId) const;
+    bool lookup(const QByteArray& key, StageData& stage);
+    void insert(const QByteArray& key, int sampleId, const StageData& stage);
+    bool contains(const QByteArray& key) const;
+
+    mutable QMutex m_mutex;
+    SampleKeyIndex m_sampleKeys;         // 须先于 m_cache 声明：m_cache 析构时条目仍要访问索引
+    QCache<QByteArray, Entry> m_cache;   // 费用单位为 KB
+    QHash<int, quint32> m_sampleVersions;
+    quint32 m_epoch = 0;
+    qint64 m_hits = 0;
+    qint64 m_misses = 0;
+    qint64 m_evictions = 0;
+};
+
+#endif // STAGECACHE_H
@@ -0,0 +1,355 @@
+#include "AirPlsSolver.h"
+#include "Logger.h"
+
+#include <QHash>
+#include <QMap>
+#include <QReadWriteLock>
+#include <QtConcurrent>
+#include <QtMath>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// ==== 惩罚矩阵 lambda * D'D ====
+
+static QVector<double> computeDiffCoeffs(int order)
+{
+    QVector<double> coeffs(order + 1, 0.0);
+    auto binom = [](int n, int k) -> double {
+        if (k < 0 || k > n) return 0.0;
+        double res = 1.0;
+        for (int i = 1; i <= k; ++i) {
+            res = res * (n - (k - i)) / i;
+        }
+        return res;
+    };
+    for (int k = 0; k <= order; ++k) {
+        double c = binom(order, k);
+        double sign = ((order - k) % 2 == 0) ? 1.0 : -1.0;
+        coeffs[k] = sign * c;
+    }
+    return coeffs;
+}
+
+// 按行连续存放的下三角带：band[i * (order + 1) + (order - d)] = A(i, i - d)，d = 0..order
+// 累加顺序与原 QVector<QVector<double>> 版本相同，数值逐位一致
+static QVector<double> buildPenaltyBand(int n, int order, double lambda)
+{
+    const int stride = order + 1;
+    QVector<double> band(n * stride, 0.0);
+    const int rows = n - order; // MATLAB: D = diff(speye(n), order) -> (n-order) x n
+    if (rows <= 0) return band;
+
+    const QVector<double> coeffs = computeDiffCoeffs(order);
+    for (int j = 0; j < rows; ++j) {
+        for (int k = 0; k <= order; ++k) {
+            const int i = j + k;
+            const double ck = coeffs[k];
+            for (int l = 0; l <= k; ++l) { // 仅累加下三角
+                const int d = k - l;
+                band[i * stride + (order - d)] += lambda * ck * coeffs[l];
+            }
+        }
+    }
+    return band;
+}
+
+struct BandKey {
+    int n;
+    int order;
+    double lambda;
+};
+
+inline bool operator==(const BandKey& a, const BandKey& b)
+{
+    return a.n == b.n && a.order == b.order && a.lambda == b.lambda;
+}
+
+inline uint qHash(const BandKey& key, uint seed = 0)
+{
+    return ::qHash(key.n, seed) ^ (::qHash(key.order, seed) << 1) ^ ::qHash(key.lambda, seed);
+}
+
+// 等长样本共享同一惩罚带（QVector 隐式共享，返回不拷贝数据）
+static QVector<double> cachedPenaltyBand(int n, int order, double lambda)
+{
+    static QReadWriteLock lock;
+    static QHash<BandKey, QVector<double>> cache;
+    const BandKey key{n, order, lambda};
+    {
+        QReadLocker locker(&lock);
+        auto it = cache.constFind(key);
+        if (it != cache.constEnd()) return it.value();
+    }
+
+    const QVector<double> band = buildPenaltyBand(n, order, lambda);
+    QWriteLocker locker(&lock);
+    if (cache.size() >= 32) cache.clear(); // 参数组合通常很少，超出时整体清空
+    cache.insert(key, band);
+    return band;
+}
+
+// ==== 带状 LDL' 分解与求解 ====
+// K 条等长曲线按列交错存放（元素 (i, c) 位于 i * K + c），逐行同步分解/求解：
+// 各曲线的依赖链互不相关，可相互掩盖除法与乘加延迟，并可在曲线方向上向量化。
+// 每条曲线的运算与 K = 1 时完全相同。
+// B > 0 时半带宽为编译期常量（内层循环展开），B = 0 时使用运行期的 bw。
+// L(i, i - d) 位于 L[(i * bw + (bw - d)) * K + c]，d = 1..bw；保存 1/D 以便求解时只做乘法。
+
+// Full 为 true 时本行有完整的 bw 个下三角元素（span 取编译期常量）
+template<int B, int K, bool Full>
+static inline void factorRow(const double* dd, const double* w, int i, int spanRuntime, int bw, const double* jitter,
+                             double* L, double* D, double* invD, bool* failed)
+{
+    const int span = (Full && B > 0) ? B : spanRuntime;
+    const double* a = dd + i * (bw + 1);
+    double* li = L + i * bw * K;
+    double diag[K];
+    for (int c = 0; c < K; ++c) diag[c] = a[bw] + (w[i * K + c] + jitter[c]);
+    for (int d = span; d >= 1; --d) {
+        const int j = i - d;
+        const double* lj = L + j * bw * K;
+        double s[K];
+        for (int c = 0; c < K; ++c) s[c] = a[bw - d];
+        for (int e = span; e > d; --e) { // k = i - e，满足 k < j
+            for (int c = 0; c < K; ++c)
+                s[c] -= li[(bw - e) * K + c] * lj[(bw - (e - d)) * K + c] * D[(i - e) * K + c];
+        }
+        for (int c = 0; c < K; ++c) {
+            const double lij = s[c] * invD[j * K + c];
+            li[(bw - d) * K + c] = lij;
+            diag[c] -= lij * s[c];
+        }
+    }
+    for (int c = 0; c < K; ++c) {
+        if (!(diag[c] > 0.0)) { // 非正定：记录失败，以 1 占位继续其余曲线
+            failed[c] = true;
+            diag[c] = 1.0;
+        }
+        D[i * K + c] = diag[c];
+        invD[i * K + c] = 1.0 / diag[c];
+    }
+}
+
+template<int B, int K>
+static void factorLdl(const double* dd, const double* w, int n, int bwRuntime, const double* jitter,
+                      double* L, double* D, double* invD, bool* failed)
+{
+    const int bw = B > 0 ? B : bwRuntime;
+    const int head = qMin(n, bw);
+    for (int i = 0; i < head; ++i) {
+        for (int d = i + 1; d <= bw; ++d)
+            for (int c = 0; c < K; ++c) L[(i * bw + (bw - d)) * K + c] = 0.0;
+        factorRow<B, K, false>(dd, w, i, i, bw, jitter, L, D, invD, failed);
+    }
+    for (int i = head; i < n; ++i)
+        factorRow<B, K, true>(dd, w, i, bw, bw, jitter, L, D, invD, failed);
+}
+
+template<int B, int K, bool Full>
+static inline void forwardRow(const double* L, int i, int spanRuntime, int bw, const double* b, double* x)
+{
+    const int span = (Full && B > 0) ? B : spanRuntime;
+    const double* li = L + i * bw * K;
+    double s[K];
+    for (int c = 0; c < K; ++c) s[c] = b[i * K + c];
+    for (int d = 1; d <= span; ++d)
+        for (int c = 0; c < K; ++c) s[c] -= li[(bw - d) * K + c] * x[(i - d) * K + c];
+    for (int c = 0; c < K; ++c) x[i * K + c] = s[c];
+}
+
+template<int B, int K, bool Full>
+static inline void backwardRow(const double* L, int i, int spanRuntime, int bw, double* x)
+{
+    const int span = (Full && B > 0) ? B : spanRuntime;
+    double s[K];
+    for (int c = 0; c < K; ++c) s[c] = x[i * K + c];
+    for (int d = 1; d <= span; ++d)
+        for (int c = 0; c < K; ++c) s[c] -= L[((i + d) * bw + (bw - d)) * K + c] * x[(i + d) * K + c];
+    for (int c = 0; c < K; ++c) x[i * K + c] = s[c];
+}
+
+template<int B, int K>
+static void solveLdl(const double* L, const double* invD, int n, int bwRuntime, const double* b, double* x)
+{
+    const int bw = B > 0 ? B : bwRuntime;
+    // 前代：L z = b（首行不足 bw 个非零元）
+    const int head = qMin(n, bw);
+    for (int i = 0; i < head; ++i) forwardRow<B, K, false>(L, i, i, bw, b, x);
+    for (int i = head; i < n; ++i) forwardRow<B, K, true>(L, i, bw, bw, b, x);
+    for (int i = 0; i < n * K; ++i) x[i] *= invD[i];
+    // 回代：L' x = z（末行不足 bw 个非零元）
+    const int tail = qMax(0, n - bw);
+    for (int i = n - 1; i >= tail; --i) backwardRow<B, K, false>(L, i, n - 1 - i, bw, x);
+    for (int i = tail - 1; i >= 0; --i) backwardRow<B, K, true>(L, i, bw, bw, x);
+}
+
+// ==== airPLS 迭代（与原 MATLAB 移植版一致）====
+// K 条等长曲线同步迭代；已收敛（或分解失败）的曲线结果立即取出，其权重不再更新。
+
+template<int B, int K>
+static void runAirPls(const QVector<double>* const* ys, QVector<double>* const* outs, int n,
+                      const QVector<double>& ddBand, const AirPlsSolver::Params& params)
+{
+    const int bw = params.order;
+    QVector<double> y(n * K), weights(n * K, 1.0), b(n * K), x(n * K, 0.0);
+    QVector<double> L(n * bw * K), D(n * K), invD(n * K);
+    for (int i = 0; i < n; ++i)
+        for (int c = 0; c < K; ++c) y[i * K + c] = (*ys[c])[i];
+
+    double sumAbsY[K];
+    bool done[K];
+    for (int c = 0; c < K; ++c) {
+        sumAbsY[c] = 0.0;
+        for (int i = 0; i < n; ++i) sumAbsY[c] += std::abs(y[i * K + c]);
+        if (sumAbsY[c] <= 0.0) sumAbsY[c] = 1.0;
+        done[c] = false;
+    }
+    auto takeResult = [&](int c) {
+        QVector<double>& out = *outs[c];
+        out.resize(n);
+        for (int i = 0; i < n; ++i) out[i] = x[i * K + c];
+        done[c] = true;
+    };
+
+    // MATLAB: startIdx = 1:ceil(n*wep); endIdx = floor(n - n*wep + 1):n
+    const int startCount = qCeil(n * params.wep);
+    const int endStart = static_cast<int>(std::floor(n - n * params.wep));
+
+    for (int iter = 1; iter <= params.itermax; ++iter) {
+        for (int i = 0; i < n * K; ++i) b[i] = weights[i] * y[i];
+
+        // A = W + DD；接近奇异时对失败的曲线添加极小对角扰动后重试
+        double jitter[K];
+        bool failed[K];
+        for (int c = 0; c < K; ++c) { jitter[c] = 0.0; failed[c] = false; }
+        factorLdl<B, K>(ddBand.constData(), weights.constData(), n, bw, jitter, L.data(), D.data(), invD.data(), failed);
+        bool retry = false;
+        for (int c = 0; c < K; ++c) {
+            if (failed[c] && !done[c]) { jitter[c] = 1e-12; retry = true; }
+            failed[c] = false;
+        }
+        if (retry) {
+            factorLdl<B, K>(ddBand.constData(), weights.constData(), n, bw, jitter, L.data(), D.data(), invD.data(), failed);
+            for (int c = 0; c < K; ++c) {
+                if (failed[c] && !done[c]) {
+                    WARNING_LOG << "airPLS: LDL 分解失败，无法求解基线";
+                    takeResult(c); // 保留上一次迭代的基线
+                }
+            }
+        }
+        solveLdl<B, K>(L.constData(), invD.constData(), n, bw, b.constData(), x.data());
+
+        bool allDone = true;
+        for (int c = 0; c < K; ++c) {
+            if (done[c]) continue;
+            double dssn = 0.0;
+            for (int i = 0; i < n; ++i) {
+                const double residual = y[i * K + c] - x[i * K + c];
+                if (residual < 0.0) dssn += -residual;
+            }
+            if (dssn < 0.001 * sumAbsY[c]) {
+                DEBUG_LOG << "airPLS 收敛于迭代 " << iter << ", dssn = " << dssn;
+                takeResult(c);
+                continue;
+            }
+            allDone = false;
+
+            // MATLAB updateWeights()：残差 >= 0 置 0，首尾保护区置 p，残差 < 0 按指数加权（后者优先）
+            const double denom = (dssn == 0.0) ? std::numeric_limits<double>::min() : dssn;
+            const double scale = iter / denom;
+            for (int i = 0; i < n; ++i) {
+                const double residual = y[i * K + c] - x[i * K + c];
+                if (residual < 0.0)
+                    weights[i * K + c] = std::exp(scale * -residual);
+                else
+                    weights[i * K + c] = (i < startCount || i >= endStart) ? params.p : 0.0;
+            }
+        }
+        if (allDone) break;
+    }
+
+    for (int c = 0; c < K; ++c) {
+        if (!done[c]) takeResult(c);
+    }
+}
+
+static AirPlsSolver::Params sanitized(AirPlsSolver::Params params)
+{
+    if (params.order < 1) params.order = 1;
+    if (params.itermax < 1) params.itermax = 1;
+    if (params.lambda <= 0.0) params.lambda = 1e5;
+    params.p = qBound(0.0, params.p, 1.0);
+    params.wep = qBound(0.0, params.wep, 0.5);
+    return params;
+}
+
+template<int K>
+static void runGroup(const QVector<double>* const* ys, QVector<double>* const* outs, const AirPlsSolver::Params& params)
+{
+    const int n = ys[0]->size();
+    if (n == 0) {
+        for (int c = 0; c < K; ++c) outs[c]->clear();
+        return;
+    }
+    const QVector<double> ddBand = cachedPenaltyBand(n, params.order, params.lambda);
+    switch (params.order) {
+    case 1: runAirPls<1, K>(ys, outs, n, ddBand, params); break;
+    case 2: runAirPls<2, K>(ys, outs, n, ddBand, params); break;
+    case 3: runAirPls<3, K>(ys, outs, n, ddBand, params); break;
+    default: runAirPls<0, K>(ys, outs, n, ddBand, params); break;
+    }
+}
+
+const int kLanes = 4; // 同步求解的曲线数
+
+} // namespace
+
+namespace AirPlsSolver {
+
+QVector<double> solve(const QVector<double>& y, const Params& params)
+{
+    QVector<double> baseline;
+    const QVector<double>* ys[1] = {&y};
+    QVector<double>* outs[1] = {&baseline};
+    runGroup<1>(ys, outs, sanitized(params));
+    return baseline;
+}
+
+QList<QVector<double>> solveBatch(const QList<QVector<double>>& ys, const Params& params)
+{
+    const Params p = sanitized(params);
+    QVector<QVector<double>> results(ys.size());
+    QVector<double>* out = results.data();
+
+    // 按长度分组，每 kLanes 条为一个同步求解任务，余下的单独求解；任务间并行
+    QMap<int, QVector<int>> byLength;
+    for (int i = 0; i < ys.size(); ++i) byLength[ys.at(i).size()].append(i);
+    QVector<QVector<int>> tasks;
+    for (const QVector<int>& indices : byLength) {
+        int k = 0;
+        for (; k + kLanes <= indices.size(); k += kLanes) tasks.append(indices.mid(k, kLanes));
+        for (; k < indices.size(); ++k) tasks.append(QVector<int>{indices[k]});
+    }
+
+    auto runTask = [&](const QVector<int>& task) {
+        const QVector<double>* in[kLanes];
+        QVector<double>* res[kLanes];
+        for (int c = 0; c < task.size(); ++c) {
+            in[c] = &ys.at(task[c]);
+            res[c] = &out[task[c]];
+        }
+        if (task.size() == kLanes)
+            runGroup<kLanes>(in, res, p);
+        else
+            runGroup<1>(in, res, p);
+    };
+    if (tasks.size() == 1)
+        runTask(tasks.first());
+    else if (!tasks.isEmpty())
+        QtConcurrent::blockingMap(tasks, runTask);
+    return results.toList();
+}
+
+} // namespace AirPlsSolver
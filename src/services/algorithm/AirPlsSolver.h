@@ -0,0 +1,36 @@
+#ifndef AIRPLSSOLVER_H
+#define AIRPLSSOLVER_H
+
+#include <QList>
+#include <QVector>
+
+/**
+ * @brief airPLS 基线求解器（BaselineCorrector 使用）
+ *
+ * 每次迭代求解 (W + lambda * D'D) z = W y，D 为 order 阶差分矩阵：
+ * - lambda * D'D 为半带宽 order 的对称带状矩阵，按 (n, lambda, order) 缓存，等长样本共享；
+ * - 带状矩阵按行连续存放（每行 order + 1 个元素），以 LDL' 分解求解（无开方），
+ *   order = 1/2/3 在编译期展开内层循环，其余阶数走通用路径；
+ * - solveBatch() 一次处理多条曲线，曲线间并行。
+ *
+ * 迭代、权重更新与收敛判据与原 MATLAB 移植版一致。
+ */
+namespace AirPlsSolver {
+
+struct Params {
+    double lambda = 1e5;
+    int order = 2;
+    double p = 0.05;
+    int itermax = 50;
+    double wep = 0.0; // 首尾保护区比例 [0, 0.5]
+};
+
+// 单条曲线的基线；失败时返回全 0
+QVector<double> solve(const QVector<double>& y, const Params& params);
+
+// 多条曲线的基线（与 ys 一一对应），长度相同的曲线共享惩罚矩阵
+QList<QVector<double>> solveBatch(const QList<QVector<double>>& ys, const Params& params);
+
+} // namespace AirPlsSolver
+
+#endif // AIRPLSSOLVER_H
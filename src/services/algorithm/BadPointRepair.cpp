@@ -1,4 +1,5 @@
 #include "BadPointRepair.h"
+#include "HampelKernel.h"
 #include "core/entities/Curve.h"
 #include "Logger.h"
 
@@ -29,46 +30,6 @@ QVariantMap BadPointRepair::defaultParameters() const {
     return params;
 }
 
-// 判断字符坏点或者无效点（这里主要用于 Curve 中已经保证 double，只处理 NaN/inf）
-bool BadPointRepair::isBadPoint(double v)
-{
-    return qIsNaN(v) || qIsInf(v);
-}
-
-/**
- * 判断局部异常点（类似 Hampel filter）
- */
-bool BadPointRepair::isLocalOutlier(const QVector<double>& y, int idx, int win, double nSigma)
-{
-    int N = y.size();
-    int half = win / 2;
-    int lo = qMax(0, idx - half);
-    int hi = qMin(N - 1, idx + half);
-
-    QVector<double> winvals;
-    winvals.reserve(hi - lo + 1);
-
-    for (int i = lo; i <= hi; ++i)
-        winvals.append(y[i]);
-
-    std::sort(winvals.begin(), winvals.end());
-    double med = winvals[winvals.size() / 2];
-
-    QVector<double> absdev;
-    absdev.reserve(winvals.size());
-    for (double v : winvals)
-        absdev.append(qAbs(v - med));
-
-    std::sort(absdev.begin(), absdev.end());
-    double mad = absdev[absdev.size() / 2];
-
-    double sigma = 1.4826 * mad;
-    if (sigma < 1e-12)
-        sigma = 1e-6;
-
-    return qAbs(y[idx] - med) > nSigma * sigma;
-}
-
 // PCHIP（单调保形分段三次插值）实现，基于 Fritsch-Carlson 方法
 static void pchipInterpolateInPlace(QVector<double>& y)
 {
@@ -188,7 +149,7 @@ void BadPointRepair::localLinearRepair(
 /**
  * 主处理流程
  */
-ProcessingResult BadPointRepair::process(const QList<Curve*>& inputCurves,
+ProcessingResult BadPointRepair::process(const QList<CurveValue>& inputCurves,
                                          const QVariantMap& params,
                                          QString& error)
 {
@@ -206,73 +167,23 @@ ProcessingResult BadPointRepair::process(const QList<Curve*>& inputCurves,
     QString fitType = params.value("fit_type", QStringLiteral("linear")).toString();
     double epsScale = params.value("eps_scale", 1e-9).toDouble();
 
-    for (Curve* inCurve : inputCurves) {
-        QVector<QPointF> raw = inCurve->data();
-        if (raw.isEmpty())
+    for (const CurveValue& inCurve : inputCurves) {
+        if (inCurve.isEmpty())
             continue;
 
-        int N = raw.size();
-        QVector<double> x(N), y(N);
-        for (int i = 0; i < N; ++i) {
-            x[i] = raw[i].x();
-            y[i] = raw[i].y();
-        }
+        int N = inCurve.pointCount();
+        const QVector<double>& x = inCurve.xValues();
+        const QVector<double>& y = inCurve.yValues();
 
         DEBUG_LOG << "BadPointRepair::process() N:" << N;
         // ------ 1. 标记坏点 ------
-        QVector<bool> bad(N, false);
-
-        // NaN / inf
-        for (int i = 0; i < N; ++i)
-            if (isBadPoint(y[i]))
-                bad[i] = true;
-
-        // 全局偏差（相对稳健基线的MAD阈值）
-        {
-            // 稳健基线（中值滤波），窗口取 max(win, N/10) 的奇数
-            int medianWin = qMax(win, qMax(3, (int)qRound(N / 10.0)));
-            if (medianWin % 2 == 0) medianWin += 1;
-            QVector<double> baseline(N);
-            int half = medianWin / 2;
-            for (int i = 0; i < N; ++i) {
-                int lo = qMax(0, i - half);
-                int hi = qMin(N - 1, i + half);
-                QVector<double> vals;
-                vals.reserve(hi - lo + 1);
-                for (int k = lo; k <= hi; ++k) vals.append(y[k]);
-                std::sort(vals.begin(), vals.end());
-                baseline[i] = vals[vals.size() / 2];
-            }
-            QVector<double> dev(N);
-            for (int i = 0; i < N; ++i) dev[i] = qAbs(y[i] - baseline[i]);
-            // MAD 估计
-            QVector<double> devAbs = dev;
-            std::sort(devAbs.begin(), devAbs.end());
-            double medDev = devAbs[devAbs.size() / 2];
-            double mad = 1.4826 * medDev;
-            if (mad < 1e-12) {
-                // MAD过小则退化为标准差估计
-                double mean = 0.0; for (double d : dev) mean += d; mean /= N;
-                double var = 0.0; for (double d : dev) var += (d - mean) * (d - mean); var /= qMax(1, N - 1);
-                mad = qMax(1e-9, std::sqrt(var));
-            }
-            for (int i = 0; i < N; ++i) {
-                if (!bad[i] && mad > 0.0 && dev[i] > globalNSigma * mad)
-                    bad[i] = true;
-            }
-        }
-
-        // 局部异常点（Hampel）
-        for (int i = 0; i < N; ++i) {
-            if (!bad[i] && isLocalOutlier(y, i, win, nSigma))
-                bad[i] = true;
-        }
-
-        // 跳变点（diff）
-        for (int i = 1; i < N; ++i) {
-            if (qAbs(y[i] - y[i - 1]) > jumpThr)
-                bad[i] = true;
-        }
+        // NaN / inf、全局偏差（相对稳健基线的MAD阈值）、局部异常点（Hampel）、跳变点（diff）
+        HampelKernel::Options outlierOptions;
+        outlierOptions.window = win;
+        outlierOptions.nSigma = nSigma;
+        outlierOptions.globalNSigma = globalNSigma;
+        outlierOptions.jumpThreshold = jumpThr;
+        QVector<bool> bad = HampelKernel::outlierMask(y, outlierOptions);
 
         // ------ 1.1 单调性破坏（仅在指定区间）------
         {
@@ -297,10 +208,8 @@ ProcessingResult BadPointRepair::process(const QList<Curve*>& inputCurves,
                 }
             }
             if (!badPts.isEmpty()) {
-                Curve* badCurve = new Curve(badPts, QObject::tr("坏点"));
-                // 设置样式为虚线，绘图层可选择散点显示
-                badCurve->setLineStyle(Qt::NoPen);
-                result.namedCurves["bad_points"].append(badCurve);
+                // 绘图层按散点显示（样式由界面决定）
+                result.namedCurves["bad_points"].append(CurveValue(badPts, QObject::tr("坏点")));
             }
         }
 
@@ -517,14 +426,9 @@ ProcessingResult BadPointRepair::process(const QList<Curve*>& inputCurves,
 
         DEBUG_LOG << "BadPointRepair::process() done";
 
-        // ------ 4. 生成新的 Curve ------
-        QVector<QPointF> repaired;
-        repaired.reserve(N);
-        for (int i = 0; i < N; ++i)
-            repaired.append(QPointF(x[i], y_repaired[i]));
-
-        Curve* c = new Curve(repaired, inCurve->name() + QObject::tr(" (坏点修复)"));
-        c->setSampleId(inCurve->sampleId());
+        // ------ 4. 生成新的曲线（与输入共享 X 列） ------
+        CurveValue c(x, y_repaired, inCurve.name() + QObject::tr(" (坏点修复)"));
+        c.setSampleId(inCurve.sampleId());
 
         result.namedCurves["repaired"].append(c);
     }
@@ -10,13 +10,11 @@ public:
     QString userVisibleName() const override;
     QVariantMap defaultParameters() const override;
 
-    ProcessingResult process(const QList<Curve*>& inputCurves,
+    ProcessingResult process(const QList<CurveValue>& inputCurves,
                              const QVariantMap& params,
                              QString& error) override;
 
 private:
-    bool isBadPoint(double v);
-    bool isLocalOutlier(const QVector<double>& y, int idx, int win, double nSigma);
     void localLinearRepair(QVector<double>& y, const QVector<bool>& badMask);
 };
 
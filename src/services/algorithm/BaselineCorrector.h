@@ -23,7 +23,7 @@ public:
     QString stepName() const;
     QString userVisibleName() const;
     QVariantMap defaultParameters() const;
-    ProcessingResult process(const QList<Curve*>& inputCurves, const QVariantMap& params, QString& error);
+    ProcessingResult process(const QList<CurveValue>& inputCurves, const QVariantMap& params, QString& error);
 
 private:
     QVector<double> airPLS(const QVector<double>& y, double lambda, int order, double wep, double p, int itermax);
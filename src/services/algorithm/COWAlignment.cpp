@@ -20,103 +20,66 @@ QVariantMap COWAlignment::defaultParameters() const {
     return params;
 }
 
-ProcessingResult COWAlignment::process(const QList<Curve*>& inputCurves,
+ProcessingResult COWAlignment::process(const QList<CurveValue>& inputCurves,
                                        const QVariantMap& params,
                                        QString& error)
 {
-    ProcessingResult result;
     if (inputCurves.size() < 2) {
         error = QObject::tr("COW峰对齐需要至少两条输入曲线（参考 + 待对齐）");
-        return result;
+        return ProcessingResult();
     }
 
-    const Curve* ref = inputCurves[0];
-    const Curve* tgt = inputCurves[1];
-    if (!ref || !tgt) {
-        error = QObject::tr("输入曲线为空，无法执行对齐");
-        return result;
-    }
+    const QSharedPointer<const PreparedReference> reference = prepareReference(inputCurves[0], params, error);
+    if (reference.isNull()) return ProcessingResult();
+    return alignToReference(*reference, inputCurves[1], error);
+}
 
-    // 提取参考与目标曲线数据
-    QVector<QPointF> refData = ref->data();
-    QVector<QPointF> tgtData = tgt->data();
-    if (refData.isEmpty() || tgtData.isEmpty()) {
+QSharedPointer<const COWAlignment::PreparedReference> COWAlignment::prepareReference(const CurveValue& ref,
+                                                                                     const QVariantMap& params,
+                                                                                     QString& error)
+{
+    if (ref.isEmpty()) {
         error = QObject::tr("参考或目标曲线数据为空");
-        return result;
+        return QSharedPointer<const PreparedReference>();
     }
 
-    QVector<double> refX, refY, tgtX, tgtY;
-    refX.reserve(refData.size());
-    refY.reserve(refData.size());
-    for (const auto& p : refData) { refX.append(p.x()); refY.append(p.y()); }
-    tgtX.reserve(tgtData.size());
-    tgtY.reserve(tgtData.size());
-    for (const auto& p : tgtData) { tgtX.append(p.x()); tgtY.append(p.y()); }
-
     int maxWarp = params.value("max_warp", 50).toInt();
     if (maxWarp < 0) maxWarp = 0;
 
-    // 估计最佳整体滞后
-    int bestLag = estimateBestLag(refY, tgtY, maxWarp);
+    auto prepared = QSharedPointer<PreparedReference>::create();
+    prepared->refX = ref.xValues();
+    // 参考去均值、前缀和与频谱只算一次，批内各目标共用
+    prepared->lagEstimator = QSharedPointer<const CrossCorrelation::LagEstimator>::create(ref.yValues(), maxWarp);
+    return prepared;
+}
+
+ProcessingResult COWAlignment::alignToReference(const PreparedReference& reference,
+                                                const CurveValue& tgt,
+                                                QString& error)
+{
+    ProcessingResult result;
+
+    // 目标曲线数据（直接使用列数据，不复制）
+    if (tgt.isEmpty()) {
+        error = QObject::tr("参考或目标曲线数据为空");
+        return result;
+    }
+    const QVector<double>& tgtX = tgt.xValues();
+    const QVector<double>& tgtY = tgt.yValues();
+
+    // 估计最佳整体滞后：在 [-maxWarp, maxWarp] 内选择重叠段皮尔逊相关最大的位移
+    const int bestLag = reference.lagEstimator->bestLag(tgtY);
 
     // 按最佳滞后进行重采样到参考x坐标
-    QVector<QPointF> alignedPoints = alignByLagAndResample(refX, refY, tgtX, tgtY, bestLag);
+    QVector<QPointF> alignedPoints = alignByLagAndResample(reference.refX, tgtX, tgtY, bestLag);
 
     // 构造对齐后的曲线对象
-    Curve* alignedCurve = new Curve(alignedPoints, tgt->name() + QObject::tr(" (对齐到参考)"));
-    alignedCurve->setSampleId(tgt->sampleId());
+    CurveValue alignedCurve(alignedPoints, tgt.name() + QObject::tr(" (对齐到参考)"));
+    alignedCurve.setSampleId(tgt.sampleId());
     result.namedCurves["aligned"].append(alignedCurve);
     return result;
 }
 
-int COWAlignment::estimateBestLag(const QVector<double>& refY,
-                                  const QVector<double>& tgtY,
-                                  int maxLag) const
-{
-    // 为简化实现，这里使用全局皮尔逊相关在 [-maxLag, maxLag] 范围内搜索最佳滞后
-    if (refY.isEmpty() || tgtY.isEmpty()) return 0;
-    int nRef = refY.size();
-    int nTgt = tgtY.size();
-    int n = qMin(nRef, nTgt);
-
-    auto pearson = [&](int lag)->double {
-        // lag > 0 表示目标向右移（滞后），负值表示向左移（超前）
-        // 对齐长度受限于公共重叠部分
-        int startRef = qMax(0, lag);
-        int startTgt = qMax(0, -lag);
-        int len = n - qAbs(lag);
-        if (len <= 5) return -1.0; // 长度过短，忽略
-
-        double sumX = 0, sumY = 0, sumXX = 0, sumYY = 0, sumXY = 0;
-        for (int i = 0; i < len; ++i) {
-            double x = refY[startRef + i];
-            double y = tgtY[startTgt + i];
-            sumX += x; sumY += y;
-            sumXX += x * x; sumYY += y * y;
-            sumXY += x * y;
-        }
-        double meanX = sumX / len;
-        double meanY = sumY / len;
-        double covXY = (sumXY / len) - meanX * meanY;
-        double varX = (sumXX / len) - meanX * meanX;
-        double varY = (sumYY / len) - meanY * meanY;
-        double denom = qSqrt(varX) * qSqrt(varY);
-        if (denom == 0.0) return -1.0;
-        return covXY / denom;
-    };
-
-    double bestCorr = -1.0;
-    int bestLag = 0;
-    for (int lag = -maxLag; lag <= maxLag; ++lag) {
-        double r = pearson(lag);
-        if (r > bestCorr) {
-            bestCorr = r;
-            bestLag = lag;
-        }
-    }
-    return bestLag;
-}
-
 static double linearInterp(const QVector<double>& xs, const QVector<double>& ys, double x)
 {
     // 一维线性插值（边界外采用就近值）
@@ -139,10 +102,9 @@ static double linearInterp(const QVector<double>& xs, const QVector<double>& ys,
 }
 
 QVector<QPointF> COWAlignment::alignByLagAndResample(const QVector<double>& refX,
-                                                     const QVector<double>& /*refY*/,
                                                      const QVector<double>& tgtX,
                                                      const QVector<double>& tgtY,
-                                                     int bestLag) const
+                                                     int bestLag)
 {
     // 将目标序列索引整体偏移 bestLag，并在参考x上进行线性插值
     // 这里为了简化，我们直接在目标的 x/y 上插值，不做复杂分段形变
@@ -2,7 +2,9 @@
 
 #include "services/algorithm/processing/IProcessingStep.h"
 #include "core/entities/Curve.h"
+#include "services/algorithm/CrossCorrelation.h"
 #include <QObject>
+#include <QSharedPointer>
 #include <QVariantMap>
 #include <QVector>
 
@@ -20,28 +22,45 @@
  *   - max_warp(int)：最大滞后搜索范围（以点为单位）
  *   - segment_count(int)：分段数（预留，当前实现未使用）
  *   - resample_step(double)：重采样步长（预留，当前实现按参考x插值）
+ * 滞后搜索由 CrossCorrelation::LagEstimator 完成（FFT 互相关 + 前缀和 Pearson）。
+ * 批处理中参考不变时，先 prepareReference() 一次（参考频谱只算一次），再对各目标调用 alignToReference()（可并行）。
  */
 class COWAlignment : public IProcessingStep
 {
 public:
+    /**
+     * 参考曲线的一次性准备结果：参考 x（对齐结果的横坐标）与滞后估计器（含参考频谱）。
+     * 构建后只读，可在多个线程间共享。
+     */
+    struct PreparedReference {
+        QVector<double> refX;
+        QSharedPointer<const CrossCorrelation::LagEstimator> lagEstimator;
+    };
+
     QString stepName() const override;
     QString userVisibleName() const override;
     QVariantMap defaultParameters() const override;
-    ProcessingResult process(const QList<Curve*>& inputCurves,
+    // 2：滞后搜索改为 FFT 互相关（去均值累加，近似并列时所选滞后可能与旧实现不同）
+    int version() const override { return 2; }
+    ProcessingResult process(const QList<CurveValue>& inputCurves,
                              const QVariantMap& params,
                              QString& error) override;
 
-private:
-    // 计算在给定滞后范围内的最佳整体位移（通过最大皮尔逊相关系数选择）
-    int estimateBestLag(const QVector<double>& refY,
-                        const QVector<double>& tgtY,
-                        int maxLag) const;
+    /** 基于参考曲线与参数构建 PreparedReference；失败时返回空指针并写入 error */
+    static QSharedPointer<const PreparedReference> prepareReference(const CurveValue& ref,
+                                                                    const QVariantMap& params,
+                                                                    QString& error);
 
+    /** 仅执行与目标相关的滞后估计与重采样；结果与 process({ref, tgt}) 相同。线程安全 */
+    static ProcessingResult alignToReference(const PreparedReference& reference,
+                                             const CurveValue& tgt,
+                                             QString& error);
+
+private:
     // 将目标y序列按照最佳滞后进行对齐，并线性插值到参考x坐标
-    QVector<QPointF> alignByLagAndResample(const QVector<double>& refX,
-                                           const QVector<double>& refY,
-                                           const QVector<double>& tgtX,
-                                           const QVector<double>& tgtY,
-                                           int bestLag) const;
+    static QVector<QPointF> alignByLagAndResample(const QVector<double>& refX,
+                                                  const QVector<double>& tgtX,
+                                                  const QVector<double>& tgtY,
+                                                  int bestLag);
 };
 
@@ -14,7 +14,7 @@ QVariantMap Clipping::defaultParameters() const {
     return params;
 }
 
-ProcessingResult Clipping::process(const QList<Curve*> &inputCurves, const QVariantMap &params, QString &error)
+ProcessingResult Clipping::process(const QList<CurveValue> &inputCurves, const QVariantMap &params, QString &error)
 {
     ProcessingResult result;
     bool okMin, okMax;
@@ -26,21 +26,25 @@ ProcessingResult Clipping::process(const QList<Curve*> &inputCurves, const QVari
         return result;
     }
 
-    for (Curve* inCurve : inputCurves) {
-        QVector<QPointF> originalData = inCurve->data();
-        QVector<QPointF> clippedData;
-        clippedData.reserve(originalData.size());
+    for (const CurveValue& inCurve : inputCurves) {
+        const int n = inCurve.pointCount();
+        const double* x = inCurve.xData();
+        const double* y = inCurve.yData();
+        QVector<double> clippedX, clippedY;
+        clippedX.reserve(n);
+        clippedY.reserve(n);
 
         // 遍历所有数据点，只保留在范围内的点
-        for (const QPointF& point : originalData) {
-            if (point.x() >= minX && point.x() <= maxX) {
-                clippedData.append(point);
+        for (int i = 0; i < n; ++i) {
+            if (x[i] >= minX && x[i] <= maxX) {
+                clippedX.append(x[i]);
+                clippedY.append(y[i]);
             }
         }
         
-        // 创建一个新的 Curve 对象来存储裁剪后的结果
-        Curve* clippedCurve = new Curve(clippedData, inCurve->name() + QObject::tr(" (裁剪后)"));
-        clippedCurve->setSampleId(inCurve->sampleId());
+        // 创建一个新的曲线来存储裁剪后的结果
+        CurveValue clippedCurve(clippedX, clippedY, inCurve.name() + QObject::tr(" (裁剪后)"));
+        clippedCurve.setSampleId(inCurve.sampleId());
         
         // 将新曲线添加到结果中
         result.namedCurves["clipped"].append(clippedCurve);
@@ -0,0 +1,258 @@
+#include "CrossCorrelation.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QtGlobal>
+#include <QtMath>
+#include <utility>
+
+namespace {
+
+using Complex = std::complex<double>;
+
+// 复数乘法（不经 std::complex 运算符的 inf/NaN 修正路径，热循环中快数倍）
+static inline Complex mul(const Complex& a, const Complex& b)
+{
+    return Complex(a.real() * b.real() - a.imag() * b.imag(), a.real() * b.imag() + a.imag() * b.real());
+}
+
+// 长度 n 的正变换旋转因子 exp(-2πi·k/n)，k < n/2；按长度缓存（QVector 隐式共享，返回副本线程安全）
+static QVector<Complex> twiddles(int n)
+{
+    static QReadWriteLock lock;
+    static QHash<int, QVector<Complex>> cache;
+    {
+        QReadLocker locker(&lock);
+        auto it = cache.constFind(n);
+        if (it != cache.constEnd()) return it.value();
+    }
+    QVector<Complex> table(qMax(1, n / 2));
+    for (int k = 0; k < n / 2; ++k) table[k] = std::polar(1.0, -2.0 * M_PI * k / n);
+    QWriteLocker locker(&lock);
+    cache.insert(n, table);
+    return table;
+}
+
+// 迭代基 2 复数 FFT（未归一化）；逆变换按 conj(FFT(conj(a))) 计算
+static void complexFft(Complex* a, int n, bool inverse)
+{
+    if (inverse)
+        for (int i = 0; i < n; ++i) a[i] = std::conj(a[i]);
+
+    for (int i = 1, j = 0; i < n; ++i) {
+        int bit = n >> 1;
+        for (; j & bit; bit >>= 1) j ^= bit;
+        j ^= bit;
+        if (i < j) std::swap(a[i], a[j]);
+    }
+
+    // 旋转因子表按最大级取得，各级按步长取用
+    const QVector<Complex> table = twiddles(n);
+    const Complex* twiddle = table.constData();
+
+    for (int len = 2; len <= n; len <<= 1) {
+        const int half = len >> 1;
+        const int stride = n / len;
+        for (int i = 0; i < n; i += len) {
+            for (int k = 0; k < half; ++k) {
+                const Complex u = a[i + k];
+                const Complex v = mul(a[i + k + half], twiddle[k * stride]);
+                a[i + k] = u + v;
+                a[i + k + half] = u - v;
+            }
+        }
+    }
+
+    if (inverse)
+        for (int i = 0; i < n; ++i) a[i] = std::conj(a[i]);
+}
+
+static int nextPowerOfTwo(int n)
+{
+    int p = 2;
+    while (p < n) p <<= 1;
+    return p;
+}
+
+// 可计算的最大滞后：重叠长度需 > 5
+static int effectiveMaxLag(int maxLag, int n)
+{
+    return qMin(maxLag, n - 6);
+}
+
+// 代价模型：直接法 (2L+1)·n 次乘加；FFT 路径约为 kFftCostFactor·N·log2(N)（目标正变换 + 逆变换，参考已缓存）。
+// 常数按 11630 点色谱实测取值：L≈50 时两者相当，更大的滞后范围 FFT 明显更快
+static const double kFftCostFactor = 4.0;
+
+} // namespace
+
+namespace CrossCorrelation {
+
+QVector<std::complex<double>> realFft(const QVector<double>& x)
+{
+    const int n = x.size();
+    const int m = n / 2;
+    QVector<Complex> out(m + 1);
+    if (n < 2) return out;
+
+    // 偶/奇下标打包成 n/2 点复数序列，一次复数 FFT 后拆分
+    QVector<Complex> z(m);
+    for (int k = 0; k < m; ++k) z[k] = Complex(x[2 * k], x[2 * k + 1]);
+    complexFft(z.data(), m, false);
+
+    const QVector<Complex> w = twiddles(n);
+    for (int k = 0; k <= m; ++k) {
+        const Complex zk = z[k % m];
+        const Complex zc = std::conj(z[(m - k) % m]);
+        const Complex even = (zk + zc) * 0.5;
+        const Complex diff = zk - zc;
+        const Complex odd(diff.imag() * 0.5, -diff.real() * 0.5); // (zk - zc) / 2i
+        const Complex wk = (k < m) ? w[k] : Complex(-1.0, 0.0); // exp(-πi) = -1
+        out[k] = even + mul(wk, odd);
+    }
+    return out;
+}
+
+QVector<double> inverseRealFft(const QVector<std::complex<double>>& spectrum, int n)
+{
+    const int m = n / 2;
+    QVector<double> x(n, 0.0);
+    if (n < 2 || spectrum.size() < m + 1) return x;
+
+    const QVector<Complex> w = twiddles(n);
+    QVector<Complex> z(m);
+    for (int k = 0; k < m; ++k) {
+        const Complex xk = spectrum[k];
+        const Complex xc = std::conj(spectrum[m - k]);
+        const Complex even = (xk + xc) * 0.5;
+        const Complex odd = mul((xk - xc) * 0.5, std::conj(w[k]));
+        z[k] = even + Complex(-odd.imag(), odd.real()); // + i·odd
+    }
+    complexFft(z.data(), m, true);
+
+    const double scale = 1.0 / m;
+    for (int k = 0; k < m; ++k) {
+        x[2 * k] = z[k].real() * scale;
+        x[2 * k + 1] = z[k].imag() * scale;
+    }
+    return x;
+}
+
+LagEstimator::LagEstimator(const QVector<double>& ref, int maxLag, Method method)
+    : m_ref(ref), m_maxLag(qMax(0, maxLag)), m_method(method)
+{
+    m_refSeries = prepare(m_ref, m_ref.size(), useFft(m_ref.size()));
+}
+
+bool LagEstimator::useFft(int n) const
+{
+    const int lag = effectiveMaxLag(m_maxLag, n);
+    if (lag < 0) return false;
+    if (m_method != Method::Auto) return m_method == Method::Fft;
+
+    const int size = fftSizeFor(n);
+    const double directCost = double(2 * lag + 1) * n;
+    const double fftCost = kFftCostFactor * size * std::log2(double(size));
+    return fftCost < directCost;
+}
+
+int LagEstimator::fftSizeFor(int n) const
+{
+    return nextPowerOfTwo(n + qMax(0, effectiveMaxLag(m_maxLag, n)));
+}
+
+LagEstimator::Series LagEstimator::prepare(const QVector<double>& y, int n, bool withSpectrum) const
+{
+    Series s;
+    s.n = n;
+    if (n <= 0) return s;
+
+    double mean = 0.0;
+    for (int i = 0; i < n; ++i) mean += y[i];
+    mean /= n;
+
+    s.centred.resize(n);
+    s.prefix.resize(n + 1);
+    s.prefix2.resize(n + 1);
+    s.prefix[0] = s.prefix2[0] = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const double v = y[i] - mean;
+        s.centred[i] = v;
+        s.prefix[i + 1] = s.prefix[i] + v;
+        s.prefix2[i + 1] = s.prefix2[i] + v * v;
+    }
+
+    if (withSpectrum) {
+        s.fftSize = fftSizeFor(n);
+        QVector<double> padded(s.fftSize, 0.0);
+        std::copy(s.centred.constBegin(), s.centred.constEnd(), padded.begin());
+        s.spectrum = realFft(padded);
+    }
+    return s;
+}
+
+QVector<double> LagEstimator::correlations(const QVector<double>& target) const
+{
+    QVector<double> out(2 * m_maxLag + 1, -1.0);
+    const int n = qMin(m_ref.size(), target.size());
+    const int lag = effectiveMaxLag(m_maxLag, n);
+    if (lag < 0) return out;
+
+    const bool fft = useFft(n);
+    const bool reuse = (n == m_refSeries.n) && (fft == !m_refSeries.spectrum.isEmpty());
+    const Series refLocal = reuse ? Series() : prepare(m_ref, n, fft);
+    const Series& ref = reuse ? m_refSeries : refLocal;
+    const Series tgt = prepare(target, n, fft);
+
+    // Σ ref[i + k]·tgt[i]（k < 0 时为 Σ ref[i]·tgt[i - k]）
+    QVector<double> circular;
+    if (fft) {
+        QVector<Complex> product(ref.spectrum.size());
+        for (int k = 0; k < product.size(); ++k) product[k] = mul(ref.spectrum[k], std::conj(tgt.spectrum[k]));
+        circular = inverseRealFft(product, ref.fftSize);
+    }
+    auto dot = [&](int k) -> double {
+        if (fft) return circular[k >= 0 ? k : ref.fftSize + k];
+        const int startRef = qMax(0, k), startTgt = qMax(0, -k), len = n - qAbs(k);
+        const double* a = ref.centred.constData() + startRef;
+        const double* b = tgt.centred.constData() + startTgt;
+        double sum = 0.0;
+        for (int i = 0; i < len; ++i) sum += a[i] * b[i];
+        return sum;
+    };
+
+    for (int k = -lag; k <= lag; ++k) {
+        const int startRef = qMax(0, k), startTgt = qMax(0, -k), len = n - qAbs(k);
+        const double meanX = (ref.prefix[startRef + len] - ref.prefix[startRef]) / len;
+        const double meanY = (tgt.prefix[startTgt + len] - tgt.prefix[startTgt]) / len;
+        const double varX = (ref.prefix2[startRef + len] - ref.prefix2[startRef]) / len - meanX * meanX;
+        const double varY = (tgt.prefix2[startTgt + len] - tgt.prefix2[startTgt]) / len - meanY * meanY;
+        if (!(varX > 0.0) || !(varY > 0.0)) continue;
+        const double covXY = dot(k) / len - meanX * meanY;
+        out[k + m_maxLag] = covXY / (qSqrt(varX) * qSqrt(varY));
+    }
+    return out;
+}
+
+int LagEstimator::bestLag(const QVector<double>& target, double* bestCorr) const
+{
+    const QVector<double> corr = correlations(target);
+    double best = -1.0;
+    int bestLag = 0;
+    for (int k = -m_maxLag; k <= m_maxLag; ++k) {
+        const double r = corr[k + m_maxLag];
+        if (r > best) {
+            best = r;
+            bestLag = k;
+        }
+    }
+    if (bestCorr) *bestCorr = best;
+    return bestLag;
+}
+
+int bestLag(const QVector<double>& ref, const QVector<double>& target, int maxLag)
+{
+    return LagEstimator(ref, maxLag).bestLag(target);
+}
+
+} // namespace CrossCorrelation
@@ -0,0 +1,81 @@
+#ifndef CROSSCORRELATION_H
+#define CROSSCORRELATION_H
+
+#include <QVector>
+#include <complex>
+
+/**
+ * @brief 整体滞后搜索内核（COW 简化对齐使用）
+ *
+ * 对 [-maxLag, maxLag] 内的每个滞后 k，计算参考 ref[max(0,k) ..] 与目标 tgt[max(0,-k) ..]
+ * 在重叠长度 n-|k| 上的 Pearson 相关（n = min(参考长度, 目标长度)）：
+ * - 互相关 Σ x·y 由实数 FFT 一次得到全部滞后（补零到 2 的幂，避免循环卷绕）；
+ * - 各滞后重叠段的 Σx、Σx²、Σy、Σy² 由前缀和 O(1) 得到；
+ * - 数据先减去整体均值再累加（Pearson 与平移无关），减小相消误差。
+ * 重叠长度 <= 5 或方差为 0 的滞后相关记为 -1，与原逐滞后实现一致。
+ *
+ * LagEstimator 只变换参考一次，批内各目标复用其频谱；构建后只读，可在多个线程间共享。
+ * 输入很短或滞后范围很小时直接计算点积（直接法），结果与 FFT 路径在舍入误差内一致。
+ */
+namespace CrossCorrelation {
+
+enum class Method {
+    Auto,   // 按规模自动选择
+    Direct, // 逐滞后点积
+    Fft     // 实数 FFT 互相关
+};
+
+/**
+ * @brief 实数 FFT：x 长度 n（2 的幂，>= 2），输出 n/2+1 个频点
+ * X[k] = Σ_j x[j]·exp(-2πi·jk/n)
+ */
+QVector<std::complex<double>> realFft(const QVector<double>& x);
+
+/**
+ * @brief 实数逆 FFT：spectrum 为 n/2+1 个频点（Hermitian 对称的一半），返回长度 n 的实序列（含 1/n 归一化）
+ */
+QVector<double> inverseRealFft(const QVector<std::complex<double>>& spectrum, int n);
+
+class LagEstimator
+{
+public:
+    LagEstimator(const QVector<double>& ref, int maxLag, Method method = Method::Auto);
+
+    int maxLag() const { return m_maxLag; }
+
+    /**
+     * @brief 各滞后的 Pearson 相关，下标 k + maxLag 对应滞后 k
+     */
+    QVector<double> correlations(const QVector<double>& target) const;
+
+    /**
+     * @brief 相关最大的滞后（并列取最小滞后；全部无效时为 0）
+     */
+    int bestLag(const QVector<double>& target, double* bestCorr = nullptr) const;
+
+private:
+    struct Series {
+        int n = 0;
+        int fftSize = 0;
+        QVector<double> centred;                // 减去均值后的前 n 个点
+        QVector<double> prefix;                 // Σ centred
+        QVector<double> prefix2;                // Σ centred²
+        QVector<std::complex<double>> spectrum; // centred 补零到 fftSize 后的频谱（仅 FFT 路径）
+    };
+
+    bool useFft(int n) const;
+    int fftSizeFor(int n) const;
+    Series prepare(const QVector<double>& y, int n, bool withSpectrum) const;
+
+    QVector<double> m_ref;
+    int m_maxLag = 0;
+    Method m_method = Method::Auto;
+    Series m_refSeries; // 以参考全长准备（目标不短于参考时直接复用）
+};
+
+// 单次调用：等价于 LagEstimator(ref, maxLag).bestLag(target)
+int bestLag(const QVector<double>& ref, const QVector<double>& target, int maxLag);
+
+} // namespace CrossCorrelation
+
+#endif // CROSSCORRELATION_H
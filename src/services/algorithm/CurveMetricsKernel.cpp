@@ -0,0 +1,152 @@
+#include "CurveMetricsKernel.h"
+
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define CM_KERNEL_X86_64 1
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+// 融合累加：sumDiffSq = Σ(b-a)²，sumProd = Σab
+// 固定的通道划分与合并顺序，结果只取决于输入
+static void fusedSums(const double* a, const double* b, int n, double& sumDiffSq, double& sumProd)
+{
+    int i = 0;
+#ifdef CM_KERNEL_X86_64
+    __m128d d2Lo = _mm_setzero_pd(), d2Hi = _mm_setzero_pd();
+    __m128d abLo = _mm_setzero_pd(), abHi = _mm_setzero_pd();
+    for (; i + 4 <= n; i += 4) {
+        const __m128d a0 = _mm_loadu_pd(a + i);
+        const __m128d a1 = _mm_loadu_pd(a + i + 2);
+        const __m128d b0 = _mm_loadu_pd(b + i);
+        const __m128d b1 = _mm_loadu_pd(b + i + 2);
+        const __m128d d0 = _mm_sub_pd(b0, a0);
+        const __m128d d1 = _mm_sub_pd(b1, a1);
+        d2Lo = _mm_add_pd(d2Lo, _mm_mul_pd(d0, d0));
+        d2Hi = _mm_add_pd(d2Hi, _mm_mul_pd(d1, d1));
+        abLo = _mm_add_pd(abLo, _mm_mul_pd(a0, b0));
+        abHi = _mm_add_pd(abHi, _mm_mul_pd(a1, b1));
+    }
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(d2Lo, d2Hi));
+    double d2 = lanes[0] + lanes[1];
+    _mm_storeu_pd(lanes, _mm_add_pd(abLo, abHi));
+    double ab = lanes[0] + lanes[1];
+#else
+    double d2Acc[4] = {0.0, 0.0, 0.0, 0.0};
+    double abAcc[4] = {0.0, 0.0, 0.0, 0.0};
+    for (; i + 4 <= n; i += 4) {
+        for (int k = 0; k < 4; ++k) {
+            const double d = b[i + k] - a[i + k];
+            d2Acc[k] += d * d;
+            abAcc[k] += a[i + k] * b[i + k];
+        }
+    }
+    double d2 = (d2Acc[0] + d2Acc[2]) + (d2Acc[1] + d2Acc[3]);
+    double ab = (abAcc[0] + abAcc[2]) + (abAcc[1] + abAcc[3]);
+#endif
+    for (; i < n; ++i) {
+        const double d = b[i] - a[i];
+        d2 += d * d;
+        ab += a[i] * b[i];
+    }
+    sumDiffSq = d2;
+    sumProd = ab;
+}
+
+} // namespace
+
+namespace CurveMetricsKernel {
+
+CurveStats computeStats(const double* y, int n)
+{
+    CurveStats s;
+    s.n = qMax(0, n);
+    if (s.n == 0) return s;
+    s.minY = std::numeric_limits<double>::infinity();
+    s.maxY = -std::numeric_limits<double>::infinity();
+    for (int i = 0; i < s.n; ++i) {
+        const double v = y[i];
+        s.sum += v;
+        s.sumSq += v * v;
+        s.minY = std::min(s.minY, v);
+        s.maxY = std::max(s.maxY, v);
+    }
+    return s;
+}
+
+CurveStats computeStats(const QVector<double>& y)
+{
+    return computeStats(y.constData(), y.size());
+}
+
+PairMetrics compare(const double* a, const CurveStats& statsA,
+                    const double* b, const CurveStats& statsB, int n)
+{
+    PairMetrics m;
+    if (n <= 0 || statsA.n != n || statsB.n != n) return m;
+
+    double sumDiffSq = 0.0, sumProd = 0.0;
+    fusedSums(a, b, n, sumDiffSq, sumProd);
+
+    m.valid = true;
+    m.euclidean = qSqrt(sumDiffSq);
+    m.rmse = qSqrt(sumDiffSq / n);
+    const double range = statsA.range();
+    m.nrmse = (qAbs(range) < std::numeric_limits<double>::epsilon()) ? 0.0 : m.rmse / range;
+
+    if (n >= 2) {
+        // 与 Pearson 策略相同的求和式
+        const double numerator = sumProd - (statsA.sum * statsB.sum / n);
+        const double denominator = qSqrt((statsA.sumSq - statsA.sum * statsA.sum / n)
+                                         * (statsB.sumSq - statsB.sum * statsB.sum / n));
+        m.pearson = (qAbs(denominator) < 1e-9) ? 0.0 : numerator / denominator;
+    }
+    return m;
+}
+
+QVector<PairMetrics> compareOneToMany(const QVector<double>& reference,
+                                      const QVector<QVector<double>>& curves)
+{
+    QVector<PairMetrics> results(curves.size());
+    const int n = reference.size();
+    const CurveStats refStats = computeStats(reference);
+    for (int i = 0; i < curves.size(); ++i) {
+        const QVector<double>& y = curves[i];
+        if (y.size() != n || n == 0) continue;
+        results[i] = compare(reference.constData(), refStats, y.constData(), computeStats(y), n);
+    }
+    return results;
+}
+
+QVector<PairMetrics> compareAllPairs(const QVector<QVector<double>>& curves)
+{
+    const int count = curves.size();
+    QVector<PairMetrics> results(count > 1 ? count * (count - 1) / 2 : 0);
+    QVector<CurveStats> stats(count);
+    for (int i = 0; i < count; ++i) stats[i] = computeStats(curves[i]);
+
+    for (int i = 0; i < count; ++i) {
+        for (int j = i + 1; j < count; ++j) {
+            const int n = curves[i].size();
+            if (curves[j].size() != n || n == 0) continue;
+            results[pairIndex(i, j, count)] = compare(curves[i].constData(), stats[i],
+                                                      curves[j].constData(), stats[j], n);
+        }
+    }
+    return results;
+}
+
+void toScores(const PairMetrics& metrics, QMap<QString, double>& scores)
+{
+    scores[QStringLiteral("nrmse")] = metrics.nrmse;
+    scores[QStringLiteral("plain_rmse")] = metrics.rmse;
+    scores[QStringLiteral("pearson")] = metrics.pearson;
+    scores[QStringLiteral("euclidean")] = metrics.euclidean;
+}
+
+} // namespace CurveMetricsKernel
@@ -0,0 +1,74 @@
+#ifndef CURVEMETRICSKERNEL_H
+#define CURVEMETRICSKERNEL_H
+
+#include <QMap>
+#include <QString>
+#include <QVector>
+
+/**
+ * @brief 曲线差异度融合内核
+ *
+ * NRMSE / RMSE / Pearson / 欧氏距离共用两个逐点累加量：Σ(b-a)² 与 Σab。
+ * 单曲线统计量（Σy、Σy²、最小/最大值）每条曲线只算一次，
+ * 每对曲线只需对连续 Y 列做一趟融合遍历（x86-64 上为 SSE2 双通道展开）。
+ *
+ * 各指标的定义与 Nrmse / PlainRmse / Pearson / Euclidean 策略一致（含输入无效时返回 -1 的约定），
+ * 数值差异仅来自累加顺序（相对误差在 1e-12 量级）。
+ */
+namespace CurveMetricsKernel {
+
+// 单条曲线（前 n 点）的统计量
+struct CurveStats {
+    int n = 0;
+    double sum = 0.0;     // Σy
+    double sumSq = 0.0;   // Σy²
+    double minY = 0.0;
+    double maxY = 0.0;
+    double range() const { return maxY - minY; }
+};
+
+CurveStats computeStats(const double* y, int n);
+CurveStats computeStats(const QVector<double>& y);
+
+// 一对曲线的全部指标；a 为参考曲线
+struct PairMetrics {
+    double nrmse = -1.0;      // RMSE / 参考 Y 范围（参考为常数时为 0）
+    double rmse = -1.0;       // sqrt(mean((b-a)²))
+    double pearson = -1.0;    // 相关系数（至少 2 点；任一曲线为常数时为 0）
+    double euclidean = -1.0;  // sqrt(Σ(b-a)²)
+    bool valid = false;       // 长度一致且非空
+};
+
+/**
+ * @brief 单对比较（融合单趟）：a、b 各取前 n 点，statsA/statsB 须由同样的 n 点算出
+ */
+PairMetrics compare(const double* a, const CurveStats& statsA,
+                    const double* b, const CurveStats& statsB, int n);
+
+/**
+ * @brief 一对多：参考与每条曲线比较，统计量各算一次
+ * 长度与参考不一致的曲线对应项 valid=false、各指标为 -1（与策略单独计算一致）。
+ */
+QVector<PairMetrics> compareOneToMany(const QVector<double>& reference,
+                                      const QVector<QVector<double>>& curves);
+
+/**
+ * @brief 多对多：所有 i<j 的组合（curves[i] 作参考），按 pairIndex(i, j, count) 存放
+ */
+QVector<PairMetrics> compareAllPairs(const QVector<QVector<double>>& curves);
+
+// 上三角 (i<j) 的行主序下标
+inline int pairIndex(int i, int j, int count)
+{
+    return i * (2 * count - i - 1) / 2 + (j - i - 1);
+}
+
+/**
+ * @brief 按差异度策略的算法ID写入 DifferenceResultRow.scores 形式的得分表
+ * 键："nrmse"、"plain_rmse"、"pearson"、"euclidean"
+ */
+void toScores(const PairMetrics& metrics, QMap<QString, double>& scores);
+
+} // namespace CurveMetricsKernel
+
+#endif // CURVEMETRICSKERNEL_H
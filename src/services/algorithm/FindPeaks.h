@@ -18,13 +18,11 @@ public:
     QString stepName() const override;
     QString userVisibleName() const override;
     QVariantMap defaultParameters() const override;
-    ProcessingResult process(const QList<Curve*>& inputCurves,
+    ProcessingResult process(const QList<CurveValue>& inputCurves,
                              const QVariantMap& params,
                              QString& error) override;
 
 private:
     bool isLocalMax(const QVector<double>& y, int i) const;
-    double localProminence(const QVector<double>& y, int i, int win) const;
-    double localNoiseStd(const QVector<double>& y, int i, int win) const;
 };
 
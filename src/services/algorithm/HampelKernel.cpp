@@ -0,0 +1,200 @@
+#include "HampelKernel.h"
+
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace {
+
+// 排序比较：NaN 视为最大值，保证严格弱序
+static bool lessNanLast(double a, double b)
+{
+    if (std::isnan(a)) return false;
+    if (std::isnan(b)) return true;
+    return a < b;
+}
+
+// 全体样本的秩：按值排序（同值按下标），每个下标占一个秩
+struct RankTable {
+    QVector<int> rankOf;     // 下标 -> 秩
+    QVector<double> sorted;  // 秩 -> 值
+
+    explicit RankTable(const QVector<double>& y)
+    {
+        const int n = y.size();
+        QVector<int> order(n);
+        for (int i = 0; i < n; ++i) order[i] = i;
+        std::sort(order.begin(), order.end(), [&y](int a, int b) {
+            if (lessNanLast(y[a], y[b])) return true;
+            if (lessNanLast(y[b], y[a])) return false;
+            return a < b;
+        });
+        rankOf.resize(n);
+        sorted.resize(n);
+        for (int r = 0; r < n; ++r) {
+            rankOf[order[r]] = r;
+            sorted[r] = y[order[r]];
+        }
+    }
+};
+
+// 滑动窗口的顺序统计：秩上的树状数组（计数），支持按下标增删与取第 k 小
+class RankWindow
+{
+public:
+    explicit RankWindow(const RankTable& ranks)
+        : m_ranks(ranks), m_tree(ranks.sorted.size() + 1, 0)
+    {
+        m_topBit = 1;
+        while (m_topBit * 2 <= ranks.sorted.size()) m_topBit *= 2;
+    }
+
+    int size() const { return m_count; }
+
+    void insert(int index) { add(m_ranks.rankOf[index] + 1, 1); ++m_count; }
+    void erase(int index) { add(m_ranks.rankOf[index] + 1, -1); --m_count; }
+
+    // 窗口内第 k 小（0 基）
+    double select(int k) const
+    {
+        int pos = 0;
+        int remaining = k + 1;
+        const int n = m_tree.size() - 1;
+        for (int step = m_topBit; step > 0; step >>= 1) {
+            if (pos + step <= n && m_tree[pos + step] < remaining) {
+                pos += step;
+                remaining -= m_tree[pos];
+            }
+        }
+        return m_ranks.sorted[pos]; // 1 基位置 pos+1 对应秩 pos
+    }
+
+    double median() const { return select(m_count / 2); }
+
+    /**
+     * 窗口 MAD：|v - med| 的第 size/2 小值。
+     * 以中位数（第 p 个）为界，左侧距离 A_j = med - s[p-1-j]、右侧 B_j = s[p+j] - med 均为升序，
+     * 两个有序序列的第 K 小用二分划分求得，与对 |v - med| 全量排序的结果相同。
+     */
+    double mad(double med) const
+    {
+        const int p = m_count / 2;
+        const int sizeA = p;
+        const int sizeB = m_count - p;
+        const int K = m_count / 2 + 1;
+        auto a = [&](int j) { return med - select(p - 1 - j); };
+        auto b = [&](int j) { return select(p + j) - med; };
+
+        int lo = qMax(0, K - sizeB);
+        int hi = qMin(K, sizeA);
+        while (lo < hi) {
+            const int i = (lo + hi) / 2;
+            if (lessNanLast(a(i), b(K - i - 1))) lo = i + 1;
+            else hi = i;
+        }
+        const int i = lo;
+        const int j = K - i;
+        if (i == 0) return b(j - 1);
+        if (j == 0) return a(i - 1);
+        const double da = a(i - 1);
+        const double db = b(j - 1);
+        return lessNanLast(da, db) ? db : da;
+    }
+
+private:
+    void add(int pos, int delta)
+    {
+        const int n = m_tree.size() - 1;
+        for (; pos <= n; pos += pos & -pos) m_tree[pos] += delta;
+    }
+
+    const RankTable& m_ranks;
+    QVector<int> m_tree;
+    int m_topBit = 1;
+    int m_count = 0;
+};
+
+// 将窗口移动到 [lo, hi]（左右端点单调不减）
+static void slideTo(RankWindow& window, int& curLo, int& curHi, int lo, int hi)
+{
+    while (curHi < hi) window.insert(++curHi);
+    while (curLo < lo) window.erase(curLo++);
+}
+
+} // namespace
+
+namespace HampelKernel {
+
+QVector<double> slidingMedian(const QVector<double>& y, int half)
+{
+    const int n = y.size();
+    QVector<double> out(n);
+    if (n == 0) return out;
+    half = qMax(0, half);
+
+    const RankTable ranks(y);
+    RankWindow window(ranks);
+    int curLo = 0, curHi = -1;
+    for (int i = 0; i < n; ++i) {
+        slideTo(window, curLo, curHi, qMax(0, i - half), qMin(n - 1, i + half));
+        out[i] = window.median();
+    }
+    return out;
+}
+
+QVector<bool> outlierMask(const QVector<double>& y, const Options& options)
+{
+    const int n = y.size();
+    QVector<bool> bad(n, false);
+    if (n == 0) return bad;
+
+    const int localHalf = qMax(0, options.window / 2);
+    int medianWin = qMax(options.window, qMax(3, (int)qRound(n / 10.0)));
+    if (medianWin % 2 == 0) medianWin += 1;
+    const int globalHalf = medianWin / 2;
+
+    // 两个窗口共用一次排序得到的秩
+    const RankTable ranks(y);
+    RankWindow local(ranks);
+    RankWindow global(ranks);
+    int localLo = 0, localHi = -1;
+    int globalLo = 0, globalHi = -1;
+
+    QVector<double> dev(n);
+    for (int i = 0; i < n; ++i) {
+        const double v = y[i];
+        if (std::isnan(v) || std::isinf(v)) bad[i] = true;
+
+        // 全局基线（中值滤波）偏差，阈值待全部偏差求出后确定
+        slideTo(global, globalLo, globalHi, qMax(0, i - globalHalf), qMin(n - 1, i + globalHalf));
+        dev[i] = qAbs(v - global.median());
+
+        // 局部 Hampel
+        slideTo(local, localLo, localHi, qMax(0, i - localHalf), qMin(n - 1, i + localHalf));
+        const double med = local.median();
+        double sigma = 1.4826 * local.mad(med);
+        if (sigma < 1e-12) sigma = 1e-6;
+        if (qAbs(v - med) > options.nSigma * sigma) bad[i] = true;
+
+        // 跳变
+        if (i > 0 && qAbs(v - y[i - 1]) > options.jumpThreshold) bad[i] = true;
+    }
+
+    // 全局 MAD（偏差的中位数）
+    QVector<double> devSorted = dev;
+    std::nth_element(devSorted.begin(), devSorted.begin() + n / 2, devSorted.end(), lessNanLast);
+    double mad = 1.4826 * devSorted[n / 2];
+    if (mad < 1e-12) {
+        // MAD过小则退化为标准差估计
+        double mean = 0.0; for (double d : dev) mean += d; mean /= n;
+        double var = 0.0; for (double d : dev) var += (d - mean) * (d - mean); var /= qMax(1, n - 1);
+        mad = qMax(1e-9, std::sqrt(var));
+    }
+    for (int i = 0; i < n; ++i) {
+        if (dev[i] > options.globalNSigma * mad) bad[i] = true;
+    }
+    return bad;
+}
+
+} // namespace HampelKernel
@@ -0,0 +1,39 @@
+#ifndef HAMPELKERNEL_H
+#define HAMPELKERNEL_H
+
+#include <QVector>
+
+/**
+ * @brief 坏点检测内核（滑动中值 / Hampel / 全局 MAD / 跳变）
+ *
+ * 全部样本按值排序一次得到秩，滑动窗口用秩上的树状数组维护，插入/删除/取第 k 小均为 O(log n)；
+ * 窗口 MAD 由中位数两侧的两个有序距离序列做第 k 小选择得到，无需逐点复制和排序窗口。
+ * 整条曲线 O(n log n)，与窗口大小基本无关。
+ *
+ * 窗口在首尾截断（[i-half, i+half] ∩ [0, n-1]），中位数取排序后第 size/2 个元素，
+ * 与原 BadPointRepair 逐点排序的结果逐位一致。NaN 在排序中视为最大值。
+ */
+namespace HampelKernel {
+
+struct Options {
+    int window = 15;            // 局部窗口
+    double nSigma = 4.0;        // 局部异常阈值（Hampel）
+    double globalNSigma = 4.0;  // 全局偏差阈值（MAD）
+    double jumpThreshold = 2.0; // 相邻点跳变阈值
+};
+
+/**
+ * @brief 一次扫描得到坏点掩码
+ * 非有限值 | 相对中值基线的全局 MAD 偏差 | 局部 Hampel 异常 | 与前一点的跳变
+ * 全局基线窗口取 max(window, 3, round(n/10)) 的奇数。
+ */
+QVector<bool> outlierMask(const QVector<double>& y, const Options& options);
+
+/**
+ * @brief 滑动中值：out[i] 为 y[max(0,i-half) .. min(n-1,i+half)] 的第 size/2 小值
+ */
+QVector<double> slidingMedian(const QVector<double>& y, int half);
+
+} // namespace HampelKernel
+
+#endif // HAMPELKERNEL_H
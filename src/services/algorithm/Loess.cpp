@@ -39,6 +39,7 @@
 
 
 #include "Loess.h"
+#include "LoessEngine.h"
 #include "core/entities/Curve.h"
 #include <QtMath>
 
@@ -56,77 +57,10 @@ QVariantMap Loess::defaultParameters() const {
     return params;
 }
 
-// ------------------------
-// Tri-cube 权重函数
-// ------------------------
-static double tricube(double x)
-{
-    x = qAbs(x);
-    return (x >= 1.0) ? 0.0 : qPow(1 - x*x*x, 3);
-}
-
-// ------------------------
-// Loess 平滑主函数（给 QVector<QPointF>）
-// ------------------------
-static QVector<QPointF> loessSmooth(const QVector<QPointF> &data, double fraction)
-{
-    int n = data.size();
-    if (n < 3) return data;
-
-    int window = qMax(3, int(n * fraction));
-    QVector<QPointF> result;
-    result.reserve(n);
-
-    for (int i = 0; i < n; i++) {
-        double xi = data[i].x();
-
-        // --- 窗口范围 ---
-        int left = qMax(0, i - window / 2);
-        int right = qMin(n - 1, left + window - 1);
-        if (right - left + 1 < window && left > 0)
-            left = qMax(0, right - window + 1);
-
-        double maxDist = qAbs(data[right].x() - data[left].x());
-        if (maxDist == 0) maxDist = 1e-12;
-
-        // --- 加权计算 ---
-        double Sw = 0, Swx = 0, Swy = 0, Swxx = 0, Swxy = 0;
-
-        for (int j = left; j <= right; j++) {
-            double d = qAbs(data[j].x() - xi) / maxDist;
-            double w = tricube(d);
-
-            double x = data[j].x();
-            double y = data[j].y();
-
-            Sw   += w;
-            Swx  += w * x;
-            Swy  += w * y;
-            Swxx += w * x * x;
-            Swxy += w * x * y;
-        }
-
-        double denom = Sw * Swxx - Swx * Swx;
-        double a = 0, b = 0;
-
-        if (qAbs(denom) > 1e-12) {
-            b = (Sw * Swxy - Swx * Swy) / denom;
-            a = (Swy - b * Swx) / Sw;
-        } else {
-            a = Swy / Sw;
-            b = 0;
-        }
-
-        result.append(QPointF(xi, a + b * xi));
-    }
-
-    return result;
-}
-
 // --------------------------------------------------
 // IProcessingStep 覆盖接口：执行 Loess 平滑
 // --------------------------------------------------
-ProcessingResult Loess::process(const QList<Curve*> &inputCurves,
+ProcessingResult Loess::process(const QList<CurveValue> &inputCurves,
                                 const QVariantMap &params,
                                 QString &error)
 {
@@ -137,17 +71,21 @@ ProcessingResult Loess::process(const QList<Curve*> &inputCurves,
         error = "fraction must be between 0 and 1.";
         return result;
     }
-
-    for (Curve* inCurve : inputCurves) {
-        if (!inCurve) continue;
-
-        QVector<QPointF> source = inCurve->data();
-        QVector<QPointF> smoothed = loessSmooth(source, fraction);
-
-        Curve* smoothedCurve =
-                new Curve(smoothed, inCurve->name() + QObject::tr(" (Loess)"));
-
-        result.namedCurves["smoothed"].append(smoothedCurve);
+    // 可选：bisquare 稳健迭代次数（默认 0，与原行为一致）
+    const int robustIterations = qMax(0, params.value("robust_iterations", 0).toInt());
+
+    for (const CurveValue& inCurve : inputCurves) {
+        LoessEngine::Options options;
+        options.fraction = fraction;
+        options.robustIterations = robustIterations;
+        const QVector<double>& x = inCurve.xValues();
+        // 等间距 X 直接按网格平滑（只检测一次，LoessEngine 内不再重复检测）
+        const UniformGrid grid = inCurve.uniformX();
+        const QVector<double> smoothed = grid.isValid()
+                                             ? LoessEngine::smooth(grid, inCurve.yValues(), options)
+                                             : LoessEngine::smooth(x, inCurve.yValues(), options);
+
+        result.namedCurves["smoothed"].append(CurveValue(x, smoothed, inCurve.name() + QObject::tr(" (Loess)")));
     }
 
     return result;
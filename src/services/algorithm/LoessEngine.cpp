@@ -0,0 +1,302 @@
+#include "LoessEngine.h"
+#include "SavitzkyGolayKernel.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+// tricube 权重：(1 - d^3)^3，d >= 1 时为 0（以乘法代替 qPow）
+static inline double tricube(double d)
+{
+    if (d >= 1.0) return 0.0;
+    const double t = 1.0 - d * d * d;
+    return t * t * t;
+}
+
+// bisquare 稳健权重：(1 - u^2)^2，|u| >= 1 时为 0
+static inline double bisquare(double u)
+{
+    u = qAbs(u);
+    if (u >= 1.0) return 0.0;
+    const double t = 1.0 - u * u;
+    return t * t;
+}
+
+// 窗口点数，与原实现一致
+static int windowPoints(int n, double fraction)
+{
+    return qMax(3, int(n * fraction));
+}
+
+// 第 i 点的窗口 [left, right]：以 i 为中心，靠边时整体平移保持 W 个点
+static inline void windowBounds(int i, int n, int window, int& left, int& right)
+{
+    left = qMax(0, i - window / 2);
+    right = qMin(n - 1, left + window - 1);
+    if (right - left + 1 < window && left > 0)
+        left = qMax(0, right - window + 1);
+}
+
+// 逐点局部线性拟合（以 xi 为原点计算加权和，避免大 x 值的相消误差）
+static double fitAt(const double* x, const double* y, const double* robust, int i, int left, int right)
+{
+    const double xi = x[i];
+    double maxDist = qAbs(x[right] - x[left]);
+    if (maxDist == 0) maxDist = 1e-12;
+    const double invMaxDist = 1.0 / maxDist;
+
+    double Sw = 0, Swx = 0, Swy = 0, Swxx = 0, Swxy = 0;
+    for (int j = left; j <= right; ++j) {
+        const double dx = x[j] - xi;
+        double w = tricube(qAbs(dx) * invMaxDist);
+        if (robust) w *= robust[j];
+        const double wx = w * dx;
+        Sw   += w;
+        Swx  += wx;
+        Swy  += w * y[j];
+        Swxx += wx * dx;
+        Swxy += wx * y[j];
+    }
+
+    if (Sw <= 0) return y[i]; // 稳健权重全为 0
+    const double denom = Sw * Swxx - Swx * Swx;
+    if (qAbs(denom) > 1e-12)
+        return (Swxx * Swy - Swx * Swxy) / denom; // 拟合直线在 xi 处的值
+    return Swy / Sw;
+}
+
+// 已知网格的逐点拟合：以间隔为单位计算（拟合值与尺度无关），权重按下标偏移 |j - i| 查表。
+// 窗口总是 W 个点，跨度恒为 W - 1 个间隔；dx2 = dx^2 仅用于与 fitAt 相同的退化判定
+static double fitAtUniform(const double* y, const double* robust, const double* offsetWeight,
+                           int i, int left, int right, double dx2)
+{
+    double Sw = 0, Swo = 0, Swy = 0, Swoo = 0, Swoy = 0;
+    for (int j = left; j <= right; ++j) {
+        const double o = j - i;
+        double w = offsetWeight[qAbs(j - i)];
+        if (robust) w *= robust[j];
+        const double wo = w * o;
+        Sw   += w;
+        Swo  += wo;
+        Swy  += w * y[j];
+        Swoo += wo * o;
+        Swoy += wo * y[j];
+    }
+
+    if (Sw <= 0) return y[i];
+    const double denom = Sw * Swoo - Swo * Swo;
+    if (qAbs(denom * dx2) > 1e-12)
+        return (Swoo * Swy - Swo * Swoy) / denom;
+    return Swy / Sw;
+}
+
+// 等间距判定：相邻间隔与平均间隔的相对偏差不超过 1e-7
+static bool detectUniform(const QVector<double>& x, double& dx)
+{
+    const int n = x.size();
+    if (n < 3) return false;
+    dx = (x[n - 1] - x[0]) / (n - 1);
+    if (dx == 0 || !qIsFinite(dx)) return false;
+    const double tol = 1e-7 * qAbs(dx);
+    for (int i = 1; i < n; ++i) {
+        if (qAbs((x[i] - x[i - 1]) - dx) > tol) return false;
+    }
+    return true;
+}
+
+// 等间距内部点的等效卷积核（偏移 k - W/2，以间隔为单位），按 W 缓存
+struct UniformKernel {
+    QVector<double> coeff;
+    double denomInStepUnits = 0; // 以间隔为单位的正规方程行列式，换算到 x 单位需乘 dx^2
+};
+
+static UniformKernel uniformKernel(int window)
+{
+    static QReadWriteLock lock;
+    static QHash<int, UniformKernel> cache;
+    {
+        QReadLocker locker(&lock);
+        auto it = cache.constFind(window);
+        if (it != cache.constEnd()) return it.value();
+    }
+
+    UniformKernel kernel;
+    const int half = window / 2;
+    const double span = window - 1;
+    QVector<double> w(window);
+    double S0 = 0, S1 = 0, S2 = 0;
+    for (int k = 0; k < window; ++k) {
+        const double o = k - half;
+        w[k] = tricube(qAbs(o) / span);
+        S0 += w[k];
+        S1 += w[k] * o;
+        S2 += w[k] * o * o;
+    }
+    kernel.denomInStepUnits = S0 * S2 - S1 * S1;
+    kernel.coeff.resize(window);
+    for (int k = 0; k < window; ++k) {
+        const double o = k - half;
+        kernel.coeff[k] = w[k] * (S2 - S1 * o) / kernel.denomInStepUnits;
+    }
+
+    QWriteLocker locker(&lock);
+    cache.insert(window, kernel);
+    return kernel;
+}
+
+// 对同一 X 的准备结果（批量平滑时复用）
+struct PreparedX {
+    int window = 3;
+    bool useKernel = false;
+    UniformKernel kernel;
+    // 已知网格：逐点拟合按偏移查表（offsetWeight[o] = tricube(o / (W - 1))），gridDx2 = dx^2
+    QVector<double> offsetWeight;
+    double gridDx2 = 0;
+};
+
+static PreparedX prepareGrid(const UniformGrid& grid, double fraction)
+{
+    PreparedX p;
+    const int n = grid.n;
+    p.window = windowPoints(n, fraction);
+    const int span = qMin(p.window, n) - 1;
+    p.offsetWeight.resize(span + 1);
+    for (int o = 0; o <= span; ++o) p.offsetWeight[o] = tricube(double(o) / span);
+    p.gridDx2 = grid.dx * grid.dx;
+    if (p.window < n) {
+        p.kernel = uniformKernel(p.window);
+        p.useKernel = qAbs(p.kernel.denomInStepUnits * p.gridDx2) > 1e-12;
+    }
+    return p;
+}
+
+static PreparedX prepare(const QVector<double>& x, double fraction)
+{
+    PreparedX p;
+    const int n = x.size();
+    p.window = windowPoints(n, fraction);
+    double dx = 0;
+    // 窗口覆盖全部点时没有内部点，无需卷积核
+    if (p.window < n && detectUniform(x, dx)) {
+        p.kernel = uniformKernel(p.window);
+        // 与逐点路径相同的退化判定（x 单位下的行列式）
+        p.useKernel = qAbs(p.kernel.denomInStepUnits * dx * dx) > 1e-12;
+    }
+    return p;
+}
+
+// px 为空时按 p 中的网格拟合
+static QVector<double> smoothPrepared(const double* px, const QVector<double>& y,
+                                      const PreparedX& p, const double* robust)
+{
+    const int n = y.size();
+    QVector<double> out(n);
+    const double* py = y.constData();
+
+    int interiorBegin = n, interiorEnd = n; // [begin, end) 由卷积给出
+    if (p.useKernel && !robust) {
+        SavitzkyGolayKernel::convolve(py, n, p.kernel.coeff, out.data());
+        interiorBegin = p.window / 2;
+        interiorEnd = n - p.window + p.window / 2 + 1;
+    }
+
+    for (int i = 0; i < n; ++i) {
+        if (i == interiorBegin) {
+            i = interiorEnd - 1;
+            continue;
+        }
+        int left, right;
+        windowBounds(i, n, p.window, left, right);
+        out[i] = px ? fitAt(px, py, robust, i, left, right)
+                    : fitAtUniform(py, robust, p.offsetWeight.constData(), i, left, right, p.gridDx2);
+    }
+    return out;
+}
+
+static QVector<double> smoothWithOptions(const QVector<double>& x, const QVector<double>& y,
+                                         const PreparedX& p, int robustIterations)
+{
+    const double* px = p.offsetWeight.isEmpty() ? x.constData() : nullptr;
+    QVector<double> fitted = smoothPrepared(px, y, p, nullptr);
+    const int n = y.size();
+    QVector<double> robust(n), absResidual(n);
+    for (int iter = 0; iter < robustIterations; ++iter) {
+        for (int i = 0; i < n; ++i) absResidual[i] = qAbs(y[i] - fitted[i]);
+        QVector<double> sorted = absResidual;
+        std::nth_element(sorted.begin(), sorted.begin() + n / 2, sorted.end());
+        const double s = sorted[n / 2];
+        if (s <= 0) break; // 已完全拟合
+        for (int i = 0; i < n; ++i) robust[i] = bisquare(absResidual[i] / (6.0 * s));
+        fitted = smoothPrepared(px, y, p, robust.constData());
+    }
+    return fitted;
+}
+
+} // namespace
+
+namespace LoessEngine {
+
+QVector<double> smooth(const QVector<double>& x, const QVector<double>& y, const Options& options)
+{
+    const int n = qMin(x.size(), y.size());
+    if (n < 3) return y;
+    if (x.size() != y.size()) return smooth(x.mid(0, n), y.mid(0, n), options);
+    return smoothWithOptions(x, y, prepare(x, options.fraction), options.robustIterations);
+}
+
+QVector<double> smooth(const UniformGrid& grid, const QVector<double>& y, const Options& options)
+{
+    const int n = qMin(grid.n, y.size());
+    if (n < 3 || !(grid.dx > 0)) return y;
+    if (y.size() != n) return smooth(grid, y.mid(0, n), options);
+
+    UniformGrid g = grid;
+    g.n = n;
+    return smoothWithOptions(QVector<double>(), y, prepareGrid(g, options.fraction), options.robustIterations);
+}
+
+QVector<QPointF> smooth(const QVector<QPointF>& data, double fraction, int robustIterations)
+{
+    const int n = data.size();
+    if (n < 3) return data;
+
+    QVector<double> x(n), y(n);
+    for (int i = 0; i < n; ++i) {
+        x[i] = data[i].x();
+        y[i] = data[i].y();
+    }
+    Options options;
+    options.fraction = fraction;
+    options.robustIterations = robustIterations;
+    const QVector<double> s = smooth(x, y, options);
+
+    QVector<QPointF> result(n);
+    for (int i = 0; i < n; ++i) result[i] = QPointF(x[i], s[i]);
+    return result;
+}
+
+QList<QVector<double>> smoothBatch(const QVector<double>& x, const QList<QVector<double>>& ys, const Options& options)
+{
+    QList<QVector<double>> results;
+    results.reserve(ys.size());
+    if (x.size() < 3) {
+        results = ys;
+        return results;
+    }
+
+    const PreparedX p = prepare(x, options.fraction);
+    for (const QVector<double>& y : ys) {
+        if (y.size() != x.size()) {
+            results.append(smooth(x, y, options)); // 长度不一致时单独处理
+            continue;
+        }
+        results.append(smoothWithOptions(x, y, p, options.robustIterations));
+    }
+    return results;
+}
+
+} // namespace LoessEngine
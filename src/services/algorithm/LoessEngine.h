@@ -0,0 +1,47 @@
+#ifndef LOESSENGINE_H
+#define LOESSENGINE_H
+
+#include <QList>
+#include <QPointF>
+#include <QVector>
+
+#include "core/entities/UniformGrid.h"
+
+/**
+ * @brief 局部线性 LOESS 平滑引擎（Loess 处理步骤与样本比较服务共用）
+ *
+ * 窗口定义与原实现一致：窗口点数 W = max(3, int(n * fraction))，窗口在边界处平移而不缩短，
+ * 距离以窗口跨度 x[right] - x[left] 归一化，权重为 tricube。
+ *
+ * - 等间距 X：内部点的权重模式只与 W 有关，预先求出等效卷积核（按 W 缓存），
+ *   内部点退化为一次卷积（复用 SG 卷积的 SIMD 内核），仅两端约 W 个点逐点拟合；
+ * - 已知网格（曲线的 UniformGrid 描述）：跳过等间距检测，两端与稳健迭代的逐点拟合
+ *   按下标偏移查 tricube 权重表，不再逐点计算距离；
+ * - 非等间距 X：逐点加权最小二乘，tricube 以乘法计算，不调用 pow；
+ * - robustIterations > 0 时追加 bisquare 稳健迭代（权重随残差变化，走逐点路径）。
+ */
+namespace LoessEngine {
+
+struct Options {
+    double fraction = 0.1;    // 窗口比例 (0, 1)
+    int robustIterations = 0; // bisquare 稳健迭代次数，0 表示不做
+};
+
+// 平滑 y(x)；n < 3 时原样返回
+QVector<double> smooth(const QVector<double>& x, const QVector<double>& y, const Options& options);
+
+// 等间距 X 由网格给出（长度不一致按较短者）
+QVector<double> smooth(const UniformGrid& grid, const QVector<double>& y, const Options& options);
+
+// QPointF 版本，返回点的 x 与输入相同
+QVector<QPointF> smooth(const QVector<QPointF>& data, double fraction, int robustIterations = 0);
+
+/**
+ * @brief 批量平滑：共享同一 X 的多条曲线只做一次等间距检测与卷积核准备
+ * @return 与 ys 一一对应的平滑结果
+ */
+QList<QVector<double>> smoothBatch(const QVector<double>& x, const QList<QVector<double>>& ys, const Options& options);
+
+} // namespace LoessEngine
+
+#endif // LOESSENGINE_H
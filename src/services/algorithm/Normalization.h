@@ -9,7 +9,7 @@ public:
     QString stepName() const override;
     QString userVisibleName() const override;
     QVariantMap defaultParameters() const override;
-    ProcessingResult process(const QList<Curve*>& inputCurves, 
+    ProcessingResult process(const QList<CurveValue>& inputCurves, 
                              const QVariantMap& params, 
                              QString& error) override;
 };
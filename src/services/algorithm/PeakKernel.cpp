@@ -0,0 +1,144 @@
+#include "PeakKernel.h"
+
+#include <QtGlobal>
+#include <QtMath>
+
+namespace {
+
+// 补偿累加一步：hi + lo 表示的前缀和加上 v（TwoSum 误差项计入 lo）
+static void accumulate(double& hi, double& lo, double v)
+{
+    const double s = hi + v;
+    const double bb = s - hi;
+    lo += (hi - (s - bb)) + (v - bb);
+    hi = s;
+}
+
+} // namespace
+
+namespace PeakKernel {
+
+RangeMin::RangeMin(const QVector<double>& y)
+    : m_n(y.size())
+{
+    m_log2.resize(m_n + 1);
+    if (m_n > 0) m_log2[0] = 0;
+    for (int len = 1; len <= m_n; ++len) m_log2[len] = (len == 1) ? 0 : m_log2[len / 2] + 1;
+
+    const int levels = (m_n > 0) ? m_log2[m_n] + 1 : 0;
+    m_table.resize(levels * m_n);
+    for (int i = 0; i < m_n; ++i) m_table[i] = y[i];
+    for (int k = 1; k < levels; ++k) {
+        const int half = 1 << (k - 1);
+        const double* prev = m_table.constData() + (k - 1) * m_n;
+        double* cur = m_table.data() + k * m_n;
+        for (int i = 0; i + 2 * half <= m_n; ++i) cur[i] = qMin(prev[i], prev[i + half]);
+    }
+}
+
+double RangeMin::min(int lo, int hi) const
+{
+    const int k = m_log2[hi - lo + 1];
+    const double* level = m_table.constData() + k * m_n;
+    return qMin(level[lo], level[hi - (1 << k) + 1]);
+}
+
+QVector<int> localMaxima(const QVector<double>& y)
+{
+    QVector<int> locs;
+    const int n = y.size();
+    if (n < 3) return locs;
+    locs.reserve(n / 10);
+
+    int k = 1;
+    while (k <= n - 2) {
+        if (y[k] > y[k - 1] && y[k] > y[k + 1]) {
+            locs.push_back(k);
+        } else if (y[k] > y[k - 1] && y[k] == y[k + 1]) {
+            int j = k;
+            while (j < n - 1 && y[j] == y[j + 1]) j++;
+            locs.push_back(int(qRound((k + j) / 2.0)));
+            k = j; // 跳过平顶
+        }
+        ++k;
+    }
+    return locs;
+}
+
+QVector<double> prominences(const QVector<double>& y, const QVector<int>& peaks)
+{
+    QVector<double> proms(peaks.size());
+    if (peaks.isEmpty()) return proms;
+    const int n = y.size();
+
+    // 单调栈：每点左侧/右侧最近的严格更高点（不存在为 -1 / n）
+    QVector<int> leftHigher(n), rightHigher(n);
+    QVector<int> stack;
+    stack.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        while (!stack.isEmpty() && y[stack.last()] <= y[i]) stack.removeLast();
+        leftHigher[i] = stack.isEmpty() ? -1 : stack.last();
+        stack.append(i);
+    }
+    stack.clear();
+    for (int i = n - 1; i >= 0; --i) {
+        while (!stack.isEmpty() && y[stack.last()] <= y[i]) stack.removeLast();
+        rightHigher[i] = stack.isEmpty() ? n : stack.last();
+        stack.append(i);
+    }
+
+    const RangeMin rangeMin(y);
+    for (int k = 0; k < peaks.size(); ++k) {
+        const int p = peaks[k];
+        const double leftMin = rangeMin.min(leftHigher[p] + 1, p);
+        const double rightMin = rangeMin.min(p, rightHigher[p] - 1);
+        proms[k] = y[p] - qMax(leftMin, rightMin);
+    }
+    return proms;
+}
+
+double windowProminence(const QVector<double>& y, const RangeMin& rangeMin, int i, int win)
+{
+    const int n = y.size();
+    const int l0 = qMax(0, i - win);
+    const int r0 = qMin(n - 1, i + win);
+    const double leftMin = (l0 <= i) ? rangeMin.min(l0, i) : y[i];
+    const double rightMin = (i <= r0) ? rangeMin.min(i, r0) : y[i];
+    return y[i] - qMax(leftMin, rightMin);
+}
+
+WindowStats::WindowStats(const QVector<double>& y)
+{
+    const int n = y.size();
+    for (double v : y) m_shift += v;
+    if (n > 0) m_shift /= n;
+
+    m_sum.resize(n + 1);
+    m_sumLo.resize(n + 1);
+    m_sum2.resize(n + 1);
+    m_sum2Lo.resize(n + 1);
+    double hi = 0.0, lo = 0.0, hi2 = 0.0, lo2 = 0.0;
+    m_sum[0] = m_sumLo[0] = m_sum2[0] = m_sum2Lo[0] = 0.0;
+    for (int i = 0; i < n; ++i) {
+        const double d = y[i] - m_shift;
+        accumulate(hi, lo, d);
+        accumulate(hi2, lo2, d * d);
+        m_sum[i + 1] = hi;
+        m_sumLo[i + 1] = lo;
+        m_sum2[i + 1] = hi2;
+        m_sum2Lo[i + 1] = lo2;
+    }
+}
+
+double WindowStats::stdDev(int lo, int hi) const
+{
+    const int len = hi - lo + 1;
+    if (len <= 1) return 0.0;
+    const double sum = (m_sum[hi + 1] - m_sum[lo]) + (m_sumLo[hi + 1] - m_sumLo[lo]);
+    const double sum2 = (m_sum2[hi + 1] - m_sum2[lo]) + (m_sum2Lo[hi + 1] - m_sum2Lo[lo]);
+    const double mean = sum / len;
+    const double var = sum2 / len - mean * mean;
+    return (var > 0.0) ? qSqrt(var) : 0.0;
+}
+
+} // namespace PeakKernel
@@ -0,0 +1,67 @@
+#ifndef PEAKKERNEL_H
+#define PEAKKERNEL_H
+
+#include <QVector>
+
+/**
+ * @brief 峰分析内核（FindPeaks 与 PeakSeg-COW 共用）
+ *
+ * - RangeMin：稀疏表区间最小值，O(n log n) 构建、O(1) 查询；
+ * - prominences()：MATLAB findpeaks 定义的显著性，单调栈求每点左右最近的严格更高点，
+ *   两侧谷底用 RangeMin 查询，整条曲线 O(n log n)，与逐峰向两侧扫描结果逐位一致；
+ * - WindowStats：前缀和求任意窗口的均值/标准差，O(1) 查询。
+ */
+namespace PeakKernel {
+
+class RangeMin
+{
+public:
+    explicit RangeMin(const QVector<double>& y);
+
+    // y[lo..hi]（闭区间，需 0 <= lo <= hi < n）的最小值
+    double min(int lo, int hi) const;
+
+private:
+    int m_n = 0;
+    QVector<int> m_log2;     // m_log2[len] = floor(log2(len))
+    QVector<double> m_table; // 第 k 层：m_table[k*n + i] = min(y[i .. i + 2^k - 1])
+};
+
+/**
+ * @brief MATLAB findpeaks 风格的局部极大值（0-based）
+ * 严格大于两侧；平顶（左侧上升、随后相等）取平顶中心，首尾点不计。
+ */
+QVector<int> localMaxima(const QVector<double>& y);
+
+/**
+ * @brief MATLAB 定义的显著性
+ * 向左/右延伸到第一个严格更高的点（或端点），两侧区间最小值中较大者为基线，prominence = y[p] - 基线。
+ */
+QVector<double> prominences(const QVector<double>& y, const QVector<int>& peaks);
+
+/**
+ * @brief 窗口显著性：y[i] - max(min(y[i-win .. i]), min(y[i .. i+win]))，窗口在首尾截断
+ */
+double windowProminence(const QVector<double>& y, const RangeMin& rangeMin, int i, int win);
+
+/**
+ * @brief 窗口均值/标准差（总体标准差）
+ * 前缀和在全局均值平移后做补偿累加（高低两部分），两前缀相减不会因整条曲线的累计量级损失窗口内精度
+ */
+class WindowStats
+{
+public:
+    explicit WindowStats(const QVector<double>& y);
+
+    // y[lo..hi]（闭区间）的标准差；长度 <= 1 或方差非正时为 0
+    double stdDev(int lo, int hi) const;
+
+private:
+    double m_shift = 0.0;
+    QVector<double> m_sum, m_sumLo;   // Σ_{k<i} (y[k] - shift)，高/低两部分
+    QVector<double> m_sum2, m_sum2Lo; // Σ_{k<i} (y[k] - shift)^2
+};
+
+} // namespace PeakKernel
+
+#endif // PEAKKERNEL_H
@@ -4,9 +4,12 @@
  * - 段内 DP：代价 1−ρ，my_linear_resample 与 my_corr 与 MATLAB 实现一致（见本文件内注释）
  * 批处理脚本 Sepu_align_batch.m 中的 opts（ranges/rangeProm）在应用层由 peakSegMatlabSepuAlignBatchParams() 注入（见 DataProcessingService.cpp）
  *
- * 性能：movmean 用前缀和 O(n)；DP 内层复用 warping 缓冲区，避免每步 QVector 分配与拷贝（与 MATLAB 数值路径一致）。
+ * 性能：movmean 用前缀和 O(n)；峰显著性由 PeakKernel（单调栈 + 稀疏表）O(n log n) 计算；DP 内层复用 warping 缓冲区，避免每步 QVector 分配与拷贝（与 MATLAB 数值路径一致）。
+ * 批处理：参考侧（平滑、分段、参考段统计）由 prepareReference() 一次构建，各目标只做 DP（alignToReference）。
+ * 段 DP：先沿贪心路径的窄带求出最优代价上界，再按上界剪枝做完整 DP，回溯结果与不剪枝时相同。
  */
 #include "PeakSegCOWAlignment.h"
+#include "PeakKernel.h"
 
 #include "core/entities/Curve.h"
 
@@ -71,46 +74,149 @@ static void linearResampleInPlace(const double* src, int origLen, double* dst, i
     }
 }
 
-static double myCorrPtr(const double* x, const double* y, int n)
+/** 参考段统计：均值、去均值值与范数只依赖参考，批处理内各目标共享 */
+struct RefSegStats {
+    const double* raw = nullptr;
+    const double* centred = nullptr;
+    int n = 0;
+    double norm = 0.0;
+    bool allZero = true;
+};
+
+/** 与 MATLAB my_corr 一致；参考侧使用预先计算的统计量（数值与逐次计算逐位相同） */
+static double myCorrWithRef(const RefSegStats& ref, const double* y)
 {
-    if (!x || !y || n <= 0)
+    const int n = ref.n;
+    if (!ref.raw || !y || n <= 0)
         return std::numeric_limits<double>::quiet_NaN();
 
-    double meanX = 0.0, meanY = 0.0;
-    for (int i = 0; i < n; ++i) {
-        meanX += x[i];
+    double meanY = 0.0;
+    for (int i = 0; i < n; ++i)
         meanY += y[i];
-    }
-    meanX /= double(n);
     meanY /= double(n);
 
     double num = 0.0;
-    double normX = 0.0;
     double normY = 0.0;
-    bool allZeroX = true;
     bool allZeroY = true;
     bool equalXY = true;
 
     for (int i = 0; i < n; ++i) {
-        const double xc = x[i] - meanX;
         const double yc = y[i] - meanY;
-        num += xc * yc;
-        normX += xc * xc;
+        num += ref.centred[i] * yc;
         normY += yc * yc;
-        if (x[i] != 0.0) allZeroX = false;
         if (y[i] != 0.0) allZeroY = false;
-        if (x[i] != y[i]) equalXY = false;
+        if (ref.raw[i] != y[i]) equalXY = false;
     }
 
-    normX = qSqrt(normX);
     normY = qSqrt(normY);
-    if (normX < std::numeric_limits<double>::epsilon() || normY < std::numeric_limits<double>::epsilon()) {
-        if (allZeroX && allZeroY) return std::numeric_limits<double>::quiet_NaN();
-        if (equalXY && !(allZeroX && allZeroY)) return 1.0;
+    if (ref.norm < std::numeric_limits<double>::epsilon() || normY < std::numeric_limits<double>::epsilon()) {
+        if (ref.allZero && allZeroY) return std::numeric_limits<double>::quiet_NaN();
+        if (equalXY && !(ref.allZero && allZeroY)) return 1.0;
         return std::numeric_limits<double>::quiet_NaN();
     }
 
-    return num / (normX * normY);
+    return num / (ref.norm * normY);
+}
+
+/**
+ * 固定 (原长 -> 新长) 的线性重采样计划：左右端下标与插值系数。
+ * 段 DP 中同一长度的候选只是起点不同，计划按长度缓存后各候选共享；
+ * 插值统一为 keep·src[left0] + alpha·src[right0]（keep = 1 - alpha），内层无分支。
+ * alpha == 0 时右端取同一点：有限值下 1·x + 0·x == x，与 linearResampleInPlace 逐位一致，也不会越过段尾读取。
+ */
+struct ResamplePlan {
+    QVector<int> left0;
+    QVector<int> right0;
+    QVector<double> keep;
+    QVector<double> alpha;
+};
+
+static void buildResamplePlan(int origLen, int newLen, ResamplePlan& plan)
+{
+    plan.left0.resize(newLen);
+    plan.right0.resize(newLen);
+    plan.keep.resize(newLen);
+    plan.alpha.resize(newLen);
+    int* left0Out = plan.left0.data();
+    int* right0Out = plan.right0.data();
+    double* keepOut = plan.keep.data();
+    double* alphaOut = plan.alpha.data();
+    for (int i = 0; i < newLen; ++i) {
+        int left0 = 0;
+        double alpha = 0.0;
+        if (origLen == newLen) {
+            left0 = i;
+        } else {
+            const double t = (newLen == 1) ? 0.0 : (double(i) / double(newLen - 1));
+            const double newX = 1.0 + t * double(origLen - 1);
+            if (newX <= 1.0) {
+                left0 = 0;
+            } else if (newX >= double(origLen)) {
+                left0 = origLen - 1;
+            } else {
+                int leftIdx1 = int(qFloor(newX));
+                leftIdx1 = qMax(1, qMin(leftIdx1, origLen - 1));
+                alpha = newX - double(leftIdx1);
+                left0 = leftIdx1 - 1;
+            }
+        }
+        left0Out[i] = left0;
+        right0Out[i] = (alpha == 0.0) ? left0 : left0 + 1;
+        keepOut[i] = 1.0 - alpha;
+        alphaOut[i] = alpha;
+    }
+}
+
+/**
+ * 候选段代价 1 - my_corr（目标段 src 按 plan 重采样到参考段长度）。
+ * 单遍即时插值：以首点为平移量累加 Σd、Σd²、Σc·d（d = w - w0，4 路独立累加器），
+ * 不再写出重采样缓冲区、也不再分三遍求均值/中心化/内积；
+ * 退化情形（任一范数低于 eps）回退到原路径以保持 my_corr 的特殊返回值。
+ */
+static double candidateCost(const RefSegStats& ref, double refCentredSum, const ResamplePlan& plan,
+                            const double* src, int srcLen, double* work)
+{
+    const int n = ref.n;
+    const int* left0 = plan.left0.constData();
+    const int* right0 = plan.right0.constData();
+    const double* keep = plan.keep.constData();
+    const double* alpha = plan.alpha.constData();
+    const double* c = ref.centred;
+    auto sample = [=](int i) { return keep[i] * src[left0[i]] + alpha[i] * src[right0[i]]; };
+    const double w0 = sample(0);
+
+    double sd[4] = {0.0, 0.0, 0.0, 0.0};
+    double sdd[4] = {0.0, 0.0, 0.0, 0.0};
+    double scd[4] = {0.0, 0.0, 0.0, 0.0};
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        for (int l = 0; l < 4; ++l) {
+            const double d = sample(i + l) - w0;
+            sd[l] += d;
+            sdd[l] += d * d;
+            scd[l] += c[i + l] * d;
+        }
+    }
+    for (; i < n; ++i) {
+        const double d = sample(i) - w0;
+        sd[0] += d;
+        sdd[0] += d * d;
+        scd[0] += c[i] * d;
+    }
+    const double sumD = (sd[0] + sd[1]) + (sd[2] + sd[3]);
+    const double sumDD = (sdd[0] + sdd[1]) + (sdd[2] + sdd[3]);
+    const double sumCD = (scd[0] + scd[1]) + (scd[2] + scd[3]);
+
+    const double meanD = sumD / double(n);
+    const double num = sumCD - meanD * refCentredSum;          // Σ c_i (w_i - mean(w))
+    const double normY = qSqrt(qMax(0.0, sumDD - double(n) * meanD * meanD));
+
+    const double eps = std::numeric_limits<double>::epsilon();
+    if (ref.norm < eps || normY < eps) {
+        linearResampleInPlace(src, srcLen, work, n);
+        return 1.0 - myCorrWithRef(ref, work);
+    }
+    return 1.0 - num / (ref.norm * normY);
 }
 
 struct Peak {
@@ -124,50 +230,16 @@ static QVector<Peak> myFindPeaksProminence(const QVector<double>& y, double minP
     QVector<Peak> peaks;
     if (y.size() < 3) return peaks;
 
-    const int N = y.size();
-
     // 1) 找局部极大值（平顶峰取中心）
-    QVector<int> locs1;
-    locs1.reserve(N / 10);
-
-    int k = 1; // 0-based, start at 2nd element
-    while (k <= N - 2) {
-        if (y[k] > y[k - 1] && y[k] > y[k + 1]) {
-            locs1.push_back(k + 1); // 1-based
-        } else if (y[k] > y[k - 1] && y[k] == y[k + 1]) {
-            int j = k;
-            while (j < N - 1 && y[j] == y[j + 1]) j++;
-            int loc0 = int(qRound((k + j) / 2.0));
-            locs1.push_back(loc0 + 1); // 1-based
-            k = j; // 跳过平顶
-        }
-        ++k;
-    }
-
-    if (locs1.isEmpty()) return peaks;
+    const QVector<int> locs0 = PeakKernel::localMaxima(y);
+    if (locs0.isEmpty()) return peaks;
 
     // 2) prominence 精确计算 + 阈值过滤（该算法只需要 MinPeakProminence）
-    for (int idx = 0; idx < locs1.size(); ++idx) {
-        int loc1 = locs1[idx];
-        int loc0 = loc1 - 1;
-
-        // 向左搜索直到遇到更高峰或开头：while L>=1 && y(L)<=y(k) L--
-        int L0 = loc0 - 1;
-        while (L0 >= 0 && y[L0] <= y[loc0]) L0--;
-        double leftMin = y[loc0];
-        for (int t = L0 + 1; t <= loc0; ++t) leftMin = qMin(leftMin, y[t]);
-
-        // 向右搜索直到遇到更高峰或结尾：while R<=N && y(R)<=y(k) R++
-        int R0 = loc0 + 1;
-        while (R0 < N && y[R0] <= y[loc0]) R0++;
-        double rightMin = y[loc0];
-        for (int t = loc0; t <= R0 - 1; ++t) rightMin = qMin(rightMin, y[t]);
-
-        double base = qMax(leftMin, rightMin);
-        double prom = y[loc0] - base;
-        if (prom < minProm) continue;
-
-        peaks.push_back(Peak{loc1, y[loc0], prom});
+    const QVector<double> proms = PeakKernel::prominences(y, locs0);
+    for (int idx = 0; idx < locs0.size(); ++idx) {
+        if (proms[idx] < minProm) continue;
+        const int loc0 = locs0[idx];
+        peaks.push_back(Peak{loc0 + 1, y[loc0], proms[idx]});
     }
 
     return peaks;
@@ -408,38 +480,78 @@ QVariantMap PeakSegCOWAlignment::defaultParameters() const
     return p;
 }
 
-QVector<int> PeakSegCOWAlignment::referenceSegmentStarts1Based(const Curve* ref,
+QVector<int> PeakSegCOWAlignment::referenceSegmentStarts1Based(const CurveValue& ref,
                                                                const QVariantMap& params,
                                                                QString& error)
 {
     QVector<int> starts1;
-    if (!ref) {
-        error = QCoreApplication::translate("PeakSegCOWAlignment", "参考曲线为空");
+    const QSharedPointer<const PreparedReference> prepared = prepareReference(ref, params, error);
+    if (prepared.isNull())
         return starts1;
+    for (int s0 : prepared->segStarts0) starts1.append(s0 + 1);
+    return starts1;
+}
+
+QSharedPointer<const PeakSegCOWAlignment::PreparedReference> PeakSegCOWAlignment::prepareReference(
+    const CurveValue& ref, const QVariantMap& params, QString& error)
+{
+    if (ref.isEmpty()) {
+        error = QCoreApplication::translate("PeakSegCOWAlignment", "参考曲线为空");
+        return {};
     }
-    const QVector<QPointF> refData = ref->data();
-    QVector<double> chrom1;
-    chrom1.reserve(refData.size());
-    for (const auto& p : refData) chrom1.append(p.y());
+    QSharedPointer<PreparedReference> prepared = QSharedPointer<PreparedReference>::create();
+    prepared->refX = ref.xValues(); // 隐式共享
+    const QVector<double>& chrom1 = ref.yValues();
     const int n1 = chrom1.size();
     if (n1 < 2) {
         error = QCoreApplication::translate("PeakSegCOWAlignment", "参考曲线数据点过少");
-        return starts1;
+        return {};
     }
+
+    // 参数（与 MATLAB opts 对齐）
     const double minProm = params.value(QStringLiteral("min_prominence"), 0.05).toDouble();
     const int maxClusterGap = params.value(QStringLiteral("max_cluster_gap"), 5).toInt();
     const int smoothSpan = qMax(1, params.value(QStringLiteral("smooth_span"), 5).toInt());
     const int rangeCount = qMax(1, params.value(QStringLiteral("range_count"), 3).toInt());
+    prepared->tWarp = qMax(0, params.value(QStringLiteral("t"), 50).toInt());
+
+    // 参考平滑 + 峰检测 + 聚类分段
     const QVector<double> refSmooth = movmean(chrom1, smoothSpan);
-    QVector<int> segStarts0;
-    QVector<int> segEnds0;
-    if (!computePeakSegSegments(chrom1, refSmooth, params, minProm, maxClusterGap, n1, rangeCount, segStarts0, segEnds0, error))
-        return starts1;
-    for (int s0 : segStarts0) starts1.append(s0 + 1);
-    return starts1;
+    if (!computePeakSegSegments(chrom1, refSmooth, params, minProm, maxClusterGap, n1, rangeCount,
+                                prepared->segStarts0, prepared->segEnds0, error))
+        return {};
+
+    // 参考段与 my_corr 参考侧统计（均值、去均值值、范数）
+    const int m = prepared->segStarts0.size();
+    prepared->segRaw.resize(m);
+    prepared->segCentred.resize(m);
+    prepared->segNorm.resize(m);
+    prepared->segAllZero.resize(m);
+    for (int i = 0; i < m; ++i) {
+        QVector<double>& raw = prepared->segRaw[i];
+        for (int k = prepared->segStarts0[i]; k <= prepared->segEnds0[i]; ++k) raw.push_back(chrom1[k]);
+        const int len = raw.size();
+
+        double mean = 0.0;
+        for (double v : raw) mean += v;
+        mean /= double(len);
+
+        QVector<double>& centred = prepared->segCentred[i];
+        centred.resize(len);
+        double norm = 0.0;
+        bool allZero = true;
+        for (int k = 0; k < len; ++k) {
+            centred[k] = raw[k] - mean;
+            norm += centred[k] * centred[k];
+            if (raw[k] != 0.0) allZero = false;
+        }
+        prepared->segNorm[i] = qSqrt(norm);
+        prepared->segAllZero[i] = allZero;
+    }
+    return prepared;
 }
 
-ProcessingResult PeakSegCOWAlignment::process(const QList<Curve*>& inputCurves,
+ProcessingResult PeakSegCOWAlignment::process(const QList<CurveValue>& inputCurves,
                                              const QVariantMap& params,
                                              QString& error)
 {
@@ -448,140 +560,231 @@ ProcessingResult PeakSegCOWAlignment::process(const QList<Curve*>& inputCurves,
         error = QObject::tr("PeakSeg-COW峰对齐需要至少两条输入曲线（参考 + 待对齐）");
         return result;
     }
-    const Curve* ref = inputCurves[0];
-    const Curve* tgt = inputCurves[1];
-    if (!ref || !tgt) {
-        error = QObject::tr("输入曲线为空，无法执行对齐");
+    const CurveValue& ref = inputCurves[0];
+    const CurveValue& tgt = inputCurves[1];
+    if (ref.isEmpty() || tgt.isEmpty()) {
+        error = QObject::tr("参考或目标曲线数据为空");
         return result;
     }
-
-    QVector<QPointF> refData = ref->data();
-    QVector<QPointF> tgtData = tgt->data();
-    if (refData.isEmpty() || tgtData.isEmpty()) {
-        error = QObject::tr("参考或目标曲线数据为空");
+    if (ref.pointCount() < 2 || tgt.pointCount() < 2) {
+        error = QObject::tr("数据点过少，无法执行 PeakSeg-COW 对齐");
         return result;
     }
 
-    QVector<double> refX, chrom1, chrom2;
-    refX.reserve(refData.size());
-    chrom1.reserve(refData.size());
-    for (const auto& p : refData) { refX.append(p.x()); chrom1.append(p.y()); }
-    chrom2.reserve(tgtData.size());
-    for (const auto& p : tgtData) { chrom2.append(p.y()); }
+    const QSharedPointer<const PreparedReference> prepared = prepareReference(ref, params, error);
+    if (prepared.isNull())
+        return result;
+    return alignToReference(*prepared, tgt, error);
+}
 
-    const int n1 = chrom1.size();
+ProcessingResult PeakSegCOWAlignment::alignToReference(const PreparedReference& reference,
+                                                       const CurveValue& tgt,
+                                                       QString& error)
+{
+    ProcessingResult result;
+    if (tgt.isEmpty()) {
+        error = QObject::tr("输入曲线为空，无法执行对齐");
+        return result;
+    }
+    const QVector<double>& chrom2 = tgt.yValues();
+
+    const QVector<double>& refX = reference.refX;
+    const QVector<int>& segStarts0 = reference.segStarts0;
+    const QVector<int>& segEnds0 = reference.segEnds0;
+    const int n1 = refX.size();
     const int n2 = chrom2.size();
+    const int tWarp = reference.tWarp;
     if (n1 < 2 || n2 < 2) {
         error = QObject::tr("数据点过少，无法执行 PeakSeg-COW 对齐");
         return result;
     }
 
-    // DP 内层每步原分配 QVector 并重采样；复用缓冲区避免海量小分配（主要性能来源）
-    QVector<double> warpWork;
-    warpWork.resize(n1);
-
-    // 参数（与 MATLAB opts 对齐）
-    const double minProm = params.value("min_prominence", 0.05).toDouble();
-    const int maxClusterGap = params.value("max_cluster_gap", 5).toInt();
-    const int tWarp = qMax(0, params.value("t", 50).toInt());
-    const int smoothSpan = qMax(1, params.value("smooth_span", 5).toInt());
-    int rangeCount = qMax(1, params.value("range_count", 3).toInt());
-
-    // 参考平滑
-    const QVector<double> refSmooth = movmean(chrom1, smoothSpan);
-
-    QVector<int> segStarts0;
-    QVector<int> segEnds0;
-    if (!computePeakSegSegments(chrom1, refSmooth, params, minProm, maxClusterGap, n1, rangeCount, segStarts0, segEnds0, error))
-        return result;
-
     const int m = segStarts0.size();
     if (m <= 0) {
         error = QCoreApplication::translate("PeakSegCOWAlignment", "分段失败，无法执行对齐");
         return result;
     }
 
+    // DP 内层每步原分配 QVector 并重采样；复用缓冲区避免海量小分配（主要性能来源）
+    QVector<double> warpWork;
+    warpWork.resize(n1);
+
     QVector<int> segLen;
     segLen.reserve(m);
     for (int i = 0; i < m; ++i) segLen.push_back(segEnds0[i] - segStarts0[i] + 1);
 
+    auto refStats = [&reference, &segLen](int seg) {
+        RefSegStats st;
+        st.raw = reference.segRaw[seg].constData();
+        st.centred = reference.segCentred[seg].constData();
+        st.n = segLen[seg];
+        st.norm = reference.segNorm[seg];
+        st.allZero = reference.segAllZero[seg];
+        return st;
+    };
+
     // === DP（严格复刻 MATLAB 的 1-based j/k 语义）===
     const double INF = std::numeric_limits<double>::infinity();
     QVector<QVector<double>> DP(m, QVector<double>(n2, INF));
     QVector<QVector<int>> path(m, QVector<int>(n2, -1)); // 存 1-based k
 
+    // 各参考段去均值值之和（理论为 0，数值上保留以与 my_corr 一致）
+    QVector<double> refCentredSum(m, 0.0);
+    for (int i = 0; i < m; ++i) {
+        for (double v : reference.segCentred[i]) refCentredSum[i] += v;
+    }
+
+    // 按目标段长度缓存重采样计划：长度范围 [currLen - t, currLen + t]
+    QVector<ResamplePlan> plans(2 * tWarp + 1);
+    QVector<int> planLen(2 * tWarp + 1, -1);
+    auto planFor = [&](int origLen, int currLen) -> const ResamplePlan& {
+        const int slot = origLen - (currLen - tWarp);
+        if (planLen[slot] != origLen) {
+            buildResamplePlan(origLen, currLen, plans[slot]);
+            planLen[slot] = origLen;
+        }
+        return plans[slot];
+    };
+
     // 7.1 第一段初始化
     int firstLen = segLen[0];
     int jmin = qMax(firstLen - tWarp, 1);
     int jmax = qMin(firstLen + tWarp, n2);
 
-    QVector<double> refSeg0;
-    refSeg0.reserve(firstLen);
-    for (int i = segStarts0[0]; i <= segEnds0[0]; ++i) refSeg0.push_back(chrom1[i]);
-
+    const RefSegStats refSeg0 = refStats(0);
     for (int j = jmin; j <= jmax; ++j) {
-        linearResampleInPlace(chrom2.constData(), j, warpWork.data(), firstLen);
-        const double r = myCorrPtr(refSeg0.constData(), warpWork.constData(), firstLen);
-        double cost = 1.0 - r;
+        const double cost = candidateCost(refSeg0, refCentredSum[0], planFor(j, firstLen),
+                                          chrom2.constData(), j, warpWork.data());
         if (!qIsFinite(cost)) continue;
         DP[0][j - 1] = cost;
         path[0][j - 1] = 1; // MATLAB 里 path(1,j)=1
     }
 
     // 7.2 主循环
-    int prefixSum = segLen[0];
-    for (int iSeg = 2; iSeg <= m; ++iSeg) { // 1-based
-        prefixSum += segLen[iSeg - 1];
-
-        int refStart0 = segStarts0[iSeg - 1];
-        int refEnd0 = segEnds0[iSeg - 1];
-        int currLen = refEnd0 - refStart0 + 1;
-
-        QVector<double> refSeg;
-        refSeg.reserve(currLen);
-        for (int i = refStart0; i <= refEnd0; ++i) refSeg.push_back(chrom1[i]);
-
-        int theoreticalSum = 0;
-        for (int k = 0; k < iSeg; ++k) theoreticalSum += segLen[k];
-        int jLo = qMax(1, theoreticalSum - iSeg * tWarp);
-        int jHi = qMin(n2, theoreticalSum + iSeg * tWarp);
-
-        for (int j = jLo; j <= jHi; ++j) {
-            int minK = qMax(1, j - currLen - tWarp);
-            int maxK = qMin(n2, j - currLen + tWarp);
-
-            double bestCost = INF;
-            int bestK = -1;
-
-            for (int k = minK; k <= maxK; ++k) {
-                if (k >= j) continue;
-                double prev = DP[iSeg - 2][k - 1];
-                if (!qIsFinite(prev)) continue;
-
-                int s0 = k;      // MATLAB: k+1, so 1-based start = k+1 => 0-based = k
-                int e0 = j - 1;  // inclusive 0-based
-                if (s0 < 0) s0 = 0;
-                if (e0 >= n2) e0 = n2 - 1;
-                if (s0 > e0) continue;
-
-                const int segLenTgt = e0 - s0 + 1;
-                linearResampleInPlace(chrom2.constData() + s0, segLenTgt, warpWork.data(), currLen);
-                const double r = myCorrPtr(refSeg.constData(), warpWork.constData(), currLen);
-                double cost = 1.0 - r;
-                if (!qIsFinite(cost)) continue;
-                double total = prev + cost;
-                if (total < bestCost) {
-                    bestCost = total;
-                    bestK = k;
+    // 候选 k 按 (DP 前值, k) 升序评估：代价 1 - r >= 0，前值已不小于当前最优时其后候选均不可能更优，提前结束。
+    // 同代价取较小 k，与原按 k 升序、严格小于才更新的选择一致。
+    struct Candidate {
+        double prev;
+        int k;
+    };
+    QVector<Candidate> candidates;
+    candidates.reserve(2 * tWarp + 1);
+    const double costLowerBound = -1e-12; // r 舍入后可能略大于 1
+
+    // 每段终点至少为后续各段留出的长度（每段至少 max(1, 段长 - t) 点），用于贪心中心不走进死路
+    QVector<int> reserve(m, 0);
+    for (int i = m - 2; i >= 0; --i) reserve[i] = reserve[i + 1] + qMax(1, segLen[i + 1] - tWarp);
+
+    // 一遍段 DP（第一段已初始化）。band < 0：完整 DP；band >= 0：每段先从上一段的贪心中心取最优段长得到本段中心，
+    // 只计算中心 ± band 的终点。窄带内的路径都是完整 DP 的可行路径，其最优代价即为完整 DP 最优值的上界。
+    // pruneAbove：前值或累计代价超过该值的状态不可能位于最优路径上（后续代价非负），直接跳过/置为不可达。
+    QVector<int> centers(m, -1);
+    auto runSegments = [&](int band, double pruneAbove) {
+        for (int i = 1; i < m; ++i) {
+            std::fill(DP[i].begin(), DP[i].end(), INF);
+            std::fill(path[i].begin(), path[i].end(), -1);
+        }
+        if (band >= 0) {
+            double best0 = INF;
+            for (int j = 1; j <= n2 - reserve[0]; ++j) {
+                if (DP[0][j - 1] < best0) {
+                    best0 = DP[0][j - 1];
+                    centers[0] = j;
                 }
             }
+            if (centers[0] < 0) return;
+        }
 
-            if (qIsFinite(bestCost) && bestK >= 1) {
-                DP[iSeg - 1][j - 1] = bestCost;
-                path[iSeg - 1][j - 1] = bestK; // 1-based
+        for (int iSeg = 2; iSeg <= m; ++iSeg) { // 1-based
+            const int currLen = segLen[iSeg - 1];
+            const RefSegStats refSeg = refStats(iSeg - 1);
+            const QVector<double>& prevRow = DP[iSeg - 2];
+            QVector<double>& dpRow = DP[iSeg - 1];
+            QVector<int>& pathRow = path[iSeg - 1];
+
+            int theoreticalSum = 0;
+            for (int k = 0; k < iSeg; ++k) theoreticalSum += segLen[k];
+            int jLo = qMax(1, theoreticalSum - iSeg * tWarp);
+            int jHi = qMin(n2, theoreticalSum + iSeg * tWarp);
+
+            if (band >= 0) {
+                const int prevCenter = centers[iSeg - 2];
+                double centerCost = INF;
+                for (int len = qMax(1, currLen - tWarp); len <= currLen + tWarp; ++len) {
+                    const int j = prevCenter + len;
+                    if (j > n2 - reserve[iSeg - 1]) break;
+                    const double cost = candidateCost(refSeg, refCentredSum[iSeg - 1], planFor(len, currLen),
+                                                      chrom2.constData() + prevCenter, len, warpWork.data());
+                    if (qIsFinite(cost) && cost < centerCost) {
+                        centerCost = cost;
+                        centers[iSeg - 1] = j;
+                    }
+                }
+                if (centers[iSeg - 1] < 0) return;
+                jLo = qMax(jLo, centers[iSeg - 1] - band);
+                jHi = qMin(jHi, centers[iSeg - 1] + band);
+            }
+
+            // 终点范围收窄到上一段可达状态能到达的区间
+            int kFirst = -1;
+            int kLast = -1;
+            for (int k = 1; k <= n2; ++k) {
+                if (qIsFinite(prevRow[k - 1]) && prevRow[k - 1] <= pruneAbove) {
+                    if (kFirst < 0) kFirst = k;
+                    kLast = k;
+                }
+            }
+            if (kFirst < 0) return;
+            jLo = qMax(jLo, kFirst + currLen - tWarp);
+            jHi = qMin(jHi, kLast + currLen + tWarp);
+
+            for (int j = jLo; j <= jHi; ++j) {
+                int minK = qMax(1, j - currLen - tWarp);
+                int maxK = qMin(n2, j - currLen + tWarp);
+
+                candidates.clear();
+                for (int k = minK; k <= maxK && k < j; ++k) {
+                    const double prev = prevRow[k - 1];
+                    if (qIsFinite(prev) && prev <= pruneAbove) candidates.append(Candidate{prev, k});
+                }
+                std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+                    return a.prev < b.prev || (a.prev == b.prev && a.k < b.k);
+                });
+
+                double bestCost = INF;
+                int bestK = -1;
+                for (const Candidate& cand : candidates) {
+                    if (cand.prev + costLowerBound > bestCost) break;
+
+                    const int s0 = cand.k;     // MATLAB: k+1, so 1-based start = k+1 => 0-based = k
+                    const int segLenTgt = j - cand.k;
+                    const double cost = candidateCost(refSeg, refCentredSum[iSeg - 1], planFor(segLenTgt, currLen),
+                                                      chrom2.constData() + s0, segLenTgt, warpWork.data());
+                    if (!qIsFinite(cost)) continue;
+                    const double total = cand.prev + cost;
+                    if (total < bestCost || (total == bestCost && cand.k < bestK)) {
+                        bestCost = total;
+                        bestK = cand.k;
+                    }
+                }
+
+                if (bestCost <= pruneAbove && bestK >= 1) {
+                    dpRow[j - 1] = bestCost;
+                    pathRow[j - 1] = bestK; // 1-based
+                }
             }
         }
+    };
+
+    // 先以窄带求上界，再做带剪枝的完整 DP：最优路径的每个前缀代价都不超过最优值（各段代价 >= costLowerBound），
+    // 因此不会被剪掉，回溯结果与不剪枝的完整 DP 相同；窄带失败时上界为 INF，即原完整 DP。
+    const int boundBand = 5;
+    runSegments(boundBand, INF);
+    double upperBound = INF;
+    if (centers[m - 1] > 0) {
+        for (double v : DP[m - 1]) upperBound = qMin(upperBound, v);
     }
+    runSegments(-1, upperBound - m * costLowerBound);
 
     // 8) 回溯 bounds（1-based）
     QVector<int> bounds1;
@@ -637,13 +840,9 @@ ProcessingResult PeakSegCOWAlignment::process(const QList<Curve*>& inputCurves,
         prevEnd1 = endIdx1;
     }
 
-    // 输出曲线：对齐到参考 x
-    QVector<QPointF> alignedPoints;
-    alignedPoints.reserve(n1);
-    for (int i = 0; i < n1; ++i) alignedPoints.push_back(QPointF(refX[i], aligned[i]));
-
-    Curve* alignedCurve = new Curve(alignedPoints, tgt->name() + QObject::tr(" (PeakSeg-COW对齐到参考)"));
-    alignedCurve->setSampleId(tgt->sampleId());
+    // 输出曲线：对齐到参考 x（共享参考 X 列）
+    CurveValue alignedCurve(refX, aligned, tgt.name() + QObject::tr(" (PeakSeg-COW对齐到参考)"));
+    alignedCurve.setSampleId(tgt.sampleId());
     result.namedCurves["aligned"].append(alignedCurve);
 
     QVariantList metaStarts;
@@ -2,7 +2,9 @@
 
 #include "services/algorithm/processing/IProcessingStep.h"
 #include <QObject>
+#include <QSharedPointer>
 #include <QVariantMap>
+#include <QVector>
 
 /**
  * @brief PeakSegCOWAlignment
@@ -14,14 +16,32 @@
  *
  * 输入：两条曲线（参考 + 目标）
  * 输出：key="aligned" 的曲线（目标对齐到参考的 x 坐标）
+ *
+ * 批处理中参考不变时，先 prepareReference() 一次，再对各目标调用 alignToReference()（可并行）。
  */
 class PeakSegCOWAlignment : public IProcessingStep
 {
 public:
+    /**
+     * 参考曲线的一次性准备结果：平滑、多区间峰检测、聚类分段，
+     * 以及各参考段在 my_corr 中的参考侧统计（去均值值、范数）。
+     * 构建后只读，可在多个线程间共享。
+     */
+    struct PreparedReference {
+        QVector<double> refX;                 // 参考 x（对齐结果的横坐标）
+        QVector<int> segStarts0;              // 分段起点（0-based）
+        QVector<int> segEnds0;                // 分段终点（0-based，闭区间）
+        QVector<QVector<double>> segRaw;      // 参考段原始值
+        QVector<QVector<double>> segCentred;  // 参考段去均值后的值
+        QVector<double> segNorm;              // 参考段去均值后的二范数
+        QVector<bool> segAllZero;             // 参考段是否全为 0
+        int tWarp = 50;                       // 每段最大伸缩量 t
+    };
+
     QString stepName() const override;
     QString userVisibleName() const override;
     QVariantMap defaultParameters() const override;
-    ProcessingResult process(const QList<Curve*>& inputCurves,
+    ProcessingResult process(const QList<CurveValue>& inputCurves,
                              const QVariantMap& params,
                              QString& error) override;
 
@@ -29,8 +49,18 @@ public:
      * 仅基于参考曲线计算 PeakSeg 分段起点（1-based，与 process 内分段一致）。
      * 用于微调边界等需与对齐分段一致的场景。
      */
-    static QVector<int> referenceSegmentStarts1Based(const Curve* ref,
+    static QVector<int> referenceSegmentStarts1Based(const CurveValue& ref,
                                                      const QVariantMap& params,
                                                      QString& error);
+
+    /** 基于参考曲线与参数构建 PreparedReference；失败时返回空指针并写入 error */
+    static QSharedPointer<const PreparedReference> prepareReference(const CurveValue& ref,
+                                                                    const QVariantMap& params,
+                                                                    QString& error);
+
+    /** 仅执行与目标相关的分段 DP 与重采样拼接；结果与 process({ref, tgt}) 相同。线程安全 */
+    static ProcessingResult alignToReference(const PreparedReference& reference,
+                                             const CurveValue& tgt,
+                                             QString& error);
 };
 
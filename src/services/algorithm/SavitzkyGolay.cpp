@@ -148,6 +148,7 @@
 
 
 #include "SavitzkyGolay.h"
+#include "SavitzkyGolayKernel.h"
 #include "core/entities/Curve.h"
 #include <QtMath>
 #include <QVector>
@@ -167,75 +168,12 @@ QVariantMap SavitzkyGolay::defaultParameters() const {
     return params;
 }
 
-// ==== 计算 SG 权重矩阵（返回每个列对应的权重）====
-// 说明：正确的权重计算应为 M = (A^T A)^{-1} A^T，其中 A(i,j)=i^j。
-//      常数项 c0 对应平滑权重（DC 增益应为 1），c1 对应一阶导权重。
-static QVector<QVector<double>> sgMatrix(int polyOrder, int windowSize)
-{
-    // 仅支持奇数窗口，half 为窗口半宽
-    int half = windowSize / 2; // 对奇数窗口与 (windowSize-1)/2 等价
-
-    // 构造 A，尺寸为 [windowSize x (polyOrder+1)]
-    QVector<QVector<double>> A(windowSize, QVector<double>(polyOrder + 1));
-    for (int i = -half; i <= half; ++i) {
-        for (int j = 0; j <= polyOrder; ++j) {
-            A[i + half][j] = qPow(i, j);
-        }
-    }
-
-    // 计算 ATA = A^T A，尺寸为 [(polyOrder+1) x (polyOrder+1)]
-    QVector<QVector<double>> ATA(polyOrder + 1, QVector<double>(polyOrder + 1, 0.0));
-    for (int i = 0; i <= polyOrder; ++i) {
-        for (int j = 0; j <= polyOrder; ++j) {
-            double sum = 0.0;
-            for (int k = 0; k < windowSize; ++k) {
-                sum += A[k][i] * A[k][j];
-            }
-            ATA[i][j] = sum;
-        }
-    }
-
-    // 使用 QMatrix4x4 求逆（polyOrder 不超过 3 时有效），得到 invATA
-    QMatrix4x4 mat; // 初始化为 0
-    for (int i = 0; i <= polyOrder && i < 4; ++i) {
-        for (int j = 0; j <= polyOrder && j < 4; ++j) {
-            mat(i, j) = ATA[i][j];
-        }
-    }
-    bool invertible = false;
-    QMatrix4x4 invATA = mat.inverted(&invertible);
-    if (!invertible) {
-        // 逆不可用时返回全零，后续调用需检查
-        return QVector<QVector<double>>(windowSize, QVector<double>(polyOrder + 1, 0.0));
-    }
-
-    // 计算 M = invATA * A^T，尺寸为 [(polyOrder+1) x windowSize]
-    QVector<QVector<double>> M(polyOrder + 1, QVector<double>(windowSize, 0.0));
-    for (int i = 0; i <= polyOrder && i < 4; ++i) {
-        for (int k = 0; k < windowSize; ++k) {
-            double sum = 0.0;
-            for (int j = 0; j <= polyOrder && j < 4; ++j) {
-                sum += invATA(i, j) * A[k][j];
-            }
-            M[i][k] = sum;
-        }
-    }
-
-    // 将权重按原有返回格式组织为 G[windowSize x (polyOrder+1)]：
-    // G[k][0] = 平滑权重；G[k][1] = 一阶导权重
-    QVector<QVector<double>> G(windowSize, QVector<double>(polyOrder + 1, 0.0));
-    for (int k = 0; k < windowSize; ++k) {
-        G[k][0] = M[0][k]; // c0 行为平滑权重
-        if (polyOrder >= 1) {
-            G[k][1] = M[1][k]; // c1 行为一阶导权重（单位步长）
-        }
-    }
-
-    return G;
-}
-
-// ==== SG 平滑 + 一阶导 ====
-ProcessingResult SavitzkyGolay::process(const QList<Curve*> &inputCurves,
+// ==== SG 平滑 / 求导 ====
+// 参数 outputs：
+//   "both"（默认，兼容旧行为）同时输出 smoothed 与 derivative<d>；
+//   "smoothed" 只输出平滑；"derivative" 只输出导数。
+// 导数阶数取 derivative_order（<1 时按 1 阶），结果键为 "derivative<d>"。
+ProcessingResult SavitzkyGolay::process(const QList<CurveValue> &inputCurves,
                                         const QVariantMap &params,
                                         QString &error)
 {
@@ -243,57 +181,46 @@ ProcessingResult SavitzkyGolay::process(const QList<Curve*> &inputCurves,
 
     int windowSize = params.value("window_size").toInt();
     int polyOrder = params.value("poly_order").toInt();
+    const int derivOrder = qMax(1, params.value("derivative_order", 1).toInt());
+    const QString outputs = params.value("outputs", QStringLiteral("both")).toString();
+    const bool wantSmoothed = (outputs != QLatin1String("derivative"));
+    const bool wantDerivative = (outputs != QLatin1String("smoothed"));
 
     if (windowSize <= polyOrder || windowSize % 2 == 0) {
         error = "Savitzky-Golay 参数无效";
         return result;
     }
 
-    int half = (windowSize - 1) / 2;
-    auto G = sgMatrix(polyOrder, windowSize);
-
-    // 提取平滑系数 (第0列) 和一阶导数系数 (第1列)
-    QVector<double> smoothCoeff(windowSize), derivCoeff(windowSize);
-    for (int i = 0; i < windowSize; ++i) {
-        smoothCoeff[i] = G[i][0];
-        derivCoeff[i] = (polyOrder >= 1 ? G[i][1] : 0.0);
-    }
-    // 为避免数值误差导致 DC 增益偏移，对平滑系数进行归一化（权重和=1）
-    double wsum = 0.0;
-    for (int i = 0; i < windowSize; ++i) wsum += smoothCoeff[i];
-    if (wsum != 0.0) {
-        for (int i = 0; i < windowSize; ++i) smoothCoeff[i] /= wsum;
+    // 系数按 (窗口, 阶数, 求导阶数) 缓存，重复调用不再重新求解
+    const QVector<double> smoothCoeff = wantSmoothed
+        ? SavitzkyGolayKernel::coefficients(windowSize, polyOrder, 0) : QVector<double>();
+    // poly_order 低于求导阶数时导数恒为 0（与旧实现 poly_order=0 时的行为一致）
+    const QVector<double> derivCoeff = (wantDerivative && derivOrder <= polyOrder)
+        ? SavitzkyGolayKernel::coefficients(windowSize, polyOrder, derivOrder)
+        : QVector<double>(windowSize, 0.0);
+    if (wantSmoothed && smoothCoeff.isEmpty()) {
+        error = "Savitzky-Golay 系数计算失败";
+        return result;
     }
 
-    for (Curve* inCurve : inputCurves) {
-        const QVector<QPointF>& data = inCurve->data();
-        int n = data.size();
-
-        QVector<QPointF> smoothData(n);
-        QVector<QPointF> derivData(n);
-
-        // 复制首尾点进行 padding
-        QVector<double> y(n + 2 * half);
-        for (int i = 0; i < half; ++i) y[i] = data.first().y();
-        for (int i = 0; i < n; ++i) y[i + half] = data[i].y();
-        for (int i = 0; i < half; ++i) y[n + half + i] = data.last().y();
-
-        // 卷积实现平滑 + 导数
-        for (int i = 0; i < n; ++i) {
-            double ys = 0, yd = 0;
-            for (int k = 0; k < windowSize; ++k) {
-                ys += smoothCoeff[k] * y[i + k];
-                yd += derivCoeff[k] * y[i + k];
-            }
-            smoothData[i] = QPointF(data[i].x(), ys);
-            derivData[i]  = QPointF(data[i].x(), yd);
-        }
+    const QString derivKey = QString("derivative%1").arg(derivOrder);
 
-        Curve* smoothed = new Curve(smoothData, inCurve->name() + QObject::tr(" (SG 平滑)"));
-        Curve* derivative = new Curve(derivData, inCurve->name() + QObject::tr(" (SG 导数)"));
+    for (const CurveValue& inCurve : inputCurves) {
+        const int n = inCurve.pointCount();
+        if (n == 0) continue;
 
-        result.namedCurves["smoothed"].append(smoothed);
-        result.namedCurves["derivative1"].append(derivative);
+        // 输出曲线与输入共享 X 列，Y 列直接由卷积写入
+        const QVector<double>& x = inCurve.xValues();
+        if (wantSmoothed) {
+            QVector<double> out(n);
+            SavitzkyGolayKernel::convolve(inCurve.yData(), n, smoothCoeff, out.data());
+            result.namedCurves["smoothed"].append(CurveValue(x, out, inCurve.name() + QObject::tr(" (SG 平滑)")));
+        }
+        if (wantDerivative) {
+            QVector<double> out(n);
+            SavitzkyGolayKernel::convolve(inCurve.yData(), n, derivCoeff, out.data());
+            result.namedCurves[derivKey].append(CurveValue(x, out, inCurve.name() + QObject::tr(" (SG 导数)")));
+        }
     }
 
     return result;
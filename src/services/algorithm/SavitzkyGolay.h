@@ -41,7 +41,7 @@ public:
      * @return 一个 ProcessingResult 结构体，其 namedCurves 中包含了处理后的结果曲线。
      *         结果曲线的 key 将是 "smoothed", "derivative1", "derivative2" 等。
      */
-    ProcessingResult process(const QList<Curve*>& inputCurves, 
+    ProcessingResult process(const QList<CurveValue>& inputCurves, 
                              const QVariantMap& params, 
                              QString& error) override;
 };
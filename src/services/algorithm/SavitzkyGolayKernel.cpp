@@ -0,0 +1,226 @@
+#include "SavitzkyGolayKernel.h"
+
+#include <QHash>
+#include <QReadWriteLock>
+#include <QtGlobal>
+#include <algorithm>
+#include <cmath>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define SG_KERNEL_X86_64 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#endif
+
+#if defined(SG_KERNEL_X86_64) && (defined(__GNUC__) || defined(__clang__))
+#define SG_TARGET_AVX __attribute__((target("avx")))
+#else
+#define SG_TARGET_AVX
+#endif
+
+namespace {
+
+// ==== 系数计算 ====
+// 以 u = i / half 缩放横坐标后解正规方程 (A^T A) M = A^T，A(k,j) = u_k^j，
+// 缩放使 A^T A 的条件数与窗口大小基本无关，高阶多项式也能稳定求解。
+static QVector<double> computeCoefficients(int windowSize, int polyOrder, int derivOrder)
+{
+    const int half = windowSize / 2;
+    const int m = polyOrder + 1;
+    const double scale = half > 0 ? double(half) : 1.0;
+
+    QVector<double> A(windowSize * m);
+    for (int k = 0; k < windowSize; ++k) {
+        const double u = (k - half) / scale;
+        double p = 1.0;
+        for (int j = 0; j < m; ++j) {
+            A[k * m + j] = p;
+            p *= u;
+        }
+    }
+
+    // 增广矩阵 [A^T A | A^T]，尺寸 m x (m + windowSize)
+    const int cols = m + windowSize;
+    QVector<double> aug(m * cols, 0.0);
+    for (int i = 0; i < m; ++i) {
+        for (int j = 0; j < m; ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < windowSize; ++k) sum += A[k * m + i] * A[k * m + j];
+            aug[i * cols + j] = sum;
+        }
+        for (int k = 0; k < windowSize; ++k) aug[i * cols + m + k] = A[k * m + i];
+    }
+
+    // 列主元高斯-约当消元
+    for (int col = 0; col < m; ++col) {
+        int pivot = col;
+        for (int r = col + 1; r < m; ++r) {
+            if (std::fabs(aug[r * cols + col]) > std::fabs(aug[pivot * cols + col])) pivot = r;
+        }
+        if (std::fabs(aug[pivot * cols + col]) < 1e-300) return QVector<double>(); // 奇异
+        if (pivot != col) {
+            for (int c = 0; c < cols; ++c) qSwap(aug[col * cols + c], aug[pivot * cols + c]);
+        }
+        const double inv = 1.0 / aug[col * cols + col];
+        for (int c = 0; c < cols; ++c) aug[col * cols + c] *= inv;
+        for (int r = 0; r < m; ++r) {
+            if (r == col) continue;
+            const double f = aug[r * cols + col];
+            if (f == 0.0) continue;
+            for (int c = 0; c < cols; ++c) aug[r * cols + c] -= f * aug[col * cols + c];
+        }
+    }
+
+    // 第 d 行即 a_d 的权重；对 i 的 d 阶导数为 d! * a_d / half^d
+    double factor = 1.0;
+    for (int i = 2; i <= derivOrder; ++i) factor *= i;
+    factor /= std::pow(scale, derivOrder);
+
+    QVector<double> coeff(windowSize);
+    for (int k = 0; k < windowSize; ++k) coeff[k] = factor * aug[derivOrder * cols + m + k];
+
+    // 平滑系数归一化（权重和=1），与原实现一致，避免数值误差导致 DC 增益偏移
+    if (derivOrder == 0) {
+        double wsum = 0.0;
+        for (double c : coeff) wsum += c;
+        if (wsum != 0.0) {
+            for (double& c : coeff) c /= wsum;
+        }
+    }
+    return coeff;
+}
+
+// ==== 卷积内核（yp 为首尾填充后的数组，长度 n + windowSize - 1）====
+// 逐点按 k 递增顺序先乘后加，各指令集路径结果逐位一致
+
+static void convolveScalar(const double* yp, int begin, int n, const double* c, int w, double* out)
+{
+    for (int i = begin; i < n; ++i) {
+        double s = 0.0;
+        for (int k = 0; k < w; ++k) s += c[k] * yp[i + k];
+        out[i] = s;
+    }
+}
+
+#ifdef SG_KERNEL_X86_64
+static void convolveSse2(const double* yp, int n, const double* c, int w, double* out)
+{
+    int i = 0;
+    for (; i + 2 <= n; i += 2) {
+        __m128d acc = _mm_setzero_pd();
+        for (int k = 0; k < w; ++k)
+            acc = _mm_add_pd(acc, _mm_mul_pd(_mm_set1_pd(c[k]), _mm_loadu_pd(yp + i + k)));
+        _mm_storeu_pd(out + i, acc);
+    }
+    convolveScalar(yp, i, n, c, w, out);
+}
+
+SG_TARGET_AVX static void convolveAvx(const double* yp, int n, const double* c, int w, double* out)
+{
+    int i = 0;
+    // 每次计算 8 个输出（两组累加器，隐藏加法延迟）
+    for (; i + 8 <= n; i += 8) {
+        __m256d acc0 = _mm256_setzero_pd();
+        __m256d acc1 = _mm256_setzero_pd();
+        for (int k = 0; k < w; ++k) {
+            const __m256d ck = _mm256_broadcast_sd(c + k);
+            acc0 = _mm256_add_pd(acc0, _mm256_mul_pd(ck, _mm256_loadu_pd(yp + i + k)));
+            acc1 = _mm256_add_pd(acc1, _mm256_mul_pd(ck, _mm256_loadu_pd(yp + i + 4 + k)));
+        }
+        _mm256_storeu_pd(out + i, acc0);
+        _mm256_storeu_pd(out + i + 4, acc1);
+    }
+    for (; i + 4 <= n; i += 4) {
+        __m256d acc = _mm256_setzero_pd();
+        for (int k = 0; k < w; ++k)
+            acc = _mm256_add_pd(acc, _mm256_mul_pd(_mm256_broadcast_sd(c + k), _mm256_loadu_pd(yp + i + k)));
+        _mm256_storeu_pd(out + i, acc);
+    }
+    convolveScalar(yp, i, n, c, w, out);
+}
+
+static bool cpuSupportsAvx()
+{
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] & (1 << 27)) != 0;
+    const bool avx = (info[2] & (1 << 28)) != 0;
+    if (!osxsave || !avx) return false;
+    return (_xgetbv(0) & 0x6) == 0x6; // 操作系统保存 YMM 状态
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx");
+#endif
+}
+#endif
+
+} // namespace
+
+namespace SavitzkyGolayKernel {
+
+Isa bestIsa()
+{
+#ifdef SG_KERNEL_X86_64
+    static const Isa isa = cpuSupportsAvx() ? Isa::AVX : Isa::SSE2;
+    return isa;
+#else
+    return Isa::Scalar;
+#endif
+}
+
+QVector<double> coefficients(int windowSize, int polyOrder, int derivOrder)
+{
+    if (windowSize <= 0 || windowSize % 2 == 0 || polyOrder < 0 || windowSize <= polyOrder
+        || derivOrder < 0 || derivOrder > polyOrder) {
+        return QVector<double>();
+    }
+
+    static QReadWriteLock lock;
+    static QHash<quint64, QVector<double>> cache;
+    const quint64 key = (quint64(quint32(windowSize)) << 32) | (quint64(quint16(polyOrder)) << 16) | quint16(derivOrder);
+    {
+        QReadLocker locker(&lock);
+        auto it = cache.constFind(key);
+        if (it != cache.constEnd()) return it.value();
+    }
+
+    const QVector<double> coeff = computeCoefficients(windowSize, polyOrder, derivOrder);
+    QWriteLocker locker(&lock);
+    cache.insert(key, coeff);
+    return coeff;
+}
+
+void convolve(const double* y, int n, const QVector<double>& coeff, double* out, Isa isa)
+{
+    const int w = coeff.size();
+    if (n <= 0 || w <= 0) return;
+    const int half = w / 2;
+
+    // 复制首尾点进行 padding
+    QVector<double> padded(n + 2 * half);
+    double* yp = padded.data();
+    for (int i = 0; i < half; ++i) yp[i] = y[0];
+    std::copy(y, y + n, yp + half);
+    for (int i = 0; i < half; ++i) yp[n + half + i] = y[n - 1];
+
+    const double* c = coeff.constData();
+    switch (isa) {
+#ifdef SG_KERNEL_X86_64
+    case Isa::AVX:
+        if (bestIsa() == Isa::AVX) { convolveAvx(yp, n, c, w, out); return; }
+        convolveSse2(yp, n, c, w, out);
+        return;
+    case Isa::SSE2:
+        convolveSse2(yp, n, c, w, out);
+        return;
+#endif
+    default:
+        convolveScalar(yp, 0, n, c, w, out);
+        return;
+    }
+}
+
+} // namespace SavitzkyGolayKernel
@@ -0,0 +1,41 @@
+#ifndef SAVITZKYGOLAYKERNEL_H
+#define SAVITZKYGOLAYKERNEL_H
+
+#include <QVector>
+
+/**
+ * @brief Savitzky-Golay 卷积内核
+ *
+ * - coefficients()：按 (窗口, 阶数, 求导阶数) 缓存的卷积系数，支持任意多项式阶数（双精度求解）；
+ * - convolve()：首尾复制填充后的卷积，按运行时检测的指令集（AVX / SSE2 / 标量）分派。
+ *   各路径逐点的累加顺序相同且不使用 FMA，结果与标量路径逐位一致。
+ *
+ * 线程安全：系数缓存可在多个流水线线程中并发读取。
+ */
+namespace SavitzkyGolayKernel {
+
+enum class Isa {
+    Scalar,
+    SSE2,
+    AVX
+};
+
+// 当前 CPU 可用的最优指令集
+Isa bestIsa();
+
+/**
+ * @brief 获取 SG 卷积系数（长度为 windowSize，按窗口从左到右排列）
+ * derivOrder=0 为平滑系数（归一化为和 1）；derivOrder=d>0 为单位步长下的 d 阶导数系数。
+ * 参数无效（窗口非奇数、windowSize <= polyOrder、derivOrder > polyOrder）时返回空数组。
+ */
+QVector<double> coefficients(int windowSize, int polyOrder, int derivOrder);
+
+/**
+ * @brief 卷积：out[i] = sum_k coeff[k] * y[clamp(i + k - half)]
+ * 边界以首尾点复制填充，与原 SavitzkyGolay::process 一致。out 需可容纳 n 个元素，可与 y 不同址。
+ */
+void convolve(const double* y, int n, const QVector<double>& coeff, double* out, Isa isa = bestIsa());
+
+} // namespace SavitzkyGolayKernel
+
+#endif // SAVITZKYGOLAYKERNEL_H
@@ -458,12 +458,8 @@
 
 
 #include "BaselineCorrector.h"
+#include "AirPlsSolver.h"
 #include "Logger.h"
-#include <QtMath>
-#include <QDebug>
-#include <QElapsedTimer>
-#include <cmath>
-#include <limits>
 
 QString BaselineCorrector::stepName() const {
     return "baseline_correction";
@@ -483,7 +479,7 @@ QVariantMap BaselineCorrector::defaultParameters() const {
     return params;
 }
 
-ProcessingResult BaselineCorrector::process(const QList<Curve*>& inputCurves, const QVariantMap& params, QString& error)
+ProcessingResult BaselineCorrector::process(const QList<CurveValue>& inputCurves, const QVariantMap& params, QString& error)
 {
     DEBUG_LOG << "BaselineCorrector::process()";
     ProcessingResult result;
@@ -494,288 +490,61 @@ ProcessingResult BaselineCorrector::process(const QList<Curve*>& inputCurves, co
     const int itermax = params.value("itermax", 50).toInt();
     const double wep = params.value("wep", 0.0).toDouble();
 
-    for (Curve* inCurve : inputCurves) {
-        const QVector<QPointF>& originalData = inCurve->data();
-        if (originalData.isEmpty()) continue;
-
-        QVector<double> y;
-        y.reserve(originalData.size());
-        for (const QPointF& pt : originalData)
-            y.append(pt.y());
-
-        QVector<double> yb;
-        try {
-            yb = airPLS(y, lambda, order, wep, p, itermax);
-        } catch (...) {
-            error = "airPLS 算法执行失败。";
-            return result;
-        }
-
-        QVector<QPointF> corrected;
-        corrected.reserve(y.size());
-        for (int i = 0; i < y.size(); ++i)
-            corrected.append(QPointF(originalData[i].x(), y[i] - yb[i]));
-
-        Curve* correctedCurve = new Curve(corrected, inCurve->name() + QObject::tr(" (基线校正)"));
-        correctedCurve->setSampleId(inCurve->sampleId());
-        result.namedCurves["baseline_corrected"].append(correctedCurve);
-
-        QVector<QPointF> baselinePts;
-        baselinePts.reserve(yb.size());
-        for (int i = 0; i < yb.size(); ++i)
-            baselinePts.append(QPointF(originalData[i].x(), yb[i]));
-        Curve* baselineCurve = new Curve(baselinePts, inCurve->name() + QObject::tr(" (基线)"));
-        baselineCurve->setSampleId(inCurve->sampleId());
-        baselineCurve->setColor(QColor(Qt::darkGray)); // 算法输出的基线统一使用深灰色，保证通用可读性
-        result.namedCurves["baseline"].append(baselineCurve);
+    AirPlsSolver::Params solverParams;
+    solverParams.lambda = lambda;
+    solverParams.order = order;
+    solverParams.p = p;
+    solverParams.itermax = itermax;
+    solverParams.wep = wep;
+
+    // 收集全部输入一次求解：等长曲线共享惩罚矩阵，曲线间并行
+    QList<CurveValue> curves;
+    QList<QVector<double>> ys;
+    for (const CurveValue& inCurve : inputCurves) {
+        if (inCurve.isEmpty()) continue;
+        curves.append(inCurve);
+        ys.append(inCurve.yValues());
     }
 
-    return result;
-}
-
-static QVector<double> computeDiffCoeffs(int order)
-{
-    QVector<double> coeffs(order + 1, 0.0);
-    auto binom = [](int n, int k) -> double {
-        if (k < 0 || k > n) return 0.0;
-        double res = 1.0;
-        for (int i = 1; i <= k; ++i) {
-            res = res * (n - (k - i)) / i;
-        }
-        return res;
-    };
-    for (int k = 0; k <= order; ++k) {
-        double c = binom(order, k);
-        double sign = ((order - k) % 2 == 0) ? 1.0 : -1.0;
-        coeffs[k] = sign * c;
+    QList<QVector<double>> baselines;
+    try {
+        baselines = AirPlsSolver::solveBatch(ys, solverParams);
+    } catch (...) {
+        error = "airPLS 算法执行失败。";
+        return result;
     }
-    return coeffs;
-}
 
-static QVector<double> applyDD(const QVector<double>& x, const QVector<double>& coeffs, double lambda)
-{
-    const int n = x.size();
-    const int m = coeffs.size() - 1;
-    QVector<double> y(n, 0.0);
-    if (n == 0 || m <= 0) return y;
-    
-    const int rows = n - m;
-    if (rows <= 0) return y;
-    
-    QVector<double> scaledCoeffs(m + 1);
-    for (int k = 0; k <= m; ++k) {
-        scaledCoeffs[k] = lambda * coeffs[k];
-    }
-    
-    QVector<double> temp(rows, 0.0);
-    for (int j = 0; j < rows; ++j) {
-        double t = 0.0;
-        const double* x_ptr = x.constData() + j;
-        const double* c_ptr = scaledCoeffs.constData();
-        for (int k = 0; k <= m; ++k) {
-            t += c_ptr[k] * x_ptr[k];
-        }
-        temp[j] = t;
-    }
-    
-    for (int j = 0; j < rows; ++j) {
-        const double tj = temp[j];
-        double* y_ptr = y.data() + j;
-        const double* c_ptr = coeffs.constData();
-        for (int k = 0; k <= m; ++k) {
-            y_ptr[k] += tj * c_ptr[k];
-        }
-    }
-    return y;
-}
+    for (int c = 0; c < curves.size(); ++c) {
+        const CurveValue& inCurve = curves[c];
+        const QVector<double>& y = ys[c];
+        const QVector<double>& yb = baselines[c];
 
-// 构造 DD = lambda * (D' * D) 的带状下三角存储（半带宽=order）
-// band[d][i] 表示矩阵元素 A(i, i-d)，其中 d=0..order 且 i>=d
-static QVector<QVector<double>> buildPenaltyBand(int n, const QVector<double>& coeffs, double lambda)
-{
-    const int order = coeffs.size() - 1;
-    QVector<QVector<double>> band(order + 1, QVector<double>(n, 0.0));
-    if (n <= 0 || order <= 0) return band;
-
-    const int rows = n - order; // MATLAB: D = diff(speye(n), order) -> (n-order) x n
-    if (rows <= 0) return band;
-
-    for (int j = 0; j < rows; ++j) {
-        for (int k = 0; k <= order; ++k) {
-            const int i = j + k;
-            const double ck = coeffs[k];
-            for (int l = 0; l <= k; ++l) { // 仅累加下三角
-                const int col = j + l;
-                const int d = i - col;     // 0..order
-                band[d][i] += lambda * ck * coeffs[l];
-            }
-        }
-    }
-    return band;
-}
+        QVector<double> corrected(y.size());
+        for (int i = 0; i < y.size(); ++i)
+            corrected[i] = y[i] - yb[i];
 
-static bool choleskyFactorBandedInPlace(QVector<QVector<double>>& band)
-{
-    const int bw = band.size() - 1;
-    if (bw < 0) return false;
-    const int n = band.isEmpty() ? 0 : band[0].size();
-    if (n <= 0) return false;
-
-    for (int i = 0; i < n; ++i) {
-        const int jStart = qMax(0, i - bw);
-        for (int j = jStart; j <= i; ++j) {
-            const int dij = i - j;
-            double aij = band[dij][i];
-
-            double sum = 0.0;
-            const int kStart = qMax(0, qMax(i - bw, j - bw));
-            for (int k = kStart; k < j; ++k) {
-                const int dik = i - k;
-                const int djk = j - k;
-                if (dik > bw || djk > bw) continue;
-                sum += band[dik][i] * band[djk][j];
-            }
-
-            double v = aij - sum;
-            if (i == j) {
-                if (!(v > 0.0)) {
-                    return false;
-                }
-                band[0][i] = std::sqrt(v);
-            } else {
-                const double ljj = band[0][j];
-                if (!(ljj > 0.0)) return false;
-                band[dij][i] = v / ljj;
-            }
-        }
-    }
-    return true;
-}
+        // 校正曲线与基线都与输入共享 X 列
+        CurveValue correctedCurve(inCurve.xValues(), corrected, inCurve.name() + QObject::tr(" (基线校正)"));
+        correctedCurve.setSampleId(inCurve.sampleId());
+        result.namedCurves["baseline_corrected"].append(correctedCurve);
 
-static QVector<double> solveCholeskyBanded(const QVector<QVector<double>>& Lband, const QVector<double>& b)
-{
-    const int bw = Lband.size() - 1;
-    const int n = b.size();
-    QVector<double> y(n, 0.0);
-    QVector<double> x(n, 0.0);
-
-    // 前代：L * y = b
-    for (int i = 0; i < n; ++i) {
-        double sum = 0.0;
-        const int kStart = qMax(0, i - bw);
-        for (int k = kStart; k < i; ++k) {
-            const int dik = i - k;
-            sum += Lband[dik][i] * y[k];
-        }
-        y[i] = (b[i] - sum) / Lband[0][i];
+        CurveValue baselineCurve(inCurve.xValues(), yb, inCurve.name() + QObject::tr(" (基线)"));
+        baselineCurve.setSampleId(inCurve.sampleId());
+        result.namedCurves["baseline"].append(baselineCurve);
     }
 
-    // 回代：L' * x = y
-    for (int i = n - 1; i >= 0; --i) {
-        double sum = 0.0;
-        const int kEnd = qMin(n - 1, i + bw);
-        for (int k = i + 1; k <= kEnd; ++k) {
-            const int dki = k - i;
-            sum += Lband[dki][k] * x[k];
-        }
-        x[i] = (y[i] - sum) / Lband[0][i];
-    }
-    return x;
+    return result;
 }
 
 QVector<double> BaselineCorrector::airPLS(const QVector<double>& y, double lambda, int order, double wep, double p, int itermax)
 {
-    const int n = y.size();
-    if (n == 0) return {};
-    
-    if (order < 1) order = 1;
-    if (itermax < 1) itermax = 1;
-    if (lambda <= 0.0) lambda = 1e5;
-    if (p < 0.0) p = 0.0;
-    if (p > 1.0) p = 1.0;
-    if (wep < 0.0) wep = 0.0;
-    if (wep > 0.5) wep = 0.5;
-    
-    const QVector<double> coeffs = computeDiffCoeffs(order);
-    QVector<double> weights(n, 1.0);
-    QVector<double> baseline(n, 0.0);
-
-    // 预计算 DD = lambda * (D' * D)，与 MATLAB 版本一致
-    const QVector<QVector<double>> ddBand = buildPenaltyBand(n, coeffs, lambda);
-    
-    double sumAbsY = 0.0;
-    for (int i = 0; i < n; ++i) sumAbsY += std::abs(y[i]);
-    if (sumAbsY <= 0.0) sumAbsY = 1.0;
-
-    // MATLAB: startIdx = 1:ceil(n*wep); endIdx = floor(n - n*wep + 1):n
-    const int startCount = qCeil(n * wep);
-    const int endStart = static_cast<int>(std::floor(n - n * wep));
-    
-    for (int iter = 1; iter <= itermax; ++iter) {
-        QElapsedTimer iterTimer;
-        iterTimer.start();
-        
-        QVector<double> b(n, 0.0);
-        for (int i = 0; i < n; ++i) b[i] = weights[i] * y[i];
-
-        // 构造 A = W + DD，并用带状 Cholesky 求解（等价 MATLAB chol / 反斜杠）
-        QVector<QVector<double>> aBand = ddBand;
-        for (int i = 0; i < n; ++i) aBand[0][i] += weights[i];
-        bool ok = choleskyFactorBandedInPlace(aBand);
-        if (!ok) {
-            // 当矩阵接近奇异时，添加极小对角扰动以继续求解（与 MATLAB 反斜杠的稳健性目的相同）
-            const double jitter = 1e-12;
-            aBand = ddBand;
-            for (int i = 0; i < n; ++i) aBand[0][i] += (weights[i] + jitter);
-            ok = choleskyFactorBandedInPlace(aBand);
-            if (!ok) {
-                qWarning() << "airPLS: Cholesky 分解失败，无法求解基线";
-                return baseline;
-            }
-        }
-        baseline = solveCholeskyBanded(aBand, b);
-        
-        double dssn = 0.0;
-        for (int i = 0; i < n; ++i) {
-            double residual = y[i] - baseline[i];
-            if (residual < 0.0) dssn += -residual;
-        }
-        
-        if (dssn < 0.001 * sumAbsY) {
-            DEBUG_LOG << "airPLS 收敛于迭代 " << iter 
-                      << ", dssn = " << dssn
-                      << ", 总耗时 " << iterTimer.elapsed() << " ms";
-            break;
-        }
-        
-        const double denom = (dssn == 0.0) ? std::numeric_limits<double>::min() : dssn;
-
-        // 严格按 MATLAB updateWeights() 的赋值顺序实现
-        for (int i = 0; i < n; ++i) {
-            double residual = y[i] - baseline[i];
-            if (residual >= 0.0) {
-                weights[i] = 0.0;
-            }
-        }
-        for (int i = 0; i < startCount && i < n; ++i) {
-            weights[i] = p;
-        }
-        for (int i = qBound(0, endStart, n); i < n; ++i) {
-            weights[i] = p;
-        }
-        for (int i = 0; i < n; ++i) {
-            double residual = y[i] - baseline[i];
-            if (residual < 0.0) {
-                weights[i] = std::exp(iter * std::abs(residual) / denom);
-            }
-        }
-
-        DEBUG_LOG << "airPLS 迭代 " << iter 
-                  << ": dssn = " << dssn
-                  << ", 耗时 " << iterTimer.elapsed() << " ms";
-    }
-    
-    return baseline;
+    AirPlsSolver::Params params;
+    params.lambda = lambda;
+    params.order = order;
+    params.wep = wep;
+    params.p = p;
+    params.itermax = itermax;
+    return AirPlsSolver::solve(y, params);
 }
 
 QVector<double> BaselineCorrector::diffMatrixApply(const QVector<double>& y, int order)
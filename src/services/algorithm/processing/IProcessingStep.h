@@ -4,20 +4,20 @@
 #include <QVariantMap>
 #include <QList>
 
-// 前置声明我们核心的 Curve 类
-class Curve;
+#include "core/entities/CurveValue.h"
 
 /**
  * @brief ProcessingResult 结构体
  * 
  * 用于从一个处理步骤中返回一个或多个命名后的结果曲线。
  * 这对于像 Savitzky-Golay 这样能同时产出“平滑”和“求导”结果的算法非常有用。
+ * 结果为值类型 CurveValue（共享数据缓冲区，非 QObject），调用方无需释放。
  */
 struct ProcessingResult
 {
     // Key: 结果的名称 (e.g., "smoothed", "derivative1")
     // Value: 该名称对应的曲线列表 (通常只有一条)
-    QMap<QString, QList<Curve*>> namedCurves;
+    QMap<QString, QList<CurveValue>> namedCurves;
     /** 可选元数据（如 PeakSeg 分段起点），不影响仅使用 namedCurves 的调用方 */
     QVariantMap metadata;
 };
@@ -52,14 +52,20 @@ public:
      */
     virtual QVariantMap defaultParameters() const = 0;
 
+    /**
+     * @brief 算法实现版本。输出结果会因实现修改而变化时递增，
+     *        使持久化的处理结果（algo_results）自动作废。
+     */
+    virtual int version() const { return 1; }
+
     /**
      * @brief 执行核心的处理/计算逻辑。
-     * @param inputCurves 输入的一组曲线。
+     * @param inputCurves 输入的一组曲线（值类型，拷贝只共享数据）。
      * @param params 传递给该算法的具体参数。
      * @param error 如果发生错误，通过此引用参数传出错误信息。
      * @return 一个 ProcessingResult 结构体，包含了所有处理后的结果曲线。
      */
-    virtual ProcessingResult process(const QList<Curve*>& inputCurves, 
+    virtual ProcessingResult process(const QList<CurveValue>& inputCurves, 
                                      const QVariantMap& params, 
                                      QString& error) = 0;
 };
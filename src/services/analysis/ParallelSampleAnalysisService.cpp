@@ -2,25 +2,29 @@
 #include "core/AppInitializer.h"
 #include "services/analysis/SampleComparisonService.h"
 #include "core/entities/Curve.h"
+#include "services/analysis/SimilarityMatrix.h"
 #include "Logger.h"
 #include <algorithm>
 #include <limits>
 #include <cmath>
+#include <QtConcurrent>
 
 ParallelSampleAnalysisService::ParallelSampleAnalysisService(AppInitializer* appInit, QObject* parent)
     : QObject(parent), m_appInitializer(appInit)
 {
 }
 
-// 复制各工作台的常用工具方法：根据阶段取曲线
-QSharedPointer<Curve> ParallelSampleAnalysisService::getCurveFromStage(const SampleDataFlexible& sample, StageName stage)
+// 复制各工作台的常用工具方法：根据阶段取曲线（值类型，不生成 Curve 对象）
+CurveValue ParallelSampleAnalysisService::getCurveFromStage(const SampleDataFlexible& sample, StageName stage, bool* found)
 {
     for (const StageData& s : sample.stages) {
-        if (s.stageName == stage) {
-            return s.curve;
+        if (s.stageName == stage && !s.curve.isNull()) {
+            if (found) *found = true;
+            return s.curve.value();
         }
     }
-    return QSharedPointer<Curve>();
+    if (found) *found = false;
+    return CurveValue();
 }
 
 void ParallelSampleAnalysisService::selectRepresentativesInBatch(
@@ -28,11 +32,21 @@ void ParallelSampleAnalysisService::selectRepresentativesInBatch(
     const ProcessingParameters& params,
     StageName stage) const
 {
+    // 各组互不相关：组间并行（每组只写自身样本的 bestInGroup）
+    QVector<SampleGroup*> groups;
+    groups.reserve(batchData.size());
     for (auto it = batchData.begin(); it != batchData.end(); ++it) {
-        SampleGroup& group = it.value();
-        processReplicateGroup(group, params, stage);
+        groups.append(&it.value());
     }
+    if (groups.size() <= 1) {
+        for (SampleGroup* group : groups) processReplicateGroup(*group, params, stage);
+        return;
+    }
+    QtConcurrent::blockingMap(groups, [&](SampleGroup* group) {
+        processReplicateGroup(*group, params, stage);
+    });
 }
+
 bool ParallelSampleAnalysisService::processReplicateGroup(
     SampleGroup& group,
     const ProcessingParameters& params,
@@ -58,41 +72,37 @@ bool ParallelSampleAnalysisService::processReplicateGroup(
         s.bestInGroup = false;
     }
 
-    // —— 根据指定阶段收集曲线（含 ROI 裁剪） ——
-    struct Item { int sampleId; QSharedPointer<Curve> curve; };
+    // —— 根据指定阶段收集曲线 Y 列（含 ROI 裁剪；只读值类型，不生成 Curve 对象） ——
+    struct Item { int sampleId; QVector<double> y; };
     QVector<Item> items;
     items.reserve(group.sampleDatas.size());
     // ROI裁剪函数，支持使用 ProcessingParameters 的 comparisonStart/comparisonEnd
-    auto getRoiCurve = [&](QSharedPointer<Curve> original) -> QSharedPointer<Curve> {
-        if (original.isNull()) return QSharedPointer<Curve>();
+    auto getRoiColumn = [&](const CurveValue& original) -> QVector<double> {
         double startX = params.comparisonStart;
         double endX   = params.comparisonEnd;
         // -1 表示不裁剪，直接返回原曲线
-        if (startX < 0 && endX < 0) return original;
+        if (startX < 0 && endX < 0) return original.yValues();
         // 构造裁剪范围，支持仅指定一端
         double minX = (startX >= 0) ? startX : -std::numeric_limits<double>::infinity();
         double maxX = (endX   >= 0) ? endX   :  std::numeric_limits<double>::infinity();
 
-        const QVector<QPointF>& data = original->data();
-        QVector<QPointF> newData; newData.reserve(data.size());
-        for (const auto& p : data) {
-            if (p.x() >= minX && p.x() <= maxX) {
-                newData.append(p);
+        const QVector<double>& x = original.xValues();
+        const QVector<double>& y = original.yValues();
+        QVector<double> roiY; roiY.reserve(y.size());
+        for (int k = 0; k < x.size(); ++k) {
+            if (x[k] >= minX && x[k] <= maxX) {
+                roiY.append(y[k]);
             }
         }
-        if (newData.size() < 2) return original; // 裁剪过小则回退
-        QSharedPointer<Curve> c(new Curve());
-        c->setData(newData);
-        c->setSampleId(original->sampleId());
-        c->setName(original->name());
-        return c;
+        if (roiY.size() < 2) return y; // 裁剪过小则回退
+        return roiY;
     };
 
     for (const SampleDataFlexible& sample : group.sampleDatas) {
-        QSharedPointer<Curve> c = getCurveFromStage(sample, stage);
-        QSharedPointer<Curve> roiC = getRoiCurve(c);
-        if (!roiC.isNull()) {
-            items.push_back({sample.sampleId, roiC});
+        bool found = false;
+        const CurveValue c = getCurveFromStage(sample, stage, &found);
+        if (found) {
+            items.push_back({sample.sampleId, getRoiColumn(c)});
         }
     }
 
@@ -110,54 +120,28 @@ bool ParallelSampleAnalysisService::processReplicateGroup(
         return true;
     }
 
-    // —— 统一长度截断到组内最短长度（对齐 V2.2.1_origin）——
-    int minLen = std::numeric_limits<int>::max();
-    for (const auto& item : items) {
-        if (!item.curve.isNull()) {
-            minLen = std::min(minLen, item.curve->pointCount());
-        }
-    }
-    if (minLen > 0 && minLen < std::numeric_limits<int>::max()) {
-        for (auto& item : items) {
-            if (!item.curve.isNull() && item.curve->pointCount() > minLen) {
-                QVector<QPointF> oldData = item.curve->data();
-                QVector<QPointF> newData = oldData.mid(0, minLen);
-                QSharedPointer<Curve> newCurve(new Curve());
-                newCurve->setData(newData);
-                newCurve->setSampleId(item.curve->sampleId());
-                newCurve->setName(item.curve->name());
-                item.curve = newCurve;
-            }
-        }
-    }
+    // —— 组内相似度矩阵：统一截断到组内最短长度（对齐 V2.2.1_origin），每对曲线融合计算一次 ——
+    // 组间已在 selectRepresentativesInBatch 中并行，这里串行计算避免嵌套等待线程池
+    QVector<QVector<double>> columns;
+    columns.reserve(items.size());
+    for (const Item& item : items) columns.append(item.y);
+    SimilarityMatrixEngine::Options matrixOptions;
+    matrixOptions.parallel = false;
+    const SimilarityMatrix matrix = SimilarityMatrixEngine::compute(columns, matrixOptions);
 
     // —— 预计算所有两两差异的原始值（含 NRMSE），用于后续按样本平均与归一化 ——
     struct PairScore { int i; int j; double nrmse; double rmse; double pearson; double euclid; };
     QVector<PairScore> pairScores;
+    pairScores.reserve(items.size() * (items.size() - 1) / 2);
     for (int i = 0; i < items.size(); ++i) {
         for (int j = i + 1; j < items.size(); ++j) {
-            // 手动计算 RMSE/NRMSE（NRMSE 以第二条曲线的振幅作为归一化分母）
-            const QVector<QPointF>& da = items[i].curve->data();
-            const QVector<QPointF>& db = items[j].curve->data();
-            int n = std::min(da.size(), db.size());
-            double sumSq = 0.0;
-            double minB = std::numeric_limits<double>::infinity();
-            double maxB = -std::numeric_limits<double>::infinity();
-            for (int k = 0; k < n; ++k) {
-                double ya = da[k].y();
-                double yb = db[k].y();
-                double diff = ya - yb;
-                sumSq += diff * diff;
-                if (yb < minB) minB = yb;
-                if (yb > maxB) maxB = yb;
-            }
-            double rmse = (n > 0) ? std::sqrt(sumSq / n) : 0.0;
-            double rangeB = std::max(maxB - minB, std::numeric_limits<double>::epsilon());
-            double nrmse = rmse / rangeB;
-
-            double pear  = comparer->calculatePearsonCorrelation(items[i].curve, items[j].curve);
-            double eucl  = comparer->calculateEuclideanDistance(items[i].curve, items[j].curve);
-            pairScores.push_back({i, j, nrmse, rmse, pear, eucl});
+            const bool valid = matrix.isValid(i, j);
+            // NRMSE 以第二条曲线的振幅作为归一化分母
+            const double rmse = valid ? matrix.value(SimilarityMatrix::Metric::Rmse, i, j) : 0.0;
+            const double rangeB = std::max(valid ? matrix.stats(j).range() : 0.0, std::numeric_limits<double>::epsilon());
+            pairScores.push_back({i, j, rmse / rangeB, rmse,
+                                  matrix.value(SimilarityMatrix::Metric::Pearson, i, j),
+                                  matrix.value(SimilarityMatrix::Metric::Euclidean, i, j)});
         }
     }
 
@@ -45,8 +45,8 @@ public:
                                       StageName stage) const;
 
 private:
-    // 根据阶段名称获取曲线指针（复用各工作台的本地逻辑，这里统一封装）
-    static QSharedPointer<Curve> getCurveFromStage(const SampleDataFlexible& sample, StageName stage);
+    // 根据阶段名称获取曲线（复用各工作台的本地逻辑，这里统一封装）；found 返回该阶段是否存在
+    static CurveValue getCurveFromStage(const SampleDataFlexible& sample, StageName stage, bool* found = nullptr);
 
     AppInitializer* m_appInitializer = nullptr;
 };
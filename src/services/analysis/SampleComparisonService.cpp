@@ -7,7 +7,9 @@
 #include "services/algorithm/Euclidean.h"
 #include "services/algorithm/PlainRmse.h"
 #include "services/algorithm/Loess.h"
+#include "services/algorithm/LoessEngine.h"
 #include "Logger.h"
+#include <QScopedPointer>
 #include <QtMath>
 #include <algorithm>
 #include <limits>
@@ -91,13 +93,35 @@ double SampleComparisonService::calculatePlainRMSE(QSharedPointer<Curve> curve1,
     return 0.0;
 }
 
+QVector<CurveMetricsKernel::PairMetrics> SampleComparisonService::compareToReference(
+    QSharedPointer<Curve> referenceCurve,
+    const QList<QSharedPointer<Curve>>& curves) const
+{
+    if (referenceCurve.isNull()) return QVector<CurveMetricsKernel::PairMetrics>(curves.size());
+    // Y 列隐式共享，收集时不复制数据
+    QVector<QVector<double>> columns;
+    columns.reserve(curves.size());
+    for (const QSharedPointer<Curve>& curve : curves)
+        columns.append(curve.isNull() ? QVector<double>() : curve->yValues());
+    return CurveMetricsKernel::compareOneToMany(referenceCurve->yValues(), columns);
+}
+
+QVector<CurveMetricsKernel::PairMetrics> SampleComparisonService::compareAllPairs(
+    const QList<QSharedPointer<Curve>>& curves) const
+{
+    QVector<QVector<double>> columns;
+    columns.reserve(curves.size());
+    for (const QSharedPointer<Curve>& curve : curves)
+        columns.append(curve.isNull() ? QVector<double>() : curve->yValues());
+    return CurveMetricsKernel::compareAllPairs(columns);
+}
+
 QList<DifferenceResultRow> SampleComparisonService::calculateRankingFromCurves(
     QSharedPointer<Curve> referenceCurve, 
     const QList<QSharedPointer<Curve>> &allCurves)
 {
-    QList<DifferenceResultRow> finalResults;
     if (referenceCurve.isNull() || allCurves.isEmpty()) {
-        return finalResults;
+        return QList<DifferenceResultRow>();
     }
 
     // for (QSharedPointer<Curve> compCurve : allCurves) {
@@ -117,107 +141,93 @@ QList<DifferenceResultRow> SampleComparisonService::calculateRankingFromCurves(
     //     finalResults.append(result);
     // }
 
-    for (QSharedPointer<Curve> compCurve : allCurves) {
-    if (compCurve.isNull()) continue;
-
-    DifferenceResultRow result;
-    result.sampleId = compCurve->sampleId();
-    DEBUG_LOG << "sampleId ==" << result.sampleId;
-    result.sampleName = compCurve->name();
-
-    bool hasInvalidScore = false;
+    // 转为值类型（共享 X/Y 列，不复制）；自比依赖指针相同，记下参考曲线在列表中的位置
+    QList<CurveValue> values;
+    values.reserve(allCurves.size());
+    int referenceIndex = -1;
+    for (const QSharedPointer<Curve>& curve : allCurves) {
+        if (curve.isNull()) continue;
+        if (curve == referenceCurve) referenceIndex = values.size();
+        values.append(curve->toCurveValue());
+    }
+    return calculateRankingFromValues(referenceCurve->toCurveValue(), values, referenceIndex);
+}
 
-    for (const QString& algId : m_registeredStrategies.keys()) {
-        IDifferenceStrategy* strategy = m_registeredStrategies.value(algId);
-        double score;
+QList<DifferenceResultRow> SampleComparisonService::calculateRankingFromValues(
+    const CurveValue& referenceCurve,
+    const QList<CurveValue>& allCurves,
+    int referenceIndex)
+{
+    QList<DifferenceResultRow> finalResults;
+    if (allCurves.isEmpty()) {
+        return finalResults;
+    }
 
-        if (compCurve == referenceCurve) {
-            // 自比：距离类为0，相关性为1
-            if (algId == QStringLiteral("pearson")) {
-                score = 1.0;
+    // 内核覆盖的算法（nrmse / plain_rmse / pearson / euclidean）整批融合计算，其余注册策略仍逐对调用
+    QVector<QVector<double>> columns;
+    columns.reserve(allCurves.size());
+    for (const CurveValue& curve : allCurves) columns.append(curve.yValues());
+    const QVector<CurveMetricsKernel::PairMetrics> fusedMetrics =
+        CurveMetricsKernel::compareOneToMany(referenceCurve.yValues(), columns);
+
+    // 未被内核覆盖的策略需要 Curve：在当前线程按需生成局部对象，随本函数在同一线程析构
+    QScopedPointer<Curve> referenceObject;
+
+    for (int c = 0; c < allCurves.size(); ++c) {
+        const CurveValue& compCurve = allCurves[c];
+
+        DifferenceResultRow result;
+        result.sampleId = compCurve.sampleId();
+        DEBUG_LOG << "sampleId ==" << result.sampleId;
+        result.sampleName = compCurve.name();
+
+        QMap<QString, double> fusedScores;
+        CurveMetricsKernel::toScores(fusedMetrics[c], fusedScores);
+
+        bool hasInvalidScore = false;
+
+        for (const QString& algId : m_registeredStrategies.keys()) {
+            IDifferenceStrategy* strategy = m_registeredStrategies.value(algId);
+            double score;
+
+            if (c == referenceIndex) {
+                // 自比：距离类为0，相关性为1
+                if (algId == QStringLiteral("pearson")) {
+                    score = 1.0;
+                } else {
+                    score = 0.0; // plain_rmse / nrmse / euclidean
+                }
+            } else if (fusedScores.contains(algId)) {
+                score = fusedScores.value(algId);
             } else {
-                score = 0.0; // plain_rmse / nrmse / euclidean
+                if (referenceObject.isNull()) referenceObject.reset(new Curve(referenceCurve));
+                const Curve compObject(compCurve);
+                score = strategy->calculateDifference(*referenceObject, compObject, {});
+            }
+
+            // 保护：过滤算法错误返回值与非有限值，避免污染排名
+            if (!qIsFinite(score) || score < 0.0) {
+                WARNING_LOG << "Invalid score detected, skip sample in ranking."
+                            << " sampleId=" << result.sampleId
+                            << " algId=" << algId
+                            << " score=" << score;
+                hasInvalidScore = true;
+                break;
             }
-        } else {
-            score = strategy->calculateDifference(*referenceCurve, *compCurve, {});
-        }
 
-        // 保护：过滤算法错误返回值与非有限值，避免污染排名
-        if (!qIsFinite(score) || score < 0.0) {
-            WARNING_LOG << "Invalid score detected, skip sample in ranking."
-                        << " sampleId=" << result.sampleId
-                        << " algId=" << algId
-                        << " score=" << score;
-            hasInvalidScore = true;
-            break;
+            result.scores[algId] = score;
         }
 
-        result.scores[algId] = score;
-    }
+        if (hasInvalidScore) {
+            continue;
+        }
 
-    if (hasInvalidScore) {
-        continue;
+        finalResults.append(result);
     }
 
-    finalResults.append(result);
-}
-
-    
     return finalResults;
 }
 
-// 辅助函数：Loess平滑（复用Loess.cpp中的逻辑）
-static QVector<QPointF> loessSmoothLocal(const QVector<QPointF>& data, double fraction)
-{
-    int n = data.size();
-    if (n < 3) return data;
-
-    int window = qMax(3, int(n * fraction));
-    QVector<QPointF> result;
-    result.reserve(n);
-
-    auto tricube = [](double x) {
-        x = qAbs(x);
-        return (x >= 1.0) ? 0.0 : qPow(1 - x*x*x, 3);
-    };
-
-    for (int i = 0; i < n; i++) {
-        double xi = data[i].x();
-        int left = qMax(0, i - window / 2);
-        int right = qMin(n - 1, left + window - 1);
-        if (right - left + 1 < window && left > 0)
-            left = qMax(0, right - window + 1);
-
-        double maxDist = qAbs(data[right].x() - data[left].x());
-        if (maxDist == 0) maxDist = 1e-12;
-
-        double Sw = 0, Swx = 0, Swy = 0, Swxx = 0, Swxy = 0;
-        for (int j = left; j <= right; j++) {
-            double d = qAbs(data[j].x() - xi) / maxDist;
-            double w = tricube(d);
-            double x = data[j].x();
-            double y = data[j].y();
-            Sw   += w;
-            Swx  += w * x;
-            Swy  += w * y;
-            Swxx += w * x * x;
-            Swxy += w * x * y;
-        }
-
-        double denom = Sw * Swxx - Swx * Swx;
-        double a = 0, b = 0;
-        if (qAbs(denom) > 1e-12) {
-            b = (Sw * Swxy - Swx * Swy) / denom;
-            a = (Swy - b * Swx) / Sw;
-        } else {
-            a = Swy / Sw;
-            b = 0;
-        }
-        result.append(QPointF(xi, a + b * xi));
-    }
-    return result;
-}
-
 // 辅助函数：安全计算相关系数
 static double safeCorr(const QVector<double>& x, const QVector<double>& y)
 {
@@ -276,15 +286,16 @@ SampleComparisonService::PickBestResult SampleComparisonService::pickBestOfTwo(
         y2.append(d2[i].y());
     }
 
-    // 配对一致性指标
-    result.nrmse = calculateNRMSE(curve1, curve2);
-    result.pearson = calculatePearsonCorrelation(curve1, curve2);
-    result.euclid = calculateEuclideanDistance(curve1, curve2);
+    // 配对一致性指标（融合内核一趟求出）
+    const CurveMetricsKernel::PairMetrics pair = compareToReference(curve1, {curve2}).first();
+    result.nrmse = pair.nrmse;
+    result.pearson = pair.pearson;
+    result.euclid = pair.euclidean;
 
     // 各自质量度量：LOESS残差RMS和稳定性
     int spanPts = qMax(5, int(loessSpan * n));
-    QVector<QPointF> s1_loess = loessSmoothLocal(d1, loessSpan);
-    QVector<QPointF> s2_loess = loessSmoothLocal(d2, loessSpan);
+    QVector<QPointF> s1_loess = LoessEngine::smooth(d1, loessSpan);
+    QVector<QPointF> s2_loess = LoessEngine::smooth(d2, loessSpan);
 
     // 残差RMS
     double sumSq1 = 0, sumSq2 = 0;
@@ -303,10 +314,10 @@ SampleComparisonService::PickBestResult SampleComparisonService::pickBestOfTwo(
     double fractionLow = double(spanPtsLow) / n;
     double fractionHigh = double(spanPtsHigh) / n;
 
-    QVector<QPointF> s1_low = loessSmoothLocal(d1, fractionLow);
-    QVector<QPointF> s1_high = loessSmoothLocal(d1, fractionHigh);
-    QVector<QPointF> s2_low = loessSmoothLocal(d2, fractionLow);
-    QVector<QPointF> s2_high = loessSmoothLocal(d2, fractionHigh);
+    QVector<QPointF> s1_low = LoessEngine::smooth(d1, fractionLow);
+    QVector<QPointF> s1_high = LoessEngine::smooth(d1, fractionHigh);
+    QVector<QPointF> s2_low = LoessEngine::smooth(d2, fractionLow);
+    QVector<QPointF> s2_high = LoessEngine::smooth(d2, fractionHigh);
 
     double diff1 = 0, diff2 = 0;
     for (int i = 0; i < n; ++i) {
@@ -6,6 +6,8 @@
 #include <QMap>
 #include <QSharedPointer>
 #include "core/common.h" // 包含 DifferenceResultRow
+#include "core/entities/CurveValue.h"
+#include "services/algorithm/CurveMetricsKernel.h"
 
 // 前置声明
 class Curve;
@@ -36,6 +38,16 @@ public:
     // 计算欧氏距离
     double calculateEuclideanDistance(QSharedPointer<Curve> curve1, QSharedPointer<Curve> curve2);
 
+    /**
+     * @brief 一对多批量比较（融合内核，一趟求出 NRMSE / RMSE / Pearson / 欧氏距离）
+     * 结果与 curves 一一对应；曲线为空或点数与参考不一致的项 valid=false、各指标为 -1。
+     */
+    QVector<CurveMetricsKernel::PairMetrics> compareToReference(QSharedPointer<Curve> referenceCurve,
+                                                               const QList<QSharedPointer<Curve>>& curves) const;
+
+    // 多对多批量比较：所有 i<j 组合（curves[i] 作参考），按 CurveMetricsKernel::pairIndex 存放
+    QVector<CurveMetricsKernel::PairMetrics> compareAllPairs(const QList<QSharedPointer<Curve>>& curves) const;
+
     // pickBestOfTwo：在两个样本中选择最优样本（参考MATLAB pickBestOfTwo-后加.m）
     // 返回最优样本索引（0或1），以及评分详情
     struct PickBestResult {
@@ -64,6 +76,16 @@ public slots:
         const QList<QSharedPointer<Curve>>& allCurves
     );
 
+    /**
+     * @brief 值类型版本：不涉及 QObject，可在任意线程调用（WorkbenchComputationService 的后台分块使用）
+     * @param referenceIndex 参考曲线自身在 allCurves 中的下标（按自比处理），不在列表中时为 -1
+     */
+    QList<DifferenceResultRow> calculateRankingFromValues(
+        const CurveValue& referenceCurve,
+        const QList<CurveValue>& allCurves,
+        int referenceIndex = -1
+    );
+
 private:
     void registerStrategies();
     // 内部持有一个已注册的差异度算法策略列表
@@ -0,0 +1,129 @@
+#include "SimilarityMatrix.h"
+
+#include <QAtomicInt>
+#include <QFuture>
+#include <QtConcurrent>
+#include <QtMath>
+#include <algorithm>
+#include <limits>
+
+// --- SimilarityMatrixEngine ---
+
+SimilarityMatrix SimilarityMatrixEngine::compute(const QVector<QVector<double>>& curves, const Options& options)
+{
+    SimilarityMatrix matrix;
+    const int count = curves.size();
+    matrix.m_count = count;
+    if (count == 0) return matrix;
+
+    int len = std::numeric_limits<int>::max();
+    for (const QVector<double>& y : curves) {
+        if (!y.isEmpty()) len = std::min(len, y.size());
+    }
+    if (len == std::numeric_limits<int>::max()) len = 0;
+    matrix.m_pointCount = len;
+
+    matrix.m_stats.resize(count);
+    for (int i = 0; i < count; ++i)
+        matrix.m_stats[i] = CurveMetricsKernel::computeStats(curves[i].constData(), curves[i].isEmpty() ? 0 : len);
+
+    const int pairCount = count * (count - 1) / 2;
+    matrix.m_rmse = QVector<double>(pairCount, -1.0);
+    matrix.m_pearson = QVector<double>(pairCount, -1.0);
+    if (pairCount == 0 || len == 0) return matrix;
+
+    // 上三角分块列表 (bi <= bj)
+    const int tile = qMax(1, options.tileSize);
+    const int blocks = (count + tile - 1) / tile;
+    QVector<QPair<int, int>> tiles;
+    tiles.reserve(blocks * (blocks + 1) / 2);
+    for (int bi = 0; bi < blocks; ++bi) {
+        for (int bj = bi; bj < blocks; ++bj) tiles.append(qMakePair(bi, bj));
+    }
+
+    double* rmseOut = matrix.m_rmse.data();
+    double* pearsonOut = matrix.m_pearson.data();
+    const QVector<CurveMetricsKernel::CurveStats>& stats = matrix.m_stats;
+    auto computeTile = [&](const QPair<int, int>& t) {
+        const int iEnd = qMin(count, (t.first + 1) * tile);
+        const int jEnd = qMin(count, (t.second + 1) * tile);
+        for (int i = t.first * tile; i < iEnd; ++i) {
+            for (int j = qMax(i + 1, t.second * tile); j < jEnd; ++j) {
+                const CurveMetricsKernel::PairMetrics m = CurveMetricsKernel::compare(
+                    curves[i].constData(), stats[i], curves[j].constData(), stats[j], len);
+                if (!m.valid) continue;
+                const int idx = CurveMetricsKernel::pairIndex(i, j, count);
+                rmseOut[idx] = m.rmse;
+                pearsonOut[idx] = m.pearson;
+            }
+        }
+    };
+
+    QThreadPool* pool = options.pool ? options.pool : QThreadPool::globalInstance();
+    const int workerCount = options.parallel ? qMin(tiles.size(), qMax(1, pool->maxThreadCount())) : 1;
+    if (workerCount <= 1) {
+        for (const QPair<int, int>& t : tiles) computeTile(t);
+        return matrix;
+    }
+
+    QAtomicInt nextTile(0);
+    QList<QFuture<void>> futures;
+    for (int w = 0; w < workerCount; ++w) {
+        futures.append(QtConcurrent::run(pool, [&]() {
+            for (int k = nextTile.fetchAndAddOrdered(1); k < tiles.size(); k = nextTile.fetchAndAddOrdered(1))
+                computeTile(tiles[k]);
+        }));
+    }
+    for (QFuture<void>& f : futures) f.waitForFinished();
+    return matrix;
+}
+
+// --- SimilarityMatrix ---
+
+bool SimilarityMatrix::isValid(int i, int j) const
+{
+    if (i < 0 || j < 0 || i >= m_count || j >= m_count) return false;
+    if (i == j) return m_stats[i].n > 0;
+    return m_rmse[CurveMetricsKernel::pairIndex(qMin(i, j), qMax(i, j), m_count)] >= 0.0;
+}
+
+double SimilarityMatrix::value(Metric metric, int i, int j) const
+{
+    if (!isValid(i, j)) return -1.0;
+    const double rmse = (i == j) ? 0.0 : m_rmse[CurveMetricsKernel::pairIndex(qMin(i, j), qMax(i, j), m_count)];
+    switch (metric) {
+    case Metric::Rmse:
+        return rmse;
+    case Metric::Euclidean:
+        return rmse * qSqrt(double(m_pointCount));
+    case Metric::Nrmse: {
+        const double range = m_stats[i].range();
+        return (qAbs(range) < std::numeric_limits<double>::epsilon()) ? 0.0 : rmse / range;
+    }
+    case Metric::Pearson:
+        if (i == j) return m_pointCount >= 2 ? 1.0 : -1.0;
+        return m_pearson[CurveMetricsKernel::pairIndex(qMin(i, j), qMax(i, j), m_count)];
+    }
+    return -1.0;
+}
+
+QVector<SimilarityMatrix::Neighbor> SimilarityMatrix::nearest(int i, int k, Metric metric) const
+{
+    QVector<Neighbor> candidates;
+    if (i < 0 || i >= m_count || k <= 0) return candidates;
+    candidates.reserve(m_count - 1);
+    for (int j = 0; j < m_count; ++j) {
+        if (j == i || !isValid(i, j)) continue;
+        candidates.append(Neighbor{j, value(metric, i, j)});
+    }
+
+    const bool higher = higherIsCloser(metric);
+    auto closer = [higher](const Neighbor& a, const Neighbor& b) {
+        if (a.value != b.value) return higher ? a.value > b.value : a.value < b.value;
+        return a.index < b.index; // 并列时按下标，结果确定
+    };
+    const int keep = qMin(k, candidates.size());
+    std::partial_sort(candidates.begin(), candidates.begin() + keep, candidates.end(), closer);
+    candidates.resize(keep);
+    return candidates;
+}
@@ -0,0 +1,76 @@
+#ifndef SIMILARITYMATRIX_H
+#define SIMILARITYMATRIX_H
+
+#include <QThreadPool>
+#include <QVector>
+
+#include "services/algorithm/CurveMetricsKernel.h"
+
+class SimilarityMatrix;
+
+/**
+ * @brief N×N 曲线相似度矩阵计算
+ *
+ * 上三角按 tileSize×tileSize 分块，分块经原子计数分发到线程池，
+ * 每对曲线用 CurveMetricsKernel 融合计算；各分块写入互不重叠的位置，无需加锁，结果与线程数无关。
+ * 所有曲线按公共最短长度（空曲线除外）比较，与代表样选择的截断约定一致。
+ */
+namespace SimilarityMatrixEngine {
+
+struct Options {
+    int tileSize = 16;            // 分块边长（曲线数）；同块曲线的列数据在缓存中复用
+    QThreadPool* pool = nullptr;  // nullptr 时使用 QThreadPool::globalInstance()
+    bool parallel = true;         // false：在调用线程串行计算（调用方已处于并行任务中时使用，避免嵌套等待）
+};
+
+SimilarityMatrix compute(const QVector<QVector<double>>& curves, const Options& options = Options());
+
+} // namespace SimilarityMatrixEngine
+
+/**
+ * @brief 紧凑的相似度矩阵：只存上三角的 RMSE 与 Pearson，其余指标由单曲线统计量导出
+ *   欧氏距离 = RMSE × sqrt(比较点数)；NRMSE(i, j) = RMSE / 曲线 i 的 Y 范围（i 为参考，同 Nrmse 策略）。
+ * 对角线：距离类为 0，Pearson 为 1；无效对（含空曲线）各指标为 -1。
+ */
+class SimilarityMatrix
+{
+public:
+    enum class Metric {
+        Nrmse,
+        Rmse,
+        Pearson,
+        Euclidean
+    };
+
+    struct Neighbor {
+        int index = -1;
+        double value = 0.0;
+    };
+
+    SimilarityMatrix() = default;
+
+    int size() const { return m_count; }
+    int pointCount() const { return m_pointCount; }
+    const CurveMetricsKernel::CurveStats& stats(int i) const { return m_stats[i]; }
+
+    bool isValid(int i, int j) const;
+    double value(Metric metric, int i, int j) const;
+
+    // Pearson 越大越相似，其余指标越小越相似
+    static bool higherIsCloser(Metric metric) { return metric == Metric::Pearson; }
+
+    // 与曲线 i 最相似的 k 条曲线（不含自身与无效对），按相似程度排序
+    QVector<Neighbor> nearest(int i, int k, Metric metric = Metric::Rmse) const;
+
+private:
+    friend SimilarityMatrix SimilarityMatrixEngine::compute(const QVector<QVector<double>>&,
+                                                            const SimilarityMatrixEngine::Options&);
+
+    int m_count = 0;
+    int m_pointCount = 0;
+    QVector<CurveMetricsKernel::CurveStats> m_stats;
+    QVector<double> m_rmse;     // 上三角，下标见 CurveMetricsKernel::pairIndex；无效对为 -1
+    QVector<double> m_pearson;  // 上三角
+};
+
+#endif // SIMILARITYMATRIX_H
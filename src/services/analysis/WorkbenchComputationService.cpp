@@ -0,0 +1,163 @@
+#include "WorkbenchComputationService.h"
+#include "SampleComparisonService.h"
+#include "core/entities/Curve.h"
+#include "data_access/SingleTobaccoSampleDAO.h"
+#include "Logger.h"
+
+#include <QAbstractButton>
+#include <QWidget>
+#include <QtConcurrent>
+
+namespace {
+
+// 分块只携带值类型：QSharedPointer<Curve> 的最后一个引用可能在线程池中释放，而 Curve 是界面线程的 QObject
+struct RankingChunk {
+    CurveValue reference;
+    QList<CurveValue> curves;
+    int referenceIndex = -1; // 参考曲线自身在本块中的下标
+};
+
+// QtConcurrent::mapped 的函数对象（Qt5 需通过 result_type 声明返回类型）
+struct RankChunk {
+    typedef QList<DifferenceResultRow> result_type;
+    SampleComparisonService* comparer;
+
+    QList<DifferenceResultRow> operator()(const RankingChunk& chunk) const
+    {
+        return comparer->calculateRankingFromValues(chunk.reference, chunk.curves, chunk.referenceIndex);
+    }
+};
+
+} // namespace
+
+WorkbenchComputationService::WorkbenchComputationService(SampleComparisonService* comparer, QObject* parent)
+    : QObject(parent), m_comparer(comparer)
+{
+}
+
+WorkbenchComputationService::~WorkbenchComputationService()
+{
+    if (m_watcher) {
+        m_watcher->disconnect(this);
+        m_watcher->cancel();
+        m_watcher->waitForFinished(); // 正在执行的分块很短，等待其结束再释放
+    }
+}
+
+QHash<int, SampleIdentifier> WorkbenchComputationService::resolveIdentifiers(const QList<int>& sampleIds)
+{
+    SingleTobaccoSampleDAO sampleDao;
+    return sampleDao.getSampleIdentifiersByIds(sampleIds);
+}
+
+void WorkbenchComputationService::setBatchSize(int batchSize)
+{
+    m_batchSize = qMax(1, batchSize);
+}
+
+bool WorkbenchComputationService::isRunning() const
+{
+    return m_watcher && m_watcher->isRunning();
+}
+
+void WorkbenchComputationService::startRanking(QSharedPointer<Curve> referenceCurve,
+                                               const QList<QSharedPointer<Curve>>& curves)
+{
+    // 旧任务静默作废：断开信号后取消，已入队的结果不再发出
+    if (m_watcher) {
+        m_watcher->disconnect(this);
+        m_watcher->cancel();
+        m_watcher->deleteLater();
+        m_watcher = nullptr;
+    }
+    m_chunkSizes.clear();
+    m_doneCurves = 0;
+    m_totalCurves = 0;
+
+    if (!m_comparer || referenceCurve.isNull()) {
+        WARNING_LOG << "WorkbenchComputationService::startRanking: comparer or reference curve is null";
+        emit finished(false);
+        return;
+    }
+
+    // 在调用线程取值类型快照（共享 X/Y 列，不复制数据）：后台只读快照，界面可继续修改原曲线的名称与样式
+    const CurveValue referenceSnapshot = referenceCurve->toCurveValue();
+    QList<CurveValue> snapshots;
+    snapshots.reserve(curves.size());
+    int referenceIndex = -1;
+    for (const QSharedPointer<Curve>& curve : curves) {
+        if (curve.isNull()) continue;
+        if (curve == referenceCurve) referenceIndex = snapshots.size(); // 自比依赖指针相同
+        snapshots.append(curve->toCurveValue());
+    }
+
+    QList<RankingChunk> chunks;
+    for (int start = 0; start < snapshots.size(); start += m_batchSize) {
+        RankingChunk chunk;
+        chunk.reference = referenceSnapshot;
+        chunk.curves = snapshots.mid(start, m_batchSize);
+        if (referenceIndex >= start && referenceIndex < start + chunk.curves.size())
+            chunk.referenceIndex = referenceIndex - start;
+        chunks.append(chunk);
+        m_chunkSizes.append(chunk.curves.size());
+    }
+    m_totalCurves = snapshots.size();
+
+    m_watcher = new QFutureWatcher<QList<DifferenceResultRow>>(this);
+    connect(m_watcher, &QFutureWatcher<QList<DifferenceResultRow>>::resultReadyAt,
+            this, &WorkbenchComputationService::onChunkReady);
+    connect(m_watcher, &QFutureWatcher<QList<DifferenceResultRow>>::finished,
+            this, &WorkbenchComputationService::onRankingFinished);
+    m_watcher->setFuture(QtConcurrent::mapped(chunks, RankChunk{m_comparer}));
+
+    DEBUG_LOG << "WorkbenchComputationService::startRanking:" << m_totalCurves << "curves in" << chunks.size() << "chunks";
+    emit progressChanged(0, m_totalCurves);
+}
+
+void WorkbenchComputationService::bindProgress(QWidget* window, const QString& baseTitle, QAbstractButton* cancelButton)
+{
+    if (!window) return;
+    if (cancelButton) {
+        cancelButton->setEnabled(false); // 仅在后台计算期间可用
+        connect(cancelButton, &QAbstractButton::clicked, this, &WorkbenchComputationService::cancel);
+    }
+    connect(this, &WorkbenchComputationService::progressChanged, window,
+            [window, baseTitle, cancelButton](int doneCurves, int totalCurves) {
+        if (cancelButton) cancelButton->setEnabled(true);
+        window->setWindowTitle(tr("%1（计算中 %2/%3）").arg(baseTitle).arg(doneCurves).arg(totalCurves));
+    });
+    connect(this, &WorkbenchComputationService::finished, window,
+            [window, baseTitle, cancelButton](bool cancelled) {
+        if (cancelButton) cancelButton->setEnabled(false);
+        window->setWindowTitle(cancelled ? tr("%1（已取消）").arg(baseTitle) : baseTitle);
+    });
+}
+
+void WorkbenchComputationService::cancel()
+{
+    if (!isRunning()) return;
+    m_watcher->disconnect(this);
+    m_watcher->cancel();
+    m_watcher->deleteLater();
+    m_watcher = nullptr;
+    DEBUG_LOG << "WorkbenchComputationService::cancel: ranking cancelled at" << m_doneCurves << "/" << m_totalCurves;
+    emit finished(true);
+}
+
+void WorkbenchComputationService::onChunkReady(int index)
+{
+    if (!m_watcher) return;
+    const QList<DifferenceResultRow> rows = m_watcher->resultAt(index);
+    m_doneCurves += m_chunkSizes.value(index);
+    if (!rows.isEmpty()) emit rowsReady(rows);
+    emit progressChanged(m_doneCurves, m_totalCurves);
+}
+
+void WorkbenchComputationService::onRankingFinished()
+{
+    if (!m_watcher) return;
+    const bool cancelled = m_watcher->isCanceled();
+    m_watcher->deleteLater();
+    m_watcher = nullptr;
+    emit finished(cancelled);
+}
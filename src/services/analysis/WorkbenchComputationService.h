@@ -0,0 +1,72 @@
+#ifndef WORKBENCHCOMPUTATIONSERVICE_H
+#define WORKBENCHCOMPUTATIONSERVICE_H
+
+#include <QObject>
+#include <QFutureWatcher>
+#include <QHash>
+#include <QList>
+#include <QSharedPointer>
+
+#include "core/common.h"
+
+class Curve;
+class QAbstractButton;
+class QWidget;
+class SampleComparisonService;
+
+/**
+ * @brief 差异度工作台的后台计算服务（每个工作台窗口持有一个实例）
+ *
+ * 参考曲线与对比曲线在调用线程取值类型快照后，按 batchSize 分块交给线程池计算排名；
+ * 每块完成即通过 rowsReady 发出结果行，界面可边算边填表。
+ * 再次调用 startRanking、cancel 或析构都会取消尚未开始的分块，旧任务的结果不再发出。
+ */
+class WorkbenchComputationService : public QObject
+{
+    Q_OBJECT
+public:
+    explicit WorkbenchComputationService(SampleComparisonService* comparer, QObject* parent = nullptr);
+    ~WorkbenchComputationService() override;
+
+    /**
+     * @brief 一次批量查询解析样本标识（替代逐样本 getSampleIdentifierById）
+     */
+    static QHash<int, SampleIdentifier> resolveIdentifiers(const QList<int>& sampleIds);
+
+    /**
+     * @brief 后台计算 referenceCurve 与 curves 中每条曲线的差异度（curves 可包含参考曲线自身）
+     * 结果与 SampleComparisonService::calculateRankingFromCurves 相同，只是分块、乱序到达。
+     */
+    void startRanking(QSharedPointer<Curve> referenceCurve, const QList<QSharedPointer<Curve>>& curves);
+
+    void cancel();
+    bool isRunning() const;
+
+    // 每个后台分块的曲线条数
+    void setBatchSize(int batchSize);
+
+    /**
+     * @brief 工作台的进度显示：计算中在窗口标题后追加“（计算中 x/y）”并启用取消按钮，结束后恢复
+     * baseTitle 为不含进度后缀的标题，由工作台在 setupUi 中确定一次；cancelButton 可为空。
+     */
+    void bindProgress(QWidget* window, const QString& baseTitle, QAbstractButton* cancelButton);
+
+signals:
+    void rowsReady(const QList<DifferenceResultRow>& rows);
+    void progressChanged(int doneCurves, int totalCurves);
+    void finished(bool cancelled);
+
+private slots:
+    void onChunkReady(int index);
+    void onRankingFinished();
+
+private:
+    SampleComparisonService* m_comparer = nullptr;
+    QFutureWatcher<QList<DifferenceResultRow>>* m_watcher = nullptr;
+    QVector<int> m_chunkSizes;  // 各分块曲线数，用于进度
+    int m_doneCurves = 0;
+    int m_totalCurves = 0;
+    int m_batchSize = 16;
+};
+
+#endif // WORKBENCHCOMPUTATIONSERVICE_H
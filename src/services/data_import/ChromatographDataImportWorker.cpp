@@ -11,6 +11,7 @@
 #include <QDateTime>
 #include <QRegularExpression>
 #include <QJsonDocument>
+#include <QElapsedTimer>
 
 // 第三方库
 #include "third_party/QXlsx/header/xlsxdocument.h"
@@ -26,6 +27,16 @@
 #include "gui/views/SingleMaterialDataWidget.h"
 #include "src/core/AppInitializer.h"
 #include "data_access/ChromatographyDataDAO.h"
+#include "data_access/CurveBlobDAO.h"
+
+namespace {
+
+static double rowsPerSecond(qint64 rows, qint64 nsecs)
+{
+    return nsecs > 0 ? rows * 1.0e9 / nsecs : 0.0;
+}
+
+} // namespace
 
 // ChromatographDataImportWorker 实现
 ChromatographDataImportWorker::ChromatographDataImportWorker(QObject* parent)
@@ -102,6 +113,8 @@ bool ChromatographDataImportWorker::initThreadDatabase()
             return false;
         }
         { QSqlQuery q(m_threadDb); q.exec("SET NAMES utf8mb4"); }
+        // 同名连接在每次导入时重新打开，表结构探测结果需重新获取
+        SchemaProbeCache::forget(m_threadDb.connectionName());
 
         // 打印子线程数据库连接信息
         DEBUG_LOG << "色谱数据导入子线程数据库连接信息:";
@@ -192,10 +205,12 @@ bool ChromatographDataImportWorker::parseDataFolderName(const QString& folderNam
     return true;
 }
 
-// 处理CSV文件并导入数据
-bool ChromatographDataImportWorker::processCsvFile(const QString& csvPath, int sampleId, const QString& shortCode, int parallelNo,
-                                                   const QJsonObject& importAttrs)
+// 读取 tic_back.csv 中 "Start of data points" 之后的数据点
+bool ChromatographDataImportWorker::readTicBackCsv(const QString& csvPath, QVector<double>& retentionTimes, QVector<double>& responseValues)
 {
+    retentionTimes.clear();
+    responseValues.clear();
+
     QFile file(csvPath);
     if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
         WARNING_LOG << "无法打开CSV文件:" << csvPath;
@@ -207,8 +222,7 @@ bool ChromatographDataImportWorker::processCsvFile(const QString& csvPath, int s
     // 查找"Start of data points"行
     bool foundDataStart = false;
     QString line;
-    while (!in.atEnd()) {
-        line = in.readLine();
+    while (in.readLineInto(&line)) {
         if (line.contains("Start of data points", Qt::CaseInsensitive)) {
             foundDataStart = true;
             break;
@@ -217,72 +231,67 @@ bool ChromatographDataImportWorker::processCsvFile(const QString& csvPath, int s
     
     if (!foundDataStart) {
         WARNING_LOG << "CSV文件中未找到'Start of data points'标记:" << csvPath;
-        file.close();
         return false;
     }
     
-    // 检测 import_attributes 列是否存在（SHOW COLUMNS 作为 information_schema 失败时的回退）
-    bool hasImportAttrsCol = false;
-    {
-        QSqlQuery chk(m_threadDb);
-        if (chk.exec("SELECT 1 FROM information_schema.COLUMNS WHERE TABLE_SCHEMA = DATABASE() "
-                     "AND TABLE_NAME = 'chromatography_data' AND COLUMN_NAME = 'import_attributes'"))
-            hasImportAttrsCol = chk.next();
-        if (!hasImportAttrsCol && chk.exec("SHOW COLUMNS FROM `chromatography_data` LIKE 'import_attributes'"))
-            hasImportAttrsCol = chk.next();
-    }
+    // 从"Start of data points"的下一行开始，先跳过可能的标题行
+    in.readLineInto(&line);
 
-    // 准备SQL语句
-    QSqlQuery query(m_threadDb);
-    if (hasImportAttrsCol) {
-        query.prepare("INSERT INTO chromatography_data (sample_id, retention_time, response_value, source_filename, import_attributes) "
-                     "VALUES (?, ?, ?, ?, ?)");
-    } else {
-        query.prepare("INSERT INTO chromatography_data (sample_id, retention_time, response_value, source_filename) "
-                     "VALUES (?, ?, ?, ?)");
-    }
-    
-    // 读取数据点 - 从"Start of data points"的下一行开始
-    int count = 0;
-    // 先读取下一行，跳过标题行
-    if (!in.atEnd()) {
-        in.readLine(); // 跳过可能的标题行
-    }
-    
-    while (!in.atEnd()) {
-        line = in.readLine().trimmed();
-        if (line.isEmpty()) {
+    // 每行约 16~24 字节，按文件大小预留，避免逐点扩容
+    const int estimate = static_cast<int>(qMin<qint64>(file.size() / 16, 1 << 22));
+    retentionTimes.reserve(estimate);
+    responseValues.reserve(estimate);
+
+    while (in.readLineInto(&line)) {
+        // 只取前两列，不拆分整行
+        const QStringRef row = QStringRef(&line).trimmed();
+        if (row.isEmpty()) {
             continue;
         }
-        
-        QStringList parts = line.split(',');
-        if (parts.size() >= 2) {
-            bool ok1 = false, ok2 = false;
-            double retentionTime = parts[0].toDouble(&ok1);
-            double responseValue = parts[1].toDouble(&ok2);
-            
-            if (ok1 && ok2) {
-                query.bindValue(0, sampleId);
-                query.bindValue(1, retentionTime);
-                query.bindValue(2, responseValue);
-                query.bindValue(3, QFileInfo(csvPath).fileName());
-                if (hasImportAttrsCol) {
-                    query.bindValue(4, QString::fromUtf8(
-                        QJsonDocument(importAttrs).toJson(QJsonDocument::Compact)));
-                }
+        const int c1 = row.indexOf(QLatin1Char(','));
+        if (c1 < 0) {
+            continue;
+        }
+        int c2 = row.indexOf(QLatin1Char(','), c1 + 1);
+        if (c2 < 0) c2 = row.size();
 
-                if (!query.exec()) {
-                    WARNING_LOG << "插入数据失败:" << query.lastError().text();
-                } else {
-                    count++;
-                }
-            }
+        bool ok1 = false, ok2 = false;
+        const double retentionTime = row.left(c1).toDouble(&ok1);
+        const double responseValue = row.mid(c1 + 1, c2 - c1 - 1).toDouble(&ok2);
+        if (ok1 && ok2) {
+            retentionTimes.append(retentionTime);
+            responseValues.append(responseValue);
         }
     }
-    
-    file.close();
-    INFO_LOG << "从" << csvPath << "导入了" << count << "个数据点";
-    return count > 0;
+    return true;
+}
+
+// 处理CSV文件并导入数据
+int ChromatographDataImportWorker::processCsvFile(const QString& csvPath, int sampleId, const QJsonObject& importAttrs)
+{
+    QVector<double> retentionTimes, responseValues;
+    if (!readTicBackCsv(csvPath, retentionTimes, responseValues)) {
+        return 0;
+    }
+    if (retentionTimes.isEmpty()) {
+        WARNING_LOG << "CSV文件中没有有效数据点:" << csvPath;
+        return 0;
+    }
+
+    // 每文件常量只计算一次
+    const QString fileName = QFileInfo(csvPath).fileName();
+    if (!m_chromatographDataDao->insertColumns(sampleId, retentionTimes, responseValues, fileName, importAttrs)) {
+        WARNING_LOG << "插入数据失败:" << csvPath;
+        return 0;
+    }
+    if (!CurveBlobDAO(m_threadDb).save(sampleId, DataType::CHROMATOGRAM, retentionTimes, responseValues,
+                                       fileName, importAttrs)) {
+        WARNING_LOG << "曲线打包写入失败:" << csvPath;
+        return 0;
+    }
+
+    INFO_LOG << "从" << csvPath << "导入了" << retentionTimes.size() << "个数据点";
+    return retentionTimes.size();
 }
 
 // 创建或获取样本ID
@@ -430,17 +439,15 @@ void ChromatographDataImportWorker::run()
     int processedFiles = 0;
     int successCount = 0;
     int totalDataCount = 0;
-    
-    // 开始事务
-    m_threadDb.transaction();
+    QElapsedTimer importTimer;
+    importTimer.start();
     
     try {
         foreach (const auto &csvFile, csvFiles) {
-            // 检查是否被要求停止
+            // 检查是否被要求停止（已提交的样本保留，当前样本尚未开启事务）
             {
                 QMutexLocker locker(&m_mutex);
                 if (m_stopped) {
-                    m_threadDb.rollback();
                     emit importError(tr("用户取消了导入操作"));
                     return;
                 }
@@ -460,24 +467,22 @@ void ChromatographDataImportWorker::run()
                 // 为每个文件创建一个独立的样本
                 int sampleId = createOrGetSample(fileShortCode, fileParallelNo);
                 
-                if (sampleId > 0) {
-                    // 删除该样本的旧数据
-                    if (m_chromatographDataDao) {
-                        m_chromatographDataDao->removeBySampleId(sampleId);
-
-                        // 处理CSV文件并导入数据
-                        if (processCsvFile(csvPath, sampleId, fileShortCode, fileParallelNo, importAttributesSnapshot)) {
-                            successCount++;
-                            
-                            // 获取导入的数据点数量
-                            QSqlQuery countQuery(m_threadDb);
-                            countQuery.prepare("SELECT COUNT(*) FROM chromatography_data WHERE sample_id = ?");
-                            countQuery.bindValue(0, sampleId);
-                            
-                            if (countQuery.exec() && countQuery.next()) {
-                                totalDataCount += countQuery.value(0).toInt();
-                            }
-                        }
+                if (sampleId > 0 && m_chromatographDataDao) {
+                    // 每个样本一个事务：删除旧数据与写入新数据同时生效或同时回滚
+                    QElapsedTimer fileTimer;
+                    fileTimer.start();
+                    m_threadDb.transaction();
+                    m_chromatographDataDao->removeBySampleId(sampleId);
+
+                    const int rows = processCsvFile(csvPath, sampleId, importAttributesSnapshot);
+                    if (rows > 0 && m_threadDb.commit()) {
+                        successCount++;
+                        totalDataCount += rows;
+                        INFO_LOG << "样本" << sampleId << "写入" << rows << "行，"
+                                 << rowsPerSecond(rows, fileTimer.nsecsElapsed()) << "行/秒";
+                    } else {
+                        m_threadDb.rollback();
+                        WARNING_LOG << "样本数据导入失败，已回滚:" << csvPath;
                     }
                 }
             }
@@ -485,7 +490,9 @@ void ChromatographDataImportWorker::run()
             processedFiles++;
         }
         
-        m_threadDb.commit();
+        const double rate = rowsPerSecond(totalDataCount, importTimer.nsecsElapsed());
+        INFO_LOG << "色谱导入完成:" << successCount << "个样本," << totalDataCount << "行," << rate << "行/秒";
+        emit progressMessage(tr("导入完成: %1 个数据点，%2 行/秒").arg(totalDataCount).arg(qRound(rate)));
         emit importFinished(successCount, totalDataCount);
         
     } catch (const std::exception &e) {
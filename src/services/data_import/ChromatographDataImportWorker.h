@@ -13,6 +13,7 @@
 #include <QSqlDatabase>
 #include <QDate>
 #include <QJsonObject>
+#include <QVector>
 
 #include "SingleTobaccoSampleData.h"
 #include "TgBigData.h"
@@ -77,9 +78,10 @@ private:
     QString findTicBackCsv(const QString& dirPath);
     // 从文件夹名称解析short_code和parallel_no
     bool parseDataFolderName(const QString& folderName, QString& shortCode, int& parallelNo);
-    // 处理CSV文件（importAttrs 为 run() 起始时在 m_mutex 下拷贝的快照）
-    bool processCsvFile(const QString& csvPath, int sampleId, const QString& shortCode, int parallelNo,
-                        const QJsonObject& importAttrs);
+    // 读取 tic_back.csv 中 "Start of data points" 之后的数据点
+    static bool readTicBackCsv(const QString& csvPath, QVector<double>& retentionTimes, QVector<double>& responseValues);
+    // 处理CSV文件（importAttrs 为 run() 起始时在 m_mutex 下拷贝的快照），返回写入的数据点数，失败为 0
+    int processCsvFile(const QString& csvPath, int sampleId, const QJsonObject& importAttrs);
     // 创建或获取样本ID
     int createOrGetSample(const QString& shortCode, int parallelNo);
 
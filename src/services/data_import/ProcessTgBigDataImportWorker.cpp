@@ -2,6 +2,7 @@
 #include "services/data_import/ImportSampleNaming.h"
 #include "core/entities/ProcessTgBigData.h"
 #include "data_access/ProcessTgBigDataDAO.h"
+#include "data_access/CurveBlobDAO.h"
 #include "data_access/SingleTobaccoSampleDAO.h"
 #include "AppInitializer.h"
 #include "DatabaseConnector.h"
@@ -202,6 +203,10 @@ void ProcessTgBigDataImportWorker::run()
                         bool saveResult = m_processTgBigDataDao->insertBatch(dataList);
                         
                         if (saveResult) {
+                            // 同步写入打包存储（x=serial_no, y=weight，与读取查询一致）
+                            CurveBlobDAO(m_threadDb).saveRows(sampleId, DataType::PROCESS_TG_BIG, dataList,
+                                [](const ProcessTgBigData& d) { return double(d.getSerialNo()); },
+                                [](const ProcessTgBigData& d) { return d.getWeight(); });
                             dataToSave.append(dataList);
                             successCount++;
                         } else {
@@ -263,6 +268,8 @@ bool ProcessTgBigDataImportWorker::initThreadDatabase()
                 return false;
             }
             { QSqlQuery q(m_threadDb); q.exec("SET NAMES utf8mb4"); }
+            // 同名连接在每次导入时重新打开，表结构探测结果需重新获取
+            SchemaProbeCache::forget(m_threadDb.connectionName());
 
             // 打印子线程数据库连接信息
             DEBUG_LOG << "工序大热重数据导入子线程数据库连接信息:";
@@ -3,6 +3,7 @@
 #include "services/data_import/ImportSampleNaming.h"
 #include "core/entities/TgBigData.h"
 #include "data_access/TgBigDataDAO.h"
+#include "data_access/CurveBlobDAO.h"
 #include "data_access/SingleTobaccoSampleDAO.h"
 #include "AppInitializer.h"
 #include "DatabaseConnector.h"
@@ -18,7 +19,73 @@
 #include <QRegularExpression>
 #include <QDirIterator>
 #include <QJsonObject>
+#include <QAtomicInt>
+#include <QFuture>
+#include <QThreadPool>
+#include <QWaitCondition>
+#include <QtConcurrent>
+
+
+namespace {
+
+// 单个文件的解析结果
+struct ParsedFile {
+    int index = -1;        // 在文件列表中的序号
+    QString filePath;
+    bool opened = false;   // 文件是否成功打开
+    QList<TgBigData> rows; // sample_id 尚未填写
+};
+
+// 有界有序队列：解析线程按任意顺序放入，写入端严格按序号取出。
+// 序号超出 [next, next + capacity) 窗口的放入会阻塞，以此对解析线程施加背压并限制内存。
+class ParsedFileQueue {
+public:
+    explicit ParsedFileQueue(int capacity) : m_capacity(qMax(1, capacity)) {}
+
+    // 返回 false 表示队列已取消
+    bool push(const ParsedFile& item)
+    {
+        QMutexLocker locker(&m_mutex);
+        while (!m_cancelled && item.index >= m_next + m_capacity)
+            m_notFull.wait(&m_mutex);
+        if (m_cancelled) return false;
+        m_items.insert(item.index, item);
+        m_notEmpty.wakeAll();
+        return true;
+    }
 
+    // 取出下一个序号的结果；超时或已取消时返回 false
+    bool pop(ParsedFile& item, unsigned long timeoutMs)
+    {
+        QMutexLocker locker(&m_mutex);
+        if (!m_cancelled && !m_items.contains(m_next))
+            m_notEmpty.wait(&m_mutex, timeoutMs);
+        if (m_cancelled || !m_items.contains(m_next)) return false;
+        item = m_items.take(m_next);
+        ++m_next;
+        m_notFull.wakeAll();
+        return true;
+    }
+
+    void cancel()
+    {
+        QMutexLocker locker(&m_mutex);
+        m_cancelled = true;
+        m_notFull.wakeAll();
+        m_notEmpty.wakeAll();
+    }
+
+private:
+    QMutex m_mutex;
+    QWaitCondition m_notFull;
+    QWaitCondition m_notEmpty;
+    QMap<int, ParsedFile> m_items;
+    int m_next = 0;
+    const int m_capacity;
+    bool m_cancelled = false;
+};
+
+} // namespace
 
 // TgBigDataImportWorker 类实现
 TgBigDataImportWorker::TgBigDataImportWorker(QObject* parent)
@@ -128,97 +195,140 @@ void TgBigDataImportWorker::run()
     QString summary = tr("扫描完成：%1 组，%2 个CSV文件。").arg(fileGroups.size()).arg(fileCount);
     emit progressMessage(summary);
     
-    // 逐个读取CSV文件并提取数据
+    // 按分组顺序展开为文件列表；写入顺序与该列表一致，同一样本出现在多个文件时以后者为准（与串行导入相同）
+    QStringList filePaths;
+    for (auto it = fileGroups.constBegin(); it != fileGroups.constEnd(); ++it) filePaths << it.value();
+
+    // 流水线：N 个解析线程 -> 有界有序队列 -> 本线程单连接写入
+    const int parserCount = qBound(1, QThread::idealThreadCount() - 1, fileCount);
+    ParsedFileQueue queue(parserCount * 2);
+    QAtomicInt nextFile(0);
+    QThreadPool parserPool;
+    parserPool.setMaxThreadCount(parserCount);
+
+    QList<QFuture<void>> parsers;
+    for (int t = 0; t < parserCount; ++t) {
+        parsers << QtConcurrent::run(&parserPool, [this, &queue, &nextFile, &filePaths, &importAttributesSnapshot]() {
+            for (;;) {
+                const int index = nextFile.fetchAndAddRelaxed(1);
+                if (index >= filePaths.size() || isStopped()) return;
+
+                ParsedFile parsed;
+                parsed.index = index;
+                parsed.filePath = filePaths.at(index);
+                QFile file(parsed.filePath);
+                if (file.open(QIODevice::ReadOnly | QIODevice::Text)) {
+                    QTextStream in(&file);
+                    in.setCodec("UTF-8");
+                    // 样本ID由写入端解析后回填
+                    parsed.rows = readTgBigDataFromCsv(in, parsed.filePath, -1);
+                    for (TgBigData& d : parsed.rows) d.setImportAttributes(importAttributesSnapshot);
+                    parsed.opened = true;
+                } else {
+                    WARNING_LOG << "无法打开文件:" << parsed.filePath;
+                }
+                if (!queue.push(parsed)) return; // 已取消
+            }
+        });
+    }
+
+    // 解析线程收尾：取消队列并等待全部退出
+    auto shutdownParsers = [&queue, &parsers]() {
+        queue.cancel();
+        for (QFuture<void>& f : parsers) f.waitForFinished();
+    };
+
     int successCount = 0;
     int failCount = 0;
-    int currentProgress = 0;
-    
-    // 准备批量保存的数据列表
-    QList<TgBigData> dataToSave;
-    
-    // 开始事务
+    int totalDataCount = 0;
+    int filesInTransaction = 0;
+    const int filesPerCommit = 20; // 每提交一次包含的文件数
+
     m_threadDb.transaction();
-    
+
     try {
-        // 遍历所有分组的文件
-        for (const auto& groupId : fileGroups.keys()) {
-            const QStringList& filePaths = fileGroups.value(groupId);
-            
-            for (const QString& filePath : filePaths) {
-                // 检查是否被要求停止
-                {
-                    QMutexLocker locker(&m_mutex);
-                    if (m_stopped) {
-                        m_threadDb.rollback();
-                        emit importError(tr("用户取消了导入操作"));
-                        return;
-                    }
-                }
-                
-                // 更新进度
-                emit progressChanged(currentProgress++, fileCount);
-                emit progressMessage(tr("正在处理文件: %1").arg(QFileInfo(filePath).fileName()));
-                
-                // 为每个文件创建一个独立的样本ID
-                int sampleId = -1;
-                QFileInfo fileInfo(filePath);
-                sampleId = createOrGetSample(fileInfo.fileName());
-                if (sampleId == -1) {
-                    WARNING_LOG << "无法从文件名创建样本:" << filePath;
-                    failCount++;
-                    continue;
-                }
-                
-                // 读取CSV文件
-                QFile file(filePath);
-                if (!file.open(QIODevice::ReadOnly | QIODevice::Text)) {
-                    WARNING_LOG << "无法打开文件:" << filePath;
-                    failCount++;
-                    continue;
-                }
-                
-                QTextStream in(&file);
-                
-                // 设置编码为UTF-8
-                in.setCodec("UTF-8");
-                
-                // 读取CSV数据
-                QList<TgBigData> dataList = readTgBigDataFromCsv(in, filePath, sampleId);
-                for (TgBigData& d : dataList) { d.setImportAttributes(importAttributesSnapshot); }
+        for (int written = 0; written < filePaths.size(); ) {
+            // 检查是否被要求停止：回滚未提交的批次
+            if (isStopped()) {
+                shutdownParsers();
+                m_threadDb.rollback();
+                emit importError(tr("用户取消了导入操作"));
+                return;
+            }
 
-                if (dataList.isEmpty()) {
-                    WARNING_LOG << "从文件中未读取到有效数据:" << filePath;
-                    failCount++;
+            ParsedFile parsed;
+            if (!queue.pop(parsed, 100)) continue; // 超时后重新检查停止标志
+            ++written;
+
+            emit progressChanged(written - 1, fileCount);
+            emit progressMessage(tr("正在处理文件: %1").arg(QFileInfo(parsed.filePath).fileName()));
+
+            if (!parsed.opened) {
+                failCount++;
+                continue;
+            }
+
+            // 为每个文件创建一个独立的样本ID
+            const int sampleId = createOrGetSample(QFileInfo(parsed.filePath).fileName());
+            if (sampleId == -1) {
+                WARNING_LOG << "无法从文件名创建样本:" << parsed.filePath;
+                failCount++;
+                continue;
+            }
+
+            if (parsed.rows.isEmpty()) {
+                WARNING_LOG << "从文件中未读取到有效数据:" << parsed.filePath;
+                failCount++;
+                continue;
+            }
+            for (TgBigData& d : parsed.rows) d.setSampleId(sampleId);
+
+            if (m_tgBigDataDao) {
+                // 删除该样本的旧数据
+                m_tgBigDataDao->removeBySampleId(sampleId);
+
+                // 保存当前文件的数据
+                bool saveResult = m_tgBigDataDao->insertBatch(parsed.rows);
+
+                if (saveResult) {
+                    // 同步写入打包存储（x=serial_no, y=weight，与读取查询一致）
+                    CurveBlobDAO(m_threadDb).saveRows(sampleId, DataType::TG_BIG, parsed.rows,
+                        [](const TgBigData& d) { return double(d.getSerialNo()); },
+                        [](const TgBigData& d) { return d.getWeight(); });
+                    totalDataCount += parsed.rows.size();
+                    successCount++;
                 } else {
-                    // 删除该样本的旧数据
-                    if (m_tgBigDataDao) {
-                        m_tgBigDataDao->removeBySampleId(sampleId);
-                        
-                        // 保存当前文件的数据
-                        bool saveResult = m_tgBigDataDao->insertBatch(dataList);
-                        
-                        if (saveResult) {
-                            dataToSave.append(dataList);
-                            successCount++;
-                        } else {
-                            WARNING_LOG << "保存数据失败:" << filePath;
-                            failCount++;
-                        }
-                    }
+                    WARNING_LOG << "保存数据失败:" << parsed.filePath;
+                    failCount++;
                 }
-                
-                file.close();
+            }
+
+            // 分批提交，避免单个超大事务
+            if (++filesInTransaction >= filesPerCommit) {
+                m_threadDb.commit();
+                m_threadDb.transaction();
+                filesInTransaction = 0;
             }
         }
-        
+
+        shutdownParsers();
         m_threadDb.commit();
-        emit importFinished(successCount, dataToSave.size());
+        emit progressChanged(fileCount, fileCount);
+        DEBUG_LOG << "大热重导入完成: 成功" << successCount << "失败" << failCount << "解析线程" << parserCount;
+        emit importFinished(successCount, totalDataCount);
         
     } catch (const std::exception &e) {
+        shutdownParsers();
         m_threadDb.rollback();
         emit importError(tr("导入过程中发生错误: %1").arg(e.what()));
     }
 }
+
+bool TgBigDataImportWorker::isStopped()
+{
+    QMutexLocker locker(&m_mutex);
+    return m_stopped;
+}
     
 // 初始化线程独立的数据库连接
 bool TgBigDataImportWorker::initThreadDatabase()
@@ -255,6 +365,8 @@ bool TgBigDataImportWorker::initThreadDatabase()
                 return false;
             }
             { QSqlQuery q(m_threadDb); q.exec("SET NAMES utf8mb4"); }
+            // 同名连接在每次导入时重新打开，表结构探测结果需重新获取
+            SchemaProbeCache::forget(m_threadDb.connectionName());
 
             // 打印子线程数据库连接信息
             DEBUG_LOG << "大热重数据导入子线程数据库连接信息:";
@@ -102,9 +102,12 @@ private:
     // 从文件名解析组ID
     QString parseGroupIdFromFilename(const QString& fileName);
     
-    // 从CSV读取大热重数据
+    // 从CSV读取大热重数据（在解析线程中并发调用，只读取导入参数，不访问数据库）
     QList<TgBigData> readTgBigDataFromCsv(QTextStream& in, const QString& filePath, int sampleId);
 
+    // 在 m_mutex 下读取停止标志（解析线程与写入线程共用）
+    bool isStopped();
+
         // QString m_dirPath;
     // AppInitializer* m_appInitializer;
     // bool m_stopped;
@@ -4,6 +4,7 @@
 #include "services/data_import/ImportSampleNaming.h"
 #include "core/entities/TgSmallData.h"
 #include "data_access/TgSmallDataDAO.h"
+#include "data_access/CurveBlobDAO.h"
 #include "data_access/SingleTobaccoSampleDAO.h"
 #include "AppInitializer.h"
 #include "DatabaseConnector.h"
@@ -129,6 +130,8 @@ bool TgSmallDataImportWorker::initThreadDatabase()
             return false;
         }
         { QSqlQuery q(m_threadDb); q.exec("SET NAMES utf8mb4"); }
+        // 同名连接在每次导入时重新打开，表结构探测结果需重新获取
+        SchemaProbeCache::forget(m_threadDb.connectionName());
 
         // 打印子线程数据库连接信息
         DEBUG_LOG << "子线程数据库连接信息:";
@@ -549,14 +552,25 @@ void TgSmallDataImportWorker::run()
 
         if (!dataList.isEmpty()) {
             if (m_tgSmallDataDao) {
+                // 每个工作表一个事务：删除旧数据、写入明细/目录/打包存储同时生效或同时回滚
+                m_threadDb.transaction();
                 m_tgSmallDataDao->removeBySampleId(sampleId);
 
                 bool saveResult = m_tgSmallDataDao->insertBatch(dataList);
                 if (saveResult) {
+                    // 同步写入打包存储（x=temperature, y=dtg_value，与读取查询一致）
+                    CurveBlobDAO blobDao(m_threadDb);
+                    saveResult = !blobDao.isAvailable()
+                                 || blobDao.saveRows(sampleId, DataType::TG_SMALL, dataList,
+                                        [](const TgSmallData& d) { return d.getTemperature(); },
+                                        [](const TgSmallData& d) { return d.getDtgValue(); });
+                }
+                if (saveResult && m_threadDb.commit()) {
                     totalDataCount += dataList.size();
                     successCount++;
                 } else {
-                    emit progressMessage("警告: 保存数据失败，工作表: " + sheetName);
+                    m_threadDb.rollback();
+                    emit progressMessage("警告: 保存数据失败，已回滚，工作表: " + sheetName);
                 }
             } else {
                 emit progressMessage("警告: 数据访问对象未初始化，无法保存数据");
@@ -4,6 +4,7 @@
 #include "services/data_import/ImportSampleNaming.h"
 #include "core/entities/TgSmallData.h"
 #include "data_access/TgSmallRawDataDAO.h"
+#include "data_access/CurveBlobDAO.h"
 #include "data_access/SingleTobaccoSampleDAO.h"
 #include "AppInitializer.h"
 #include "DatabaseConnector.h"
@@ -117,6 +118,8 @@ bool TgSmallRawDataImportWorker::initThreadDatabase()
             return false;
         }
         { QSqlQuery q(m_threadDb); q.exec("SET NAMES utf8mb4"); }
+        // 同名连接在每次导入时重新打开，表结构探测结果需重新获取
+        SchemaProbeCache::forget(m_threadDb.connectionName());
 
         DEBUG_LOG << "子线程数据库连接信息:";
         DEBUG_LOG << "  连接名称:" << m_threadDb.connectionName();
@@ -545,9 +548,23 @@ void TgSmallRawDataImportWorker::run()
                   << "有效数据行数=" << dataList.size()
                   << "nullValueRows=" << nullValueRows
                   << "nonNumericRows=" << nonNumericRows;
+        // 每个工作表一个事务：删除旧数据、写入明细/目录/打包存储同时生效或同时回滚
+        m_threadDb.transaction();
         m_tgSmallRawDataDao->removeBySampleId(sampleId);
         if (!m_tgSmallRawDataDao->insertBatch(dataList)) {
-            WARNING_LOG << "批量插入小热重（原始数据）失败:" << sheetName;
+            m_threadDb.rollback();
+            WARNING_LOG << "批量插入小热重（原始数据）失败，已回滚:" << sheetName;
+            continue;
+        }
+        // 同步写入打包存储（x=temperature, y=weight，与读取查询一致）
+        CurveBlobDAO blobDao(m_threadDb);
+        const bool blobSaved = !blobDao.isAvailable()
+                               || blobDao.saveRows(sampleId, DataType::TG_SMALL_RAW, dataList,
+                                      [](const TgSmallData& d) { return d.getTemperature(); },
+                                      [](const TgSmallData& d) { return d.getWeight(); });
+        if (!blobSaved || !m_threadDb.commit()) {
+            m_threadDb.rollback();
+            WARNING_LOG << "写入小热重（原始数据）失败，已回滚:" << sheetName;
             continue;
         }
 
@@ -143,6 +143,40 @@ CREATE TABLE IF NOT EXISTS process_tg_big_data (
   INDEX idx_bigdata_sample (sample_id, serial_no)
 ) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
 
+-- 7.1 曲线打包存储（每个样本/数据类型一行，x/y 为 little-endian float64 数组，可选 XOR 差分 + zlib）
+-- 由应用在导入时与明细同一事务内写入，删除明细时一并删除；已有数据由应用启动时的后台任务（SampleDAO::backfillCurveBlobs）回填
+CREATE TABLE IF NOT EXISTS curve_blob (
+  sample_id INT NOT NULL COMMENT '样品ID',
+  data_type ENUM('big','small','small_raw','chrom','process_big') NOT NULL COMMENT '数据类型',
+  format_version SMALLINT NOT NULL DEFAULT 1 COMMENT '存储格式版本（2=含等间距X编码）',
+  encoding TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '编码标志：1=XOR差分 2=zlib 4=等间距X(x_data 为 x0,dx) 16=文本(迁移回填)',
+  point_count INT NOT NULL COMMENT '点数',
+  x_data LONGBLOB NOT NULL COMMENT 'x 数组（等间距时为 x0, dx 两个 float64）',
+  y_data LONGBLOB NOT NULL COMMENT 'y 数组',
+  checksum INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'CRC32(x_data || y_data)',
+  source_filename VARCHAR(255) COMMENT '原始文件名',
+  import_attributes JSON NULL COMMENT '导入属性',
+  updated_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+  PRIMARY KEY (sample_id, data_type),
+  FOREIGN KEY (sample_id) REFERENCES single_tobacco_sample(id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
+-- 7.2 样本数据目录（每个样本/数据类型一行），导航树按此判断"哪些样本有哪类数据"，不再对明细表做 DISTINCT 关联
+-- 由应用在写入/删除明细时同一事务内维护；checksum 为明细 (x, y) 的 BIT_XOR(CRC32) 指纹
+CREATE TABLE IF NOT EXISTS sample_data_summary (
+  sample_id INT NOT NULL COMMENT '样品ID',
+  data_type ENUM('big','small','small_raw','chrom','process_big') NOT NULL COMMENT '数据类型',
+  point_count INT NOT NULL COMMENT '点数',
+  x_min DOUBLE NULL COMMENT 'x 最小值',
+  x_max DOUBLE NULL COMMENT 'x 最大值',
+  checksum INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'BIT_XOR(CRC32(x,y))',
+  import_attributes JSON NULL COMMENT '导入属性',
+  imported_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+  PRIMARY KEY (sample_id, data_type),
+  INDEX idx_summary_type (data_type, sample_id),
+  FOREIGN KEY (sample_id) REFERENCES single_tobacco_sample(id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
+
 
 -- =========================
 -- 8. 最优平行样表
@@ -175,27 +209,26 @@ CREATE TABLE IF NOT EXISTS representative_samples (
 -- 算法处理结果表
 -- =========================
 CREATE TABLE IF NOT EXISTS algo_results (
-    id INT AUTO_INCREMENT PRIMARY KEY,
-    
-    raw_type ENUM('big', 'small', 'chrom') NOT NULL COMMENT '原始数据来源类型: 大热重、小热重、色谱',
-    raw_id INT NOT NULL COMMENT '对应原始数据表的 ID (tg_big_data.id / tg_small_data.id / chromatography_data.id)',
-    
-    algo_name VARCHAR(100) NOT NULL COMMENT '算法名称',
-    run_no INT NOT NULL DEFAULT 1 COMMENT '同一算法重复运行编号',
-    param_json JSON COMMENT '算法运行参数',
-    
-    x_value DOUBLE NOT NULL COMMENT '算法处理后的横坐标值',
-    y_value DOUBLE NOT NULL COMMENT '算法处理后的纵坐标值',
-    
-    created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP COMMENT '记录创建时间',
-    
-    -- 联合唯一约束，避免同一算法同次运行重复插入同一个原始点
-    UNIQUE KEY uq_algo_point (raw_type, raw_id, algo_name, run_no, x_value),
-    
-    -- 常用查询索引
-    INDEX idx_raw (raw_type, raw_id),
-    INDEX idx_algo (algo_name, run_no)
-) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COLLATE=utf8mb4_general_ci;
+  sample_id INT NOT NULL COMMENT '样品ID',
+  data_type ENUM('big','small','small_raw','chrom','process_big') NOT NULL COMMENT '数据类型',
+  stage_key VARCHAR(64) NOT NULL COMMENT '阶段ID（如 baseline_correction / peak_alignment）',
+  param_hash BINARY(20) NOT NULL COMMENT '参数哈希 SHA-1（含前序阶段参数）',
+  algo_name VARCHAR(100) NOT NULL COMMENT '算法名称',
+  algo_version INT NOT NULL DEFAULT 1 COMMENT '算法实现版本，与程序内版本不一致时结果作废',
+  raw_version INT UNSIGNED NOT NULL COMMENT '原始数据版本：原始 x/y 列的 CRC32，原始数据变化时结果作废',
+  param_json JSON NULL COMMENT '算法运行参数（仅供查看）',
+  curve_name VARCHAR(255) NULL COMMENT '结果曲线名称',
+  format_version SMALLINT NOT NULL DEFAULT 1 COMMENT '存储格式版本（同 curve_blob）',
+  encoding TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '编码标志：1=XOR差分 2=zlib 4=等间距X(x_data 为 x0,dx)',
+  point_count INT NOT NULL COMMENT '点数',
+  x_data LONGBLOB NOT NULL COMMENT 'x 数组（等间距时为 x0, dx 两个 float64）',
+  y_data LONGBLOB NOT NULL COMMENT 'y 数组',
+  metrics_data LONGBLOB NULL COMMENT '附加指标（QDataStream 序列化的 QVariantMap）',
+  checksum INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'CRC32(x_data || y_data)',
+  created_at TIMESTAMP DEFAULT CURRENT_TIMESTAMP ON UPDATE CURRENT_TIMESTAMP,
+  PRIMARY KEY (sample_id, data_type, stage_key, param_hash),
+  FOREIGN KEY (sample_id) REFERENCES single_tobacco_sample(id) ON DELETE CASCADE
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4;
 
 
 
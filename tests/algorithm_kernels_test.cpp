@@ -0,0 +1,1592 @@
+/**
+ * 算法内核回归与性能校验（不依赖数据库）。
+ * 每个内核一段：与原实现的容差对比 + 微基准计时。默认只输出 PASS/FAIL，
+ * 计时仅在 --benchmark 下运行并输出。
+ * 用法：algorithm_kernels_test [--benchmark]
+ * 构建：见 tests/CMakeLists.txt
+ */
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QMatrix4x4>
+#include <QThreadPool>
+#include <QtMath>
+#include <algorithm>
+#include <cmath>
+#include <cstdarg>
+#include <cstdio>
+#include <limits>
+
+#include "core/CurveMathUtils.h"
+#include "core/entities/Curve.h"
+#include "data_access/AlgoResultRetention.h"
+#include "gui/views/CurveHitIndex.h"
+#include "gui/views/CurveLodPyramid.h"
+#include "services/StageCache.h"
+#include "services/analysis/SimilarityMatrix.h"
+#include "services/algorithm/AirPlsSolver.h"
+#include "services/algorithm/BaselineCorrector.h"
+#include "services/algorithm/CrossCorrelation.h"
+#include "services/algorithm/CurveMetricsKernel.h"
+#include "services/algorithm/Euclidean.h"
+#include "services/algorithm/HampelKernel.h"
+#include "services/algorithm/Loess.h"
+#include "services/algorithm/LoessEngine.h"
+#include "services/algorithm/Nrmse.h"
+#include "services/algorithm/PeakKernel.h"
+#include "services/algorithm/Pearson.h"
+#include "services/algorithm/PlainRmse.h"
+#include "services/algorithm/SavitzkyGolay.h"
+#include "services/algorithm/SavitzkyGolayKernel.h"
+#include "services/algorithm/processing/IProcessingStep.h"
+
+static int g_failures = 0;
+static bool g_benchmark = false; // --benchmark：运行微基准并输出计时
+
+static void check(bool ok, const char* what)
+{
+    std::printf("[%s] %s\n", ok ? "PASS" : "FAIL", what);
+    if (!ok) ++g_failures;
+}
+
+// 计时输出只在 --benchmark 下打印，回归输出与机器负载无关
+static void reportTiming(const char* format, ...)
+{
+    if (!g_benchmark) return;
+    va_list args;
+    va_start(args, format);
+    std::vprintf(format, args);
+    va_end(args);
+}
+
+static double maxAbsDiff(const QVector<double>& a, const QVector<double>& b)
+{
+    if (a.size() != b.size()) return 1e100;
+    double m = 0.0;
+    for (int i = 0; i < a.size(); ++i) m = qMax(m, std::fabs(a[i] - b[i]));
+    return m;
+}
+
+static double maxAbs(const QVector<double>& a)
+{
+    double m = 0.0;
+    for (double v : a) m = qMax(m, std::fabs(v));
+    return m;
+}
+
+static QVector<double> yOf(const CurveValue& c)
+{
+    return c.yValues();
+}
+
+// 合成热重类曲线：S 形失重 + 高频扰动
+static QVector<QPointF> syntheticCurve(int n)
+{
+    QVector<QPointF> pts(n);
+    for (int i = 0; i < n; ++i) {
+        const double t = i * 0.1;
+        const double y = 100.0 - 60.0 / (1.0 + std::exp(-(t - n * 0.05) / 20.0))
+                       + 0.3 * std::sin(i * 0.7) + 0.1 * std::cos(i * 2.3);
+        pts[i] = QPointF(t, y);
+    }
+    return pts;
+}
+
+// ==== Savitzky-Golay：原实现（QMatrix4x4 求逆，每次调用重算系数，同时计算平滑与导数）====
+static void legacySavitzkyGolay(const QVector<QPointF>& data, int windowSize, int polyOrder,
+                                QVector<double>& smooth, QVector<double>& deriv)
+{
+    const int half = windowSize / 2;
+    QVector<QVector<double>> A(windowSize, QVector<double>(polyOrder + 1));
+    for (int i = -half; i <= half; ++i)
+        for (int j = 0; j <= polyOrder; ++j) A[i + half][j] = qPow(i, j);
+    QMatrix4x4 mat;
+    for (int i = 0; i <= polyOrder && i < 4; ++i)
+        for (int j = 0; j <= polyOrder && j < 4; ++j) {
+            double sum = 0.0;
+            for (int k = 0; k < windowSize; ++k) sum += A[k][i] * A[k][j];
+            mat(i, j) = sum;
+        }
+    const QMatrix4x4 inv = mat.inverted();
+    QVector<double> sc(windowSize), dc(windowSize);
+    for (int k = 0; k < windowSize; ++k) {
+        double s0 = 0.0, s1 = 0.0;
+        for (int j = 0; j <= polyOrder && j < 4; ++j) {
+            s0 += inv(0, j) * A[k][j];
+            s1 += inv(1, j) * A[k][j];
+        }
+        sc[k] = s0;
+        dc[k] = polyOrder >= 1 ? s1 : 0.0;
+    }
+    double wsum = 0.0;
+    for (double v : sc) wsum += v;
+    for (double& v : sc) v /= wsum;
+
+    const int n = data.size();
+    QVector<double> y(n + 2 * half);
+    for (int i = 0; i < half; ++i) y[i] = data.first().y();
+    for (int i = 0; i < n; ++i) y[i + half] = data[i].y();
+    for (int i = 0; i < half; ++i) y[n + half + i] = data.last().y();
+    smooth.resize(n);
+    deriv.resize(n);
+    for (int i = 0; i < n; ++i) {
+        double ys = 0, yd = 0;
+        for (int k = 0; k < windowSize; ++k) {
+            ys += sc[k] * y[i + k];
+            yd += dc[k] * y[i + k];
+        }
+        smooth[i] = ys;
+        deriv[i] = yd;
+    }
+}
+
+static void testSavitzkyGolay()
+{
+    std::printf("== Savitzky-Golay ==\n");
+
+    // 教科书系数
+    const QVector<double> s52 = SavitzkyGolayKernel::coefficients(5, 2, 0);
+    const QVector<double> d52 = SavitzkyGolayKernel::coefficients(5, 2, 1);
+    const QVector<double> d73 = SavitzkyGolayKernel::coefficients(7, 3, 2);
+    check(maxAbsDiff(s52, {-3 / 35.0, 12 / 35.0, 17 / 35.0, 12 / 35.0, -3 / 35.0}) < 1e-12, "coeff (5,2,0) = [-3,12,17,12,-3]/35");
+    check(maxAbsDiff(d52, {-0.2, -0.1, 0.0, 0.1, 0.2}) < 1e-12, "coeff (5,2,1) = [-2,-1,0,1,2]/10");
+    check(maxAbsDiff(d73, {5 / 42.0, 0.0, -3 / 42.0, -4 / 42.0, -3 / 42.0, 0.0, 5 / 42.0}) < 1e-12, "coeff (7,3,2) = [5,0,-3,-4,-3,0,5]/42");
+    check(!SavitzkyGolayKernel::coefficients(51, 7, 0).isEmpty(), "poly_order > 3 supported");
+
+    // 与原实现容差对比（原实现以单精度 QMatrix4x4 求逆，系数相对误差约 1e-6）
+    const QVector<QPointF> data = syntheticCurve(11000);
+    SavitzkyGolay sg;
+    const int windows[] = {5, 11, 21, 51};
+    const int orders[] = {1, 2, 3};
+    for (int w : windows) {
+        for (int p : orders) {
+            if (w <= p) continue;
+            QVector<double> refS, refD;
+            legacySavitzkyGolay(data, w, p, refS, refD);
+            const CurveValue in(data, "in");
+            QVariantMap params;
+            params["window_size"] = w;
+            params["poly_order"] = p;
+            params["derivative_order"] = 1;
+            QString error;
+            ProcessingResult res = sg.process({in}, params, error);
+            const QVector<double> s = yOf(res.namedCurves.value("smoothed").first());
+            const QVector<double> d = yOf(res.namedCurves.value("derivative1").first());
+            const double es = maxAbsDiff(s, refS) / maxAbs(refS);
+            const double ed = maxAbsDiff(d, refD) / qMax(1e-12, maxAbs(refD));
+            char label[128];
+            std::snprintf(label, sizeof(label), "SG w=%d p=%d vs legacy (rel smooth %.2e, deriv %.2e)", w, p, es, ed);
+            check(es < 1e-5 && ed < 1e-4, label);
+        }
+    }
+
+    // 只计算所需输出
+    {
+        const CurveValue in(data, "in");
+        QVariantMap params;
+        params["window_size"] = 11;
+        params["poly_order"] = 2;
+        params["outputs"] = "smoothed";
+        QString error;
+        ProcessingResult res = sg.process({in}, params, error);
+        check(res.namedCurves.contains("smoothed") && !res.namedCurves.contains("derivative1"), "outputs=smoothed returns only smoothed");
+    }
+
+    // 各指令集路径逐位一致
+    QVector<double> y(data.size());
+    for (int i = 0; i < data.size(); ++i) y[i] = data[i].y();
+    const QVector<double> coeff = SavitzkyGolayKernel::coefficients(21, 3, 1);
+    QVector<double> outScalar(y.size()), outSse(y.size()), outBest(y.size());
+    SavitzkyGolayKernel::convolve(y.constData(), y.size(), coeff, outScalar.data(), SavitzkyGolayKernel::Isa::Scalar);
+    SavitzkyGolayKernel::convolve(y.constData(), y.size(), coeff, outSse.data(), SavitzkyGolayKernel::Isa::SSE2);
+    SavitzkyGolayKernel::convolve(y.constData(), y.size(), coeff, outBest.data());
+    check(outScalar == outSse && outScalar == outBest, "SIMD kernels bit-identical to scalar");
+
+    if (!g_benchmark) return;
+
+    // 微基准：11k 点，原实现（重算系数 + 双输出）对比新实现（缓存系数 + 单输出）
+    const int reps = 200;
+    QElapsedTimer timer;
+    QVector<double> s, d;
+    timer.start();
+    for (int r = 0; r < reps; ++r) legacySavitzkyGolay(data, 21, 3, s, d);
+    const double legacyUs = timer.nsecsElapsed() / 1000.0 / reps;
+
+    timer.restart();
+    for (int r = 0; r < reps; ++r) {
+        const QVector<double> c = SavitzkyGolayKernel::coefficients(21, 3, 0);
+        SavitzkyGolayKernel::convolve(y.constData(), y.size(), c, outBest.data());
+    }
+    const double kernelUs = timer.nsecsElapsed() / 1000.0 / reps;
+
+    timer.restart();
+    for (int r = 0; r < reps; ++r) {
+        const QVector<double> c = SavitzkyGolayKernel::coefficients(21, 3, 0);
+        SavitzkyGolayKernel::convolve(y.constData(), y.size(), c, outScalar.data(), SavitzkyGolayKernel::Isa::Scalar);
+    }
+    const double scalarUs = timer.nsecsElapsed() / 1000.0 / reps;
+
+    reportTiming("SG 11k points, w=21 p=3: legacy %.1f us, cached scalar %.1f us, cached SIMD %.1f us (isa=%d)\n",
+                 legacyUs, scalarUs, kernelUs, int(SavitzkyGolayKernel::bestIsa()));
+}
+
+// ==== LOESS：原实现（逐点 qPow tricube，绝对坐标加权和）====
+static QVector<QPointF> legacyLoess(const QVector<QPointF>& data, double fraction)
+{
+    const int n = data.size();
+    if (n < 3) return data;
+    const int window = qMax(3, int(n * fraction));
+    QVector<QPointF> result;
+    result.reserve(n);
+    for (int i = 0; i < n; ++i) {
+        const double xi = data[i].x();
+        int left = qMax(0, i - window / 2);
+        const int right = qMin(n - 1, left + window - 1);
+        if (right - left + 1 < window && left > 0) left = qMax(0, right - window + 1);
+        double maxDist = qAbs(data[right].x() - data[left].x());
+        if (maxDist == 0) maxDist = 1e-12;
+        double Sw = 0, Swx = 0, Swy = 0, Swxx = 0, Swxy = 0;
+        for (int j = left; j <= right; ++j) {
+            const double d = qAbs(data[j].x() - xi) / maxDist;
+            const double w = d >= 1.0 ? 0.0 : qPow(1 - d * d * d, 3);
+            const double x = data[j].x(), y = data[j].y();
+            Sw += w; Swx += w * x; Swy += w * y; Swxx += w * x * x; Swxy += w * x * y;
+        }
+        const double denom = Sw * Swxx - Swx * Swx;
+        double a = Swy / Sw, b = 0;
+        if (qAbs(denom) > 1e-12) {
+            b = (Sw * Swxy - Swx * Swy) / denom;
+            a = (Swy - b * Swx) / Sw;
+        }
+        result.append(QPointF(xi, a + b * xi));
+    }
+    return result;
+}
+
+// 合成色谱类曲线：基线漂移 + 若干高斯峰 + 高频扰动；jitter > 0 时 X 非等间距
+static QVector<QPointF> syntheticChromatogram(int n, double jitter)
+{
+    QVector<QPointF> pts(n);
+    for (int i = 0; i < n; ++i) {
+        const double x = i * 0.01 + jitter * std::sin(i * 1.3);
+        const double y = 5.0 * std::sin(x * 0.1)
+                       + 100.0 * std::exp(-std::pow((x - 40.0) / 3.0, 2))
+                       + 40.0 * std::exp(-std::pow((x - 75.0) / 1.5, 2))
+                       + 0.3 * std::sin(i * 0.7);
+        pts[i] = QPointF(x, y);
+    }
+    return pts;
+}
+
+static double maxAbsDiffY(const QVector<QPointF>& a, const QVector<QPointF>& b)
+{
+    if (a.size() != b.size()) return 1e100;
+    double m = 0.0;
+    for (int i = 0; i < a.size(); ++i) m = qMax(m, std::fabs(a[i].y() - b[i].y()));
+    return m;
+}
+
+static double maxAbsY(const QVector<QPointF>& a)
+{
+    double m = 0.0;
+    for (const QPointF& p : a) m = qMax(m, std::fabs(p.y()));
+    return m;
+}
+
+static void testLoess()
+{
+    std::printf("== LOESS ==\n");
+
+    // 与原实现容差对比：等间距（卷积核路径）与非等间距（逐点路径）
+    const double spans[] = {0.2, 0.05, 0.01};
+    for (int jittered = 0; jittered < 2; ++jittered) {
+        const QVector<QPointF> data = syntheticChromatogram(jittered ? 3000 : 11630, jittered ? 0.004 : 0.0);
+        for (double f : spans) {
+            const QVector<QPointF> ref = legacyLoess(data, f);
+            const double e = maxAbsDiffY(LoessEngine::smooth(data, f), ref) / maxAbsY(ref);
+            char label[128];
+            std::snprintf(label, sizeof(label), "LOESS %s n=%d span=%.2f vs legacy (rel %.2e)",
+                          jittered ? "non-uniform" : "uniform", data.size(), f, e);
+            check(e < 1e-6, label);
+        }
+    }
+
+    // 处理步骤走同一引擎
+    {
+        const QVector<QPointF> data = syntheticChromatogram(2000, 0.0);
+        const CurveValue in(data, "in");
+        Loess loess;
+        QVariantMap params;
+        params["fraction"] = 0.1;
+        QString error;
+        ProcessingResult res = loess.process({in}, params, error);
+        const QList<CurveValue> out = res.namedCurves.value("smoothed");
+        check(out.size() == 1 && maxAbsDiffY(out.first().points(), legacyLoess(data, 0.1)) / maxAbsY(data) < 1e-6,
+              "Loess::process matches legacy");
+    }
+
+    // 稳健迭代：直线上的单个离群点被抑制
+    {
+        QVector<QPointF> line(500);
+        for (int i = 0; i < line.size(); ++i) line[i] = QPointF(i, 0.01 * i + (i == 250 ? 50.0 : 0.0));
+        const double plain = LoessEngine::smooth(line, 0.1)[250].y();
+        const double robust = LoessEngine::smooth(line, 0.1, 3)[250].y();
+        check(std::fabs(plain - 2.5) > 0.5 && std::fabs(robust - 2.5) < 1e-6, "robust iterations suppress outlier");
+    }
+
+    // 批量：共享 X 的多条曲线与逐条结果一致
+    {
+        const QVector<QPointF> data = syntheticChromatogram(5000, 0.0);
+        QVector<double> x(data.size()), y(data.size()), y2(data.size());
+        for (int i = 0; i < data.size(); ++i) {
+            x[i] = data[i].x();
+            y[i] = data[i].y();
+            y2[i] = 0.5 * data[i].y() + 1.0;
+        }
+        LoessEngine::Options options;
+        options.fraction = 0.05;
+        const QList<QVector<double>> batch = LoessEngine::smoothBatch(x, {y, y2}, options);
+        check(batch.size() == 2 && batch[0] == LoessEngine::smooth(x, y, options)
+              && batch[1] == LoessEngine::smooth(x, y2, options), "smoothBatch matches per-curve smooth");
+    }
+
+    if (!g_benchmark) return;
+
+    // 微基准：11630 点（色谱典型长度），span=0.2
+    const QVector<QPointF> data = syntheticChromatogram(11630, 0.0);
+    const int reps = 3;
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < reps; ++r) legacyLoess(data, 0.2);
+    const double legacyMs = timer.nsecsElapsed() / 1e6 / reps;
+    timer.restart();
+    for (int r = 0; r < reps; ++r) LoessEngine::smooth(data, 0.2);
+    const double engineMs = timer.nsecsElapsed() / 1e6 / reps;
+    reportTiming("LOESS 11630 points, span=0.2: legacy %.1f ms, engine %.1f ms\n", legacyMs, engineMs);
+}
+
+// ==== airPLS：原实现（QVector<QVector<double>> 带状存储，每次迭代完整 Cholesky）====
+static QVector<double> legacyAirPls(const QVector<double>& y, double lambda, int order, double wep, double p, int itermax)
+{
+    const int n = y.size();
+    QVector<double> coeffs(order + 1);
+    for (int k = 0; k <= order; ++k) {
+        double c = 1.0;
+        for (int i = 1; i <= k; ++i) c = c * (order - (k - i)) / i;
+        coeffs[k] = ((order - k) % 2 == 0 ? 1.0 : -1.0) * c;
+    }
+    QVector<QVector<double>> dd(order + 1, QVector<double>(n, 0.0));
+    for (int j = 0; j < n - order; ++j)
+        for (int k = 0; k <= order; ++k)
+            for (int l = 0; l <= k; ++l) dd[k - l][j + k] += lambda * coeffs[k] * coeffs[l];
+
+    QVector<double> weights(n, 1.0), baseline(n, 0.0);
+    double sumAbsY = 0.0;
+    for (double v : y) sumAbsY += std::abs(v);
+    if (sumAbsY <= 0.0) sumAbsY = 1.0;
+    const int startCount = qCeil(n * wep);
+    const int endStart = static_cast<int>(std::floor(n - n * wep));
+
+    for (int iter = 1; iter <= itermax; ++iter) {
+        QVector<QVector<double>> band = dd;
+        for (int i = 0; i < n; ++i) band[0][i] += weights[i];
+        for (int i = 0; i < n; ++i) { // 带状 Cholesky
+            for (int j = qMax(0, i - order); j <= i; ++j) {
+                double sum = 0.0;
+                for (int k = qMax(0, i - order); k < j; ++k) sum += band[i - k][i] * band[j - k][j];
+                const double v = band[i - j][i] - sum;
+                if (i == j) band[0][i] = std::sqrt(v);
+                else band[i - j][i] = v / band[0][j];
+            }
+        }
+        QVector<double> z(n);
+        for (int i = 0; i < n; ++i) {
+            double sum = 0.0;
+            for (int k = qMax(0, i - order); k < i; ++k) sum += band[i - k][i] * z[k];
+            z[i] = (weights[i] * y[i] - sum) / band[0][i];
+        }
+        for (int i = n - 1; i >= 0; --i) {
+            double sum = 0.0;
+            for (int k = i + 1; k <= qMin(n - 1, i + order); ++k) sum += band[k - i][k] * baseline[k];
+            baseline[i] = (z[i] - sum) / band[0][i];
+        }
+
+        double dssn = 0.0;
+        for (int i = 0; i < n; ++i) dssn += qMax(0.0, baseline[i] - y[i]);
+        if (dssn < 0.001 * sumAbsY) break;
+        for (int i = 0; i < n; ++i) if (y[i] - baseline[i] >= 0.0) weights[i] = 0.0;
+        for (int i = 0; i < startCount; ++i) weights[i] = p;
+        for (int i = qBound(0, endStart, n); i < n; ++i) weights[i] = p;
+        for (int i = 0; i < n; ++i) {
+            const double r = y[i] - baseline[i];
+            if (r < 0.0) weights[i] = std::exp(iter * std::abs(r) / dssn);
+        }
+    }
+    return baseline;
+}
+
+static void testAirPls()
+{
+    std::printf("== airPLS ==\n");
+
+    // 8 条等长色谱类曲线（峰位、漂移各不相同）
+    QList<QVector<double>> ys;
+    for (int k = 0; k < 8; ++k) {
+        const QVector<QPointF> pts = syntheticChromatogram(11630, 0.0);
+        QVector<double> y(pts.size());
+        for (int i = 0; i < pts.size(); ++i)
+            y[i] = pts[i].y() + 20.0 + 0.1 * (1.0 + 0.1 * k) * pts[i].x() + 3.0 * std::sin(pts[i].x() * 0.05 + k);
+        ys.append(y);
+    }
+
+    for (int order = 1; order <= 4; ++order) {
+        AirPlsSolver::Params params;
+        params.order = order;
+        params.lambda = 1e5;
+        params.wep = 0.1;
+        const QVector<double> ref = legacyAirPls(ys.first(), params.lambda, order, params.wep, params.p, params.itermax);
+        const double e = maxAbsDiff(AirPlsSolver::solve(ys.first(), params), ref) / maxAbs(ref);
+        char label[128];
+        std::snprintf(label, sizeof(label), "airPLS order=%d vs legacy (rel %.2e)", order, e);
+        check(e < 1e-6, label);
+    }
+
+    // 批量（按 4 条交错求解 + 并行）与逐条结果逐位一致，含不足 4 条的余数与不同长度
+    {
+        AirPlsSolver::Params params;
+        params.wep = 0.1;
+        QList<QVector<double>> mixed = ys;
+        mixed.append(ys.first().mid(0, 5000));
+        const QList<QVector<double>> batch = AirPlsSolver::solveBatch(mixed, params);
+        bool same = batch.size() == mixed.size();
+        for (int k = 0; same && k < mixed.size(); ++k) same = batch[k] == AirPlsSolver::solve(mixed[k], params);
+        check(same, "solveBatch bit-identical to per-curve solve");
+    }
+
+    // 处理步骤：输出基线与校正曲线
+    {
+        const QVector<QPointF> pts = syntheticChromatogram(3000, 0.0);
+        const CurveValue in(pts, "in");
+        BaselineCorrector corrector;
+        QString error;
+        ProcessingResult res = corrector.process({in}, corrector.defaultParameters(), error);
+        const QList<CurveValue> baseline = res.namedCurves.value("baseline");
+        const QList<CurveValue> corrected = res.namedCurves.value("baseline_corrected");
+        check(baseline.size() == 1 && corrected.size() == 1 && baseline.first().pointCount() == pts.size(),
+              "BaselineCorrector::process outputs baseline and corrected curves");
+    }
+
+    if (!g_benchmark) return;
+
+    // 微基准：8 条 11630 点曲线（order=2, lambda=1e5）
+    AirPlsSolver::Params params;
+    params.wep = 0.1;
+    QElapsedTimer timer;
+    timer.start();
+    for (const QVector<double>& y : ys) legacyAirPls(y, params.lambda, params.order, params.wep, params.p, params.itermax);
+    const double legacyMs = timer.nsecsElapsed() / 1e6;
+    timer.restart();
+    for (const QVector<double>& y : ys) AirPlsSolver::solve(y, params);
+    const double singleMs = timer.nsecsElapsed() / 1e6;
+    timer.restart();
+    AirPlsSolver::solveBatch(ys, params);
+    const double batchMs = timer.nsecsElapsed() / 1e6;
+    reportTiming("airPLS 8 x 11630 points: legacy %.1f ms, per-curve %.1f ms, batch %.1f ms\n", legacyMs, singleMs, batchMs);
+}
+
+static void testCurveStorage()
+{
+    std::printf("== Curve storage ==\n");
+
+    const QVector<QPointF> pts = syntheticCurve(2000);
+    QVector<double> x(pts.size()), y(pts.size());
+    for (int i = 0; i < pts.size(); ++i) {
+        x[i] = pts[i].x();
+        y[i] = pts[i].y();
+    }
+
+    Curve c(x, y, "columns");
+    check(c.xData() == x.constData() && c.yData() == y.constData(), "setData(x, y) shares the column buffers");
+    check(c.data() == pts, "data() shim reproduces the points");
+
+    const QSharedPointer<QCPGraphDataContainer> container = c.getDataContainer();
+    bool sameContainer = !container.isNull() && container->size() == pts.size()
+                         && c.getDataContainer() == container;
+    for (int i = 0; sameContainer && i < pts.size(); ++i)
+        sameContainer = container->at(i)->key == x[i] && container->at(i)->value == y[i];
+    check(sameContainer, "getDataContainer() is built once and matches the columns");
+
+    Curve copy(c);
+    check(copy.xData() == c.xData(), "copy shares the column buffers");
+
+    QVector<double> y2 = y;
+    y2[10] += 1.0;
+    c.setData(x, y2);
+    check(c.getDataContainer() != container && c.getDataContainer()->at(10)->value == y2[10]
+              && c.data()[10].y() == y2[10] && container->at(10)->value == y[10],
+          "setData invalidates cached views without touching handed-out containers");
+
+    Curve fromPoints(pts, "points");
+    check(fromPoints.xValues() == x && fromPoints.yValues() == y && fromPoints.pointCount() == pts.size(),
+          "QPointF constructor fills the columns");
+}
+
+static void testStageCurve()
+{
+    std::printf("== StageCurve ==\n");
+
+    const QVector<QPointF> pts = syntheticCurve(1000);
+    const CurveValue raw(pts, "raw");
+
+    StageCurve stage(raw);
+    check(!stage.isNull() && !stage.isMaterialized() && stage.value().xData() == raw.xData(),
+          "StageCurve stores the value without creating a Curve");
+    StageCurve copy = stage;
+    const QSharedPointer<Curve> curve = copy;
+    check(stage.isMaterialized() && stage.data() == curve.data() && curve->xData() == raw.xData(),
+          "first UI access materializes one shared Curve over the same columns");
+    curve->setName("renamed");
+    check(stage.value().name() == "renamed", "value() follows the materialized Curve");
+    check(StageCurve(QSharedPointer<Curve>()).isNull(), "null Curve pointer gives a null StageCurve");
+
+    // 微基准：100 个样本 x 5 个阶段（每阶段一次 SG），值类型阶段 vs 每阶段生成 Curve
+    const int sampleCount = 100;
+    const int stageCount = 5;
+    SavitzkyGolay sg;
+    QVariantMap params;
+    params["window_size"] = 11;
+    params["poly_order"] = 2;
+    params["outputs"] = "smoothed";
+    QString error;
+
+    QElapsedTimer timer;
+    timer.start();
+    QList<QList<QSharedPointer<Curve>>> legacyStages;
+    for (int s = 0; s < sampleCount; ++s) {
+        QList<QSharedPointer<Curve>> stages;
+        QSharedPointer<Curve> current = QSharedPointer<Curve>::create(pts, "raw");
+        stages.append(current);
+        for (int k = 1; k < stageCount; ++k) {
+            ProcessingResult res = sg.process({current->toCurveValue()}, params, error);
+            current = QSharedPointer<Curve>::create(res.namedCurves.value("smoothed").first());
+            current->setSampleId(s);
+            stages.append(current);
+        }
+        legacyStages.append(stages);
+    }
+    const double curveMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    QList<QList<StageCurve>> valueStages;
+    for (int s = 0; s < sampleCount; ++s) {
+        QList<StageCurve> stages;
+        CurveValue current(pts, "raw");
+        stages.append(StageCurve(current));
+        for (int k = 1; k < stageCount; ++k) {
+            ProcessingResult res = sg.process({current}, params, error);
+            current = res.namedCurves.value("smoothed").first();
+            current.setSampleId(s);
+            stages.append(StageCurve(current));
+        }
+        valueStages.append(stages);
+    }
+    const double valueMs = timer.nsecsElapsed() / 1e6;
+
+    bool lazy = true;
+    bool same = true;
+    for (int s = 0; s < sampleCount; ++s) {
+        for (int k = 0; k < stageCount; ++k) {
+            lazy = lazy && !valueStages[s][k].isMaterialized();
+            same = same && valueStages[s][k].value().yValues() == legacyStages[s][k]->yValues();
+        }
+    }
+    check(lazy, "pipeline stages stay unmaterialized");
+    check(same, "value-type stages match Curve-per-stage results");
+    reportTiming("100 samples x 5 stages: Curve per stage %.1f ms, CurveValue %.1f ms\n", curveMs, valueMs);
+}
+
+static StageData cacheStage(StageName name, const CurveValue& value)
+{
+    StageData stage;
+    stage.stageName = name;
+    stage.algorithm = AlgorithmType::None;
+    stage.curve = value;
+    return stage;
+}
+
+static void testStageCache()
+{
+    std::printf("== StageCache ==\n");
+
+    const CurveValue raw(syntheticCurve(1000), "raw");
+    const CurveValue smoothed(raw.xValues(), raw.yValues(), "smoothed");
+    QVariantMap smoothParams;
+    smoothParams["fraction"] = 0.1;
+
+    StageCache cache;
+    {
+        // 首次运行：全部未命中，逐阶段写入
+        StageCache::Chain chain(&cache, DataType::TG_BIG, 7);
+        SampleDataFlexible sample;
+        StageData stage;
+        CurveValue current;
+        check(!chain.restore("raw", QVariantMap(), stage, sample, current), "cold cache misses the raw stage");
+        chain.store(cacheStage(StageName::RawData, raw));
+        check(!chain.restore("smoothing_loess", smoothParams, stage, sample, current), "cold cache misses the smoothing stage");
+        chain.store(cacheStage(StageName::Smooth, smoothed));
+    }
+    {
+        // 参数不变：两个阶段都命中，结果写入样本与接力棒
+        StageCache::Chain chain(&cache, DataType::TG_BIG, 7);
+        SampleDataFlexible sample;
+        StageData stage;
+        CurveValue current;
+        const bool rawHit = chain.restore("raw", QVariantMap(), stage, sample, current);
+        const bool smoothHit = chain.restore("smoothing_loess", smoothParams, stage, sample, current);
+        check(rawHit && smoothHit && sample.stages.size() == 2 && current.name() == "smoothed"
+                  && current.xData() == raw.xData(),
+              "unchanged parameters hit every stage without copying columns");
+
+        // 界面修改取回的 Curve 不影响缓存
+        sample.stages[1].curve->setName("edited");
+    }
+    {
+        // 只改平滑参数：原始阶段命中，平滑阶段未命中
+        QVariantMap changed = smoothParams;
+        changed["fraction"] = 0.2;
+        StageCache::Chain chain(&cache, DataType::TG_BIG, 7);
+        SampleDataFlexible sample;
+        StageData stage;
+        CurveValue current;
+        const bool rawHit = chain.restore("raw", QVariantMap(), stage, sample, current);
+        const bool smoothHit = chain.restore("smoothing_loess", changed, stage, sample, current);
+        check(rawHit && !smoothHit, "changed parameter recomputes only from that stage on");
+    }
+    {
+        StageCache::Chain chain(&cache, DataType::TG_BIG, 7);
+        SampleDataFlexible sample;
+        StageData stage;
+        CurveValue current;
+        chain.restore("raw", QVariantMap(), stage, sample, current);
+        chain.restore("smoothing_loess", smoothParams, stage, sample, current);
+        check(current.name() == "smoothed" && !stage.curve.isMaterialized(),
+              "cached stage is isolated from UI edits");
+    }
+    check(StageCache::Chain(&cache, DataType::TG_BIG, 7).contains("raw")
+              && !StageCache::Chain(&cache, DataType::CHROMATOGRAM, 7).contains("raw"),
+          "keys include the data type");
+
+    cache.invalidateSample(7);
+    check(!StageCache::Chain(&cache, DataType::TG_BIG, 7).contains("raw"), "invalidateSample drops the sample's stages");
+
+    // 内存预算：每条 1000 点曲线约 16 KB，预算 64 KB 时最多保留 4 条
+    cache.setBudget(64 * 1024);
+    const StageCache::Stats before = cache.stats();
+    for (int id = 0; id < 10; ++id) {
+        StageCache::Chain chain(&cache, DataType::TG_BIG, id);
+        SampleDataFlexible sample;
+        StageData stage;
+        CurveValue current;
+        chain.restore("raw", QVariantMap(), stage, sample, current);
+        chain.store(cacheStage(StageName::RawData, raw));
+    }
+    const StageCache::Stats after = cache.stats();
+    check(after.entries <= 4 && after.usedBytes <= after.budgetBytes && after.evictions - before.evictions >= 6,
+          "budget evicts least recently used stages");
+    check(StageCache::Chain(&cache, DataType::TG_BIG, 9).contains("raw")
+              && !StageCache::Chain(&cache, DataType::TG_BIG, 0).contains("raw"),
+          "most recent stages survive eviction");
+    std::printf("stage cache: %lld hits, %lld misses, %lld evictions, %d entries, %lld KB\n",
+                static_cast<long long>(after.hits), static_cast<long long>(after.misses),
+                static_cast<long long>(after.evictions), after.entries, static_cast<long long>(after.usedBytes / 1024));
+
+    // 失效某个样本不改变其余条目的最近使用顺序：此时缓存内为 6..9（6 最久未用）
+    cache.invalidateSample(8);
+    for (int id = 100; id < 102; ++id) {
+        StageCache::Chain chain(&cache, DataType::TG_BIG, id);
+        SampleDataFlexible sample;
+        StageData stage;
+        CurveValue current;
+        chain.restore("raw", QVariantMap(), stage, sample, current);
+        chain.store(cacheStage(StageName::RawData, raw));
+    }
+    check(!StageCache::Chain(&cache, DataType::TG_BIG, 6).contains("raw")
+              && StageCache::Chain(&cache, DataType::TG_BIG, 7).contains("raw")
+              && StageCache::Chain(&cache, DataType::TG_BIG, 9).contains("raw"),
+          "invalidateSample keeps the LRU order of other samples");
+}
+
+// ==== 差异度融合内核 ====
+static void testCurveMetricsKernel()
+{
+    std::printf("== CurveMetricsKernel ==\n");
+
+    // 1 条参考 + 50 条对比曲线（幅度/相位扰动），11630 点
+    const int n = 11630;
+    const int curveCount = 50;
+    const QVector<QPointF> refPts = syntheticChromatogram(n, 0.0);
+    const Curve reference(refPts, "ref");
+    QList<QSharedPointer<Curve>> curves;
+    QVector<QVector<double>> columns;
+    for (int k = 0; k < curveCount; ++k) {
+        QVector<QPointF> pts = refPts;
+        for (int i = 0; i < n; ++i) pts[i].setY(pts[i].y() * (1.0 + 0.002 * k) + 0.05 * k * std::sin(i * 0.01 + k));
+        curves.append(QSharedPointer<Curve>::create(pts, QString("c%1").arg(k)));
+        columns.append(curves.last()->yValues());
+    }
+
+    Nrmse nrmse;
+    PlainRmse plainRmse;
+    Pearson pearson;
+    Euclidean euclidean;
+
+    QElapsedTimer timer;
+    timer.start();
+    QVector<CurveMetricsKernel::PairMetrics> legacy(curveCount);
+    for (int k = 0; k < curveCount; ++k) {
+        legacy[k].nrmse = nrmse.calculateDifference(reference, *curves[k], {});
+        legacy[k].rmse = plainRmse.calculateDifference(reference, *curves[k], {});
+        legacy[k].pearson = pearson.calculateDifference(reference, *curves[k], {});
+        legacy[k].euclidean = euclidean.calculateDifference(reference, *curves[k], {});
+    }
+    const double legacyMs = timer.nsecsElapsed() / 1e6;
+
+    timer.restart();
+    const QVector<CurveMetricsKernel::PairMetrics> fused =
+        CurveMetricsKernel::compareOneToMany(reference.yValues(), columns);
+    const double fusedMs = timer.nsecsElapsed() / 1e6;
+
+    auto rel = [](double a, double b) { return std::fabs(a - b) / qMax(1e-300, qMax(std::fabs(a), std::fabs(b))); };
+    double worst = 0.0;
+    bool allValid = true;
+    for (int k = 0; k < curveCount; ++k) {
+        allValid = allValid && fused[k].valid;
+        // k = 0 为自比：距离为 0，相关系数为 1
+        worst = qMax(worst, std::fabs(fused[k].nrmse - legacy[k].nrmse) > 1e-15 ? rel(fused[k].nrmse, legacy[k].nrmse) : 0.0);
+        worst = qMax(worst, std::fabs(fused[k].rmse - legacy[k].rmse) > 1e-15 ? rel(fused[k].rmse, legacy[k].rmse) : 0.0);
+        worst = qMax(worst, rel(fused[k].pearson, legacy[k].pearson));
+        worst = qMax(worst, std::fabs(fused[k].euclidean - legacy[k].euclidean) > 1e-15 ? rel(fused[k].euclidean, legacy[k].euclidean) : 0.0);
+    }
+    check(allValid, "fused kernel accepts equal-length curves");
+    check(worst < 1e-9, "fused NRMSE/RMSE/Pearson/Euclidean match the strategies");
+
+    // 长度不一致 / 过短：与策略一样返回 -1
+    const QVector<CurveMetricsKernel::PairMetrics> bad =
+        CurveMetricsKernel::compareOneToMany(reference.yValues(), {columns[1].mid(0, n - 1), QVector<double>()});
+    check(!bad[0].valid && bad[0].nrmse == -1.0 && bad[0].pearson == -1.0 && !bad[1].valid,
+          "length mismatch and empty curves are reported as invalid");
+    const QVector<double> one{1.0};
+    const CurveMetricsKernel::CurveStats oneStats = CurveMetricsKernel::computeStats(one);
+    const CurveMetricsKernel::PairMetrics single = CurveMetricsKernel::compare(one.constData(), oneStats, one.constData(), oneStats, 1);
+    check(single.valid && single.pearson == -1.0 && single.nrmse == 0.0, "single point: Pearson undefined, NRMSE 0");
+
+    // 多对多：与逐对 compare 一致，下标按上三角行主序
+    const QVector<QVector<double>> few = columns.mid(0, 6);
+    const QVector<CurveMetricsKernel::PairMetrics> all = CurveMetricsKernel::compareAllPairs(few);
+    bool pairsOk = (all.size() == 15);
+    for (int i = 0; i < few.size() && pairsOk; ++i) {
+        for (int j = i + 1; j < few.size(); ++j) {
+            const CurveMetricsKernel::PairMetrics one2one = CurveMetricsKernel::compareOneToMany(few[i], {few[j]}).first();
+            const CurveMetricsKernel::PairMetrics& m = all[CurveMetricsKernel::pairIndex(i, j, few.size())];
+            pairsOk = pairsOk && m.rmse == one2one.rmse && m.pearson == one2one.pearson;
+        }
+    }
+    check(pairsOk, "all-pairs results match one-to-many and pairIndex layout");
+
+    QMap<QString, double> scores;
+    CurveMetricsKernel::toScores(fused[3], scores);
+    check(scores.value("nrmse") == fused[3].nrmse && scores.value("plain_rmse") == fused[3].rmse
+              && scores.value("pearson") == fused[3].pearson && scores.value("euclidean") == fused[3].euclidean,
+          "scores use the strategy algorithm ids");
+
+    reportTiming("1 x %d curves (%d pts): 4 strategies %.2f ms, fused kernel %.2f ms\n", curveCount, n, legacyMs, fusedMs);
+}
+
+static void testSimilarityMatrix()
+{
+    std::printf("== SimilarityMatrix ==\n");
+
+    // 正确性：与逐对融合内核一致（含一条空曲线与一条较长曲线，按公共最短长度截断）
+    const int n = 2000;
+    const QVector<QPointF> base = syntheticChromatogram(n, 0.0);
+    auto makeColumns = [&](int count) {
+        QVector<QVector<double>> columns;
+        columns.reserve(count);
+        for (int k = 0; k < count; ++k) {
+            QVector<double> y(n);
+            for (int i = 0; i < n; ++i) y[i] = base[i].y() * (1.0 + 0.001 * (k % 37)) + 0.02 * k * std::sin(i * 0.013 + k);
+            columns.append(y);
+        }
+        return columns;
+    };
+
+    QVector<QVector<double>> columns = makeColumns(40);
+    columns[7].append(1.0e6);          // 比其他曲线多 1 点：被截断
+    columns[11] = QVector<double>();   // 空曲线：与任何曲线都无效
+    SimilarityMatrixEngine::Options small;
+    small.tileSize = 8;                // 40 条曲线跨 5 个分块，覆盖块对角与非对角
+    const SimilarityMatrix matrix = SimilarityMatrixEngine::compute(columns, small);
+
+    QVector<QVector<double>> truncated = columns;
+    for (QVector<double>& y : truncated) if (!y.isEmpty()) y.resize(n);
+    const QVector<CurveMetricsKernel::PairMetrics> reference = CurveMetricsKernel::compareAllPairs(truncated);
+
+    bool sameAsKernel = (matrix.size() == 40 && matrix.pointCount() == n);
+    for (int i = 0; i < columns.size() && sameAsKernel; ++i) {
+        for (int j = 0; j < columns.size(); ++j) {
+            if (i == j) continue;
+            const CurveMetricsKernel::PairMetrics& m = reference[CurveMetricsKernel::pairIndex(qMin(i, j), qMax(i, j), columns.size())];
+            if (m.valid != matrix.isValid(i, j)) { sameAsKernel = false; break; }
+            if (!m.valid) continue;
+            const double nrmse = matrix.value(SimilarityMatrix::Metric::Nrmse, i, j);
+            const double expectedNrmse = CurveMetricsKernel::compareOneToMany(truncated[i], {truncated[j]}).first().nrmse;
+            sameAsKernel = matrix.value(SimilarityMatrix::Metric::Rmse, i, j) == m.rmse
+                           && matrix.value(SimilarityMatrix::Metric::Pearson, i, j) == m.pearson
+                           && std::fabs(matrix.value(SimilarityMatrix::Metric::Euclidean, i, j) - m.euclidean) <= 1e-9 * qMax(1.0, m.euclidean)
+                           && std::fabs(nrmse - expectedNrmse) <= 1e-12 * qMax(1.0, expectedNrmse);
+            if (!sameAsKernel) break;
+        }
+    }
+    check(sameAsKernel, "matrix matches per-pair kernel (symmetric, truncated, empty curve invalid)");
+    check(matrix.value(SimilarityMatrix::Metric::Rmse, 3, 3) == 0.0 && matrix.value(SimilarityMatrix::Metric::Pearson, 3, 3) == 1.0
+              && !matrix.isValid(11, 11),
+          "diagonal: distance 0, Pearson 1; empty curve invalid");
+
+    // top-k：与全排序一致，按相似程度排列且不含自身
+    bool topKOk = true;
+    for (SimilarityMatrix::Metric metric : {SimilarityMatrix::Metric::Rmse, SimilarityMatrix::Metric::Pearson}) {
+        const QVector<SimilarityMatrix::Neighbor> top = matrix.nearest(5, 4, metric);
+        QVector<SimilarityMatrix::Neighbor> all = matrix.nearest(5, columns.size(), metric);
+        topKOk = topKOk && top.size() == 4 && all.size() == columns.size() - 2;
+        for (int k = 0; k < top.size() && topKOk; ++k) {
+            topKOk = top[k].index == all[k].index && top[k].index != 5 && top[k].index != 11;
+            if (k > 0) {
+                topKOk = topKOk && (SimilarityMatrix::higherIsCloser(metric) ? top[k - 1].value >= top[k].value
+                                                                              : top[k - 1].value <= top[k].value);
+            }
+        }
+    }
+    check(topKOk, "nearest() returns ordered top-k without self or invalid pairs");
+
+    // 结果与线程数无关
+    SimilarityMatrixEngine::Options serial = small;
+    serial.parallel = false;
+    const SimilarityMatrix serialMatrix = SimilarityMatrixEngine::compute(columns, serial);
+    bool deterministic = true;
+    for (int i = 0; i < columns.size() && deterministic; ++i)
+        for (int j = i + 1; j < columns.size(); ++j)
+            deterministic = deterministic && serialMatrix.value(SimilarityMatrix::Metric::Rmse, i, j) == matrix.value(SimilarityMatrix::Metric::Rmse, i, j)
+                            && serialMatrix.value(SimilarityMatrix::Metric::Pearson, i, j) == matrix.value(SimilarityMatrix::Metric::Pearson, i, j);
+    check(deterministic, "parallel and serial matrices are identical");
+
+    // 规模：N = 10 / 100 / 1000，串行 vs 线程池
+    QElapsedTimer timer;
+    for (int count : {10, 100, 1000}) {
+        const QVector<QVector<double>> batch = makeColumns(count);
+        SimilarityMatrixEngine::Options serialOptions;
+        serialOptions.parallel = false;
+        timer.start();
+        const SimilarityMatrix s = SimilarityMatrixEngine::compute(batch, serialOptions);
+        const double serialMs = timer.nsecsElapsed() / 1e6;
+        timer.restart();
+        const SimilarityMatrix p = SimilarityMatrixEngine::compute(batch);
+        const double parallelMs = timer.nsecsElapsed() / 1e6;
+        check(s.size() == count && p.value(SimilarityMatrix::Metric::Rmse, 0, count - 1) == s.value(SimilarityMatrix::Metric::Rmse, 0, count - 1),
+              "batch matrix consistent across thread counts");
+        reportTiming("N=%d (%d pts, %d pairs): serial %.2f ms, parallel %.2f ms (%d threads)\n",
+                     count, n, count * (count - 1) / 2, serialMs, parallelMs, QThreadPool::globalInstance()->maxThreadCount());
+    }
+}
+
+static void testCurveLodPyramid()
+{
+    std::printf("== CurveLodPyramid ==\n");
+
+    // 正确性：每级每桶保留的点 = 原始数据对应区间的最小/最大值（含 NaN 段）
+    const int n = 11630;
+    const QVector<QPointF> base = syntheticChromatogram(n, 0.0);
+    auto makeContainer = [&](double scale) {
+        QVector<QCPGraphData> points(n);
+        for (int i = 0; i < n; ++i) points[i] = QCPGraphData(base[i].x(), base[i].y() * scale);
+        for (int i = 5000; i < 5100; ++i) points[i].value = std::numeric_limits<double>::quiet_NaN();
+        auto container = QSharedPointer<QCPGraphDataContainer>::create();
+        container->set(points, true);
+        return container;
+    };
+    const QSharedPointer<QCPGraphDataContainer> full = makeContainer(1.0);
+    const CurveLodPyramid pyramid(full);
+    check(pyramid.levelCount() > 2 && pyramid.fullData() == full, "pyramid has several levels, level 0 is the shared full data");
+
+    bool envelopeOk = true;
+    for (int level = 1; level < pyramid.levelCount() && envelopeOk; ++level) {
+        const int bucket = CurveLodPyramid::bucketSize(level);
+        const QSharedPointer<QCPGraphDataContainer> decimated = pyramid.level(level);
+        // 每桶 1~2 个点，逐桶对照原始数据的极值
+        for (int b = 0, p = 0; b * bucket < n && envelopeOk; ++b) {
+            const int end = qMin(n, (b + 1) * bucket);
+            double lo = std::numeric_limits<double>::max(), hi = -std::numeric_limits<double>::max();
+            for (int i = b * bucket; i < end; ++i) {
+                const double v = full->at(i)->value;
+                if (std::isnan(v)) continue;
+                lo = qMin(lo, v);
+                hi = qMax(hi, v);
+            }
+            const double bucketEndKey = (end < n) ? full->at(end)->key : std::numeric_limits<double>::max();
+            double gotLo = std::numeric_limits<double>::max(), gotHi = -std::numeric_limits<double>::max();
+            for (; p < decimated->size() && decimated->at(p)->key < bucketEndKey; ++p) {
+                const double v = decimated->at(p)->value;
+                if (std::isnan(v)) continue;
+                gotLo = qMin(gotLo, v);
+                gotHi = qMax(gotHi, v);
+            }
+            envelopeOk = (gotLo == lo && gotHi == hi);
+        }
+        envelopeOk = envelopeOk && decimated->size() <= 2 * ((n + bucket - 1) / bucket);
+    }
+    check(envelopeOk, "every bucket keeps exactly the raw min/max of its range");
+
+    // 级别选择：全视野 1000 像素取粗级别；放大到几十个点时回到原始数据
+    const QCPRange all(full->constBegin()->key, (full->constEnd() - 1)->key);
+    const int coarse = pyramid.levelFor(all, 1000);
+    const double span = all.upper - all.lower;
+    const QCPRange zoomed(all.lower + span * 0.5, all.lower + span * 0.5 + span * 40.0 / n);
+    const double pointsPerPixel = double(n) / 1000;
+    check(coarse > 0 && CurveLodPyramid::bucketSize(coarse) <= pointsPerPixel
+              && (coarse == pyramid.levelCount() - 1 || CurveLodPyramid::bucketSize(coarse + 1) > pointsPerPixel),
+          "full view picks the coarsest level with >= 1 bucket per pixel");
+    check(pyramid.levelFor(zoomed, 1000) == 0 && pyramid.levelFor(all, 0) == 0, "zoomed view and zero width fall back to full data");
+
+    const QSharedPointer<QCPGraphDataContainer> tiny = QSharedPointer<QCPGraphDataContainer>::create();
+    tiny->add(QCPGraphData(0.0, 1.0));
+    check(CurveLodPyramid(tiny).levelCount() == 1, "small curve is not decimated");
+
+    if (!g_benchmark) return;
+
+    // 规模：100 条 × 11630 点，构建耗时与 1000 像素下每帧绘制点数
+    QVector<QSharedPointer<QCPGraphDataContainer>> curves;
+    for (int k = 0; k < 100; ++k) curves.append(makeContainer(1.0 + 0.001 * k));
+    QElapsedTimer timer;
+    timer.start();
+    qint64 drawnPoints = 0;
+    for (const QSharedPointer<QCPGraphDataContainer>& c : curves) {
+        const CurveLodPyramid p(c);
+        drawnPoints += p.level(p.levelFor(all, 1000))->size();
+    }
+    const double buildMs = timer.nsecsElapsed() / 1e6;
+    reportTiming("100 curves x %d pts: build %.2f ms, drawn points at 1000 px %lld (raw %d)\n",
+                 n, buildMs, static_cast<long long>(drawnPoints), 100 * n);
+}
+
+static void testCurveHitIndex()
+{
+    std::printf("== CurveHitIndex ==\n");
+
+    // 100 条 × 11630 点，映射到 1000×600 像素的坐标轴矩形
+    const int n = 11630;
+    const int curveCount = 100;
+    const QVector<QPointF> base = syntheticChromatogram(n, 0.0);
+    QVector<CurveHitIndex> indexes;
+    for (int k = 0; k < curveCount; ++k) {
+        QVector<QCPGraphData> points(n);
+        for (int i = 0; i < n; ++i) points[i] = QCPGraphData(base[i].x(), base[i].y() + 0.5 * k);
+        if (k == 3)
+            for (int i = 2000; i < 2100; ++i) points[i].value = std::numeric_limits<double>::quiet_NaN();
+        auto container = QSharedPointer<QCPGraphDataContainer>::create();
+        container->set(points, true);
+        indexes.append(CurveHitIndex(container, k % 10 != 9)); // 每 10 条有一条散点曲线
+    }
+    CurveHitIndex::Mapping mapping;
+    mapping.keyScale = 1000.0 / (base.last().x() - base.first().x());
+    mapping.keyOffset = 50.0 - mapping.keyScale * base.first().x();
+    mapping.valueScale = -600.0 / 200.0;
+    mapping.valueOffset = 650.0;
+
+    // 逐点逐线段的暴力最近距离
+    auto bruteForce = [&](const CurveHitIndex& index, const QPointF& p) {
+        const QSharedPointer<QCPGraphDataContainer> data = index.data();
+        double best = std::numeric_limits<double>::max();
+        for (int i = 0; i < data->size(); ++i) {
+            const QCPGraphData* a = data->at(i);
+            if (std::isnan(a->value)) continue;
+            const double ax = mapping.keyScale * a->key + mapping.keyOffset;
+            const double ay = mapping.valueScale * a->value + mapping.valueOffset;
+            best = qMin(best, std::hypot(ax - p.x(), ay - p.y()));
+            if (!index.connected() || i + 1 >= data->size() || std::isnan(data->at(i + 1)->value)) continue;
+            const double bx = mapping.keyScale * data->at(i + 1)->key + mapping.keyOffset;
+            const double by = mapping.valueScale * data->at(i + 1)->value + mapping.valueOffset;
+            const double dx = bx - ax, dy = by - ay;
+            const double t = qBound(0.0, ((p.x() - ax) * dx + (p.y() - ay) * dy) / (dx * dx + dy * dy), 1.0);
+            best = qMin(best, std::hypot(ax + t * dx - p.x(), ay + t * dy - p.y()));
+        }
+        return best;
+    };
+
+    const double tolerance = 12.0;
+    QVector<QPointF> probes;
+    for (int q = 0; q < 200; ++q) probes.append(QPointF(50.0 + std::fmod(q * 37.3, 1000.0), 50.0 + std::fmod(q * 53.9, 600.0)));
+    probes.append(QPointF(50.0 + 1000.0 * 20.5 / (base.last().x() - base.first().x()), 500.0)); // NaN 段附近
+
+    bool sameAsBruteForce = true;
+    int hits = 0;
+    for (const QPointF& p : probes) {
+        for (const CurveHitIndex& index : indexes) {
+            const double expected = bruteForce(index, p);
+            const double got = index.nearest(p, tolerance, mapping).distance;
+            if (expected <= tolerance) {
+                ++hits;
+                sameAsBruteForce = sameAsBruteForce && std::fabs(got - expected) <= 1e-9;
+            } else {
+                sameAsBruteForce = sameAsBruteForce && got < 0;
+            }
+        }
+    }
+    check(sameAsBruteForce && hits > 0, "indexed distance matches brute-force point/segment scan");
+
+    CurveHitIndex::Mapping zoomed = mapping; // 缩放只改变映射，索引不变
+    zoomed.keyScale *= 8.0;
+    zoomed.keyOffset = 50.0 - zoomed.keyScale * 40.0;
+    const CurveHitIndex::Hit zoomHit = indexes[0].nearest(QPointF(50.0, zoomed.valueScale * indexes[0].data()->findBegin(40.0, false)->value + zoomed.valueOffset),
+                                                          tolerance, zoomed);
+    check(zoomHit.distance >= 0 && zoomHit.pointDistance <= tolerance, "query after zoom uses the same index");
+
+    if (!g_benchmark) return;
+
+    // 规模：每次鼠标移动查询全部 100 条曲线
+    QElapsedTimer timer;
+    timer.start();
+    int found = 0;
+    for (const QPointF& p : probes)
+        for (const CurveHitIndex& index : indexes)
+            found += index.nearest(p, tolerance, mapping).distance >= 0 ? 1 : 0;
+    const double perMoveMs = timer.nsecsElapsed() / 1e6 / probes.size();
+    reportTiming("%d curves x %d pts: %.3f ms per mouse move (%d hits over %d moves)\n",
+                 curveCount, n, perMoveMs, found, probes.size());
+}
+
+// ==== 坏点检测：原 BadPointRepair 逐点复制窗口并两次排序 ====
+static QVector<bool> legacyOutlierMask(const QVector<double>& y, const HampelKernel::Options& o)
+{
+    const int n = y.size();
+    QVector<bool> bad(n, false);
+    auto windowMedian = [&](int i, int half, QVector<double>* sortedWindow) {
+        QVector<double> vals;
+        for (int k = qMax(0, i - half); k <= qMin(n - 1, i + half); ++k) vals.append(y[k]);
+        std::sort(vals.begin(), vals.end());
+        if (sortedWindow) *sortedWindow = vals;
+        return vals[vals.size() / 2];
+    };
+
+    int medianWin = qMax(o.window, qMax(3, (int)qRound(n / 10.0)));
+    if (medianWin % 2 == 0) medianWin += 1;
+    QVector<double> dev(n);
+    for (int i = 0; i < n; ++i) dev[i] = qAbs(y[i] - windowMedian(i, medianWin / 2, nullptr));
+    QVector<double> devAbs = dev;
+    std::sort(devAbs.begin(), devAbs.end());
+    double mad = 1.4826 * devAbs[n / 2];
+    if (mad < 1e-12) {
+        double mean = 0.0; for (double d : dev) mean += d; mean /= n;
+        double var = 0.0; for (double d : dev) var += (d - mean) * (d - mean); var /= qMax(1, n - 1);
+        mad = qMax(1e-9, std::sqrt(var));
+    }
+
+    for (int i = 0; i < n; ++i) {
+        if (dev[i] > o.globalNSigma * mad) bad[i] = true;
+
+        QVector<double> window;
+        const double med = windowMedian(i, o.window / 2, &window);
+        QVector<double> absdev;
+        for (double v : window) absdev.append(qAbs(v - med));
+        std::sort(absdev.begin(), absdev.end());
+        double sigma = 1.4826 * absdev[absdev.size() / 2];
+        if (sigma < 1e-12) sigma = 1e-6;
+        if (qAbs(y[i] - med) > o.nSigma * sigma) bad[i] = true;
+
+        if (i > 0 && qAbs(y[i] - y[i - 1]) > o.jumpThreshold) bad[i] = true;
+    }
+    return bad;
+}
+
+static void testHampelKernel()
+{
+    std::printf("== HampelKernel ==\n");
+
+    // 随机长度/窗口；含尖峰、跳变与大量重复值（量化数据）
+    quint32 seed = 12345;
+    auto next = [&seed]() { seed = seed * 1664525u + 1013904223u; return seed >> 8; };
+    bool identical = true;
+    for (int trial = 0; trial < 200; ++trial) {
+        const int n = 1 + int(next() % 500);
+        QVector<double> y(n);
+        for (int i = 0; i < n; ++i) {
+            y[i] = (trial % 3 == 0) ? double(next() % 5)
+                                    : 100.0 - 0.05 * i + std::sin(i * 0.3) + (next() % 1000) / 5000.0;
+            if (next() % 50 == 0) y[i] += (next() % 2) ? 30.0 : -30.0;
+        }
+        HampelKernel::Options o;
+        o.window = int(next() % 40);
+        o.nSigma = 3.0;
+        o.jumpThreshold = (trial % 2) ? 2.0 : 100.0;
+        identical = identical && HampelKernel::outlierMask(y, o) == legacyOutlierMask(y, o);
+    }
+    check(identical, "outlier mask identical to per-point sort implementation");
+
+    const QVector<double> ramp = {5, 1, 4, 2, 3};
+    check(HampelKernel::slidingMedian(ramp, 1) == QVector<double>({5, 4, 2, 3, 3}), "sliding median with truncated edges");
+
+    // 规模：工序大热重 20000 点，默认窗口
+    const int n = 20000;
+    QVector<double> y(n);
+    for (int i = 0; i < n; ++i) y[i] = 100.0 - 0.005 * i + std::sin(i * 0.01) + (next() % 1000) / 1e4;
+    HampelKernel::Options o;
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<bool> fast = HampelKernel::outlierMask(y, o);
+    const double fastMs = timer.nsecsElapsed() / 1e6;
+    timer.restart();
+    const QVector<bool> legacy = legacyOutlierMask(y, o);
+    const double legacyMs = timer.nsecsElapsed() / 1e6;
+    check(fast == legacy, "20000-point mask matches legacy");
+    reportTiming("n=%d: legacy %.1f ms, kernel %.1f ms (%.0fx)\n", n, legacyMs, fastMs, legacyMs / qMax(fastMs, 1e-3));
+}
+
+// ==== 峰分析：原 FindPeaks 窗口扫描 / PeakSeg-COW 逐峰向两侧扫描 ====
+static double legacyWindowProminence(const QVector<double>& y, int i, int win)
+{
+    const int n = y.size();
+    double leftMin = y[i], rightMin = y[i];
+    for (int k = qMax(0, i - win); k <= i; ++k) leftMin = qMin(leftMin, y[k]);
+    for (int k = i; k <= qMin(n - 1, i + win); ++k) rightMin = qMin(rightMin, y[k]);
+    return y[i] - qMax(leftMin, rightMin);
+}
+
+static double legacyNoiseStd(const QVector<double>& y, int i, int win)
+{
+    const int l0 = qMax(0, i - win), r0 = qMin(y.size() - 1, i + win);
+    const int len = r0 - l0 + 1;
+    if (len <= 1) return 0.0;
+    double sum = 0.0, sum2 = 0.0;
+    for (int k = l0; k <= r0; ++k) {
+        sum += y[k];
+        sum2 += y[k] * y[k];
+    }
+    const double mean = sum / len;
+    const double var = (sum2 / len) - mean * mean;
+    return (var > 0.0) ? qSqrt(var) : 0.0;
+}
+
+static double legacyProminence(const QVector<double>& y, int p)
+{
+    int L = p - 1;
+    while (L >= 0 && y[L] <= y[p]) L--;
+    double leftMin = y[p];
+    for (int t = L + 1; t <= p; ++t) leftMin = qMin(leftMin, y[t]);
+    int R = p + 1;
+    while (R < y.size() && y[R] <= y[p]) R++;
+    double rightMin = y[p];
+    for (int t = p; t <= R - 1; ++t) rightMin = qMin(rightMin, y[t]);
+    return y[p] - qMax(leftMin, rightMin);
+}
+
+static void testPeakKernel()
+{
+    std::printf("== PeakKernel ==\n");
+
+    // 11630 点噪声色谱：数千个局部极大值；量化到 0.05 制造平顶
+    const int n = 11630;
+    const QVector<QPointF> base = syntheticChromatogram(n, 0.0);
+    QVector<double> y(n);
+    quint32 seed = 777;
+    for (int i = 0; i < n; ++i) {
+        seed = seed * 1664525u + 1013904223u;
+        y[i] = std::round((base[i].y() + ((seed >> 8) % 1000) / 500.0) * 20.0) / 20.0;
+    }
+
+    const QVector<int> locs = PeakKernel::localMaxima(y);
+    bool plateauCentred = PeakKernel::localMaxima({0, 1, 2, 2, 2, 1, 0}) == QVector<int>({3})
+                          && PeakKernel::localMaxima({0, 2, 2, 1}) == QVector<int>({2}); // 偶数平顶四舍五入
+    check(plateauCentred, "local maxima take plateau centre");
+
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<double> proms = PeakKernel::prominences(y, locs);
+    const double kernelMs = timer.nsecsElapsed() / 1e6;
+    timer.restart();
+    bool sameProm = proms.size() == locs.size();
+    for (int k = 0; k < locs.size() && sameProm; ++k) sameProm = proms[k] == legacyProminence(y, locs[k]);
+    const double legacyMs = timer.nsecsElapsed() / 1e6;
+    check(sameProm, "prominence identical to nearest-higher scan");
+    reportTiming("%d maxima: legacy %.2f ms, kernel %.2f ms\n", locs.size(), legacyMs, kernelMs);
+
+    const PeakKernel::RangeMin rangeMin(y);
+    const PeakKernel::WindowStats stats(y);
+    bool sameWindow = true;
+    double noiseErr = 0.0;
+    for (int win : {0, 1, 7, 20, 200}) {
+        for (int i = 1; i < n - 1; ++i) {
+            sameWindow = sameWindow && PeakKernel::windowProminence(y, rangeMin, i, win) == legacyWindowProminence(y, i, win);
+            const double expected = legacyNoiseStd(y, i, win);
+            const double got = stats.stdDev(qMax(0, i - win), qMin(n - 1, i + win));
+            noiseErr = qMax(noiseErr, std::fabs(got - expected));
+        }
+    }
+    check(sameWindow, "window prominence identical to window scan");
+    // 原实现直接累加 y^2，自身有 ~1e-8 量级的相消误差；内核为补偿前缀和，误差更小
+    char label[96];
+    std::snprintf(label, sizeof(label), "window noise std matches direct sums (abs %.2e)", noiseErr);
+    check(noiseErr < 1e-6, label);
+}
+
+// ==== 整体滞后搜索：原 COWAlignment::estimateBestLag（逐滞后全量累加 Pearson）====
+static int legacyBestLag(const QVector<double>& refY, const QVector<double>& tgtY, int maxLag)
+{
+    const int n = qMin(refY.size(), tgtY.size());
+    double bestCorr = -1.0;
+    int bestLag = 0;
+    for (int lag = -maxLag; lag <= maxLag; ++lag) {
+        const int startRef = qMax(0, lag), startTgt = qMax(0, -lag), len = n - qAbs(lag);
+        if (len <= 5) continue;
+        double sumX = 0, sumY = 0, sumXX = 0, sumYY = 0, sumXY = 0;
+        for (int i = 0; i < len; ++i) {
+            const double x = refY[startRef + i], y = tgtY[startTgt + i];
+            sumX += x; sumY += y;
+            sumXX += x * x; sumYY += y * y;
+            sumXY += x * y;
+        }
+        const double meanX = sumX / len, meanY = sumY / len;
+        const double denom = qSqrt(sumXX / len - meanX * meanX) * qSqrt(sumYY / len - meanY * meanY);
+        if (denom == 0.0) continue;
+        const double r = (sumXY / len - meanX * meanY) / denom;
+        if (r > bestCorr) {
+            bestCorr = r;
+            bestLag = lag;
+        }
+    }
+    return bestLag;
+}
+
+static void testCrossCorrelation()
+{
+    std::printf("== CrossCorrelation ==\n");
+
+    // 实数 FFT 与 DFT 定义一致，逆变换还原
+    QVector<double> x(64);
+    for (int i = 0; i < 64; ++i) x[i] = std::sin(i * 0.3) + i * 0.01;
+    const QVector<std::complex<double>> spectrum = CrossCorrelation::realFft(x);
+    double dftErr = 0.0;
+    for (int k = 0; k <= 32; ++k) {
+        std::complex<double> sum = 0.0;
+        for (int j = 0; j < 64; ++j) sum += x[j] * std::polar(1.0, -2.0 * M_PI * j * k / 64);
+        dftErr = qMax(dftErr, std::abs(sum - spectrum[k]));
+    }
+    check(dftErr < 1e-10 && maxAbsDiff(CrossCorrelation::inverseRealFft(spectrum, 64), x) < 1e-12,
+          "real FFT matches DFT and round-trips");
+
+    // 不同长度、位移与滞后范围：FFT / 直接法 与原实现选出同一滞后
+    auto shifted = [](int n, double shift, quint32 seed) {
+        QVector<double> y(n);
+        for (int i = 0; i < n; ++i) {
+            const double t = (i - shift) * 0.01;
+            seed = seed * 1664525u + 1013904223u;
+            y[i] = 5.0 * std::sin(t * 0.1) + 100.0 * std::exp(-std::pow((t - 40.0) / 3.0, 2))
+                 + 40.0 * std::exp(-std::pow((t - 75.0) / 1.5, 2)) + ((seed >> 8) % 1000) / 500.0;
+        }
+        return y;
+    };
+    bool sameLag = true;
+    double corrDiff = 0.0;
+    for (int t = 0; t < 60; ++t) {
+        const int nRef = 20 + t * 97;
+        const int nTgt = qMax(3, nRef + (t % 5) * 13 - 20);
+        const int maxLag = (t * 7) % 120;
+        const QVector<double> ref = shifted(nRef, 0.0, t);
+        const QVector<double> tgt = shifted(nTgt, (t % 11) - 5 + 0.3 * t, t + 99);
+        const int expected = legacyBestLag(ref, tgt, maxLag);
+        const CrossCorrelation::LagEstimator direct(ref, maxLag, CrossCorrelation::Method::Direct);
+        const CrossCorrelation::LagEstimator fft(ref, maxLag, CrossCorrelation::Method::Fft);
+        sameLag = sameLag && direct.bestLag(tgt) == expected && fft.bestLag(tgt) == expected;
+        corrDiff = qMax(corrDiff, maxAbsDiff(direct.correlations(tgt), fft.correlations(tgt)));
+    }
+    check(sameLag, "best lag identical to per-lag Pearson scan");
+    char label[96];
+    std::snprintf(label, sizeof(label), "FFT and direct correlations agree (max diff %.2e)", corrDiff);
+    check(corrDiff < 1e-9, label);
+
+    // 规模：11630 点色谱，20 个目标共用一个参考
+    const int n = 11630;
+    const QVector<double> ref = shifted(n, 0.0, 1);
+    QVector<QVector<double>> targets;
+    for (int k = 0; k < 20; ++k) targets.append(shifted(n, k * 3 - 30, k + 5));
+    for (int maxLag : {50, 200, 1000}) {
+        QElapsedTimer timer;
+        timer.start();
+        int legacySum = 0;
+        for (const QVector<double>& tgt : targets) legacySum += legacyBestLag(ref, tgt, maxLag);
+        const double legacyMs = timer.nsecsElapsed() / 1e6 / targets.size();
+        timer.restart();
+        const CrossCorrelation::LagEstimator estimator(ref, maxLag);
+        int kernelSum = 0;
+        for (const QVector<double>& tgt : targets) kernelSum += estimator.bestLag(tgt);
+        const double kernelMs = timer.nsecsElapsed() / 1e6 / targets.size();
+        check(legacySum == kernelSum, "batched lags match legacy");
+        reportTiming("maxLag=%d: legacy %.3f ms, kernel %.3f ms per target\n", maxLag, legacyMs, kernelMs);
+    }
+}
+
+// ==== 重采样：原 CurveMathUtils::sumCurvesYByUnionX（并集排序 + 每点两次二分插值）====
+static QVector<QPointF> legacySumCurvesYByUnionX(const QVector<QPointF>& curveA, const QVector<QPointF>& curveB)
+{
+    QVector<QPointF> out;
+    if (curveA.isEmpty() || curveB.isEmpty()) return out;
+    QVector<double> xs;
+    for (const QPointF& p : curveA) xs.append(p.x());
+    for (const QPointF& p : curveB) xs.append(p.x());
+    std::sort(xs.begin(), xs.end());
+    xs.erase(std::unique(xs.begin(), xs.end()), xs.end());
+    for (double x : xs)
+        out.append(QPointF(x, CurveMathUtils::interpolateYAtX(curveA, x) + CurveMathUtils::interpolateYAtX(curveB, x)));
+    return out;
+}
+
+static void testCurveResampling()
+{
+    std::printf("== CurveResampling ==\n");
+
+    quint32 seed = 7u;
+    auto uniformRand = [&seed]() {
+        seed = seed * 1664525u + 1013904223u;
+        return ((seed >> 8) & 0xFFFF) / 65536.0;
+    };
+    // 不规则升序 X（含重复点）的测试曲线
+    auto irregular = [&](int n, double x0) {
+        QVector<QPointF> pts;
+        double x = x0;
+        for (int i = 0; i < n; ++i) {
+            x += (i % 17 == 5) ? 0.0 : 0.05 + uniformRand();
+            pts.append(QPointF(x, std::sin(x * 0.1) * 50.0 + uniformRand()));
+        }
+        return pts;
+    };
+
+    // 两曲线并集加和与原实现逐位一致
+    bool sumSame = true;
+    for (int t = 0; t < 20; ++t) {
+        const QVector<QPointF> a = irregular(2 + t * 37, -3.0 * t);
+        const QVector<QPointF> b = irregular(1 + t * 23, 5.0 * t);
+        const QVector<QPointF> expected = legacySumCurvesYByUnionX(a, b);
+        const QVector<QPointF> actual = CurveMathUtils::sumCurvesYByUnionX(a, b);
+        sumSame = sumSame && expected.size() == actual.size();
+        for (int i = 0; sumSame && i < expected.size(); ++i)
+            sumSame = expected[i].x() == actual[i].x() && expected[i].y() == actual[i].y();
+    }
+    check(sumSame, "union sum identical to legacy");
+
+    // 乱序目标（二分回退）与等间距源（下标定位）均与逐点插值逐位一致
+    bool pointwise = true;
+    for (int uniform = 0; uniform < 2; ++uniform) {
+        QVector<QPointF> src = irregular(500, 0.0);
+        if (uniform) {
+            for (int i = 0; i < src.size(); ++i) src[i] = QPointF(10.0 + i * 0.25, src[i].y());
+        }
+        CurveMathUtils::UniformGrid grid;
+        QVector<double> srcX;
+        for (const QPointF& p : src) srcX.append(p.x());
+        pointwise = pointwise && CurveMathUtils::detectUniformGrid(srcX, &grid) == bool(uniform);
+        QVector<double> target;
+        for (int i = 0; i < 2000; ++i) target.append(srcX.first() - 5.0 + uniformRand() * (srcX.last() - srcX.first() + 10.0));
+        const QVector<double> y = CurveMathUtils::resample(src, target);
+        for (int i = 0; i < target.size(); ++i)
+            pointwise = pointwise && y[i] == CurveMathUtils::interpolateYAtX(src, target[i]);
+    }
+    check(pointwise, "unordered targets and uniform sources match per-point interpolation");
+
+    // PCHIP：过节点、保单调、线性数据精确重现
+    QVector<double> mx, my, lineY;
+    for (int i = 0; i < 40; ++i) {
+        mx.append(i * i * 0.1 + i);
+        my.append(std::tanh((i - 20) * 0.3) + (i > 30 ? 1.0 : 0.0));
+        lineY.append(2.0 * mx.last() - 3.0);
+    }
+    const QVector<double> atNodes = CurveMathUtils::resample(mx, my, mx, CurveMathUtils::Interpolation::Pchip);
+    QVector<double> fine;
+    for (int i = 0; i <= 4000; ++i) fine.append(mx.first() + (mx.last() - mx.first()) * i / 4000.0);
+    const QVector<double> pchip = CurveMathUtils::resample(mx, my, fine, CurveMathUtils::Interpolation::Pchip);
+    bool monotone = true;
+    for (int i = 1; i < pchip.size(); ++i) monotone = monotone && pchip[i] >= pchip[i - 1] - 1e-12;
+    QVector<double> lineExpected;
+    for (double x : fine) lineExpected.append(2.0 * x - 3.0);
+    check(maxAbsDiff(atNodes, my) < 1e-12 && monotone
+              && maxAbsDiff(CurveMathUtils::resample(mx, lineY, fine, CurveMathUtils::Interpolation::Pchip), lineExpected) < 1e-9,
+          "PCHIP interpolates nodes, keeps monotonicity, reproduces lines");
+
+    // 公共网格：X 相同（serial_no）时等价于截断到最短长度
+    QVector<QVector<double>> xs, ys;
+    for (int c = 0; c < 4; ++c) {
+        QVector<double> x, y;
+        for (int i = 0; i < 100 + c * 7; ++i) { x.append(i); y.append(uniformRand()); }
+        xs.append(x);
+        ys.append(y);
+    }
+    std::swap(xs[0], xs[2]);
+    std::swap(ys[0], ys[2]);
+    const CurveMathUtils::AlignedCurves aligned = CurveMathUtils::alignToCommonGrid(xs, ys);
+    bool truncated = aligned.x.size() == 100;
+    for (int c = 0; truncated && c < 4; ++c)
+        truncated = aligned.y[c] == ys[c].mid(0, 100);
+    check(truncated, "overlap grid on shared serial X equals truncation to shortest");
+
+    // 规模：两条约 2 万点不规则曲线并集加和
+    const QVector<QPointF> a = irregular(20000, 0.0);
+    const QVector<QPointF> b = irregular(20000, 0.3);
+    QElapsedTimer timer;
+    timer.start();
+    const QVector<QPointF> legacy = legacySumCurvesYByUnionX(a, b);
+    const double legacyMs = timer.nsecsElapsed() / 1e6;
+    timer.restart();
+    const QVector<QPointF> merged = CurveMathUtils::sumCurvesYByUnionX(a, b);
+    const double mergedMs = timer.nsecsElapsed() / 1e6;
+    check(legacy.size() == merged.size(), "large union sum size matches");
+    reportTiming("union sum of 2x20000 points: legacy %.3f ms, merge walk %.3f ms\n", legacyMs, mergedMs);
+}
+
+// ==== 等间距 X 网格：检测不改 X、曲线携带与按网格平滑 ====
+static void testUniformGrid()
+{
+    std::printf("== UniformGrid ==\n");
+
+    // 检测：1e-9·dx 以内的偏差识别为网格，X 列保持原样；非等间距没有网格
+    const int n = 11630;
+    QVector<double> nearUniform(n), irregular(n), serial(n), y(n);
+    for (int i = 0; i < n; ++i) {
+        nearUniform[i] = 3.0 + i * 0.01 + ((i % 7) - 3) * 1e-14;
+        irregular[i] = i * 0.01 + 0.004 * std::sin(i * 1.3);
+        serial[i] = i;
+        y[i] = std::sin(i * 0.01) + 0.1 * std::sin(i * 0.7);
+    }
+    const CurveValue fromX(nearUniform, y, "x");
+    const UniformGrid grid = fromX.uniformX();
+    check(grid.isValid() && grid.n == n && grid.x0 == nearUniform[0] && std::fabs(grid.dx - 0.01) < 1e-15,
+          "near-uniform X detected as grid");
+    check(fromX.xValues().constData() == nearUniform.constData() && fromX.xValues() == nearUniform,
+          "grid detection leaves X untouched");
+    check(!CurveValue(irregular, y).hasUniformX() && !UniformGrid::fromX(QVector<double>{1.0}).isValid(),
+          "irregular or single-point X has no grid");
+    check(UniformGrid::detect(serial, nullptr, 0.0) && !UniformGrid::detect(nearUniform, nullptr, 0.0),
+          "exact detection (relTol 0) accepts only bit-exact grids");
+
+    // 网格按需检测：网格构造直接记下描述，拷贝、Curve 往返与截断后检测结果一致，setData 后不再沿用旧网格
+    const CurveValue fromGrid(grid, y, "grid");
+    const CurveValue copy = fromX;
+    const Curve curve(fromX);
+    const Curve curveCopy(curve);
+    UniformGrid prefix = grid;
+    prefix.n = 6000;
+    const CurveValue truncated(nearUniform.mid(0, prefix.n), y);
+    check(fromGrid.uniformX() == grid && fromGrid.xValues() == grid.values() && copy.uniformX() == grid
+              && curveCopy.uniformX() == grid && curve.toCurveValue().uniformX() == grid
+              && truncated.uniformX().n == prefix.n && std::fabs(truncated.uniformX().dx - grid.dx) < 1e-15,
+          "curves carry the grid through construction, copies and truncation");
+    CurveValue replaced(grid, y);
+    replaced.setData(irregular, y);
+    check(!replaced.hasUniformX(), "setData drops a grid the new X does not follow");
+
+    // LOESS：按网格平滑（含两端与稳健迭代的查表拟合）与显式 X 路径一致
+    bool loessSame = true;
+    for (int robust = 0; robust <= 2; robust += 2) {
+        for (double f : {0.2, 0.05, 0.01}) {
+            LoessEngine::Options options;
+            options.fraction = f;
+            options.robustIterations = robust;
+            const QVector<double> ref = LoessEngine::smooth(nearUniform, y, options);
+            loessSame = loessSame && maxAbsDiff(LoessEngine::smooth(grid, y, options), ref) / maxAbs(ref) < 1e-9;
+        }
+    }
+    check(loessSame, "LOESS on grid matches explicit X");
+    {
+        Loess loess;
+        QVariantMap params;
+        params["fraction"] = 0.1;
+        QString error;
+        ProcessingResult res = loess.process({fromX}, params, error);
+        const QList<CurveValue> out = res.namedCurves.value("smoothed");
+        check(out.size() == 1 && out.first().uniformX() == grid && out.first().xValues() == nearUniform,
+              "Loess::process keeps X and its grid on the output");
+    }
+
+    if (!g_benchmark) return;
+
+    // 微基准：11630 点、span=0.05、2 次稳健迭代（全部逐点拟合）
+    LoessEngine::Options options;
+    options.fraction = 0.05;
+    options.robustIterations = 2;
+    const int reps = 3;
+    QElapsedTimer timer;
+    timer.start();
+    for (int r = 0; r < reps; ++r) LoessEngine::smooth(nearUniform, y, options);
+    const double explicitMs = timer.nsecsElapsed() / 1e6 / reps;
+    timer.restart();
+    for (int r = 0; r < reps; ++r) LoessEngine::smooth(grid, y, options);
+    const double gridMs = timer.nsecsElapsed() / 1e6 / reps;
+    reportTiming("robust LOESS 11630 points, span=0.05: explicit X %.1f ms, grid %.1f ms\n", explicitMs, gridMs);
+}
+
+static void testAlgoResultRetention()
+{
+    std::printf("== AlgoResultRetention ==\n");
+
+    const QDateTime t0(QDate(2024, 1, 1), QTime(8, 0));
+    QVector<AlgoResultRetention::Entry> entries;
+    for (int i = 0; i < 12; ++i) entries.append({QByteArray(20, char('a' + i)), t0.addSecs(i * 60)});
+
+    // 未超出上限时不淘汰
+    check(AlgoResultRetention::hashesToEvict(entries.mid(0, 5), entries[4].paramHash, 8).isEmpty(),
+          "under the limit nothing is evicted");
+
+    // 超出上限：保留最近写入的 8 组，淘汰最早的 4 组（与输入顺序无关）
+    QVector<AlgoResultRetention::Entry> shuffled = entries;
+    std::reverse(shuffled.begin(), shuffled.end());
+    std::swap(shuffled[2], shuffled[9]);
+    const QList<QByteArray> evicted = AlgoResultRetention::hashesToEvict(shuffled, entries[11].paramHash, 8);
+    bool oldestEvicted = evicted.size() == 4;
+    for (int i = 0; i < 4 && oldestEvicted; ++i) oldestEvicted = evicted.contains(entries[i].paramHash);
+    check(oldestEvicted, "oldest parameter sets are evicted first");
+
+    // 刚写入的参数组即使时间戳最旧（同一秒写入、时钟回拨）也保留
+    const QList<QByteArray> keepCurrent = AlgoResultRetention::hashesToEvict(entries, entries[0].paramHash, 3);
+    check(keepCurrent.size() == 9 && !keepCurrent.contains(entries[0].paramHash)
+              && !keepCurrent.contains(entries[11].paramHash) && !keepCurrent.contains(entries[10].paramHash),
+          "the set just written is always kept");
+
+    // 同一写入时间按哈希决定，结果确定
+    QVector<AlgoResultRetention::Entry> sameTime;
+    for (int i = 0; i < 4; ++i) sameTime.append({QByteArray(20, char('k' - i)), t0});
+    const QList<QByteArray> tie = AlgoResultRetention::hashesToEvict(sameTime, sameTime[0].paramHash, 2);
+    check(tie == (QList<QByteArray>{QByteArray(20, 'i'), QByteArray(20, 'j')}),
+          "ties on write time are broken deterministically");
+    check(AlgoResultRetention::hashesToEvict(entries, entries[11].paramHash, 0).size() == 11,
+          "keep count below one keeps only the current set");
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    g_benchmark = app.arguments().contains("--benchmark");
+
+    testSavitzkyGolay();
+    testLoess();
+    testAirPls();
+    testCurveStorage();
+    testStageCurve();
+    testStageCache();
+    testCurveMetricsKernel();
+    testSimilarityMatrix();
+    testCurveLodPyramid();
+    testCurveHitIndex();
+    testHampelKernel();
+    testPeakKernel();
+    testCrossCorrelation();
+    testCurveResampling();
+    testUniformGrid();
+    testAlgoResultRetention();
+
+    std::printf("%s (%d failures)\n", g_failures == 0 ? "ALL PASSED" : "FAILED", g_failures);
+    return g_failures == 0 ? 0 : 1;
+}
@@ -3,11 +3,12 @@
  * 构建：见 tests/CMakeLists.txt
  */
 #include <QCoreApplication>
+#include <QElapsedTimer>
 #include <QtMath>
 #include <cmath>
 #include <cstdio>
 
-#include "core/entities/Curve.h"
+#include "core/entities/CurveValue.h"
 #include "services/algorithm/PeakSegCOWAlignment.h"
 #include "services/algorithm/processing/IProcessingStep.h"
 
@@ -63,8 +64,8 @@ int main(int argc, char* argv[])
         yTgt.append(yRef[i]);
     }
 
-    Curve ref(x, yRef, QStringLiteral("ref"));
-    Curve tgt(x, yTgt, QStringLiteral("tgt"));
+    const CurveValue ref(x, yRef, QStringLiteral("ref"));
+    const CurveValue tgt(x, yTgt, QStringLiteral("tgt"));
 
     PeakSegCOWAlignment aligner;
     QVariantMap p;
@@ -75,16 +76,13 @@ int main(int argc, char* argv[])
     p.insert(QStringLiteral("range_count"), 4);
 
     QString err;
-    ProcessingResult pr = aligner.process({&ref, &tgt}, p, err);
+    ProcessingResult pr = aligner.process({ref, tgt}, p, err);
     if (!err.isEmpty() || !pr.namedCurves.contains(QStringLiteral("aligned"))
         || pr.namedCurves[QStringLiteral("aligned")].isEmpty()) {
         std::fprintf(stderr, "FAIL: PeakSeg-COW %s\n", qPrintable(err));
         return 1;
     }
-    Curve* al = pr.namedCurves[QStringLiteral("aligned")].first();
-    QVector<double> ya;
-    for (const QPointF& pt : al->data())
-        ya.append(pt.y());
+    const QVector<double> ya = pr.namedCurves[QStringLiteral("aligned")].first().yValues();
 
     const double r = pearsonCorr(yRef, ya);
     const double e = rmse(yRef, ya);
@@ -93,6 +91,79 @@ int main(int argc, char* argv[])
         return 2;
     }
 
+    // 批处理路径：参考只准备一次，对多条平移目标逐一对齐，结果须与 process 逐位一致
+    QString prepErr;
+    const QSharedPointer<const PeakSegCOWAlignment::PreparedReference> prepared =
+        PeakSegCOWAlignment::prepareReference(ref, p, prepErr);
+    if (prepared.isNull()) {
+        std::fprintf(stderr, "FAIL: prepareReference %s\n", qPrintable(prepErr));
+        return 3;
+    }
+    for (int shift = -6; shift <= 6; shift += 3) {
+        QVector<double> yShift(n);
+        for (int i = 0; i < n; ++i) yShift[i] = yRef[qBound(0, i - shift, n - 1)];
+        const CurveValue shifted(x, yShift, QStringLiteral("shifted"));
+        QString e1, e2;
+        ProcessingResult viaProcess = aligner.process({ref, shifted}, p, e1);
+        ProcessingResult viaPrepared = PeakSegCOWAlignment::alignToReference(*prepared, shifted, e2);
+        const QList<CurveValue> a1 = viaProcess.namedCurves.value(QStringLiteral("aligned"));
+        const QList<CurveValue> a2 = viaPrepared.namedCurves.value(QStringLiteral("aligned"));
+        const bool same = a1.size() == 1 && a2.size() == 1
+                          && a1.first().xValues() == a2.first().xValues()
+                          && a1.first().yValues() == a2.first().yValues()
+                          && viaProcess.metadata == viaPrepared.metadata;
+        if (!same) {
+            std::fprintf(stderr, "FAIL: prepared reference differs from process (shift=%d)\n", shift);
+            return 3;
+        }
+    }
+
+    // 段 DP 规模校验：11630 点多峰色谱、10 个区间、t = 50，平移目标对齐后相关性须提升（同时输出耗时）
+    {
+        const int nBig = 11630;
+        const int peakCount = (nBig - 300) / 200;
+        QVector<double> xb(nBig), yb(nBig), ybShift(nBig);
+        auto chrom = [peakCount](double t, double shift) {
+            double v = 0.5;
+            for (int k = 0; k < peakCount; ++k) {
+                const double c = 150.0 + 200.0 * k + shift * (1.0 + 0.01 * k);
+                const double w = 15.0 + k % 15;
+                v += (1 + k % 3) * std::exp(-0.5 * (t - c) * (t - c) / (w * w));
+            }
+            return v;
+        };
+        for (int i = 0; i < nBig; ++i) {
+            xb[i] = double(i);
+            yb[i] = chrom(i, 0.0);
+            ybShift[i] = chrom(i, 8.0);
+        }
+        const CurveValue refBig(xb, yb, QStringLiteral("ref_big"));
+        const CurveValue tgtBig(xb, ybShift, QStringLiteral("tgt_big"));
+        QVariantMap pBig = p;
+        pBig.insert(QStringLiteral("t"), 50);
+        pBig.insert(QStringLiteral("range_count"), 10);
+
+        QElapsedTimer timer;
+        timer.start();
+        QString errBig;
+        ProcessingResult big = aligner.process({refBig, tgtBig}, pBig, errBig);
+        const qint64 elapsedMs = timer.elapsed();
+        const QList<CurveValue> alignedBig = big.namedCurves.value(QStringLiteral("aligned"));
+        if (!errBig.isEmpty() || alignedBig.size() != 1) {
+            std::fprintf(stderr, "FAIL: PeakSeg-COW large %s\n", qPrintable(errBig));
+            return 4;
+        }
+        const QVector<double> yBigAligned = alignedBig.first().yValues();
+        const double rBefore = pearsonCorr(yb, ybShift);
+        const double rAfter = pearsonCorr(yb, yBigAligned);
+        std::printf("PeakSeg-COW n=%d ranges=10 t=50: %lld ms, r %.4f -> %.4f\n",
+                    nBig, static_cast<long long>(elapsedMs), rBefore, rAfter);
+        if (rAfter < rBefore) {
+            std::fprintf(stderr, "FAIL: large PeakSeg alignment did not improve correlation\n");
+            return 4;
+        }
+    }
+
     std::printf("OK chromatogram_matlab_parity_test PeakSeg r=%.6f rmse=%.6f\n", r, e);
     return 0;
 }
@@ -0,0 +1,89 @@
+/**
+ * 色谱批量单样本阶段的线程扩展性基准（需要可连接的 MySQL 与已导入的色谱样本）。
+ * 依次以 1/2/4/8/16 线程运行同一批样本的单样本流水线（不含对齐），
+ * 输出每档耗时与相对 1 线程的加速比。每档计时前清空阶段缓存，避免后续档位直接命中缓存。
+ * 用法：chromatograph_batch_scaling_benchmark <config.json> <sql_config.json> <sampleId>...
+ * 构建：见 tests/CMakeLists.txt（BUILD_BATCH_SCALING_BENCHMARK）
+ */
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QMap>
+#include <cstdio>
+
+#include "core/common.h"
+#include "core/sql/SqlConfigLoader.h"
+#include "data_access/DatabaseConnector.h"
+#include "data_access/databasemanager.h"
+#include "services/DataProcessingService.h"
+
+static bool connectDatabases(const QString& configPath)
+{
+    QFile file(configPath);
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot open %s\n", qPrintable(configPath));
+        return false;
+    }
+    const QJsonObject dbConfig = QJsonDocument::fromJson(file.readAll()).object().value("database").toObject();
+    // 批量路径的线程连接从 DatabaseConnector 克隆，单样本默认 DAO 走 DatabaseManager，两者都需连接
+    if (!DatabaseConnector::getInstance().connectOrCreateDatabase(dbConfig.toVariantMap())) {
+        std::fprintf(stderr, "DatabaseConnector connection failed\n");
+        return false;
+    }
+    if (!DatabaseManager::instance().connectToDb(dbConfig.value("dbName").toString(),
+                                                 dbConfig.value("user").toString(),
+                                                 dbConfig.value("password").toString(),
+                                                 dbConfig.value("host").toString("127.0.0.1"),
+                                                 dbConfig.value("port").toInt(3306))) {
+        std::fprintf(stderr, "DatabaseManager connection failed\n");
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 4) {
+        std::fprintf(stderr, "usage: %s <config.json> <sql_config.json> <sampleId>...\n", argv[0]);
+        return 2;
+    }
+    if (!connectDatabases(QString::fromLocal8Bit(argv[1]))) return 1;
+    if (!SqlConfigLoader::getInstance().loadConfig(QString::fromLocal8Bit(argv[2]), SqlConfigLoader::JSON_CONFIG)) {
+        std::fprintf(stderr, "cannot load %s\n", argv[2]);
+        return 1;
+    }
+
+    QList<int> sampleIds;
+    for (int i = 3; i < argc; ++i) sampleIds.append(QString::fromLocal8Bit(argv[i]).toInt());
+
+    ProcessingParameters params;
+    params.alignmentEnabled = false; // 只测单样本阶段
+
+    DataProcessingService service;
+    const int savedThreadCount = service.batchThreadCount();
+
+    // 预热：持久化的基线校正结果与各档一致命中，避免首档计入首次计算
+    service.runChromatographPipelineForMultiple(sampleIds, params);
+
+    QMap<int, qint64> elapsedByThreads;
+    QElapsedTimer timer;
+    for (int threads : {1, 2, 4, 8, 16}) {
+        service.setBatchThreadCount(threads);
+        service.invalidateStageCache();
+        timer.restart();
+        service.runChromatographPipelineForMultiple(sampleIds, params);
+        elapsedByThreads.insert(threads, timer.elapsed());
+    }
+    service.setBatchThreadCount(savedThreadCount);
+
+    const qint64 baseMs = elapsedByThreads.value(1, -1);
+    for (auto it = elapsedByThreads.constBegin(); it != elapsedByThreads.constEnd(); ++it) {
+        const double speedup = (baseMs > 0 && it.value() > 0) ? double(baseMs) / double(it.value()) : 0.0;
+        std::printf("Chromatograph batch: %2d thread(s) %6lld ms for %d sample(s), speedup x%.2f\n",
+                    it.key(), static_cast<long long>(it.value()), sampleIds.size(), speedup);
+    }
+    return 0;
+}
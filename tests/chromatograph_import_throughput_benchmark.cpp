@@ -0,0 +1,146 @@
+/**
+ * 色谱导入写入吞吐基准（需要可连接的 MySQL 与一个可写入的样本，建议使用测试库中的专用样本）。
+ * 生成 folderCount 条合成色谱曲线（每条 pointsPerFile 点，若干高斯峰叠加基线），
+ * 分别以逐行 INSERT（旧导入路径）与 ChromatographyDataDAO::insertColumns 的多行批量 INSERT 写入，
+ * 两条路径都同步维护汇总表与 curve_blob，与导入线程的写入内容一致。
+ * 全部写入在同一事务内完成，结束后整体回滚，不留下数据。
+ * 用法：chromatograph_import_throughput_benchmark <config.json> <sampleId> [folderCount=50] [pointsPerFile=6000]
+ * 构建：见 tests/CMakeLists.txt（BUILD_BATCH_SCALING_BENCHMARK）
+ */
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSqlQuery>
+#include <QVector>
+#include <cmath>
+#include <cstdio>
+
+#include "core/common.h"
+#include "data_access/ChromatographyDataDAO.h"
+#include "data_access/CurveBlobDAO.h"
+#include "data_access/DatabaseConnector.h"
+#include "data_access/SampleDataSummaryDAO.h"
+
+static double rowsPerSecond(qint64 rows, qint64 nsecs)
+{
+    return nsecs > 0 ? rows * 1.0e9 / nsecs : 0.0;
+}
+
+static void makeCurve(int fileIndex, int points, QVector<double>& rt, QVector<double>& rv)
+{
+    rt.resize(points);
+    rv.resize(points);
+    for (int i = 0; i < points; ++i) {
+        const double t = i * 0.01;
+        double y = 1000.0 + 5.0 * t;
+        for (int k = 1; k <= 8; ++k) {
+            const double c = k * points * 0.01 / 9.0 + fileIndex * 0.001;
+            y += 2.0e4 * k * std::exp(-(t - c) * (t - c) / 0.02);
+        }
+        rt[i] = t;
+        rv[i] = y;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    if (argc < 3) {
+        std::fprintf(stderr, "usage: %s <config.json> <sampleId> [folderCount] [pointsPerFile]\n", argv[0]);
+        return 2;
+    }
+    QFile file(QString::fromLocal8Bit(argv[1]));
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    const QJsonObject dbConfig = QJsonDocument::fromJson(file.readAll()).object().value("database").toObject();
+    if (!DatabaseConnector::getInstance().connectOrCreateDatabase(dbConfig.toVariantMap())) {
+        std::fprintf(stderr, "DatabaseConnector connection failed\n");
+        return 1;
+    }
+
+    const int sampleId = QString::fromLocal8Bit(argv[2]).toInt();
+    const int folderCount = argc > 3 ? QString::fromLocal8Bit(argv[3]).toInt() : 50;
+    const int pointsPerFile = argc > 4 ? QString::fromLocal8Bit(argv[4]).toInt() : 6000;
+    if (sampleId <= 0 || folderCount <= 0 || pointsPerFile <= 0) {
+        std::fprintf(stderr, "invalid arguments\n");
+        return 2;
+    }
+
+    ScopedThreadConnection connection;
+    QSqlDatabase& db = connection.database();
+    if (!db.isOpen()) {
+        std::fprintf(stderr, "cannot open benchmark connection\n");
+        return 1;
+    }
+
+    QJsonObject attrs;
+    attrs.insert("code", "BENCH");
+    attrs.insert("year", 2024);
+    bool withAttrs = false;
+    {
+        QSqlQuery chk(db);
+        withAttrs = chk.exec("SHOW COLUMNS FROM `chromatography_data` LIKE 'import_attributes'") && chk.next();
+    }
+
+    if (!db.transaction()) {
+        std::fprintf(stderr, "cannot start transaction\n");
+        return 1;
+    }
+
+    QVector<double> rt, rv;
+    QElapsedTimer timer;
+
+    // 旧路径：逐行 exec，每行重复序列化 JSON 与取文件名
+    qint64 legacyRows = 0;
+    timer.start();
+    {
+        CurveBlobDAO blobDao(db);
+        SampleDataSummaryDAO summaryDao(db);
+        QSqlQuery query(db);
+        query.prepare(withAttrs
+            ? "INSERT INTO chromatography_data (sample_id, retention_time, response_value, source_filename, import_attributes) VALUES (?, ?, ?, ?, ?)"
+            : "INSERT INTO chromatography_data (sample_id, retention_time, response_value, source_filename) VALUES (?, ?, ?, ?)");
+        for (int f = 0; f < folderCount; ++f) {
+            makeCurve(f, pointsPerFile, rt, rv);
+            const QString fileName = QString("B%1-1.D/tic_back.csv").arg(f + 1);
+            for (int i = 0; i < rt.size(); ++i) {
+                query.bindValue(0, sampleId);
+                query.bindValue(1, rt[i]);
+                query.bindValue(2, rv[i]);
+                query.bindValue(3, fileName);
+                if (withAttrs)
+                    query.bindValue(4, QString::fromUtf8(QJsonDocument(attrs).toJson(QJsonDocument::Compact)));
+                if (query.exec()) ++legacyRows;
+            }
+            summaryDao.refresh(sampleId, DataType::CHROMATOGRAM);
+            blobDao.save(sampleId, DataType::CHROMATOGRAM, rt, rv, fileName, attrs);
+        }
+    }
+    const double legacyRate = rowsPerSecond(legacyRows, timer.nsecsElapsed());
+
+    // 新路径：多行批量 INSERT（insertColumns 内部刷新汇总表）
+    qint64 batchRows = 0;
+    timer.restart();
+    {
+        ChromatographyDataDAO chromatographyDao(db);
+        CurveBlobDAO blobDao(db);
+        for (int f = 0; f < folderCount; ++f) {
+            makeCurve(f, pointsPerFile, rt, rv);
+            const QString fileName = QString("B%1-1.D/tic_back.csv").arg(f + 1);
+            if (chromatographyDao.insertColumns(sampleId, rt, rv, fileName, attrs)
+                && blobDao.save(sampleId, DataType::CHROMATOGRAM, rt, rv, fileName, attrs))
+                batchRows += rt.size();
+        }
+    }
+    const double batchRate = rowsPerSecond(batchRows, timer.nsecsElapsed());
+
+    db.rollback();
+
+    std::printf("Chromatograph import: %d file(s) x %d point(s), row-by-row %.0f rows/s, batched %.0f rows/s, speedup x%.2f\n",
+                folderCount, pointsPerFile, legacyRate, batchRate, legacyRate > 0 ? batchRate / legacyRate : 0.0);
+    return 0;
+}
@@ -0,0 +1,91 @@
+/**
+ * 原始曲线加载路径对比基准（需要可连接的 MySQL 与已导入的样本，只读）。
+ * 分别以逐样本查询（fetchChartDataForSample + getSampleIdentifierById）与批量查询
+ * （fetchChartDataForSamples + getSampleIdentifiersByIds）加载同一批样本，输出两者耗时与点数。
+ * 用法：raw_data_loading_benchmark <config.json> <sql_config.json> <big|small|small_raw|chrom|process_big> <sampleId>...
+ * 构建：见 tests/CMakeLists.txt（BUILD_BATCH_SCALING_BENCHMARK）
+ */
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <cstdio>
+
+#include "core/common.h"
+#include "core/sql/SqlConfigLoader.h"
+#include "data_access/DatabaseConnector.h"
+#include "data_access/SampleDAO.h"
+#include "data_access/SingleTobaccoSampleDAO.h"
+
+static bool parseDataType(const QString& name, DataType& dataType)
+{
+    static const QHash<QString, DataType> types = {
+        {"big", DataType::TG_BIG},
+        {"small", DataType::TG_SMALL},
+        {"small_raw", DataType::TG_SMALL_RAW},
+        {"chrom", DataType::CHROMATOGRAM},
+        {"process_big", DataType::PROCESS_TG_BIG},
+    };
+    if (!types.contains(name)) return false;
+    dataType = types.value(name);
+    return true;
+}
+
+int main(int argc, char* argv[])
+{
+    QCoreApplication app(argc, argv);
+    DataType dataType = DataType::TG_BIG;
+    if (argc < 5 || !parseDataType(QString::fromLocal8Bit(argv[3]), dataType)) {
+        std::fprintf(stderr, "usage: %s <config.json> <sql_config.json> <big|small|small_raw|chrom|process_big> <sampleId>...\n", argv[0]);
+        return 2;
+    }
+    QFile file(QString::fromLocal8Bit(argv[1]));
+    if (!file.open(QIODevice::ReadOnly)) {
+        std::fprintf(stderr, "cannot open %s\n", argv[1]);
+        return 1;
+    }
+    const QJsonObject dbConfig = QJsonDocument::fromJson(file.readAll()).object().value("database").toObject();
+    if (!DatabaseConnector::getInstance().connectOrCreateDatabase(dbConfig.toVariantMap())) {
+        std::fprintf(stderr, "DatabaseConnector connection failed\n");
+        return 1;
+    }
+    if (!SqlConfigLoader::getInstance().loadConfig(QString::fromLocal8Bit(argv[2]), SqlConfigLoader::JSON_CONFIG)) {
+        std::fprintf(stderr, "cannot load %s\n", argv[2]);
+        return 1;
+    }
+
+    QList<int> sampleIds;
+    for (int i = 4; i < argc; ++i) sampleIds.append(QString::fromLocal8Bit(argv[i]).toInt());
+
+    ScopedThreadConnection connection;
+    qint64 perSampleMs = 0, bulkMs = 0;
+    qint64 perSamplePoints = 0, bulkPoints = 0;
+    {
+        SampleDAO sampleDao(connection.database());
+        SingleTobaccoSampleDAO identifierDao(connection.database());
+        QString error;
+        QElapsedTimer timer;
+
+        // 旧路径：每个样本两次往返
+        timer.start();
+        for (int sampleId : sampleIds) {
+            perSamplePoints += sampleDao.fetchChartDataForSample(sampleId, dataType, error).size();
+            identifierDao.getSampleIdentifierById(sampleId);
+        }
+        perSampleMs = timer.elapsed();
+
+        // 新路径：整批两条查询
+        timer.restart();
+        const QHash<int, SampleCurveColumns> curves = sampleDao.fetchChartDataForSamples(sampleIds, dataType, error);
+        for (auto it = curves.constBegin(); it != curves.constEnd(); ++it) bulkPoints += it->x.size();
+        identifierDao.getSampleIdentifiersByIds(sampleIds);
+        bulkMs = timer.elapsed();
+    }
+
+    std::printf("Raw data loading: %d sample(s), per-sample %lld ms (%lld points), bulk %lld ms (%lld points)\n",
+                sampleIds.size(), static_cast<long long>(perSampleMs), static_cast<long long>(perSamplePoints),
+                static_cast<long long>(bulkMs), static_cast<long long>(bulkPoints));
+    return 0;
+}